@@ -0,0 +1,628 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+
+#include "LightAgent.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+typedef SOCKET SocketHandle;
+#define CloseSocket closesocket
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+typedef int SocketHandle;
+#define INVALID_SOCKET (-1)
+#define CloseSocket close
+#endif
+
+namespace {
+    constexpr double PI = 3.14159265358979323846;
+    constexpr unsigned int IDLE_SLEEP_MS = 1;
+    constexpr unsigned int REOPEN_INTERVAL_MS = 500;
+    constexpr unsigned int EXPORT_INTERVAL_MS = 250;
+
+    // Indexed by LightAgentProtocol::LightType
+    const char* TYPE_NAMES[] = { "Unknown", "Directional", "Point", "Spot", "Ambient" };
+
+    const char* TypeName(uint8_t type)
+    {
+        return type < sizeof(TYPE_NAMES) / sizeof(TYPE_NAMES[0]) ? TYPE_NAMES[type] : TYPE_NAMES[0];
+    }
+
+    // Same text as ON_UuidToString for the ON_UUID bytes the plug-in copied
+    void AppendUuid(std::string& out, const uint8_t id[16])
+    {
+        static const char HEX[] = "0123456789ABCDEF";
+        // Data1, Data2 and Data3 are stored little-endian, Data4 as bytes
+        static const int ORDER[16] = { 3, 2, 1, 0, 5, 4, 7, 6, 8, 9, 10, 11, 12, 13, 14, 15 };
+        for (int i = 0; i < 16; ++i)
+        {
+            if (i == 4 || i == 6 || i == 8 || i == 10)
+                out += '-';
+            out += HEX[id[ORDER[i]] >> 4];
+            out += HEX[id[ORDER[i]] & 0x0F];
+        }
+    }
+
+    // Pitch, yaw and roll in degrees, as CLightEventWatcher::DirectionToRhinoRotation
+    void ToRotation(const double direction[3], double& pitch, double& yaw, double& roll)
+    {
+        double x = direction[0], y = direction[1], z = direction[2];
+        const double length = std::sqrt(x * x + y * y + z * z);
+        if (length > 0.0)
+        {
+            x /= length;
+            y /= length;
+            z /= length;
+        }
+        pitch = std::asin(-z) * 180.0 / PI;
+        yaw = std::atan2(y, x) * 180.0 / PI;
+        roll = 0.0;
+    }
+
+    void AppendFormat(std::string& out, const char* format, double value)
+    {
+        char buffer[64];
+        const int length = snprintf(buffer, sizeof(buffer), format, value);
+        if (length > 0)
+            out.append(buffer, static_cast<size_t>(length));
+    }
+
+    std::string EventName(const LightAgentProtocol::RecordHeader& header)
+    {
+        return std::string(header.eventName, strnlen(header.eventName, sizeof(header.eventName)));
+    }
+}
+
+LightAgent::LightAgent(const Options& options)
+    : m_options(options), m_exportDocument(0), m_exportDirty(false),
+    m_lastExport(std::chrono::steady_clock::now()), m_lastStats(std::chrono::steady_clock::now()),
+    m_records(0), m_messagesSent(0), m_bytesSent(0), m_sendFailures(0), m_fileExports(0)
+{
+    for (int port : m_options.ports)
+    {
+        m_ports[port] = Port();
+    }
+}
+
+/**
+ * @brief Reads and applies records until asked to stop
+ *
+ * Polls the ring with a short sleep while it is empty. When the plug-in closes
+ * its ring (Rhino exits or the agent link is switched off) the agent forgets
+ * every document and waits for the next ring.
+ *
+ * @param stop Set by the signal handler to end the loop
+ */
+void LightAgent::Run(const std::atomic<bool>& stop)
+{
+#ifdef _WIN32
+    WSADATA wsaData;
+    WSAStartup(MAKEWORD(2, 2), &wsaData);
+#endif
+
+    std::vector<unsigned char> record;
+    while (!stop.load())
+    {
+        if (!m_ring.IsOpen() || m_ring.IsProducerClosed())
+        {
+            if (m_ring.IsOpen())
+            {
+                printf("LightSyncAgent: plug-in closed the ring, waiting for a new one\n");
+                m_ring.Close();
+                m_documents.clear();
+                for (auto& port : m_ports)
+                    port.second.document = 0;
+            }
+            if (!m_ring.Open(m_options.ringName))
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(REOPEN_INTERVAL_MS));
+                continue;
+            }
+            printf("LightSyncAgent: attached to %s (%u KB)\n", m_options.ringName.c_str(),
+                static_cast<unsigned int>(m_ring.Capacity() / 1024));
+        }
+
+        bool idle = true;
+        while (m_ring.Read(record))
+        {
+            Apply(record.data(), record.size());
+            idle = false;
+        }
+
+        if (LightAgentRing::AgentCounters* counters = m_ring.Counters())
+        {
+            counters->heartbeat.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        ExportIfDue(false);
+        if (m_options.statsIntervalSeconds > 0 && std::chrono::steady_clock::now() - m_lastStats >=
+            std::chrono::seconds(m_options.statsIntervalSeconds))
+        {
+            PrintStats();
+        }
+
+        if (idle)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(IDLE_SLEEP_MS));
+        }
+    }
+
+    ExportIfDue(true);
+    PrintStats();
+    m_ring.Close();
+
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+/**
+ * @brief Applies one change record
+ *
+ * Records that are truncated or carry more lights than their size allows are
+ * ignored. A SceneBegin while another scene was still being received discards
+ * the unfinished one (the plug-in dropped its rest and starts over).
+ *
+ * @param record Record bytes
+ * @param size Number of bytes
+ */
+void LightAgent::Apply(const unsigned char* record, size_t size)
+{
+    using namespace LightAgentProtocol;
+
+    if (size < sizeof(RecordHeader))
+    {
+        return;
+    }
+    RecordHeader header;
+    memcpy(&header, record, sizeof(header));
+    if (header.lightCount > MAX_LIGHTS_PER_RECORD || size < RecordSize(header.lightCount))
+    {
+        return;
+    }
+    ++m_records;
+
+    const Light* lights = reinterpret_cast<const Light*>(record + sizeof(RecordHeader));
+    switch (static_cast<RecordKind>(header.kind))
+    {
+    case RecordKind::SceneBegin:
+    {
+        Document& document = m_documents[header.document];
+        document.incoming.clear();
+        document.incoming.reserve(header.sceneLightCount);
+        document.incomingEvent = EventName(header);
+        document.receiving = true;
+        break;
+    }
+    case RecordKind::Lights:
+    {
+        Document& document = m_documents[header.document];
+        if (document.receiving)
+        {
+            document.incoming.insert(document.incoming.end(), lights, lights + header.lightCount);
+        }
+        break;
+    }
+    case RecordKind::SceneEnd:
+    {
+        auto document = m_documents.find(header.document);
+        if (document != m_documents.end() && document->second.receiving)
+        {
+            ApplyScene(header.document, document->second);
+        }
+        break;
+    }
+    case RecordKind::Update:
+        ApplyUpdate(header.document, EventName(header), lights, header.lightCount);
+        break;
+    case RecordKind::DocumentClosed:
+        CloseDocument(header.document);
+        break;
+    default:
+        break;
+    }
+}
+
+void LightAgent::ApplyScene(uint32_t docSerial, Document& document)
+{
+    document.receiving = false;
+    document.lights.swap(document.incoming);
+    document.incoming.clear();
+
+    document.slots.clear();
+    document.slots.reserve(document.lights.size());
+    for (size_t i = 0; i < document.lights.size(); ++i)
+    {
+        const Light& light = document.lights[i];
+        document.slots[std::string(reinterpret_cast<const char*>(light.id), sizeof(light.id))] = i;
+    }
+
+    m_exportDocument = docSerial;
+    m_exportDirty = true;
+    SendScene(docSerial, document, document.incomingEvent);
+}
+
+/**
+ * @brief Applies a partial update and forwards it to the document's ports
+ *
+ * Lights switched off (FIELD_ENABLED without enabled) leave the document's set.
+ */
+void LightAgent::ApplyUpdate(uint32_t docSerial, const std::string& eventName, const Light* lights, uint32_t count)
+{
+    Document& document = m_documents[docSerial];
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const Light& update = lights[i];
+        const std::string key(reinterpret_cast<const char*>(update.id), sizeof(update.id));
+        auto slot = document.slots.find(key);
+
+        if ((update.dirtyFields & LightAgentProtocol::FIELD_ENABLED) != 0 && !update.enabled)
+        {
+            if (slot != document.slots.end())
+            {
+                const size_t index = slot->second;
+                document.lights.erase(document.lights.begin() + index);
+                document.slots.erase(slot);
+                for (auto& entry : document.slots)
+                {
+                    if (entry.second > index)
+                        --entry.second;
+                }
+            }
+            continue;
+        }
+
+        // Updates always carry the light's complete state; dirtyFields only selects what is sent
+        Light stored = update;
+        stored.dirtyFields = LightAgentProtocol::FIELD_ALL;
+        if (slot != document.slots.end())
+        {
+            document.lights[slot->second] = stored;
+        }
+        else
+        {
+            document.slots[key] = document.lights.size();
+            document.lights.push_back(stored);
+        }
+    }
+    m_exportDocument = docSerial;
+    m_exportDirty = true;
+
+    // Partial messages go to the ports streaming this document, under their current sequence
+    std::string records;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        if (i > 0)
+            records += ",\n";
+        records += lights[i].dirtyFields == LightAgentProtocol::FIELD_ALL ?
+            EncodeFullRecord(lights[i], i) : EncodeSparseRecord(lights[i]);
+    }
+
+    for (auto& entry : m_ports)
+    {
+        Port& port = entry.second;
+        if (port.document != docSerial)
+            continue;
+
+        std::string payload = "{\n  \"event\": \"" + eventName + "\",\n";
+        payload += "  \"document\": " + std::to_string(docSerial) + ",\n";
+        payload += "  \"sequence\": " + std::to_string(port.sequence) + ",\n";
+        payload += "  \"lightCount\": " + std::to_string(count) + ",\n";
+        payload += "  \"partial\": true,\n  \"lights\": [\n";
+        payload += records;
+        payload += count > 0 ? "\n  ]\n}" : "  ]\n}";
+        Send(entry.first, payload);
+    }
+}
+
+void LightAgent::CloseDocument(uint32_t docSerial)
+{
+    m_documents.erase(docSerial);
+    for (auto& entry : m_ports)
+    {
+        if (entry.second.document == docSerial)
+            entry.second.document = 0;
+    }
+    if (m_exportDocument == docSerial)
+    {
+        m_exportDocument = 0;
+        m_exportDirty = false;
+    }
+}
+
+/**
+ * @brief Sends a document's complete scene to the ports streaming it
+ *
+ * Unbound ports are bound to the document first.
+ */
+void LightAgent::SendScene(uint32_t docSerial, const Document& document, const std::string& eventName)
+{
+    std::string records;
+    for (size_t i = 0; i < document.lights.size(); ++i)
+    {
+        records += EncodeFullRecord(document.lights[i], i);
+        records += i + 1 < document.lights.size() ? ",\n" : "\n";
+    }
+
+    for (auto& entry : m_ports)
+    {
+        Port& port = entry.second;
+        if (port.document == 0)
+            port.document = docSerial;
+        if (port.document != docSerial)
+            continue;
+
+        std::string payload = "{\n  \"event\": \"" + eventName + "\",\n";
+        payload += "  \"document\": " + std::to_string(docSerial) + ",\n";
+        payload += "  \"sequence\": " + std::to_string(++port.sequence) + ",\n";
+        payload += "  \"lightCount\": " + std::to_string(document.lights.size()) + ",\n";
+        payload += "  \"lights\": [\n";
+        payload += records;
+        payload += "  ]\n}";
+        Send(entry.first, payload);
+    }
+}
+
+/**
+ * @brief Sends one payload over its own loopback connection
+ *
+ * Same framing as the plug-in: the receiver reads until the connection closes.
+ */
+void LightAgent::Send(int port, const std::string& payload)
+{
+    SocketHandle sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    bool sent = false;
+    if (sock != INVALID_SOCKET)
+    {
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(static_cast<unsigned short>(port));
+        inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+
+        if (connect(sock, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0)
+        {
+            size_t offset = 0;
+            while (offset < payload.size())
+            {
+                const int chunk = static_cast<int>(std::min<size_t>(payload.size() - offset, 1 << 20));
+                const int written = static_cast<int>(send(sock, payload.data() + offset, chunk, 0));
+                if (written <= 0)
+                    break;
+                offset += static_cast<size_t>(written);
+            }
+            sent = offset == payload.size();
+        }
+        CloseSocket(sock);
+    }
+
+    LightAgentRing::AgentCounters* counters = m_ring.Counters();
+    if (sent)
+    {
+        ++m_messagesSent;
+        m_bytesSent += payload.size();
+        if (counters)
+        {
+            counters->messagesSent.fetch_add(1, std::memory_order_relaxed);
+            counters->bytesSent.fetch_add(payload.size(), std::memory_order_relaxed);
+        }
+    }
+    else
+    {
+        ++m_sendFailures;
+        if (counters)
+            counters->sendFailures.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Rewrites the backup file with the last changed document, at most every EXPORT_INTERVAL_MS
+ *
+ * Same layout as LightUtils::ExportLightsToFile.
+ *
+ * @param force Write a pending change now (shutdown)
+ */
+void LightAgent::ExportIfDue(bool force)
+{
+    const auto now = std::chrono::steady_clock::now();
+    if (!m_exportDirty || m_options.exportPath.empty() ||
+        (!force && now - m_lastExport < std::chrono::milliseconds(EXPORT_INTERVAL_MS)))
+    {
+        return;
+    }
+    m_exportDirty = false;
+    m_lastExport = now;
+
+    auto document = m_documents.find(m_exportDocument);
+    if (document == m_documents.end())
+    {
+        return;
+    }
+
+    FILE* file = fopen(m_options.exportPath.c_str(), "wb");
+    if (!file)
+    {
+        return;
+    }
+
+    const std::vector<Light>& lights = document->second.lights;
+    fprintf(file, "# RhinoLightSync Export File\n");
+    fprintf(file, "# Format: <Type> <Location> <Rotation> <Intensity> <Color> [InnerAngle OuterAngle]\n");
+    fprintf(file, "# Total Lights: %u\n\n", static_cast<unsigned int>(lights.size()));
+    for (const Light& light : lights)
+    {
+        // Rotation as azimuth, elevation, roll like LightUtils::WriteRotation
+        double x = light.direction[0], y = light.direction[1], z = light.direction[2];
+        const double length = std::sqrt(x * x + y * y + z * z);
+        if (length > 0.0)
+        {
+            x /= length;
+            y /= length;
+            z /= length;
+        }
+        fprintf(file, "%s (%g,%g,%g) (%g\xC2\xB0, %g\xC2\xB0, 0.00\xC2\xB0) %g RGB(%d,%d,%d)", TypeName(light.type),
+            light.location[0], light.location[1], light.location[2],
+            std::atan2(y, x) * 180.0 / PI, std::asin(z) * 180.0 / PI, light.intensity,
+            light.color[0], light.color[1], light.color[2]);
+        if (light.isSpotLight)
+        {
+            fprintf(file, " %g\xC2\xB0 %g\xC2\xB0", light.innerAngle, light.outerAngle);
+        }
+        fprintf(file, "\n");
+    }
+    fclose(file);
+
+    ++m_fileExports;
+    if (LightAgentRing::AgentCounters* counters = m_ring.Counters())
+    {
+        counters->fileExports.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void LightAgent::PrintStats()
+{
+    m_lastStats = std::chrono::steady_clock::now();
+
+    size_t lightCount = 0;
+    for (const auto& document : m_documents)
+    {
+        lightCount += document.second.lights.size();
+    }
+    printf("LightSyncAgent: %llu record(s), %u document(s), %u light(s), %llu message(s), %llu byte(s), "
+        "%llu failure(s), %llu export(s), ring %u/%u KB, %llu dropped\n",
+        static_cast<unsigned long long>(m_records), static_cast<unsigned int>(m_documents.size()),
+        static_cast<unsigned int>(lightCount), static_cast<unsigned long long>(m_messagesSent),
+        static_cast<unsigned long long>(m_bytesSent), static_cast<unsigned long long>(m_sendFailures),
+        static_cast<unsigned long long>(m_fileExports), static_cast<unsigned int>(m_ring.Used() / 1024),
+        static_cast<unsigned int>(m_ring.Capacity() / 1024), static_cast<unsigned long long>(m_ring.Dropped()));
+    fflush(stdout);
+}
+
+/**
+ * @brief Encodes a complete light record as the plug-in's EncodeLightRecord does
+ *
+ * @param light Light in meters
+ * @param index Position of the light in the message
+ * @return Record text without trailing separator
+ */
+std::string LightAgent::EncodeFullRecord(const Light& light, size_t index)
+{
+    double pitch = 0.0, yaw = 0.0, roll = 0.0;
+    ToRotation(light.direction, pitch, yaw, roll);
+
+    std::string out = "    {\n      \"id\": " + std::to_string(index) + ",\n";
+    out += "      \"uuid\": \"";
+    AppendUuid(out, light.id);
+    out += "\",\n      \"type\": \"";
+    out += TypeName(light.type);
+    out += "\",\n      \"location\": {\n        \"x\": ";
+    AppendFormat(out, "%.6f", light.location[0]);
+    out += ",\n        \"y\": ";
+    AppendFormat(out, "%.6f", light.location[1]);
+    out += ",\n        \"z\": ";
+    AppendFormat(out, "%.6f", light.location[2]);
+    out += "\n      },\n      \"rotation\": {\n        \"pitch\": ";
+    AppendFormat(out, "%.3f", pitch);
+    out += ",\n        \"yaw\": ";
+    AppendFormat(out, "%.3f", yaw);
+    out += ",\n        \"roll\": ";
+    AppendFormat(out, "%.3f", roll);
+    out += "\n      },\n      \"intensity\": ";
+    AppendFormat(out, "%.3f", light.intensity);
+    out += ",\n      \"color\": {\n        \"r\": " + std::to_string(light.color[0]);
+    out += ",\n        \"g\": " + std::to_string(light.color[1]);
+    out += ",\n        \"b\": " + std::to_string(light.color[2]);
+    out += "\n      }";
+    if (light.isSpotLight)
+    {
+        out += ",\n      \"spotLight\": {\n        \"innerAngle\": ";
+        AppendFormat(out, "%.3f", light.innerAngle);
+        out += ",\n        \"outerAngle\": ";
+        AppendFormat(out, "%.3f", light.outerAngle);
+        out += "\n      }";
+    }
+    out += "\n    }";
+    return out;
+}
+
+/**
+ * @brief Encodes the dirty fields of a light as the plug-in's AppendSparseLightJSON does
+ */
+std::string LightAgent::EncodeSparseRecord(const Light& light)
+{
+    const uint32_t fields = light.dirtyFields;
+
+    std::string out = "    {\"uuid\": \"";
+    AppendUuid(out, light.id);
+    out += "\", \"fields\": " + std::to_string(fields);
+
+    if (fields & LightAgentProtocol::FIELD_ENABLED)
+    {
+        out += light.enabled ? ", \"enabled\": true" : ", \"enabled\": false";
+    }
+    if (fields & LightAgentProtocol::FIELD_LOCATION)
+    {
+        out += ", \"location\": {\"x\": ";
+        AppendFormat(out, "%.6f", light.location[0]);
+        out += ", \"y\": ";
+        AppendFormat(out, "%.6f", light.location[1]);
+        out += ", \"z\": ";
+        AppendFormat(out, "%.6f", light.location[2]);
+        out += "}";
+    }
+    if (fields & LightAgentProtocol::FIELD_DIRECTION)
+    {
+        double pitch = 0.0, yaw = 0.0, roll = 0.0;
+        ToRotation(light.direction, pitch, yaw, roll);
+        out += ", \"rotation\": {\"pitch\": ";
+        AppendFormat(out, "%.3f", pitch);
+        out += ", \"yaw\": ";
+        AppendFormat(out, "%.3f", yaw);
+        out += ", \"roll\": ";
+        AppendFormat(out, "%.3f", roll);
+        out += "}";
+    }
+    if (fields & LightAgentProtocol::FIELD_INTENSITY)
+    {
+        out += ", \"intensity\": ";
+        AppendFormat(out, "%.3f", light.intensity);
+    }
+    if (fields & LightAgentProtocol::FIELD_COLOR)
+    {
+        out += ", \"color\": {\"r\": " + std::to_string(light.color[0]) + ", \"g\": " +
+            std::to_string(light.color[1]) + ", \"b\": " + std::to_string(light.color[2]) + "}";
+    }
+    if (fields & LightAgentProtocol::FIELD_SPOT_ANGLES)
+    {
+        out += ", \"spotLight\": {\"innerAngle\": ";
+        AppendFormat(out, "%.3f", light.innerAngle);
+        out += ", \"outerAngle\": ";
+        AppendFormat(out, "%.3f", light.outerAngle);
+        out += "}";
+    }
+    out += "}";
+    return out;
+}
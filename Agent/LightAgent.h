@@ -0,0 +1,112 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+
+#pragma once
+
+#include "LightAgentProtocol.h"
+#include "LightAgentRing.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Companion process side of the sync pipeline
+ *
+ * Reads the plug-in's change records from the shared ring, keeps every
+ * document's light set, and does the work the plug-in hands off: encoding the
+ * JSON messages receivers expect, sending them to each configured port, writing
+ * the backup file and keeping the statistics (mirrored into the ring header,
+ * where the plug-in's LightSyncStats command reads them).
+ *
+ * Each port streams one document: the first one that sends a scene, until it
+ * closes. Messages use the same layout, precision and sequence rules as the
+ * plug-in's own sender, so receivers cannot tell the two apart.
+ */
+class LightAgent
+{
+public:
+    struct Options
+    {
+        std::string ringName;
+        std::vector<int> ports;
+        std::string exportPath;          // Empty disables the backup file
+        unsigned int statsIntervalSeconds;
+
+        Options() : ringName(LightAgentRing::DEFAULT_NAME), ports(1, 5173),
+            exportPath(DEFAULT_EXPORT_PATH), statsIntervalSeconds(10) {}
+    };
+
+    static constexpr const char* DEFAULT_EXPORT_PATH = "C:/ProgramData/RhinoLightSync/Lights.txt";
+
+    explicit LightAgent(const Options& options);
+
+    // Runs until stop is set; waits for the plug-in whenever its ring is not there
+    void Run(const std::atomic<bool>& stop);
+
+    // Applies one record; public so the agent can be driven without a ring
+    void Apply(const unsigned char* record, size_t size);
+
+private:
+    typedef LightAgentProtocol::Light Light;
+
+    struct Document
+    {
+        std::vector<Light> lights;                 // Scene order
+        std::unordered_map<std::string, size_t> slots;  // Keyed by the 16 id bytes
+        std::vector<Light> incoming;               // Scene being received
+        std::string incomingEvent;
+        bool receiving;
+
+        Document() : receiving(false) {}
+    };
+
+    struct Port
+    {
+        uint32_t document;   // 0 until bound
+        uint64_t sequence;
+
+        Port() : document(0), sequence(0) {}
+    };
+
+    void ApplyScene(uint32_t docSerial, Document& document);
+    void ApplyUpdate(uint32_t docSerial, const std::string& eventName, const Light* lights, uint32_t count);
+    void CloseDocument(uint32_t docSerial);
+
+    void SendScene(uint32_t docSerial, const Document& document, const std::string& eventName);
+    void Send(int port, const std::string& payload);
+    void ExportIfDue(bool force);
+    void PrintStats();
+
+    static std::string EncodeFullRecord(const Light& light, size_t index);
+    static std::string EncodeSparseRecord(const Light& light);
+
+    Options m_options;
+    LightAgentRing m_ring;
+    std::map<uint32_t, Document> m_documents;
+    std::map<int, Port> m_ports;
+    uint32_t m_exportDocument;     // Document the backup file shows (last changed)
+    bool m_exportDirty;
+    std::chrono::steady_clock::time_point m_lastExport;
+    std::chrono::steady_clock::time_point m_lastStats;
+
+    // Kept here as well, for agents running without a ring
+    uint64_t m_records;
+    uint64_t m_messagesSent;
+    uint64_t m_bytesSent;
+    uint64_t m_sendFailures;
+    uint64_t m_fileExports;
+};
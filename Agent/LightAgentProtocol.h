@@ -0,0 +1,94 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Binary change records the plug-in hands to the sync agent
+ *
+ * Records are plain structs copied into the shared ring as they are, so both
+ * sides must be built for the same architecture (x64 little-endian). A record
+ * is a LightAgentRecordHeader followed by header.lightCount LightAgentLight
+ * entries. A scene is sent as SceneBegin, any number of Lights records and
+ * SceneEnd; the agent only acts on a scene once its SceneEnd arrived.
+ */
+namespace LightAgentProtocol
+{
+    constexpr uint32_t VERSION = 2;  // 2: LightType renumbered to match LightUtils::LightType
+
+    // Lights carried by one Lights or Update record
+    constexpr uint32_t MAX_LIGHTS_PER_RECORD = 256;
+
+    enum class RecordKind : uint16_t
+    {
+        SceneBegin = 1,      // sceneLightCount is the number of lights that follow
+        Lights = 2,          // Next lights of the scene being sent
+        SceneEnd = 3,
+        Update = 4,          // Partial update of the listed lights (dirtyFields select members)
+        DocumentClosed = 5
+    };
+
+    // Same bits as LightUtils::Field
+    enum Field : uint32_t
+    {
+        FIELD_LOCATION = 1,
+        FIELD_DIRECTION = 2,
+        FIELD_INTENSITY = 4,
+        FIELD_COLOR = 8,
+        FIELD_SPOT_ANGLES = 16,
+        FIELD_ENABLED = 32,
+        FIELD_TYPE = 64,
+        FIELD_ALL = 127
+    };
+
+    // Same values as LightUtils::LightType (pinned by static_asserts in LightAgentLink.cpp)
+    enum class LightType : uint8_t { Unknown, Directional, Point, Spot, Ambient };
+
+    struct RecordHeader
+    {
+        uint16_t kind;           // RecordKind
+        uint16_t reserved;
+        uint32_t document;       // Runtime serial number of the document
+        uint32_t lightCount;
+        uint32_t sceneLightCount; // SceneBegin: lights that follow in Lights records
+        char eventName[32];      // UTF-8, zero padded (SceneBegin and Update)
+    };
+
+    struct Light
+    {
+        uint8_t id[16];          // ON_UUID bytes
+        uint8_t type;            // LightType
+        uint8_t enabled;
+        uint8_t isSpotLight;
+        uint8_t color[3];        // r, g, b
+        uint16_t reserved;
+        uint32_t dirtyFields;    // FIELD_ALL for complete records
+        uint32_t reserved2;
+        double location[3];      // Meters
+        double direction[3];
+        double intensity;
+        double innerAngle;       // Degrees
+        double outerAngle;
+    };
+
+    static_assert(sizeof(RecordHeader) == 48, "record header layout is shared with the agent");
+    static_assert(sizeof(Light) == 104, "light layout is shared with the agent");
+
+    inline size_t RecordSize(uint32_t lightCount)
+    {
+        return sizeof(RecordHeader) + lightCount * sizeof(Light);
+    }
+}
@@ -0,0 +1,402 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+
+#include "LightAgentRing.h"
+#include "LightAgentProtocol.h"
+#include <cstring>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    constexpr uint32_t RING_MAGIC = 0x52534C4C; // "LLSR"
+    constexpr uint32_t RING_VERSION = LightAgentProtocol::VERSION;  // An agent never reads records of another layout
+    constexpr uint32_t PAD_RECORD = 0xFFFFFFFFu;
+    constexpr size_t FRAME_SIZE = 8;            // uint32 length + uint32 reserved
+    constexpr size_t MIN_CAPACITY = 64u * 1024u;
+
+    size_t Align8(size_t size)
+    {
+        return (size + 7) & ~static_cast<size_t>(7);
+    }
+
+    size_t RoundUpToPowerOfTwo(size_t value)
+    {
+        size_t result = MIN_CAPACITY;
+        while (result < value)
+        {
+            result <<= 1;
+        }
+        return result;
+    }
+}
+
+// Start of the shared mapping; the ring bytes follow it
+struct LightAgentRing::Header
+{
+    std::atomic<uint32_t> magic;          // Stored last when the producer initializes the ring
+    uint32_t version;
+    uint64_t capacity;
+    std::atomic<uint32_t> closed;         // Set when the producer closes; the consumer reopens
+    alignas(64) std::atomic<uint64_t> head;     // Bytes ever written
+    alignas(64) std::atomic<uint64_t> tail;     // Bytes ever read
+    alignas(64) std::atomic<uint64_t> dropped;
+    AgentCounters counters;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "ring counters must be lock-free to be shared");
+
+LightAgentRing::LightAgentRing()
+    : m_header(nullptr), m_data(nullptr), m_capacity(0), m_mappedSize(0), m_owner(false), m_pendingHead(0)
+#ifdef _WIN32
+    , m_mapping(nullptr)
+#else
+    , m_fd(-1)
+#endif
+{
+}
+
+LightAgentRing::~LightAgentRing()
+{
+    Close();
+}
+
+/**
+ * @brief Creates the ring, or takes over one left by an earlier producer
+ *
+ * An existing ring of the same capacity keeps its positions, so an agent that
+ * stayed attached across a plug-in reload continues where it was.
+ *
+ * @param name Shared memory name
+ * @param capacity Requested ring size in bytes
+ * @return False if the shared memory could not be created or mapped
+ */
+bool LightAgentRing::Create(const std::string& name, size_t capacity)
+{
+    Close();
+
+    const size_t ringCapacity = RoundUpToPowerOfTwo(capacity);
+    if (!Map(name, sizeof(Header) + ringCapacity, true))
+    {
+        return false;
+    }
+    m_owner = true;
+    m_capacity = ringCapacity;
+
+    const bool reusable = m_header->magic.load(std::memory_order_acquire) == RING_MAGIC &&
+        m_header->version == RING_VERSION && m_header->capacity == ringCapacity;
+    if (!reusable)
+    {
+        m_header->magic.store(0, std::memory_order_relaxed);
+        m_header->version = RING_VERSION;
+        m_header->capacity = ringCapacity;
+        m_header->head.store(0, std::memory_order_relaxed);
+        m_header->tail.store(0, std::memory_order_relaxed);
+        m_header->dropped.store(0, std::memory_order_relaxed);
+        m_header->counters.recordsRead.store(0, std::memory_order_relaxed);
+        m_header->counters.messagesSent.store(0, std::memory_order_relaxed);
+        m_header->counters.bytesSent.store(0, std::memory_order_relaxed);
+        m_header->counters.sendFailures.store(0, std::memory_order_relaxed);
+        m_header->counters.fileExports.store(0, std::memory_order_relaxed);
+        m_header->counters.heartbeat.store(0, std::memory_order_relaxed);
+    }
+    m_header->closed.store(0, std::memory_order_relaxed);
+    m_header->magic.store(RING_MAGIC, std::memory_order_release);
+    return true;
+}
+
+/**
+ * @brief Maps a ring created by the producer
+ *
+ * @param name Shared memory name
+ * @return False if there is no initialized, open ring under that name yet
+ */
+bool LightAgentRing::Open(const std::string& name)
+{
+    Close();
+
+    if (!Map(name, 0, false))
+    {
+        return false;
+    }
+
+    if (m_header->magic.load(std::memory_order_acquire) != RING_MAGIC || m_header->version != RING_VERSION ||
+        m_header->closed.load(std::memory_order_acquire) != 0 ||
+        sizeof(Header) + m_header->capacity > m_mappedSize)
+    {
+        Close();
+        return false;
+    }
+    m_capacity = static_cast<size_t>(m_header->capacity);
+    return true;
+}
+
+void LightAgentRing::Close()
+{
+    if (m_header && m_owner)
+    {
+        m_header->closed.store(1, std::memory_order_release);
+    }
+
+#ifdef _WIN32
+    if (m_header)
+    {
+        UnmapViewOfFile(m_header);
+    }
+    if (m_mapping)
+    {
+        CloseHandle(static_cast<HANDLE>(m_mapping));
+        m_mapping = nullptr;
+    }
+#else
+    if (m_header)
+    {
+        munmap(m_header, m_mappedSize);
+    }
+    if (m_fd >= 0)
+    {
+        close(m_fd);
+        m_fd = -1;
+    }
+    if (m_owner && !m_name.empty())
+    {
+        shm_unlink(m_name.c_str());
+    }
+    m_name.clear();
+#endif
+
+    m_header = nullptr;
+    m_data = nullptr;
+    m_capacity = 0;
+    m_mappedSize = 0;
+    m_owner = false;
+}
+
+/**
+ * @brief Reserves contiguous space for one record
+ *
+ * A record that would cross the end of the ring starts over at its beginning;
+ * the skipped tail is marked as padding for the consumer.
+ *
+ * @param size Record size in bytes
+ * @return Where to write the record, or null if the ring is full (the drop is counted)
+ */
+unsigned char* LightAgentRing::BeginWrite(size_t size)
+{
+    if (!m_header)
+    {
+        return nullptr;
+    }
+
+    const size_t need = Align8(FRAME_SIZE + size);
+    const uint64_t head = m_header->head.load(std::memory_order_relaxed);
+    const uint64_t tail = m_header->tail.load(std::memory_order_acquire);
+    const size_t position = static_cast<size_t>(head & (m_capacity - 1));
+    const size_t toEnd = m_capacity - position;
+    const size_t skip = toEnd < need ? toEnd : 0;
+
+    if (size == 0 || need > m_capacity / 2 || (head - tail) + skip + need > m_capacity)
+    {
+        m_header->dropped.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    uint64_t start = head;
+    if (skip > 0)
+    {
+        const uint32_t pad = PAD_RECORD;
+        memcpy(m_data + position, &pad, sizeof(pad));
+        start += skip;
+    }
+
+    unsigned char* frame = m_data + (start & (m_capacity - 1));
+    const uint32_t length = static_cast<uint32_t>(size);
+    memcpy(frame, &length, sizeof(length));
+    m_pendingHead = start + need;
+    return frame + FRAME_SIZE;
+}
+
+void LightAgentRing::EndWrite()
+{
+    if (m_header)
+    {
+        m_header->head.store(m_pendingHead, std::memory_order_release);
+    }
+}
+
+/**
+ * @brief Takes the oldest unread record off the ring
+ *
+ * If the producer re-created the ring underneath the consumer, the unread
+ * bytes are skipped and reading continues with the next record written. A
+ * frame whose length runs past the ring or past the written bytes is treated
+ * the same way and counted as dropped, since the memory is shared with another
+ * process.
+ *
+ * @param record Receives the record bytes
+ * @return False if there is nothing to read
+ */
+bool LightAgentRing::Read(std::vector<unsigned char>& record)
+{
+    if (!m_header)
+    {
+        return false;
+    }
+
+    uint64_t tail = m_header->tail.load(std::memory_order_relaxed);
+    const uint64_t head = m_header->head.load(std::memory_order_acquire);
+    if (head < tail || head - tail > m_capacity)
+    {
+        m_header->tail.store(head, std::memory_order_release);
+        return false;
+    }
+
+    while (tail != head)
+    {
+        const size_t position = static_cast<size_t>(tail & (m_capacity - 1));
+        uint32_t length = 0;
+        memcpy(&length, m_data + position, sizeof(length));
+        if (length == PAD_RECORD)
+        {
+            if (m_capacity - position > head - tail)
+                break;
+            tail += m_capacity - position;
+            continue;
+        }
+        if (position + FRAME_SIZE + length > m_capacity || Align8(FRAME_SIZE + length) > head - tail)
+            break;
+
+        const unsigned char* payload = m_data + position + FRAME_SIZE;
+        record.assign(payload, payload + length);
+        tail += Align8(FRAME_SIZE + length);
+        m_header->tail.store(tail, std::memory_order_release);
+        m_header->counters.recordsRead.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    if (tail != head)
+    {
+        m_header->dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+    m_header->tail.store(head, std::memory_order_release);
+    return false;
+}
+
+uint64_t LightAgentRing::Dropped() const
+{
+    return m_header ? m_header->dropped.load(std::memory_order_relaxed) : 0;
+}
+
+size_t LightAgentRing::Used() const
+{
+    if (!m_header)
+    {
+        return 0;
+    }
+    const uint64_t tail = m_header->tail.load(std::memory_order_relaxed);
+    const uint64_t head = m_header->head.load(std::memory_order_relaxed);
+    return head >= tail ? static_cast<size_t>(head - tail) : 0;
+}
+
+bool LightAgentRing::IsProducerClosed() const
+{
+    return !m_header || m_header->closed.load(std::memory_order_acquire) != 0;
+}
+
+LightAgentRing::AgentCounters* LightAgentRing::Counters()
+{
+    return m_header ? &m_header->counters : nullptr;
+}
+
+bool LightAgentRing::Map(const std::string& name, size_t totalSize, bool create)
+{
+#ifdef _WIN32
+    HANDLE mapping = nullptr;
+    if (create)
+    {
+        const unsigned long long size = totalSize;
+        mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+            static_cast<DWORD>(size >> 32), static_cast<DWORD>(size & 0xFFFFFFFFull), name.c_str());
+    }
+    else
+    {
+        mapping = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, name.c_str());
+    }
+    if (!mapping)
+    {
+        return false;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, create ? totalSize : 0);
+    if (!view)
+    {
+        CloseHandle(mapping);
+        return false;
+    }
+
+    // An opened mapping's size is that of the region, rounded to pages
+    MEMORY_BASIC_INFORMATION info = {};
+    VirtualQuery(view, &info, sizeof(info));
+    m_mapping = mapping;
+    m_mappedSize = create ? totalSize : static_cast<size_t>(info.RegionSize);
+    m_header = static_cast<Header*>(view);
+#else
+    const int fd = create ? shm_open(name.c_str(), O_CREAT | O_RDWR, 0600) : shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat info = {};
+    if (fstat(fd, &info) != 0)
+    {
+        close(fd);
+        return false;
+    }
+    if (create && static_cast<size_t>(info.st_size) != totalSize && ftruncate(fd, static_cast<off_t>(totalSize)) != 0)
+    {
+        close(fd);
+        return false;
+    }
+    const size_t size = create ? totalSize : static_cast<size_t>(info.st_size);
+    if (size < sizeof(Header))
+    {
+        close(fd);
+        return false;
+    }
+
+    void* view = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (view == MAP_FAILED)
+    {
+        close(fd);
+        return false;
+    }
+
+    m_fd = fd;
+    m_name = name;
+    m_mappedSize = size;
+    m_header = static_cast<Header*>(view);
+#endif
+
+    m_data = reinterpret_cast<unsigned char*>(m_header) + sizeof(Header);
+    return true;
+}
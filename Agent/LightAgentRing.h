@@ -0,0 +1,110 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Single-producer, single-consumer byte ring in named shared memory
+ *
+ * The plug-in creates the ring and is its only writer; the sync agent opens it
+ * by name and is its only reader. Records are written in place: BeginWrite
+ * hands out contiguous space, the producer fills it and EndWrite publishes it
+ * with one release store, so pushing a record costs the memcpy of its bytes.
+ * Nothing ever blocks: a record that does not fit is dropped and counted, and
+ * the producer resends a complete scene once there is room again.
+ *
+ * The consumer also keeps its counters in the shared header, so the plug-in can
+ * report the agent's statistics without another channel. Backends are Windows
+ * file mappings and POSIX shm_open.
+ */
+class LightAgentRing
+{
+public:
+    // Counters written by the consumer
+    struct AgentCounters
+    {
+        std::atomic<uint64_t> recordsRead;
+        std::atomic<uint64_t> messagesSent;
+        std::atomic<uint64_t> bytesSent;
+        std::atomic<uint64_t> sendFailures;
+        std::atomic<uint64_t> fileExports;
+        std::atomic<uint64_t> heartbeat;   // Bumped by the agent while it runs
+    };
+
+    static constexpr size_t DEFAULT_CAPACITY = 8u * 1024u * 1024u;
+#ifdef _WIN32
+    static constexpr const char* DEFAULT_NAME = "Local\\RhinoLightSyncAgent";
+#else
+    static constexpr const char* DEFAULT_NAME = "/RhinoLightSyncAgent";
+#endif
+
+    LightAgentRing();
+    ~LightAgentRing();
+    LightAgentRing(const LightAgentRing&) = delete;
+    LightAgentRing& operator=(const LightAgentRing&) = delete;
+
+    // Producer side: creates (or resets) the ring; capacity is rounded up to a power of two
+    bool Create(const std::string& name, size_t capacity = DEFAULT_CAPACITY);
+
+    // Consumer side: maps an existing ring; false if the producer has not created it yet
+    bool Open(const std::string& name);
+
+    void Close();
+    bool IsOpen() const { return m_header != nullptr; }
+
+    // Producer: contiguous space for a record of size bytes, or null if it does not fit
+    unsigned char* BeginWrite(size_t size);
+
+    // Producer: publishes the record started by the last successful BeginWrite
+    void EndWrite();
+
+    // Consumer: copies the next record into record; false if the ring is empty
+    bool Read(std::vector<unsigned char>& record);
+
+    // Records the producer had to drop because the ring was full, and corrupt frames the consumer skipped
+    uint64_t Dropped() const;
+
+    // Bytes written but not yet read
+    size_t Used() const;
+
+    // Consumer: true once the producer closed the ring (the agent then waits for a new one)
+    bool IsProducerClosed() const;
+    size_t Capacity() const { return m_capacity; }
+
+    // Null until the ring is created or opened
+    AgentCounters* Counters();
+
+private:
+    struct Header;
+
+    bool Map(const std::string& name, size_t totalSize, bool create);
+
+    Header* m_header;
+    unsigned char* m_data;
+    size_t m_capacity;
+    size_t m_mappedSize;
+    bool m_owner;
+    uint64_t m_pendingHead;  // Producer: head after the record being written
+#ifdef _WIN32
+    void* m_mapping;
+#else
+    int m_fd;
+    std::string m_name;
+#endif
+};
@@ -0,0 +1,98 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+
+#include "LightAgent.h"
+#include <atomic>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+    std::atomic<bool> g_stop(false);
+
+    void OnSignal(int)
+    {
+        g_stop.store(true);
+    }
+
+    void PrintUsage()
+    {
+        printf("Usage: LightSyncAgent [--ring NAME] [--port PORT]... [--export PATH | --no-export] [--stats SECONDS]\n");
+        printf("  --ring     Shared memory name the plug-in writes to (default %s)\n", LightAgentRing::DEFAULT_NAME);
+        printf("  --port     Receiver port; repeat for several receivers (default 5173)\n");
+        printf("  --export   Backup file rewritten with the last changed document (default %s)\n",
+            LightAgent::DEFAULT_EXPORT_PATH);
+        printf("  --stats    Seconds between statistics lines, 0 for none (default 10)\n");
+    }
+}
+
+/**
+ * @brief Entry point of the sync agent
+ *
+ * Runs until interrupted (Ctrl+C or SIGTERM).
+ */
+int main(int argc, char** argv)
+{
+    LightAgent::Options options;
+    bool portsGiven = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--ring") == 0 && hasValue)
+        {
+            options.ringName = argv[++i];
+        }
+        else if (strcmp(argv[i], "--port") == 0 && hasValue)
+        {
+            const int port = atoi(argv[++i]);
+            if (port < 1 || port > 65535)
+            {
+                fprintf(stderr, "Invalid port %s\n", argv[i]);
+                return 1;
+            }
+            if (!portsGiven)
+            {
+                options.ports.clear();
+                portsGiven = true;
+            }
+            options.ports.push_back(port);
+        }
+        else if (strcmp(argv[i], "--export") == 0 && hasValue)
+        {
+            options.exportPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--no-export") == 0)
+        {
+            options.exportPath.clear();
+        }
+        else if (strcmp(argv[i], "--stats") == 0 && hasValue)
+        {
+            options.statsIntervalSeconds = static_cast<unsigned int>(atoi(argv[++i]));
+        }
+        else
+        {
+            PrintUsage();
+            return strcmp(argv[i], "--help") == 0 ? 0 : 1;
+        }
+    }
+
+    std::signal(SIGINT, OnSignal);
+    std::signal(SIGTERM, OnSignal);
+
+    printf("LightSyncAgent: waiting for ring %s\n", options.ringName.c_str());
+    LightAgent agent(options);
+    agent.Run(g_stop);
+    return 0;
+}
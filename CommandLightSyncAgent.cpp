@@ -0,0 +1,97 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+#include "stdafx.h"
+#include "CommandLightSyncAgent.h"
+#include "LightAgentLink.h"
+#include "LightSnapshotExporter.h"
+#include "LightSyncRuntime.h"
+#include "LightUtils.h"
+
+// Global static instance of the command - automatically registers with Rhino
+static class CCommandLightSyncAgent theLightSyncAgentCommand;
+
+/**
+ * @brief Returns the unique identifier for this command
+ * @return UUID that uniquely identifies the LightSyncAgent command
+ * @note This UUID should never change to maintain compatibility
+ */
+UUID CCommandLightSyncAgent::CommandUUID()
+{
+    // Static UUID for LightSyncAgent command - generated once and remains constant
+    static const GUID uuid = { 0x1F532E65, 0xB758, 0x47DA, {0x8E,0x1C,0xE0,0xE5,0xA6,0x89,0x96,0x27} };
+    return uuid;
+}
+
+/**
+ * @brief Returns the English name of the command as it appears in Rhino
+ * @return Wide character string containing the command name
+ */
+const wchar_t* CCommandLightSyncAgent::EnglishCommandName()
+{
+    return L"LightSyncAgent";
+}
+
+/**
+ * @brief Main command execution method
+ * @param context Command context containing document and other execution information
+ * @return Command execution result (success, failure, etc.)
+ *
+ * Prompts for the agent state and the ring size. While the agent is on, the
+ * plug-in's own sender and backup file writer are idle; the agent does both.
+ * The next light event of each document hands its complete scene over.
+ */
+CRhinoCommand::result CCommandLightSyncAgent::RunCommand(const CRhinoCommandContext& context)
+{
+    bool agent = !LightAgentLink::IsActive();
+    int ringSizeMB = static_cast<int>(LightAgentRing::DEFAULT_CAPACITY / (1024 * 1024));
+
+    CRhinoGetOption go;
+    go.SetCommandPrompt(L"Out-of-process sync agent. Press Enter to apply");
+    go.AcceptNothing();
+    for (;;)
+    {
+        go.ClearCommandOptions();
+        go.AddCommandOptionToggle(RHCMDOPTNAME(L"Agent"), RHCMDOPTVALUE(L"Off"), RHCMDOPTVALUE(L"On"), agent, &agent);
+        go.AddCommandOptionInteger(RHCMDOPTNAME(L"RingSizeMB"), &ringSizeMB, L"Shared memory ring size", 1, 1024);
+
+        CRhinoGet::result res = go.GetOption();
+        if (res == CRhinoGet::option)
+            continue;
+        if (res == CRhinoGet::nothing)
+            break;
+        return CRhinoCommand::cancel;
+    }
+
+    // A sync command starts the runtime like a light event does
+    LightSyncRuntime::EnsureStarted(L"LightSyncAgent command");
+    if (!agent)
+    {
+        if (LightAgentLink::IsActive())
+        {
+            LightAgentLink::Stop();
+            LightSnapshotExporter::Start(LightUtils::DEFAULT_EXPORT_PATH);
+        }
+        RhinoApp().Print(L"Sync agent off; the plug-in sends light data itself.\n");
+        return CRhinoCommand::success;
+    }
+
+    if (!LightAgentLink::Start(static_cast<size_t>(ringSizeMB) * 1024 * 1024))
+    {
+        RhinoApp().Print(L"Error: Could not create the shared memory ring for the sync agent.\n");
+        return CRhinoCommand::failure;
+    }
+    LightSnapshotExporter::Stop();
+
+    RhinoApp().Print(L"Sync agent on (%d MB ring). Start LightSyncAgent to send light data.\n", ringSizeMB);
+    return CRhinoCommand::success;
+}
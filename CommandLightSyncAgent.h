@@ -0,0 +1,29 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+#pragma once
+
+#include "stdafx.h"
+#include "rhinoSdkCommand.h"
+
+/**
+ * Rhino command that hands light sync over to the out-of-process agent, or takes it back.
+ */
+class CCommandLightSyncAgent : public CRhinoCommand
+{
+public:
+    CCommandLightSyncAgent() = default;
+
+    UUID CommandUUID() override;
+    const wchar_t* EnglishCommandName() override;
+    CRhinoCommand::result RunCommand(const CRhinoCommandContext& context) override;
+};
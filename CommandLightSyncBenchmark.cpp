@@ -0,0 +1,303 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+#include "stdafx.h"
+#include "CommandLightSyncBenchmark.h"
+#include "LightEventWatcher.h"
+#include "LightFragmentCache.h"
+#include "LightQuantizedEncoder.h"
+#include "LightWorkerPool.h"
+#include "Receiver/LightMirror.h"
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <vector>
+
+// Global static instance of the command - automatically registers with Rhino
+static class CCommandLightSyncBenchmark theLightSyncBenchmarkCommand;
+
+namespace {
+    // Deterministic mix of point, spot and directional lights spread over a 1 km square
+    std::vector<LightUtils::LightInfo> MakeBenchmarkLights(size_t lightCount)
+    {
+        std::vector<LightUtils::LightInfo> lights(lightCount);
+        for (size_t i = 0; i < lightCount; ++i)
+        {
+            LightUtils::LightInfo& light = lights[i];
+            light.id = ON_CreateId();
+            light.location = ON_3dPoint(static_cast<double>(i % 1000), static_cast<double>(i / 1000 % 1000),
+                static_cast<double>(i % 7));
+            light.direction = ON_3dVector(0.3 * static_cast<double>(i % 5), -0.2, -1.0);
+            light.intensity = 0.25 + 0.001 * static_cast<double>(i % 750);
+            light.color = ON_Color(static_cast<int>(i % 256), static_cast<int>(i * 7 % 256), static_cast<int>(i * 13 % 256));
+
+            switch (i % 3)
+            {
+            case 0:
+                light.type = LightUtils::LightType::Point;
+                break;
+            case 1:
+                light.type = LightUtils::LightType::Spot;
+                light.isSpotLight = true;
+                light.outerAngle = 30.0 + static_cast<double>(i % 20);
+                light.innerAngle = 0.5 * light.outerAngle;
+                break;
+            default:
+                light.type = LightUtils::LightType::Directional;
+                break;
+            }
+        }
+        return lights;
+    }
+
+    std::string Concatenate(const std::vector<LightFragmentCache::Fragment>& fragments)
+    {
+        size_t size = 0;
+        for (const auto& fragment : fragments)
+        {
+            size += fragment->size();
+        }
+
+        std::string bytes;
+        bytes.reserve(size);
+        for (const auto& fragment : fragments)
+        {
+            bytes += *fragment;
+        }
+        return bytes;
+    }
+
+    // Decodes a complete message with the receiver library and checks every light arrived unchanged
+    bool RoundTrip(const std::vector<LightUtils::LightInfo>& lights, int runs)
+    {
+        LightSyncSubscriptions::Delivery delivery;
+        delivery.sequence = 1;
+        delivery.lights = lights;
+
+        LightFragmentCache cache(&CLightEventWatcher::EncodeLightRecord);
+        LightSyncBuffers::EncodeBuffers buffers;
+        CLightEventWatcher::EncodeLightData(delivery, L"Benchmark", cache, buffers);
+
+        std::string message;
+        for (const auto& segment : buffers.segments)
+        {
+            message.append(segment.data, segment.size);
+        }
+
+        LightMessageDecoder decoder;
+        LightMessage decoded;
+        double bestMs = 0.0;
+        for (int run = 0; run < runs; ++run)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            if (!decoder.Decode(message.data(), message.size(), decoded))
+            {
+                RhinoApp().Print(L"  Decode failed at byte %d.\n", static_cast<int>(decoder.ErrorOffset()));
+                return false;
+            }
+            const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            if (run == 0 || ms < bestMs)
+            {
+                bestMs = ms;
+            }
+        }
+
+        LightMirror mirror;
+        mirror.Apply(decoded);
+        bool matches = mirror.Count() == lights.size();
+        for (size_t i = 0; matches && i < lights.size(); ++i)
+        {
+            const std::string id = LightSyncNetwork::WStringToUTF8(LightUtils::UuidToString(lights[i].id));
+            LightUuid uuid;
+            const ReceivedLight* received = LightUuid::Parse(id.data(), id.size(), uuid) ? mirror.Find(uuid) : nullptr;
+            matches = received != nullptr &&
+                std::fabs(received->location[0] - lights[i].location.x) < 1e-6 &&
+                std::fabs(received->location[1] - lights[i].location.y) < 1e-6 &&
+                std::fabs(received->location[2] - lights[i].location.z) < 1e-6 &&
+                received->color[0] == lights[i].color.Red() &&
+                ((received->members & ReceivedLight::SPOT_ANGLES) != 0) == lights[i].isSpotLight;
+        }
+
+        RhinoApp().Print(L"  Receiver decode: %9.2f ms  %8.1f MB/s  %d light(s) %s\n", bestMs,
+            bestMs > 0.0 ? (message.size() / 1048576.0) / (bestMs / 1000.0) : 0.0,
+            static_cast<int>(mirror.Count()), matches ? L"match" : L"DIFFER");
+        return matches;
+    }
+
+    // Encodes the scene quantized, then moves every light as a field update, and checks the positions arrive within bounds
+    bool QuantizedRoundTrip(const std::vector<LightUtils::LightInfo>& lights)
+    {
+        LightSyncSubscriptions::Delivery scene;
+        scene.sequence = 1;
+        scene.quantized = true;
+        scene.lights = lights;
+        std::string sceneMessage;
+        LightQuantizedEncoder::Encode(scene, L"Benchmark", sceneMessage);
+        LightQuantizedEncoder::Delivered(scene.port, true);
+
+        LightSyncSubscriptions::Delivery update = scene;
+        update.partial = true;
+        for (auto& light : update.lights)
+        {
+            light.location.x += 0.25;
+            light.dirtyFields = LightUtils::FIELD_LOCATION;
+        }
+        std::string updateMessage;
+        LightQuantizedEncoder::Encode(update, L"Benchmark", updateMessage);
+        LightQuantizedEncoder::ForgetReceiver(scene.port);
+
+        LightMessageDecoder decoder;
+        LightMessage decoded;
+        LightMirror mirror;
+        bool matches = decoder.Decode(sceneMessage.data(), sceneMessage.size(), decoded) &&
+            mirror.Apply(decoded) == LightMirror::Result::Applied &&
+            decoder.Decode(updateMessage.data(), updateMessage.size(), decoded) &&
+            mirror.Apply(decoded) == LightMirror::Result::Applied &&
+            mirror.Count() == lights.size();
+
+        const double bound = 0.5 * scene.positionStep + 1e-9;
+        for (size_t i = 0; matches && i < update.lights.size(); ++i)
+        {
+            const LightUtils::LightInfo& light = update.lights[i];
+            const std::string id = LightSyncNetwork::WStringToUTF8(LightUtils::UuidToString(light.id));
+            LightUuid uuid;
+            const ReceivedLight* received = LightUuid::Parse(id.data(), id.size(), uuid) ? mirror.Find(uuid) : nullptr;
+            matches = received != nullptr &&
+                std::fabs(received->location[0] - light.location.x) <= bound &&
+                std::fabs(received->location[1] - light.location.y) <= bound &&
+                std::fabs(received->location[2] - light.location.z) <= bound;
+        }
+
+        RhinoApp().Print(L"  Quantized: scene %d bytes (%.1f per light), moves %d bytes (%.1f per light) %s\n",
+            static_cast<int>(sceneMessage.size()), static_cast<double>(sceneMessage.size()) / lights.size(),
+            static_cast<int>(updateMessage.size()), static_cast<double>(updateMessage.size()) / lights.size(),
+            matches ? L"within bounds" : L"DIFFER");
+        return matches;
+    }
+}
+
+/**
+ * @brief Returns the unique identifier for this command
+ * @return UUID that uniquely identifies the LightSyncBenchmark command
+ * @note This UUID should never change to maintain compatibility
+ */
+UUID CCommandLightSyncBenchmark::CommandUUID()
+{
+    // Static UUID for LightSyncBenchmark command - generated once and remains constant
+    static const GUID uuid = { 0x3C71B5E2, 0x94A8, 0x4F0D, {0xA6,0x1B,0x58,0xD2,0x07,0xE9,0x3F,0x4C} };
+    return uuid;
+}
+
+/**
+ * @brief Returns the English name of the command as it appears in Rhino
+ * @return Wide character string containing the command name
+ */
+const wchar_t* CCommandLightSyncBenchmark::EnglishCommandName()
+{
+    return L"LightSyncBenchmark";
+}
+
+/**
+ * @brief Main command execution method
+ * @param context Command context containing document and other execution information
+ * @return Command execution result (success, failure, etc.)
+ *
+ * Encodes a synthetic scene from a cold cache with doubling thread counts up to
+ * the worker pool size, keeping the best of several runs each, and prints the
+ * time, throughput and speedup over one thread. The complete message is then
+ * decoded with the receiver library and compared with the input, and the sizes
+ * of the quantized encoding are reported. Nothing is sent.
+ */
+CRhinoCommand::result CCommandLightSyncBenchmark::RunCommand(const CRhinoCommandContext& context)
+{
+    int lightCount = 100000;
+    int runs = 3;
+
+    CRhinoGetOption go;
+    go.SetCommandPrompt(L"Encoding benchmark. Press Enter to run");
+    go.AcceptNothing();
+    for (;;)
+    {
+        go.ClearCommandOptions();
+        go.AddCommandOptionInteger(RHCMDOPTNAME(L"LightCount"), &lightCount, L"Synthetic lights", 1000, 1000000);
+        go.AddCommandOptionInteger(RHCMDOPTNAME(L"Runs"), &runs, L"Runs per thread count", 1, 20);
+
+        CRhinoGet::result res = go.GetOption();
+        if (res == CRhinoGet::option)
+            continue;
+        if (res == CRhinoGet::nothing)
+            break;
+        return CRhinoCommand::cancel;
+    }
+
+    const std::vector<LightUtils::LightInfo> lights = MakeBenchmarkLights(static_cast<size_t>(lightCount));
+    const size_t maxThreads = LightWorkerPool::ThreadCount();
+
+    RhinoApp().Print(L"Encoding %d lights, best of %d run(s), up to %d thread(s):\n",
+        lightCount, runs, static_cast<int>(maxThreads));
+
+    std::string reference;
+    double singleThreadMs = 0.0;
+    bool identical = true;
+    std::vector<LightFragmentCache::Fragment> fragments;
+
+    for (size_t threads = 1; ; threads *= 2)
+    {
+        if (threads > maxThreads)
+        {
+            threads = maxThreads;
+        }
+
+        double bestMs = 0.0;
+        for (int run = 0; run < runs; ++run)
+        {
+            // A fresh cache makes every light a miss, as in a resync of a new scene
+            LightFragmentCache cache(&CLightEventWatcher::EncodeLightRecord);
+
+            const auto start = std::chrono::steady_clock::now();
+            cache.Gather(lights, fragments, threads);
+            const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            if (run == 0 || ms < bestMs)
+            {
+                bestMs = ms;
+            }
+        }
+
+        std::string bytes = Concatenate(fragments);
+        if (threads == 1)
+        {
+            reference.swap(bytes);
+            singleThreadMs = bestMs;
+        }
+        else if (bytes != reference)
+        {
+            identical = false;
+        }
+
+        const double megabytesPerSecond = bestMs > 0.0 ? (reference.size() / 1048576.0) / (bestMs / 1000.0) : 0.0;
+        RhinoApp().Print(L"  %2d thread(s): %9.2f ms  %8.1f MB/s  x%.2f\n", static_cast<int>(threads), bestMs,
+            megabytesPerSecond, bestMs > 0.0 ? singleThreadMs / bestMs : 0.0);
+
+        if (threads == maxThreads)
+        {
+            break;
+        }
+    }
+
+    RhinoApp().Print(L"Encoded %d bytes per run; output %s across thread counts.\n",
+        static_cast<int>(reference.size()), identical ? L"identical" : L"DIFFERS");
+
+    const bool decoded = RoundTrip(lights, runs);
+    const bool quantized = QuantizedRoundTrip(lights);
+
+    return identical && decoded && quantized ? CRhinoCommand::success : CRhinoCommand::failure;
+}
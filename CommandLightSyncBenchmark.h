@@ -0,0 +1,31 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+
+#pragma once
+
+#include "stdafx.h"
+#include "rhinoSdkCommand.h"
+
+/**
+ * Rhino command that measures full-state encoding of a synthetic scene
+ * with 1, 2, 4, ... threads and checks that every run produces the same bytes.
+ */
+class CCommandLightSyncBenchmark : public CRhinoCommand
+{
+public:
+    CCommandLightSyncBenchmark() = default;
+
+    UUID CommandUUID() override;
+    const wchar_t* EnglishCommandName() override;
+    CRhinoCommand::result RunCommand(const CRhinoCommandContext& context) override;
+};
@@ -0,0 +1,87 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+#include "stdafx.h"
+#include "CommandLightSyncJournal.h"
+#include "LightEventJournal.h"
+
+// Global static instance of the command - automatically registers with Rhino
+static class CCommandLightSyncJournal theLightSyncJournalCommand;
+
+/**
+ * @brief Returns the unique identifier for this command
+ * @return UUID that uniquely identifies the LightSyncJournal command
+ * @note This UUID should never change to maintain compatibility
+ */
+UUID CCommandLightSyncJournal::CommandUUID()
+{
+    // Static UUID for LightSyncJournal command - generated once and remains constant
+    static const GUID uuid = { 0x6D28A9F3, 0x1E54, 0x4B7C, {0x95,0xD0,0x3A,0x6F,0xE1,0x27,0x8C,0x4B} };
+    return uuid;
+}
+
+/**
+ * @brief Returns the English name of the command as it appears in Rhino
+ * @return Wide character string containing the command name
+ */
+const wchar_t* CCommandLightSyncJournal::EnglishCommandName()
+{
+    return L"LightSyncJournal";
+}
+
+/**
+ * @brief Main command execution method
+ * @param context Command context containing document and other execution information
+ * @return Command execution result (success, failure, etc.)
+ *
+ * Prompts for the recording state and the size limit. Starting a recording
+ * replaces the journal file at the default path.
+ */
+CRhinoCommand::result CCommandLightSyncJournal::RunCommand(const CRhinoCommandContext& context)
+{
+    bool recording = !LightEventJournal::IsRecording();
+    int maxSizeMB = static_cast<int>(LightEventJournal::DEFAULT_MAX_BYTES / (1024 * 1024));
+
+    CRhinoGetOption go;
+    go.SetCommandPrompt(L"Light event journal. Press Enter to apply");
+    go.AcceptNothing();
+    for (;;)
+    {
+        go.ClearCommandOptions();
+        go.AddCommandOptionToggle(RHCMDOPTNAME(L"Recording"), RHCMDOPTVALUE(L"Off"), RHCMDOPTVALUE(L"On"), recording, &recording);
+        go.AddCommandOptionInteger(RHCMDOPTNAME(L"MaxSizeMB"), &maxSizeMB, L"Size at which the journal is rotated", 1, 4096);
+
+        CRhinoGet::result res = go.GetOption();
+        if (res == CRhinoGet::option)
+            continue;
+        if (res == CRhinoGet::nothing)
+            break;
+        return CRhinoCommand::cancel;
+    }
+
+    if (!recording)
+    {
+        LightEventJournal::Stop();
+        RhinoApp().Print(L"Light event journal off.\n");
+        return CRhinoCommand::success;
+    }
+
+    if (!LightEventJournal::Start(LightEventJournal::DEFAULT_JOURNAL_PATH, static_cast<size_t>(maxSizeMB) * 1024 * 1024))
+    {
+        RhinoApp().Print(L"Error: Could not create %s.\n", LightEventJournal::DEFAULT_JOURNAL_PATH.c_str());
+        return CRhinoCommand::failure;
+    }
+
+    RhinoApp().Print(L"Recording light events to %s (%d MB max, previous part kept as .1).\n",
+        LightEventJournal::DEFAULT_JOURNAL_PATH.c_str(), maxSizeMB);
+    return CRhinoCommand::success;
+}
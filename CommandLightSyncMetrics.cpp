@@ -0,0 +1,94 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+#include "stdafx.h"
+#include "CommandLightSyncMetrics.h"
+#include "LightSyncMetrics.h"
+#include "LightSyncRuntime.h"
+
+// Global static instance of the command - automatically registers with Rhino
+static class CCommandLightSyncMetrics theLightSyncMetricsCommand;
+
+/**
+ * @brief Returns the unique identifier for this command
+ * @return UUID that uniquely identifies the LightSyncMetrics command
+ * @note This UUID should never change to maintain compatibility
+ */
+UUID CCommandLightSyncMetrics::CommandUUID()
+{
+    // Static UUID for LightSyncMetrics command - generated once and remains constant
+    static const GUID uuid = { 0xD6F05407, 0x6D94, 0x4425, {0xBD,0x50,0x70,0xA5,0x55,0xEC,0xC7,0x44} };
+    return uuid;
+}
+
+/**
+ * @brief Returns the English name of the command as it appears in Rhino
+ * @return Wide character string containing the command name
+ */
+const wchar_t* CCommandLightSyncMetrics::EnglishCommandName()
+{
+    return L"LightSyncMetrics";
+}
+
+/**
+ * @brief Main command execution method
+ * @param context Command context containing document and other execution information
+ * @return Command execution result (success, failure, etc.)
+ *
+ * Prompts for the endpoint state and its port. Counters are kept either way;
+ * latency histograms only record while the endpoint is on.
+ */
+CRhinoCommand::result CCommandLightSyncMetrics::RunCommand(const CRhinoCommandContext& context)
+{
+    bool enabled = !LightSyncMetrics::IsEnabled();
+    int port = LightSyncMetrics::IsEnabled() ? LightSyncMetrics::Port() : LightSyncMetrics::DEFAULT_METRICS_PORT;
+
+    CRhinoGetOption go;
+    go.SetCommandPrompt(L"Metrics endpoint. Press Enter to apply");
+    go.AcceptNothing();
+    for (;;)
+    {
+        go.ClearCommandOptions();
+        go.AddCommandOptionToggle(RHCMDOPTNAME(L"Metrics"), RHCMDOPTVALUE(L"Off"), RHCMDOPTVALUE(L"On"), enabled, &enabled);
+        go.AddCommandOptionInteger(RHCMDOPTNAME(L"Port"), &port, L"Loopback port the scraper connects to", 1, 65535);
+
+        CRhinoGet::result res = go.GetOption();
+        if (res == CRhinoGet::option)
+            continue;
+        if (res == CRhinoGet::nothing)
+            break;
+        return CRhinoCommand::cancel;
+    }
+
+    if (!enabled)
+    {
+        LightSyncMetrics::Disable();
+        RhinoApp().Print(L"Metrics endpoint off.\n");
+        return CRhinoCommand::success;
+    }
+
+    // A new port needs a new listener
+    if (LightSyncMetrics::IsEnabled() && LightSyncMetrics::Port() != port)
+    {
+        LightSyncMetrics::Disable();
+    }
+    // The endpoint listens on the network thread
+    LightSyncRuntime::EnsureStarted(L"LightSyncMetrics command");
+    if (!LightSyncMetrics::Enable(port))
+    {
+        RhinoApp().Print(L"Error: Could not listen on port %d for metrics.\n", port);
+        return CRhinoCommand::failure;
+    }
+
+    RhinoApp().Print(L"Metrics endpoint on: http://127.0.0.1:%d/metrics\n", port);
+    return CRhinoCommand::success;
+}
@@ -0,0 +1,124 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+#include "stdafx.h"
+#include "CommandLightSyncReplay.h"
+#include "LightEventJournal.h"
+#include "LightEventReplay.h"
+#include <algorithm>
+
+// Global static instance of the command - automatically registers with Rhino
+static class CCommandLightSyncReplay theLightSyncReplayCommand;
+
+/**
+ * @brief Returns the unique identifier for this command
+ * @return UUID that uniquely identifies the LightSyncReplay command
+ * @note This UUID should never change to maintain compatibility
+ */
+UUID CCommandLightSyncReplay::CommandUUID()
+{
+    // Static UUID for LightSyncReplay command - generated once and remains constant
+    static const GUID uuid = { 0x0F93C6B1, 0x7A2E, 0x4D85, {0xB4,0x61,0xC9,0x3E,0x58,0x0A,0xD7,0x12} };
+    return uuid;
+}
+
+/**
+ * @brief Returns the English name of the command as it appears in Rhino
+ * @return Wide character string containing the command name
+ */
+const wchar_t* CCommandLightSyncReplay::EnglishCommandName()
+{
+    return L"LightSyncReplay";
+}
+
+/**
+ * @brief Main command execution method
+ * @param context Command context containing document and other execution information
+ * @return Command execution result (success, failure, etc.)
+ *
+ * Reads the journal (or its rotated previous part), replays it at the recorded
+ * pace or as fast as possible and prints event counts and per-stage timings.
+ * The document and the receivers are not touched.
+ */
+CRhinoCommand::result CCommandLightSyncReplay::RunCommand(const CRhinoCommandContext& context)
+{
+    bool originalSpeed = false;
+    bool previousPart = false;
+
+    CRhinoGetOption go;
+    go.SetCommandPrompt(L"Replay light event journal. Press Enter to run");
+    go.AcceptNothing();
+    for (;;)
+    {
+        go.ClearCommandOptions();
+        go.AddCommandOptionToggle(RHCMDOPTNAME(L"Speed"), RHCMDOPTVALUE(L"Maximum"), RHCMDOPTVALUE(L"Original"), originalSpeed, &originalSpeed);
+        go.AddCommandOptionToggle(RHCMDOPTNAME(L"Part"), RHCMDOPTVALUE(L"Current"), RHCMDOPTVALUE(L"Previous"), previousPart, &previousPart);
+
+        CRhinoGet::result res = go.GetOption();
+        if (res == CRhinoGet::option)
+            continue;
+        if (res == CRhinoGet::nothing)
+            break;
+        return CRhinoCommand::cancel;
+    }
+
+    // Records still in the write buffer of an ongoing recording
+    LightEventJournal::Flush();
+
+    const std::wstring path = LightEventJournal::DEFAULT_JOURNAL_PATH + (previousPart ? L".1" : L"");
+    std::vector<LightEventJournal::Entry> entries;
+    if (!LightEventJournal::Read(path, entries))
+    {
+        RhinoApp().Print(L"Error: %s is missing or not a light event journal.\n", path.c_str());
+        return CRhinoCommand::failure;
+    }
+
+    // The journal holds every open document; replay this one if it was recorded, else the first recorded one
+    const unsigned int currentDoc = context.Document() ? context.Document()->RuntimeSerialNumber() : 0;
+    std::vector<unsigned int> documents;
+    for (const auto& entry : entries)
+    {
+        if (std::find(documents.begin(), documents.end(), entry.docSerial) == documents.end())
+            documents.push_back(entry.docSerial);
+    }
+    if (documents.empty())
+    {
+        RhinoApp().Print(L"%s holds no records.\n", path.c_str());
+        return CRhinoCommand::nothing;
+    }
+    const unsigned int docSerial =
+        std::find(documents.begin(), documents.end(), currentDoc) != documents.end() ? currentDoc : documents.front();
+
+    LightEventReplay::Report report;
+    LightEventReplay::Run(entries, docSerial, originalSpeed, report);
+
+    RhinoApp().Print(L"=== Replay of %s ===\n", path.c_str());
+    RhinoApp().Print(L"  Document: %u (%d document(s) in the journal)\n", docSerial, static_cast<int>(documents.size()));
+    RhinoApp().Print(L"  Events: %d (%d suppressed, %d field updates, %d scene updates)\n",
+        static_cast<int>(report.events), static_cast<int>(report.suppressed),
+        static_cast<int>(report.fieldUpdates), static_cast<int>(report.sceneUpdates));
+    RhinoApp().Print(L"  Encoded: %llu bytes, receiver mirror holds %d light(s)\n",
+        static_cast<unsigned long long>(report.bytesEncoded), static_cast<int>(report.mirroredLights));
+    RhinoApp().Print(L"  Wall time: %.1f ms (%s speed)\n", report.wallMilliseconds,
+        originalSpeed ? L"original" : L"maximum");
+    RhinoApp().Print(L"  Stage       total ms     p50 us     p99 us     max us\n");
+    for (int stage = 0; stage < LightEventReplay::STAGE_COUNT; ++stage)
+    {
+        const LightEventReplay::Stage s = static_cast<LightEventReplay::Stage>(stage);
+        RhinoApp().Print(L"  %-8s %11.2f %10.1f %10.1f %10.1f\n", LightEventReplay::StageName(s),
+            report.Total(s) / 1000.0, report.Percentile(s, 0.5), report.Percentile(s, 0.99),
+            report.Percentile(s, 1.0));
+    }
+    RhinoApp().Print(L"=== End of Replay ===\n");
+
+    return CRhinoCommand::success;
+}
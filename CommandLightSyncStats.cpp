@@ -0,0 +1,49 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+#include "stdafx.h"
+#include "CommandLightSyncStats.h"
+#include "LightSyncStats.h"
+
+// Global static instance of the command - automatically registers with Rhino
+static class CCommandLightSyncStats theLightSyncStatsCommand;
+
+/**
+ * @brief Returns the unique identifier for this command
+ * @return UUID that uniquely identifies the LightSyncStats command
+ * @note This UUID should never change to maintain compatibility
+ */
+UUID CCommandLightSyncStats::CommandUUID()
+{
+    // Static UUID for LightSyncStats command - generated once and remains constant
+    static const GUID uuid = { 0x5A9E2C14, 0x7F31, 0x4D6B, {0x8C,0x27,0xE4,0x10,0x9B,0x5F,0x62,0xA3} };
+    return uuid;
+}
+
+/**
+ * @brief Returns the English name of the command as it appears in Rhino
+ * @return Wide character string containing the command name
+ */
+const wchar_t* CCommandLightSyncStats::EnglishCommandName()
+{
+    return L"LightSyncStats";
+}
+
+/**
+ * @brief Main command execution method
+ * @param context Command context containing document and other execution information
+ * @return Command execution result
+ */
+CRhinoCommand::result CCommandLightSyncStats::RunCommand(const CRhinoCommandContext& context)
+{
+    LightSyncStats::Print();
+    return CRhinoCommand::success;
+}
@@ -0,0 +1,94 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+#include "stdafx.h"
+#include "CommandLightSyncTrace.h"
+#include "LightSyncTrace.h"
+
+// Global static instance of the command - automatically registers with Rhino
+static class CCommandLightSyncTrace theLightSyncTraceCommand;
+
+/**
+ * @brief Returns the unique identifier for this command
+ * @return UUID that uniquely identifies the LightSyncTrace command
+ * @note This UUID should never change to maintain compatibility
+ */
+UUID CCommandLightSyncTrace::CommandUUID()
+{
+    // Static UUID for LightSyncTrace command - generated once and remains constant
+    static const GUID uuid = { 0x2295B829, 0x87B9, 0x434B, {0x95,0x18,0x98,0x73,0x00,0x09,0x23,0xC9} };
+    return uuid;
+}
+
+/**
+ * @brief Returns the English name of the command as it appears in Rhino
+ * @return Wide character string containing the command name
+ */
+const wchar_t* CCommandLightSyncTrace::EnglishCommandName()
+{
+    return L"LightSyncTrace";
+}
+
+/**
+ * @brief Main command execution method
+ * @param context Command context containing document and other execution information
+ * @return Command execution result (success, failure, etc.)
+ *
+ * Prompts for the tracing state. Turning tracing off writes the spans recorded
+ * since it was turned on to the default trace path.
+ */
+CRhinoCommand::result CCommandLightSyncTrace::RunCommand(const CRhinoCommandContext& context)
+{
+    bool tracing = !LightSyncTrace::IsRunning();
+
+    CRhinoGetOption go;
+    go.SetCommandPrompt(L"Pipeline trace. Press Enter to apply");
+    go.AcceptNothing();
+    for (;;)
+    {
+        go.ClearCommandOptions();
+        go.AddCommandOptionToggle(RHCMDOPTNAME(L"Tracing"), RHCMDOPTVALUE(L"Off"), RHCMDOPTVALUE(L"On"), tracing, &tracing);
+
+        CRhinoGet::result res = go.GetOption();
+        if (res == CRhinoGet::option)
+            continue;
+        if (res == CRhinoGet::nothing)
+            break;
+        return CRhinoCommand::cancel;
+    }
+
+    if (tracing)
+    {
+        // Restarting discards the spans of the running trace
+        LightSyncTrace::Start();
+        RhinoApp().Print(L"Tracing the sync pipeline. Run LightSyncTrace again to write the trace.\n");
+        return CRhinoCommand::success;
+    }
+
+    if (!LightSyncTrace::IsRunning())
+    {
+        RhinoApp().Print(L"Tracing is already off.\n");
+        return CRhinoCommand::nothing;
+    }
+
+    size_t spanCount = 0;
+    size_t droppedCount = 0;
+    if (!LightSyncTrace::Stop(LightSyncTrace::DEFAULT_TRACE_PATH, spanCount, droppedCount))
+    {
+        RhinoApp().Print(L"Error: Could not write %s.\n", LightSyncTrace::DEFAULT_TRACE_PATH.c_str());
+        return CRhinoCommand::failure;
+    }
+
+    RhinoApp().Print(L"Wrote %d span(s) to %s (%d dropped). Open it in chrome://tracing or ui.perfetto.dev.\n",
+        static_cast<int>(spanCount), LightSyncTrace::DEFAULT_TRACE_PATH.c_str(), static_cast<int>(droppedCount));
+    return CRhinoCommand::success;
+}
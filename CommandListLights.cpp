@@ -11,11 +11,178 @@
 // Contact: rudraojhaif@gmail.com for licensing inquiries.
 #include "stdafx.h"
 #include "CommandListLights.h"
+#include "LightEventJournal.h"
+#include "LightEventWatcher.h"
 #include "LightUtils.h"
+#include <algorithm>
+#include <string>
+#include <vector>
 
 // Global static instance of the command - automatically registers with Rhino
 static class CCommandListLights theListLightsCommand;
 
+namespace {
+    const std::wstring FILTERED_EXPORT_PATH = L"C:/ProgramData/RhinoLightSync/LightsFiltered.txt";
+    const std::wstring SNAPSHOT_EXPORT_PATH = L"C:/ProgramData/RhinoLightSync/Lights.lsj";
+    constexpr int DEFAULT_PAGE_SIZE = 50;
+    constexpr int TYPE_COUNT = 5;  // LightUtils::LightType values, Unknown first
+
+    enum View { VIEW_SUMMARY, VIEW_PAGE };
+    enum Output { OUTPUT_NONE, OUTPUT_TEXT, OUTPUT_SNAPSHOT };
+
+    // Options of the last run, kept for the session like Rhino's own commands do
+    struct Settings
+    {
+        int view;
+        int page;
+        int pageSize;
+        int type;           // LightUtils::LightType, Unknown for every type
+        int layerIndex;     // -1 for every layer
+        ON_wString layerName;
+        bool hasRegion;
+        ON_3dPoint regionMin;  // Model units
+        ON_3dPoint regionMax;
+        int output;
+
+        Settings() : view(VIEW_SUMMARY), page(1), pageSize(DEFAULT_PAGE_SIZE),
+            type(static_cast<int>(LightUtils::LightType::Unknown)), layerIndex(-1), hasRegion(false), output(OUTPUT_TEXT) {}
+
+        bool IsFiltered() const
+        {
+            return type != static_cast<int>(LightUtils::LightType::Unknown) || layerIndex >= 0 || hasRegion;
+        }
+    };
+    Settings g_settings;
+
+    // Counts, extent and intensity range of the listed lights, gathered in one pass
+    struct Summary
+    {
+        size_t count;
+        size_t byType[TYPE_COUNT];
+        ON_3dPoint min;
+        ON_3dPoint max;
+        double minIntensity;
+        double maxIntensity;
+        double sumIntensity;
+
+        Summary() : count(0), byType(), minIntensity(0.0), maxIntensity(0.0), sumIntensity(0.0) {}
+
+        void Add(const LightUtils::LightInfo& light)
+        {
+            const ON_3dPoint& p = light.location;
+            if (count == 0)
+            {
+                min = max = p;
+                minIntensity = maxIntensity = light.intensity;
+            }
+            min.x = std::min(min.x, p.x); min.y = std::min(min.y, p.y); min.z = std::min(min.z, p.z);
+            max.x = std::max(max.x, p.x); max.y = std::max(max.y, p.y); max.z = std::max(max.z, p.z);
+            minIntensity = std::min(minIntensity, light.intensity);
+            maxIntensity = std::max(maxIntensity, light.intensity);
+            sumIntensity += light.intensity;
+            ++byType[static_cast<int>(light.type)];
+            ++count;
+        }
+    };
+
+    bool Matches(const CRhinoLight& rhinoLight, const Settings& settings)
+    {
+        // Same lights as LightUtils::GetAllLights: deleted and switched-off ones are skipped
+        const ON_Light& light = rhinoLight.Light();
+        if (rhinoLight.IsDeleted() || !light.m_bOn)
+            return false;
+        if (settings.type != static_cast<int>(LightUtils::LightType::Unknown) &&
+            static_cast<int>(LightUtils::GetLightType(light.Style())) != settings.type)
+            return false;
+        if (settings.layerIndex >= 0 && rhinoLight.Attributes().m_layer_index != settings.layerIndex)
+            return false;
+        if (settings.hasRegion)
+        {
+            const ON_3dPoint p = light.Location();
+            if (p.x < settings.regionMin.x || p.y < settings.regionMin.y || p.z < settings.regionMin.z ||
+                p.x > settings.regionMax.x || p.y > settings.regionMax.y || p.z > settings.regionMax.z)
+                return false;
+        }
+        return true;
+    }
+
+    // Asks for a layer by its full path; Enter lists every layer again
+    void PromptLayer(CRhinoDoc& doc)
+    {
+        CRhinoGetString gs;
+        gs.SetCommandPrompt(L"Layer to list (full path, Enter for all layers)");
+        gs.AcceptNothing();
+        const CRhinoGet::result res = gs.GetString();
+        if (res == CRhinoGet::nothing)
+        {
+            g_settings.layerIndex = -1;
+            g_settings.layerName.Empty();
+            return;
+        }
+        if (res != CRhinoGet::string)
+            return;
+
+        const int layerIndex = doc.m_layer_table.FindLayerFromFullPathName(gs.String(), -1);
+        if (layerIndex < 0)
+        {
+            RhinoApp().Print(L"Layer \"%s\" not found.\n", gs.String());
+            return;
+        }
+        g_settings.layerIndex = layerIndex;
+        g_settings.layerName = gs.String();
+    }
+
+    // Asks for two corners of the box lights must be in; Enter lists everywhere again
+    void PromptRegion()
+    {
+        CRhinoGetPoint first;
+        first.SetCommandPrompt(L"First corner of region (Enter for no region)");
+        first.AcceptNothing();
+        const CRhinoGet::result res = first.GetPoint();
+        if (res == CRhinoGet::nothing)
+        {
+            g_settings.hasRegion = false;
+            return;
+        }
+        if (res != CRhinoGet::point)
+            return;
+
+        CRhinoGetPoint second;
+        second.SetCommandPrompt(L"Opposite corner of region");
+        if (second.GetPoint() != CRhinoGet::point)
+            return;
+
+        const ON_3dPoint a = first.Point();
+        const ON_3dPoint b = second.Point();
+        g_settings.regionMin = ON_3dPoint(std::min(a.x, b.x), std::min(a.y, b.y), std::min(a.z, b.z));
+        g_settings.regionMax = ON_3dPoint(std::max(a.x, b.x), std::max(a.y, b.y), std::max(a.z, b.z));
+        g_settings.hasRegion = true;
+    }
+
+    void PrintSummary(const Summary& summary, size_t sceneCount)
+    {
+        RhinoApp().Print(L"=== Light Summary ===\n");
+        RhinoApp().Print(L"Listed %d of %d light(s)\n", static_cast<int>(summary.count), static_cast<int>(sceneCount));
+        for (int type = 1; type < TYPE_COUNT; ++type)
+        {
+            RhinoApp().Print(L"  %-12s %d\n", LightUtils::GetLightTypeName(static_cast<LightUtils::LightType>(type)),
+                static_cast<int>(summary.byType[type]));
+        }
+        if (summary.byType[0] != 0)
+        {
+            RhinoApp().Print(L"  %-12s %d\n", L"Unknown", static_cast<int>(summary.byType[0]));
+        }
+        if (summary.count != 0)
+        {
+            RhinoApp().Print(L"Bounding box: (%.3f, %.3f, %.3f) to (%.3f, %.3f, %.3f)\n",
+                summary.min.x, summary.min.y, summary.min.z, summary.max.x, summary.max.y, summary.max.z);
+            RhinoApp().Print(L"Intensity:    %.3f to %.3f (mean %.3f)\n", summary.minIntensity, summary.maxIntensity,
+                summary.sumIntensity / static_cast<double>(summary.count));
+        }
+        RhinoApp().Print(L"=== End of Light Summary ===\n");
+    }
+}
+
 /**
  * @brief Returns the unique identifier for this command
  * @return UUID that uniquely identifies the ListLights command
@@ -43,11 +210,11 @@ const wchar_t* CCommandListLights::EnglishCommandName()
  * @param context Command context containing document and other execution information
  * @return Command execution result (success, failure, etc.)
  *
- * This method:
- * 1. Validates the document context
- * 2. Retrieves all lights from the active document
- * 3. Prints a comprehensive inventory to the console
- * 4. Exports the light data to a file for backup/analysis
+ * Prompts for the view (a summary or one page of lights), the type, layer and
+ * region filters and the file to write, then makes one pass over the light
+ * table. Only pointers to the matching lights are kept; light records are
+ * made as they are printed or written, so large models neither flood the
+ * command line nor build a copy of every light.
  */
 CRhinoCommand::result CCommandListLights::RunCommand(const CRhinoCommandContext& context)
 {
@@ -59,24 +226,112 @@ CRhinoCommand::result CCommandListLights::RunCommand(const CRhinoCommandContext&
         return CRhinoCommand::failure;
     }
 
+    const CRhinoCommandOptionValue views[] = { RHCMDOPTVALUE(L"Summary"), RHCMDOPTVALUE(L"Page") };
+    const CRhinoCommandOptionValue types[] = { RHCMDOPTVALUE(L"All"), RHCMDOPTVALUE(L"Directional"),
+        RHCMDOPTVALUE(L"Point"), RHCMDOPTVALUE(L"Spot"), RHCMDOPTVALUE(L"Ambient") };
+    const CRhinoCommandOptionValue outputs[] = { RHCMDOPTVALUE(L"None"), RHCMDOPTVALUE(L"Text"), RHCMDOPTVALUE(L"Snapshot") };
+
+    CRhinoGetOption go;
+    go.SetCommandPrompt(L"List lights. Press Enter to list");
+    go.AcceptNothing();
+    for (;;)
+    {
+        go.ClearCommandOptions();
+        const int viewOption = go.AddCommandOptionList(RHCMDOPTNAME(L"View"), 2, views, g_settings.view);
+        go.AddCommandOptionInteger(RHCMDOPTNAME(L"Page"), &g_settings.page, L"Page to print", 1, 1000000);
+        go.AddCommandOptionInteger(RHCMDOPTNAME(L"PageSize"), &g_settings.pageSize, L"Lights per page", 1, 10000);
+        const int typeOption = go.AddCommandOptionList(RHCMDOPTNAME(L"Type"), TYPE_COUNT, types, g_settings.type);
+        const int layerOption = go.AddCommandOption(RHCMDOPTNAME(L"Layer"));
+        const int regionOption = go.AddCommandOption(RHCMDOPTNAME(L"Region"));
+        const int outputOption = go.AddCommandOptionList(RHCMDOPTNAME(L"Output"), 3, outputs, g_settings.output);
+
+        CRhinoGet::result res = go.GetOption();
+        if (res == CRhinoGet::option)
+        {
+            const CRhinoCommandOption* option = go.Option();
+            if (option->m_option_index == viewOption)
+                g_settings.view = option->m_list_option_current;
+            else if (option->m_option_index == typeOption)
+                g_settings.type = option->m_list_option_current;
+            else if (option->m_option_index == outputOption)
+                g_settings.output = option->m_list_option_current;
+            else if (option->m_option_index == layerOption)
+                PromptLayer(*doc);
+            else if (option->m_option_index == regionOption)
+                PromptRegion();
+            continue;
+        }
+        if (res == CRhinoGet::nothing)
+            break;
+        return CRhinoCommand::cancel;
+    }
+
     try
     {
-        // Get all lights using the utility class - this handles all light types
-        std::vector<LightUtils::LightInfo> lights = LightUtils::GetAllLights(doc);
+        // One pass over the table: matching lights are remembered by pointer and summarized
+        ON_SimpleArray<const CRhinoLight*> table;
+        doc->m_light_table.GetSortedList(table);
+        std::vector<const CRhinoLight*> matches;
+        Summary summary;
+        size_t sceneCount = 0;
+        for (int i = 0; i < table.Count(); ++i)
+        {
+            const CRhinoLight* rhinoLight = table[i];
+            if (!rhinoLight->IsDeleted() && rhinoLight->Light().m_bOn)
+                ++sceneCount;
+            if (!Matches(*rhinoLight, g_settings))
+                continue;
+            matches.push_back(rhinoLight);
+            summary.Add(LightUtils::MakeLightInfo(*rhinoLight));
+        }
 
-        // Print the light inventory to console - provides immediate feedback to user
-        LightUtils::PrintLightInventory(lights);
+        if (g_settings.layerIndex >= 0)
+            RhinoApp().Print(L"Layer: %s\n", static_cast<const wchar_t*>(g_settings.layerName));
+        PrintSummary(summary, sceneCount);
 
-        // Export data to file - creates a persistent record of the light configuration
-        if (LightUtils::ExportLightsToFile(lights, LightUtils::DEFAULT_EXPORT_PATH))
+        if (g_settings.view == VIEW_PAGE)
         {
-            // Inform user of successful export with file location
-            RhinoApp().Print(L"Light data successfully exported to: %s\n", LightUtils::DEFAULT_EXPORT_PATH.c_str());
+            const size_t pageSize = static_cast<size_t>(g_settings.pageSize);
+            const size_t pageCount = std::max<size_t>(1, (matches.size() + pageSize - 1) / pageSize);
+            const size_t page = std::min(static_cast<size_t>(g_settings.page), pageCount);
+            const size_t first = (page - 1) * pageSize;
+            const size_t last = std::min(first + pageSize, matches.size());
+
+            RhinoApp().Print(L"=== Light Inventory Report ===\n");
+            RhinoApp().Print(L"Lights %d-%d of %d (page %d of %d):\n\n", static_cast<int>(std::min(first + 1, last)),
+                static_cast<int>(last), static_cast<int>(matches.size()), static_cast<int>(page), static_cast<int>(pageCount));
+            for (size_t i = first; i < last; ++i)
+            {
+                LightUtils::PrintLightInfo(LightUtils::MakeLightInfo(*matches[i]), i + 1);
+            }
+            RhinoApp().Print(L"=== End of Light Report ===\n");
         }
-        else
+
+        // Files are streamed from the matching lights, one record at a time
+        if (g_settings.output == OUTPUT_TEXT)
         {
-            // Warn user if file export failed, but don't fail the entire command
-            RhinoApp().Print(L"Warning: Failed to export light data to file.\n");
+            // A filtered list must not replace the complete backup file
+            const std::wstring& path = g_settings.IsFiltered() ? FILTERED_EXPORT_PATH : LightUtils::DEFAULT_EXPORT_PATH;
+            LightUtils::LightInfo scratch;
+            const bool exported = LightUtils::ExportLightsToFile(matches.size(),
+                [&matches, &scratch](size_t index) -> const LightUtils::LightInfo& {
+                    scratch = LightUtils::MakeLightInfo(*matches[index]);
+                    return scratch;
+                }, path);
+            if (exported)
+                RhinoApp().Print(L"Light data successfully exported to: %s\n", path.c_str());
+            else
+                RhinoApp().Print(L"Warning: Failed to export light data to file.\n");
+        }
+        else if (g_settings.output == OUTPUT_SNAPSHOT)
+        {
+            const bool exported = LightEventJournal::WriteSnapshot(SNAPSHOT_EXPORT_PATH, doc->RuntimeSerialNumber(),
+                matches.size(), [&matches](size_t index) -> const CRhinoLight& { return *matches[index]; },
+                CLightEventWatcher::GetModelUnitScaleToMeters(doc));
+            if (exported)
+                RhinoApp().Print(L"Light snapshot written to: %s (event journal format)\n", SNAPSHOT_EXPORT_PATH.c_str());
+            else
+                RhinoApp().Print(L"Warning: Failed to write the light snapshot.\n");
         }
 
         return CRhinoCommand::success;
@@ -93,4 +348,4 @@ CRhinoCommand::result CCommandListLights::RunCommand(const CRhinoCommandContext&
         RhinoApp().Print(L"Error: An unknown exception occurred during command execution.\n");
         return CRhinoCommand::failure;
     }
-}
\ No newline at end of file
+}
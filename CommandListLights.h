@@ -17,9 +17,10 @@
 #include <sstream>
 
 /**
- * Rhino command to list all lights in the scene and export them to a text file.
- * Enumerates all lights in the current Rhino document, displays their properties
- * in the command line, and exports the data to a structured text file.
+ * Rhino command to list the lights in the scene and export them to a file.
+ * Prints a summary or one page of the lights in the current Rhino document,
+ * optionally filtered by type, layer and region, and streams them to a
+ * structured text file or a binary snapshot.
  */
 class CCommandListLights : public CRhinoCommand
 {
@@ -0,0 +1,97 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+#include "stdafx.h"
+#include "CommandLiveDrag.h"
+#include "LightSyncRuntime.h"
+#include "LiveDragStreamer.h"
+
+// Global static instance of the command - automatically registers with Rhino
+static class CCommandLiveDrag theLiveDragCommand;
+
+/**
+ * @brief Returns the unique identifier for this command
+ * @return UUID that uniquely identifies the LightSyncLiveDrag command
+ * @note This UUID should never change to maintain compatibility
+ */
+UUID CCommandLiveDrag::CommandUUID()
+{
+    // Static UUID for LightSyncLiveDrag command - generated once and remains constant
+    static const GUID uuid = { 0x8E4F0D37, 0x2B6C, 0x4A91, {0xB3,0x0E,0x71,0x5A,0xC2,0x9D,0x46,0xF8} };
+    return uuid;
+}
+
+/**
+ * @brief Returns the English name of the command as it appears in Rhino
+ * @return Wide character string containing the command name
+ */
+const wchar_t* CCommandLiveDrag::EnglishCommandName()
+{
+    return L"LightSyncLiveDrag";
+}
+
+/**
+ * @brief Main command execution method
+ * @param context Command context containing document and other execution information
+ * @return Command execution result (success, failure, etc.)
+ *
+ * Prompts for the on/off state, the maximum update rate and the transport of
+ * the samples, then enables or disables the live drag streamer for the current
+ * document.
+ */
+CRhinoCommand::result CCommandLiveDrag::RunCommand(const CRhinoCommandContext& context)
+{
+    CRhinoDoc* doc = context.Document();
+    if (nullptr == doc)
+    {
+        RhinoApp().Print(L"Error: No active document found.\n");
+        return CRhinoCommand::failure;
+    }
+
+    bool enabled = !LiveDragStreamer::IsEnabled();
+    double maxRate = LiveDragStreamer::MaxRateHz();
+    bool udp = LiveDragStreamer::TransformChannel() == LiveDragStreamer::Channel::Udp;
+
+    CRhinoGetOption go;
+    go.SetCommandPrompt(L"Live drag streaming. Press Enter to apply");
+    go.AcceptNothing();
+    for (;;)
+    {
+        go.ClearCommandOptions();
+        go.AddCommandOptionToggle(RHCMDOPTNAME(L"Streaming"), RHCMDOPTVALUE(L"Off"), RHCMDOPTVALUE(L"On"), enabled, &enabled);
+        go.AddCommandOptionNumber(RHCMDOPTNAME(L"MaxRate"), &maxRate, L"Maximum updates per second", FALSE, 1.0, 240.0);
+        go.AddCommandOptionToggle(RHCMDOPTNAME(L"Channel"), RHCMDOPTVALUE(L"TCP"), RHCMDOPTVALUE(L"UDP"), udp, &udp);
+
+        CRhinoGet::result res = go.GetOption();
+        if (res == CRhinoGet::option)
+            continue;
+        if (res == CRhinoGet::nothing)
+            break;
+        return CRhinoCommand::cancel;
+    }
+
+    if (enabled)
+    {
+        LightSyncRuntime::EnsureStarted(L"LightSyncLiveDrag command");
+        // Re-enabling applies a changed rate or channel without restarting the sender
+        LiveDragStreamer::Enable(doc->RuntimeSerialNumber(), maxRate,
+            udp ? LiveDragStreamer::Channel::Udp : LiveDragStreamer::Channel::Tcp);
+        RhinoApp().Print(L"Live drag streaming on (%.0f Hz max, %s).\n", LiveDragStreamer::MaxRateHz(),
+            udp ? L"UDP datagrams" : L"TCP");
+    }
+    else
+    {
+        LiveDragStreamer::Disable();
+        RhinoApp().Print(L"Live drag streaming off.\n");
+    }
+
+    return CRhinoCommand::success;
+}
@@ -0,0 +1,167 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+#include "stdafx.h"
+#include "CommandSyncSunStudy.h"
+#include "LightSyncNetwork.h"
+#include "LightSyncRuntime.h"
+#include "SunStudy.h"
+#include <ctime>
+
+// Global static instance of the command - automatically registers with Rhino
+static class CCommandSyncSunStudy theSyncSunStudyCommand;
+
+/**
+ * @brief Returns the unique identifier for this command
+ * @return UUID that uniquely identifies the SyncSunStudy command
+ * @note This UUID should never change to maintain compatibility
+ */
+UUID CCommandSyncSunStudy::CommandUUID()
+{
+    // Static UUID for SyncSunStudy command - generated once and remains constant
+    static const GUID uuid = { 0x3C1B6E2A, 0x58D4, 0x4F0B, {0x9A,0x61,0x2E,0x7C,0x0D,0x43,0xB5,0x18} };
+    return uuid;
+}
+
+/**
+ * @brief Returns the English name of the command as it appears in Rhino
+ * @return Wide character string containing the command name
+ */
+const wchar_t* CCommandSyncSunStudy::EnglishCommandName()
+{
+    return L"SyncSunStudy";
+}
+
+/**
+ * @brief Main command execution method
+ * @param context Command context containing document and other execution information
+ * @return Command execution result (success, failure, etc.)
+ *
+ * This method:
+ * 1. Finds the directional light that acts as the sun
+ * 2. Lets the user adjust date, time range and sampling of the study
+ * 3. Builds and simplifies the keyframe curve
+ * 4. Sends the curve to Unreal in a single background TCP message
+ */
+CRhinoCommand::result CCommandSyncSunStudy::RunCommand(const CRhinoCommandContext& context)
+{
+    CRhinoDoc* doc = context.Document();
+    if (nullptr == doc)
+    {
+        RhinoApp().Print(L"Error: No active document found.\n");
+        return CRhinoCommand::failure;
+    }
+    LightSyncRuntime::EnsureStarted(L"SyncSunStudy command");
+
+    try
+    {
+        // The first enabled directional light in the table is treated as the sun
+        const CRhinoLight* sunLight = nullptr;
+        ON_SimpleArray<const CRhinoLight*> lights;
+        doc->m_light_table.GetSortedList(lights);
+        for (int i = 0; i < lights.Count(); ++i)
+        {
+            const ON_Light& light = lights[i]->Light();
+            if (light.m_bOn && light.IsDirectionalLight())
+            {
+                sunLight = lights[i];
+                break;
+            }
+        }
+
+        if (nullptr == sunLight)
+        {
+            RhinoApp().Print(L"Error: The document has no enabled directional light to drive the sun study.\n");
+            return CRhinoCommand::failure;
+        }
+
+        // Defaults come from the document location and today's date
+        SunStudy::Settings settings;
+        const ON_EarthAnchorPoint& anchor = doc->Properties().EarthAnchorPoint();
+        settings.latitude = anchor.Latitude();
+        settings.longitude = anchor.Longitude();
+        settings.timeZoneHours = ON_Round(settings.longitude / 15.0);
+        settings.peakIntensity = sunLight->Light().Intensity();
+        settings.noonColor = sunLight->Light().Diffuse();
+
+        std::time_t now = std::time(nullptr);
+        std::tm localTime = {};
+        localtime_s(&localTime, &now);
+        settings.year = localTime.tm_year + 1900;
+        settings.month = localTime.tm_mon + 1;
+        settings.day = localTime.tm_mday;
+
+        // Let the user adjust the study before sending
+        CRhinoGetOption go;
+        go.SetCommandPrompt(L"Sun study options. Press Enter to send");
+        go.AcceptNothing();
+        for (;;)
+        {
+            go.ClearCommandOptions();
+            go.AddCommandOptionInteger(RHCMDOPTNAME(L"Month"), &settings.month, L"Month", 1, 12);
+            go.AddCommandOptionInteger(RHCMDOPTNAME(L"Day"), &settings.day, L"Day of month", 1, 31);
+            go.AddCommandOptionNumber(RHCMDOPTNAME(L"StartHour"), &settings.startHour, L"Start hour", FALSE, 0.0, 24.0);
+            go.AddCommandOptionNumber(RHCMDOPTNAME(L"EndHour"), &settings.endHour, L"End hour", FALSE, 0.0, 24.0);
+            go.AddCommandOptionNumber(RHCMDOPTNAME(L"StepMinutes"), &settings.stepMinutes, L"Sampling step in minutes", FALSE, 1.0, 120.0);
+            go.AddCommandOptionNumber(RHCMDOPTNAME(L"Latitude"), &settings.latitude, L"Latitude", FALSE, -90.0, 90.0);
+            go.AddCommandOptionNumber(RHCMDOPTNAME(L"Longitude"), &settings.longitude, L"Longitude", FALSE, -180.0, 180.0);
+            go.AddCommandOptionNumber(RHCMDOPTNAME(L"TimeZone"), &settings.timeZoneHours, L"Time zone offset from UTC", FALSE, -12.0, 14.0);
+
+            CRhinoGet::result res = go.GetOption();
+            if (res == CRhinoGet::option)
+                continue;
+            if (res == CRhinoGet::nothing)
+                break;
+            return CRhinoCommand::cancel;
+        }
+
+        if (!SunStudy::IsValidDate(settings))
+        {
+            RhinoApp().Print(L"Error: Month %d of %d has only %d days.\n", settings.month, settings.year,
+                SunStudy::DaysInMonth(settings.year, settings.month));
+            return CRhinoCommand::failure;
+        }
+        if (settings.endHour <= settings.startHour)
+        {
+            RhinoApp().Print(L"Error: End hour must be later than start hour.\n");
+            return CRhinoCommand::failure;
+        }
+
+        // Sample the day and keep only the keyframes Unreal needs
+        std::vector<SunStudy::Keyframe> samples = SunStudy::BuildKeyframes(settings);
+        std::vector<SunStudy::Keyframe> keyframes = SunStudy::SimplifyKeyframes(samples, settings);
+
+        std::string utf8Data = LightSyncNetwork::WStringToUTF8(
+            SunStudy::CreateSunStudyJSON(keyframes, settings, sunLight->Attributes().m_uuid));
+
+        RhinoApp().Print(L"Sun study: %d samples reduced to %d keyframes (%d bytes).\n",
+            static_cast<int>(samples.size()), static_cast<int>(keyframes.size()), static_cast<int>(utf8Data.size()));
+
+        // Written by the network thread so an absent Unreal listener does not block the UI
+        if (!LightSyncNetwork::SendPayload(std::move(utf8Data), LightSyncNetwork::DEFAULT_TCP_PORT))
+        {
+            RhinoApp().Print(L"Error: The network thread is not running.\n");
+            return CRhinoCommand::failure;
+        }
+
+        return CRhinoCommand::success;
+    }
+    catch (const std::exception&)
+    {
+        RhinoApp().Print(L"Error: An exception occurred during command execution.\n");
+        return CRhinoCommand::failure;
+    }
+    catch (...)
+    {
+        RhinoApp().Print(L"Error: An unknown exception occurred during command execution.\n");
+        return CRhinoCommand::failure;
+    }
+}
@@ -0,0 +1,31 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+#pragma once
+
+#include "stdafx.h"
+#include "rhinoSdkCommand.h"
+
+/**
+ * Rhino command that streams a daylight study for the directional sun.
+ * Samples the sun for the document's earth anchor location over a time range,
+ * reduces it to a keyframe curve and sends the curve to Unreal once so playback
+ * is interpolated locally instead of sending one light event per frame.
+ */
+class CCommandSyncSunStudy : public CRhinoCommand
+{
+public:
+    CCommandSyncSunStudy() = default;
+
+    UUID CommandUUID() override;
+    const wchar_t* EnglishCommandName() override;
+    CRhinoCommand::result RunCommand(const CRhinoCommandContext& context) override;
+};
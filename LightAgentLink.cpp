@@ -0,0 +1,229 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+
+#include "stdafx.h"
+#include "LightAgentLink.h"
+#include "Agent/LightAgentProtocol.h"
+#include "LightSyncStats.h"
+#include <algorithm>
+#include <cstring>
+#include <unordered_set>
+
+namespace {
+    LightAgentRing g_ring;
+    std::unordered_set<unsigned int> g_needsScene;
+
+    void CopyEventName(LightAgentProtocol::RecordHeader& header, const wchar_t* eventType)
+    {
+        // Event names are ASCII literals
+        size_t i = 0;
+        for (; eventType && eventType[i] != 0 && i + 1 < sizeof(header.eventName); ++i)
+        {
+            header.eventName[i] = static_cast<char>(eventType[i] & 0x7F);
+        }
+        memset(header.eventName + i, 0, sizeof(header.eventName) - i);
+    }
+
+    constexpr bool SameType(LightAgentProtocol::LightType agent, LightUtils::LightType plugin)
+    {
+        return static_cast<int>(agent) == static_cast<int>(plugin);
+    }
+
+    // The type is copied across as its value, so both enums must agree value for value
+    static_assert(SameType(LightAgentProtocol::LightType::Unknown, LightUtils::LightType::Unknown) &&
+        SameType(LightAgentProtocol::LightType::Directional, LightUtils::LightType::Directional) &&
+        SameType(LightAgentProtocol::LightType::Point, LightUtils::LightType::Point) &&
+        SameType(LightAgentProtocol::LightType::Spot, LightUtils::LightType::Spot) &&
+        SameType(LightAgentProtocol::LightType::Ambient, LightUtils::LightType::Ambient),
+        "LightAgentProtocol::LightType must match LightUtils::LightType");
+
+    void WriteLight(LightAgentProtocol::Light& out, const LightUtils::LightInfo& light)
+    {
+        static_assert(sizeof(out.id) == sizeof(ON_UUID), "agent light ids are ON_UUID bytes");
+        memcpy(out.id, &light.id, sizeof(out.id));
+        out.type = static_cast<uint8_t>(light.type);
+        out.enabled = light.enabled ? 1 : 0;
+        out.isSpotLight = light.isSpotLight ? 1 : 0;
+        out.color[0] = static_cast<uint8_t>(light.color.Red());
+        out.color[1] = static_cast<uint8_t>(light.color.Green());
+        out.color[2] = static_cast<uint8_t>(light.color.Blue());
+        out.reserved = 0;
+        out.dirtyFields = light.dirtyFields;
+        out.reserved2 = 0;
+        out.location[0] = light.location.x;
+        out.location[1] = light.location.y;
+        out.location[2] = light.location.z;
+        out.direction[0] = light.direction.x;
+        out.direction[1] = light.direction.y;
+        out.direction[2] = light.direction.z;
+        out.intensity = light.intensity;
+        out.innerAngle = light.innerAngle;
+        out.outerAngle = light.outerAngle;
+    }
+
+    /**
+     * @brief Writes one record of lightCount lights taken from lightAt
+     *
+     * @return False if the ring had no room (the document then needs a scene)
+     */
+    template <class LightAt>
+    bool PushRecord(LightAgentProtocol::RecordKind kind, unsigned int docSerial, const wchar_t* eventType,
+        uint32_t sceneLightCount, size_t lightCount, const LightAt& lightAt)
+    {
+        const size_t size = LightAgentProtocol::RecordSize(static_cast<uint32_t>(lightCount));
+        unsigned char* record = g_ring.BeginWrite(size);
+        if (!record)
+        {
+            g_needsScene.insert(docSerial);
+            LightSyncStats::Increment(LightSyncStats::Get().agentRecordsDropped);
+            return false;
+        }
+
+        LightAgentProtocol::RecordHeader header;
+        header.kind = static_cast<uint16_t>(kind);
+        header.reserved = 0;
+        header.document = docSerial;
+        header.lightCount = static_cast<uint32_t>(lightCount);
+        header.sceneLightCount = sceneLightCount;
+        CopyEventName(header, eventType);
+        memcpy(record, &header, sizeof(header));
+
+        LightAgentProtocol::Light* lights = reinterpret_cast<LightAgentProtocol::Light*>(record + sizeof(header));
+        for (size_t i = 0; i < lightCount; ++i)
+        {
+            WriteLight(lights[i], lightAt(i));
+        }
+
+        g_ring.EndWrite();
+        LightSyncStats::Increment(LightSyncStats::Get().agentRecords);
+        return true;
+    }
+
+    const LightUtils::LightInfo& NoLight(size_t)
+    {
+        static const LightUtils::LightInfo none;
+        return none;
+    }
+}
+
+/**
+ * @brief Creates the shared ring the agent reads from
+ *
+ * @param capacity Ring size in bytes
+ * @return False if the shared memory could not be created
+ */
+bool LightAgentLink::Start(size_t capacity)
+{
+    g_needsScene.clear();
+    return g_ring.Create(LightAgentRing::DEFAULT_NAME, capacity);
+}
+
+void LightAgentLink::Stop()
+{
+    g_ring.Close();
+    g_needsScene.clear();
+}
+
+bool LightAgentLink::IsActive()
+{
+    return g_ring.IsOpen();
+}
+
+/**
+ * @brief Pushes a document's complete scene
+ *
+ * The lights go out in records of MAX_LIGHTS_PER_RECORD between SceneBegin and
+ * SceneEnd. If any record is dropped the rest is skipped; the agent discards
+ * the unfinished scene when the next one begins.
+ *
+ * @param docSerial Document the scene belongs to
+ * @param eventType Event name for the receivers' messages
+ * @param snapshot The scene as last recorded by the document's change tracker
+ */
+void LightAgentLink::PushScene(unsigned int docSerial, const wchar_t* eventType, const LightSnapshot& snapshot)
+{
+    using LightAgentProtocol::RecordKind;
+    const size_t lightCount = snapshot.Count();
+
+    if (!PushRecord(RecordKind::SceneBegin, docSerial, eventType, static_cast<uint32_t>(lightCount), 0, NoLight))
+    {
+        return;
+    }
+
+    for (size_t begin = 0; begin < lightCount; begin += LightAgentProtocol::MAX_LIGHTS_PER_RECORD)
+    {
+        const size_t count = std::min(lightCount - begin, static_cast<size_t>(LightAgentProtocol::MAX_LIGHTS_PER_RECORD));
+        const auto lightAt = [&snapshot, begin](size_t index) -> const LightUtils::LightInfo& {
+            return snapshot.At(begin + index);
+        };
+        if (!PushRecord(RecordKind::Lights, docSerial, eventType, 0, count, lightAt))
+        {
+            return;
+        }
+    }
+
+    if (PushRecord(RecordKind::SceneEnd, docSerial, eventType, 0, 0, NoLight))
+    {
+        g_needsScene.erase(docSerial);
+    }
+}
+
+void LightAgentLink::PushUpdate(unsigned int docSerial, const wchar_t* eventType,
+    const std::vector<LightUtils::LightInfo>& lights)
+{
+    for (size_t begin = 0; begin < lights.size(); begin += LightAgentProtocol::MAX_LIGHTS_PER_RECORD)
+    {
+        const size_t count = std::min(lights.size() - begin, static_cast<size_t>(LightAgentProtocol::MAX_LIGHTS_PER_RECORD));
+        const auto lightAt = [&lights, begin](size_t index) -> const LightUtils::LightInfo& {
+            return lights[begin + index];
+        };
+        if (!PushRecord(LightAgentProtocol::RecordKind::Update, docSerial, eventType, 0, count, lightAt))
+        {
+            return;
+        }
+    }
+}
+
+void LightAgentLink::PushDocumentClosed(unsigned int docSerial)
+{
+    g_needsScene.erase(docSerial);
+    if (!PushRecord(LightAgentProtocol::RecordKind::DocumentClosed, docSerial, L"", 0, 0, NoLight))
+    {
+        // Nothing to resend for a closed document
+        g_needsScene.erase(docSerial);
+    }
+}
+
+bool LightAgentLink::NeedsScene(unsigned int docSerial)
+{
+    return g_needsScene.find(docSerial) != g_needsScene.end();
+}
+
+bool LightAgentLink::GetAgentStats(AgentStats& stats)
+{
+    LightAgentRing::AgentCounters* counters = g_ring.Counters();
+    if (!counters)
+    {
+        return false;
+    }
+
+    stats.recordsRead = counters->recordsRead.load(std::memory_order_relaxed);
+    stats.messagesSent = counters->messagesSent.load(std::memory_order_relaxed);
+    stats.bytesSent = counters->bytesSent.load(std::memory_order_relaxed);
+    stats.sendFailures = counters->sendFailures.load(std::memory_order_relaxed);
+    stats.fileExports = counters->fileExports.load(std::memory_order_relaxed);
+    stats.dropped = g_ring.Dropped();
+    stats.usedBytes = g_ring.Used();
+    stats.capacityBytes = g_ring.Capacity();
+    return true;
+}
@@ -0,0 +1,70 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+
+#pragma once
+
+#include "stdafx.h"
+#include "LightSnapshot.h"
+#include "LightUtils.h"
+#include "Agent/LightAgentRing.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Hands light changes to the out-of-process sync agent
+ *
+ * While the link is active the plug-in does no encoding, sending or file
+ * export of its own: each event is written as compact binary records
+ * (Agent/LightAgentProtocol.h) straight into a shared-memory ring, and the
+ * LightSyncAgent process does the rest. A scene costs one record per
+ * MAX_LIGHTS_PER_RECORD lights plus two markers; a field update or live drag
+ * commit costs a single record.
+ *
+ * The ring never blocks Rhino. When it is full a record is dropped and the
+ * document is marked, so its next event pushes the complete scene again.
+ * All pushes happen on the UI thread, the ring's only producer.
+ */
+class LightAgentLink
+{
+public:
+    struct AgentStats
+    {
+        uint64_t recordsRead;
+        uint64_t messagesSent;
+        uint64_t bytesSent;
+        uint64_t sendFailures;
+        uint64_t fileExports;
+        uint64_t dropped;       // Records the ring had no room for
+        size_t usedBytes;
+        size_t capacityBytes;
+    };
+
+    static bool Start(size_t capacity = LightAgentRing::DEFAULT_CAPACITY);
+    static void Stop();
+    static bool IsActive();
+
+    // Complete scene of a document; positions in meters
+    static void PushScene(unsigned int docSerial, const wchar_t* eventType, const LightSnapshot& snapshot);
+
+    // Lights whose dirtyFields changed (FIELD_ALL for complete records)
+    static void PushUpdate(unsigned int docSerial, const wchar_t* eventType,
+        const std::vector<LightUtils::LightInfo>& lights);
+
+    static void PushDocumentClosed(unsigned int docSerial);
+
+    // True once a record of the document was dropped, until its scene went through again
+    static bool NeedsScene(unsigned int docSerial);
+
+    // Counters the agent keeps in the ring header; false while the link is off
+    static bool GetAgentStats(AgentStats& stats);
+};
@@ -0,0 +1,114 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Free list of reusable buffers (vectors, strings or structs of them)
+ *
+ * Acquire hands out a previously released buffer, empty but with its storage
+ * still allocated, so once every buffer has grown to the scene size the event
+ * pipeline stops allocating. Buffers are moved in and out, never copied. At most
+ * maxPooled buffers are kept; extra releases are simply freed. Buffer needs a
+ * clear() member that keeps capacity. Safe to use from any thread.
+ *
+ * A pool of std::shared_ptr<T> keeps the objects together with their control
+ * blocks, for buffers that send handlers keep alive: a miss creates the object,
+ * and a buffer released while other references remain is not pooled.
+ *
+ * Does not use the Rhino SDK, so the allocation test builds it on its own.
+ */
+template <class Buffer>
+class LightBufferPool
+{
+public:
+    // misses, if given, counts the buffers created because the pool was empty
+    explicit LightBufferPool(size_t maxPooled, std::atomic<uint64_t>* misses = nullptr)
+        : m_maxPooled(maxPooled), m_misses(misses)
+    {
+        m_buffers.reserve(maxPooled);
+    }
+
+    Buffer Acquire()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_buffers.empty())
+        {
+            if (m_misses != nullptr)
+            {
+                m_misses->fetch_add(1, std::memory_order_relaxed);
+            }
+            Buffer buffer = Buffer();
+            Create(buffer);
+            return buffer;
+        }
+
+        Buffer buffer = std::move(m_buffers.back());
+        m_buffers.pop_back();
+        return buffer;
+    }
+
+    void Release(Buffer&& buffer)
+    {
+        if (!Clear(buffer))
+        {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_buffers.size() < m_maxPooled)
+        {
+            m_buffers.push_back(std::move(buffer));
+        }
+    }
+
+private:
+    template <class T>
+    static void Create(T&) {}
+
+    template <class T>
+    static void Create(std::shared_ptr<T>& buffer)
+    {
+        buffer = std::make_shared<T>();
+    }
+
+    // Empties the buffer; false if it must not be pooled
+    template <class T>
+    static bool Clear(T& buffer)
+    {
+        buffer.clear();
+        return true;
+    }
+
+    // A shared buffer still referenced elsewhere is left to its other owners
+    template <class T>
+    static bool Clear(std::shared_ptr<T>& buffer)
+    {
+        if (!buffer || buffer.use_count() != 1)
+            return false;
+        buffer->clear();
+        return true;
+    }
+
+    std::mutex m_mutex;
+    std::vector<Buffer> m_buffers;
+    const size_t m_maxPooled;
+    std::atomic<uint64_t>* const m_misses;
+};
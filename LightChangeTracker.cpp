@@ -0,0 +1,441 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+#include "stdafx.h"
+#include "LightChangeTracker.h"
+#include "LightSchema.h"
+#include "LightSnapshotStore.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <utility>
+
+namespace {
+    constexpr uint64_t FNV_OFFSET_BASIS = 0xCBF29CE484222325ULL;
+    constexpr uint64_t FNV_PRIME = 0x100000001B3ULL;
+
+    // Versions are numbered across all trackers, so snapshots of different documents never share one
+    std::atomic<uint64_t> g_lastVersion(0);
+
+    // FNV-1a over raw bytes
+    void HashBytes(uint64_t& hash, const void* data, size_t size)
+    {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i)
+        {
+            hash ^= bytes[i];
+            hash *= FNV_PRIME;
+        }
+    }
+
+    void HashDouble(uint64_t& hash, double value)
+    {
+        // -0.0 and 0.0 are sent identically
+        if (value == 0.0)
+            value = 0.0;
+        HashBytes(hash, &value, sizeof(value));
+    }
+
+    void HashInt(uint64_t& hash, int value)
+    {
+        HashBytes(hash, &value, sizeof(value));
+    }
+
+    // Hash of each schema value type
+    void HashValue(uint64_t& hash, LightUtils::LightType type)
+    {
+        HashInt(hash, static_cast<int>(type));
+    }
+
+    void HashValue(uint64_t& hash, bool value)
+    {
+        HashInt(hash, value ? 1 : 0);
+    }
+
+    void HashValue(uint64_t& hash, const ON_3dPoint& point)
+    {
+        HashDouble(hash, point.x);
+        HashDouble(hash, point.y);
+        HashDouble(hash, point.z);
+    }
+
+    void HashValue(uint64_t& hash, const ON_3dVector& vector)
+    {
+        HashDouble(hash, vector.x);
+        HashDouble(hash, vector.y);
+        HashDouble(hash, vector.z);
+    }
+
+    void HashValue(uint64_t& hash, double value)
+    {
+        HashDouble(hash, value);
+    }
+
+    void HashValue(uint64_t& hash, const ON_Color& color)
+    {
+        HashInt(hash, color.Red());
+        HashInt(hash, color.Green());
+        HashInt(hash, color.Blue());
+    }
+
+    void HashValue(uint64_t& hash, const LightSchema::SpotAngles& angles)
+    {
+        HashInt(hash, angles.present ? 1 : 0);
+        if (angles.present)
+        {
+            HashDouble(hash, angles.inner);
+            HashDouble(hash, angles.outer);
+        }
+    }
+
+    // Final avalanche (splitmix64) so summed scene terms do not cancel out
+    uint64_t Mix(uint64_t value)
+    {
+        value ^= value >> 30;
+        value *= 0xBF58476D1CE4E5B9ULL;
+        value ^= value >> 27;
+        value *= 0x94D049BB133111EBULL;
+        value ^= value >> 31;
+        return value;
+    }
+}
+
+LightChangeTracker::LightChangeTracker(bool publishSnapshots)
+    : m_sceneHash(0), m_unitScale(1.0), m_initialized(false), m_publishSnapshots(publishSnapshots)
+{
+}
+
+/**
+ * @brief Hashes every field of a light that is transmitted to receivers
+ *
+ * @param light Light with position already converted to meters
+ * @return 64-bit content hash
+ */
+uint64_t LightChangeTracker::HashLight(const LightUtils::LightInfo& light)
+{
+    uint64_t hash = FNV_OFFSET_BASIS;
+
+    // Only enabled lights are tracked, so fields outside complete records are left out
+    LightSchema::ForEachField([&hash, &light](const auto& field) {
+        if (field.complete)
+        {
+            HashValue(hash, field.get(light));
+        }
+    });
+
+    return Mix(hash);
+}
+
+/**
+ * @brief Works out which transmitted fields of a light changed since it was sent
+ *
+ * @param light Light with position already converted to meters
+ * @param unitScale Unit scale the position was converted with
+ * @return Dirty mask of LightUtils::Field bits
+ */
+unsigned int LightChangeTracker::ChangedFields(const LightUtils::LightInfo& light, double unitScale) const
+{
+    if (!m_initialized || unitScale != m_unitScale)
+    {
+        return LightUtils::FIELD_ALL;
+    }
+
+    auto slot = m_slots.find(light.id);
+    if (slot == m_slots.end())
+    {
+        return light.enabled ? static_cast<unsigned int>(LightUtils::FIELD_ALL) : 0u;
+    }
+
+    // Only enabled lights are tracked
+    if (!light.enabled)
+    {
+        return LightUtils::FIELD_ENABLED;
+    }
+
+    if (m_lightHashes[slot->second] == HashLight(light))
+    {
+        return 0;
+    }
+
+    const LightUtils::LightInfo& sent = m_snapshot->At(slot->second);
+
+    unsigned int changed = 0;
+    bool reshaped = false;
+    LightSchema::ForEachField([&](const auto& field) {
+        if (!field.complete)
+        {
+            return;
+        }
+        const auto now = field.get(light);
+        const auto before = field.get(sent);
+        if (now != before)
+        {
+            changed |= field.bit;
+        }
+        if (LightSchema::IsPresent(now) != LightSchema::IsPresent(before))
+        {
+            reshaped = true;
+        }
+    });
+
+    // A new type or an optional field appearing or going away changes the record's shape
+    if (reshaped || (changed & LightUtils::FIELD_TYPE))
+    {
+        return LightUtils::FIELD_ALL;
+    }
+
+    return changed;
+}
+
+/**
+ * @brief Records the new state of a single light sent on its own
+ *
+ * Only the chunk holding the light is copied; the new version shares every
+ * other chunk with the previous one.
+ *
+ * @param light Light with position already converted to meters
+ */
+void LightChangeTracker::UpdateLight(const LightUtils::LightInfo& light)
+{
+    const uint64_t lightHash = HashLight(light);
+
+    const uint64_t version = NextVersion();
+
+    // The snapshot stands for the light's complete state, whatever was sent
+    LightUtils::LightInfo recorded = light;
+    recorded.dirtyFields = LightUtils::FIELD_ALL;
+    recorded.version = version;
+
+    std::vector<LightSnapshot::ChunkPtr> chunks;
+    size_t lightCount = 0;
+    if (m_snapshot)
+    {
+        chunks = m_snapshot->Chunks();
+        lightCount = m_snapshot->Count();
+    }
+
+    auto slot = m_slots.find(light.id);
+    if (slot != m_slots.end())
+    {
+        const size_t index = slot->second;
+        auto chunk = std::make_shared<LightSnapshot::Chunk>(*chunks[index / LightSnapshot::CHUNK_SIZE]);
+        (*chunk)[index % LightSnapshot::CHUNK_SIZE] = recorded;
+        chunks[index / LightSnapshot::CHUNK_SIZE] = chunk;
+
+        m_sceneHash -= SceneTerm(light.id, m_lightHashes[index]);
+        m_lightHashes[index] = lightHash;
+    }
+    else
+    {
+        if (lightCount % LightSnapshot::CHUNK_SIZE == 0)
+        {
+            chunks.push_back(LightSnapshot::MakeChunk(&recorded, 1));
+        }
+        else
+        {
+            auto chunk = std::make_shared<LightSnapshot::Chunk>(*chunks.back());
+            chunk->push_back(recorded);
+            chunks.back() = chunk;
+        }
+
+        m_slots.emplace(light.id, lightCount);
+        m_lightHashes.push_back(lightHash);
+        ++lightCount;
+    }
+    m_sceneHash += SceneTerm(light.id, lightHash);
+
+    Publish(std::move(chunks), lightCount, version);
+}
+
+/**
+ * @brief Removes a light, keeping the remaining lights in scene order
+ *
+ * Chunks before the removed light are shared; the rest are rebuilt.
+ *
+ * @param lightId Light to forget
+ */
+void LightChangeTracker::RemoveLight(const ON_UUID& lightId)
+{
+    auto slot = m_slots.find(lightId);
+    if (slot == m_slots.end() || !m_snapshot)
+    {
+        return;
+    }
+
+    const size_t index = slot->second;
+    const size_t firstRebuilt = index / LightSnapshot::CHUNK_SIZE;
+    const size_t tailStart = firstRebuilt * LightSnapshot::CHUNK_SIZE;
+    const size_t lightCount = m_snapshot->Count();
+
+    // Lights from the start of the removed light's chunk on, without the removed one
+    std::vector<LightUtils::LightInfo> tail;
+    tail.reserve(lightCount - tailStart);
+    for (size_t i = tailStart; i < lightCount; ++i)
+    {
+        if (i != index)
+        {
+            tail.push_back(m_snapshot->At(i));
+        }
+    }
+
+    std::vector<LightSnapshot::ChunkPtr> chunks(m_snapshot->Chunks().begin(),
+        m_snapshot->Chunks().begin() + firstRebuilt);
+    for (size_t begin = 0; begin < tail.size(); begin += LightSnapshot::CHUNK_SIZE)
+    {
+        const size_t remaining = tail.size() - begin;
+        chunks.push_back(LightSnapshot::MakeChunk(&tail[begin],
+            remaining < LightSnapshot::CHUNK_SIZE ? remaining : LightSnapshot::CHUNK_SIZE));
+    }
+
+    m_sceneHash -= SceneTerm(lightId, m_lightHashes[index]);
+    m_lightHashes.erase(m_lightHashes.begin() + index);
+    m_slots.erase(slot);
+    for (size_t i = index; i < lightCount - 1; ++i)
+    {
+        m_slots[tail[i - tailStart].id] = i;
+    }
+
+    Publish(std::move(chunks), lightCount - 1, NextVersion());
+}
+
+/**
+ * @brief Replaces the tracked state with the full active light set
+ *
+ * When the lights are the same ones in the same order, chunks whose lights all
+ * kept their hash are shared with the previous version, so an event that
+ * changed one light builds one new chunk. Lights that kept their hash keep the
+ * version that last changed them; the others get the new version.
+ *
+ * @param lights Active lights with positions in meters
+ * @param unitScale Unit scale the positions were converted with
+ * @return True if the scene differs from the previously recorded one
+ */
+bool LightChangeTracker::UpdateScene(const std::vector<LightUtils::LightInfo>& lights, double unitScale)
+{
+    const bool wasInitialized = m_initialized && unitScale == m_unitScale && m_snapshot;
+
+    // The id map only has to be rebuilt when lights were added, removed or reordered
+    bool sameOrder = wasInitialized && m_snapshot->Count() == lights.size();
+    for (size_t i = 0; sameOrder && i < lights.size(); ++i)
+    {
+        sameOrder = (m_snapshot->At(i).id == lights[i].id);
+    }
+
+    // A reordered scene finds its lights' previous hashes and versions through the old id map
+    std::unordered_map<ON_UUID, size_t, LightUtils::UuidHash> previousSlots;
+    std::vector<uint64_t> previousHashes;
+    if (!sameOrder)
+    {
+        if (wasInitialized)
+        {
+            previousSlots.swap(m_slots);
+            previousHashes.swap(m_lightHashes);
+        }
+        m_slots.clear();
+        m_slots.reserve(lights.size());
+    }
+    m_lightHashes.resize(lights.size());
+
+    // Claimed by the first chunk that has to be rebuilt
+    uint64_t version = 0;
+
+    const size_t chunkCount = (lights.size() + LightSnapshot::CHUNK_SIZE - 1) / LightSnapshot::CHUNK_SIZE;
+    std::vector<LightSnapshot::ChunkPtr> chunks;
+    chunks.reserve(chunkCount);
+
+    bool changed = !sameOrder;
+    m_sceneHash = 0;
+    for (size_t chunkIndex = 0; chunkIndex < chunkCount; ++chunkIndex)
+    {
+        const size_t begin = chunkIndex * LightSnapshot::CHUNK_SIZE;
+        const size_t end = std::min(lights.size(), begin + static_cast<size_t>(LightSnapshot::CHUNK_SIZE));
+
+        bool chunkChanged = !sameOrder;
+        uint64_t sentHashes[LightSnapshot::CHUNK_SIZE];
+        for (size_t i = begin; i < end; ++i)
+        {
+            const uint64_t lightHash = HashLight(lights[i]);
+            sentHashes[i - begin] = sameOrder ? m_lightHashes[i] : 0;
+            if (sameOrder && lightHash != m_lightHashes[i])
+            {
+                chunkChanged = true;
+            }
+            m_lightHashes[i] = lightHash;
+            if (!sameOrder)
+            {
+                m_slots[lights[i].id] = i;
+            }
+            m_sceneHash += SceneTerm(lights[i].id, lightHash);
+        }
+
+        if (!chunkChanged)
+        {
+            chunks.push_back(m_snapshot->Chunks()[chunkIndex]);
+            continue;
+        }
+
+        if (version == 0)
+        {
+            version = NextVersion();
+        }
+        auto chunk = std::make_shared<LightSnapshot::Chunk>(lights.begin() + begin, lights.begin() + end);
+        for (size_t i = begin; i < end; ++i)
+        {
+            LightUtils::LightInfo& light = (*chunk)[i - begin];
+            light.dirtyFields = LightUtils::FIELD_ALL;
+            light.version = version;
+            if (sameOrder)
+            {
+                if (sentHashes[i - begin] == m_lightHashes[i])
+                    light.version = m_snapshot->At(i).version;
+                continue;
+            }
+            auto previous = previousSlots.find(light.id);
+            if (previous != previousSlots.end() && previousHashes[previous->second] == m_lightHashes[i])
+            {
+                light.version = m_snapshot->At(previous->second).version;
+            }
+        }
+        chunks.push_back(chunk);
+        changed = true;
+    }
+
+    m_unitScale = unitScale;
+    m_initialized = true;
+
+    if (changed)
+    {
+        // An empty scene rebuilt no chunk
+        Publish(std::move(chunks), lights.size(), version != 0 ? version : NextVersion());
+    }
+    return changed;
+}
+
+uint64_t LightChangeTracker::NextVersion()
+{
+    return ++g_lastVersion;
+}
+
+void LightChangeTracker::Publish(std::vector<LightSnapshot::ChunkPtr> chunks, size_t lightCount, uint64_t version)
+{
+    std::atomic_store(&m_snapshot,
+        std::make_shared<const LightSnapshot>(version, m_unitScale, std::move(chunks), lightCount));
+    if (m_publishSnapshots)
+    {
+        LightSnapshotStore::Publish(m_snapshot);
+    }
+}
+
+uint64_t LightChangeTracker::SceneTerm(const ON_UUID& lightId, uint64_t lightHash)
+{
+    return Mix(static_cast<uint64_t>(LightUtils::UuidHash()(lightId)) ^ lightHash);
+}
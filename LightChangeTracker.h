@@ -0,0 +1,78 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+#pragma once
+
+#include "stdafx.h"
+#include "LightSnapshot.h"
+#include "LightUtils.h"
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Remembers what was last transmitted for every light
+ *
+ * Each light's transmitted fields (after unit conversion) are kept per UUID
+ * together with a hash of them. The state itself lives in immutable snapshots:
+ * every recorded change produces a new LightSnapshot version, which is also
+ * published to LightSnapshotStore for the other consumers. The scene hash is an order-independent sum of
+ * per-light terms, so a single light can be swapped in or out without rehashing
+ * the scene. Comparing an incoming light against its snapshot yields a dirty
+ * mask of LightUtils::Field bits, so an edit can be sent as just those fields.
+ * Every light in a snapshot carries the version that last changed it.
+ */
+class LightChangeTracker
+{
+public:
+    // A private tracker (event replay) keeps its snapshots out of LightSnapshotStore
+    explicit LightChangeTracker(bool publishSnapshots = true);
+
+    // Hash over the fields sent to receivers
+    static uint64_t HashLight(const LightUtils::LightInfo& light);
+
+    // Fields that differ from what was last sent: 0 if nothing, FIELD_ALL if the light
+    // is new or the unit scale changed. A switched-off light that was never sent is 0.
+    unsigned int ChangedFields(const LightUtils::LightInfo& light, double unitScale) const;
+
+    // Records a single light that is being sent on its own (publishes a new version)
+    void UpdateLight(const LightUtils::LightInfo& light);
+
+    // Forgets a light that receivers were told to drop (publishes a new version)
+    void RemoveLight(const ON_UUID& lightId);
+
+    // Records the full active light set; returns false (and publishes nothing) if nothing transmitted changed
+    bool UpdateScene(const std::vector<LightUtils::LightInfo>& lights, double unitScale);
+
+    // Last transmitted state of every tracked light, in scene order (null before the first event)
+    const LightSnapshot::Ptr& Snapshot() const { return m_snapshot; }
+
+    // Same snapshot for readers on other threads (queries)
+    LightSnapshot::Ptr SharedSnapshot() const { return std::atomic_load(&m_snapshot); }
+
+    uint64_t SceneHash() const { return m_sceneHash; }
+    size_t TrackedLightCount() const { return m_lightHashes.size(); }
+
+private:
+    static uint64_t SceneTerm(const ON_UUID& lightId, uint64_t lightHash);
+    static uint64_t NextVersion();
+    void Publish(std::vector<LightSnapshot::ChunkPtr> chunks, size_t lightCount, uint64_t version);
+
+    LightSnapshot::Ptr m_snapshot;
+    std::vector<uint64_t> m_lightHashes;  // In snapshot order
+    std::unordered_map<ON_UUID, size_t, LightUtils::UuidHash> m_slots;
+    uint64_t m_sceneHash;
+    double m_unitScale;
+    bool m_initialized;
+    bool m_publishSnapshots;
+};
@@ -0,0 +1,481 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+
+#include "stdafx.h"
+#include "LightDocumentPipeline.h"
+#include "LightAgentLink.h"
+#include "LightEventWatcher.h"
+#include "LightQuantizedEncoder.h"
+#include "LightSyncBuffers.h"
+#include "LightSyncReactor.h"
+#include "LightSyncStats.h"
+#include "LiveDragStreamer.h"
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+    // Keyed by document runtime serial number
+    std::mutex g_pipelinesMutex;
+    std::unordered_map<unsigned int, LightDocumentPipeline::Ptr> g_pipelines;
+
+    // Folds an older enter/leave list into a newer one that replaces it
+    void CarryMembership(const LightSyncSubscriptions::Delivery& older, LightSyncSubscriptions::Delivery& newer)
+    {
+        std::unordered_set<ON_UUID, LightUtils::UuidHash> enteredLater(newer.entered.begin(), newer.entered.end());
+        std::unordered_set<ON_UUID, LightUtils::UuidHash> leftLater(newer.left.begin(), newer.left.end());
+
+        // Entered then left again cancels out, and the other way round
+        for (const ON_UUID& lightId : older.entered)
+        {
+            if (leftLater.find(lightId) == leftLater.end() && enteredLater.insert(lightId).second)
+                newer.entered.push_back(lightId);
+        }
+        for (const ON_UUID& lightId : older.left)
+        {
+            if (enteredLater.find(lightId) == enteredLater.end() && leftLater.insert(lightId).second)
+                newer.left.push_back(lightId);
+        }
+    }
+}
+
+/**
+ * @brief Returns the document's pipeline, creating it on the first event
+ *
+ * A new pipeline also makes the document known to receivers under its name.
+ *
+ * @param doc Document raising the event
+ * @return Pipeline shared with the document's sends in flight
+ */
+LightDocumentPipeline::Ptr LightDocumentPipeline::ForDocument(CRhinoDoc& doc)
+{
+    const unsigned int docSerial = doc.RuntimeSerialNumber();
+    {
+        std::lock_guard<std::mutex> lock(g_pipelinesMutex);
+        auto existing = g_pipelines.find(docSerial);
+        if (existing != g_pipelines.end())
+        {
+            return existing->second;
+        }
+    }
+
+    Ptr pipeline = std::make_shared<LightDocumentPipeline>(docSerial);
+    {
+        std::lock_guard<std::mutex> lock(g_pipelinesMutex);
+        g_pipelines[docSerial] = pipeline;
+    }
+
+    ON_wString title;
+    doc.GetTitle(title);
+    LightSyncSubscriptions::AddDocument(docSerial, std::wstring(static_cast<const wchar_t*>(title)));
+    return pipeline;
+}
+
+void LightDocumentPipeline::Remove(unsigned int docSerial)
+{
+    Ptr pipeline;
+    {
+        std::lock_guard<std::mutex> lock(g_pipelinesMutex);
+        auto existing = g_pipelines.find(docSerial);
+        if (existing == g_pipelines.end())
+        {
+            return;
+        }
+        pipeline = std::move(existing->second);
+        g_pipelines.erase(existing);
+    }
+    pipeline->Close();
+}
+
+void LightDocumentPipeline::Shutdown()
+{
+    std::unordered_map<unsigned int, Ptr> pipelines;
+    {
+        std::lock_guard<std::mutex> lock(g_pipelinesMutex);
+        pipelines.swap(g_pipelines);
+    }
+    for (auto& entry : pipelines)
+    {
+        entry.second->Close();
+    }
+}
+
+size_t LightDocumentPipeline::Count()
+{
+    std::lock_guard<std::mutex> lock(g_pipelinesMutex);
+    return g_pipelines.size();
+}
+
+size_t LightDocumentPipeline::QueuedDeliveries()
+{
+    std::vector<Ptr> pipelines;
+    {
+        std::lock_guard<std::mutex> lock(g_pipelinesMutex);
+        for (const auto& entry : g_pipelines)
+        {
+            pipelines.push_back(entry.second);
+        }
+    }
+
+    size_t queued = 0;
+    for (const auto& pipeline : pipelines)
+    {
+        std::lock_guard<std::mutex> lock(pipeline->m_channelMutex);
+        for (const auto& port : pipeline->m_ports)
+        {
+            queued += port.second.queue.size();
+        }
+    }
+    return queued;
+}
+
+LightDocumentPipeline::Ptr LightDocumentPipeline::Find(unsigned int docSerial)
+{
+    std::lock_guard<std::mutex> lock(g_pipelinesMutex);
+    auto existing = g_pipelines.find(docSerial);
+    return existing != g_pipelines.end() ? existing->second : Ptr();
+}
+
+/**
+ * @brief Catches a (re)connecting receiver up with a document
+ *
+ * @param docSerial Document the receiver is bound to
+ * @param port Receiver port
+ * @param receiverVersion Last version the receiver applied from this document, -1 if none
+ * @return Control channel reply naming what is being sent
+ */
+std::string LightDocumentPipeline::Resume(unsigned int docSerial, int port, int64_t receiverVersion)
+{
+    if (LightAgentLink::IsActive())
+    {
+        return "{\"status\": \"error\", \"message\": \"the sync agent is sending; resume is not available\"}";
+    }
+
+    Ptr pipeline = Find(docSerial);
+    if (!pipeline)
+    {
+        return "{\"status\": \"ok\", \"resume\": \"none\"}";
+    }
+    return pipeline->ResumeReceiver(port, receiverVersion);
+}
+
+LightDocumentPipeline::LightDocumentPipeline(unsigned int docSerial)
+    : m_docSerial(docSerial), m_fragmentCache(&CLightEventWatcher::EncodeLightRecord), m_closed(false)
+{
+}
+
+/**
+ * @brief Returns the state queries are answered from
+ *
+ * That is the change tracker's last snapshot; before the first event it is the
+ * keyframe the document was seeded with when it was opened.
+ *
+ * @return Snapshot, or null if the document has not recorded any lights yet
+ */
+LightSnapshot::Ptr LightDocumentPipeline::LatestSnapshot() const
+{
+    LightSnapshot::Ptr snapshot = m_changeTracker.SharedSnapshot();
+    return snapshot ? snapshot : m_resumeLog.Keyframe();
+}
+
+/**
+ * @brief Queues deliveries on the document's channel
+ *
+ * A full delivery supersedes everything still waiting for its port, and a
+ * failing port drops its oldest deliveries past MAX_BACKLOG_WHILE_FAILING.
+ * Ports that were idle start sending on the network thread, until their queue
+ * is empty. Each delivery is stamped with the current transform sequence, so
+ * receivers drop live drag samples taken before it.
+ *
+ * @param deliveries Deliveries resolved for this document, moved into the queue
+ * @param eventType Event name written into each message (string literal)
+ */
+void LightDocumentPipeline::Send(std::vector<LightSyncSubscriptions::Delivery>&& deliveries,
+    const wchar_t* eventType)
+{
+    std::vector<Queued> dropped;
+    size_t backlogDrops = 0;
+    const uint64_t transformSequence = LiveDragStreamer::TransformSequence();
+    {
+        std::lock_guard<std::mutex> lock(m_channelMutex);
+        for (auto& delivery : deliveries)
+        {
+            delivery.transformSequence = transformSequence;
+            if (m_closed)
+            {
+                dropped.push_back({ std::move(delivery), eventType });
+                continue;
+            }
+
+            Port& port = m_ports[delivery.port];
+            if (!delivery.partial)
+            {
+                Supersede(port, delivery, dropped);
+            }
+
+            const int portNumber = delivery.port;
+            port.queue.push_back({ std::move(delivery), eventType });
+            if (port.failures > 0 && port.queue.size() > MAX_BACKLOG_WHILE_FAILING)
+            {
+                dropped.push_back(std::move(port.queue.front()));
+                port.queue.pop_front();
+                ++backlogDrops;
+            }
+
+            // Started from here, so an event does not need a list of idle ports; SendNext waits for this lock
+            if (!port.draining)
+            {
+                Ptr pipeline = shared_from_this();
+                port.draining = LightSyncReactor::Post([pipeline, portNumber]() { pipeline->SendNext(portNumber); });
+            }
+        }
+    }
+
+    // The emptied list goes back to its pool for the next event
+    LightSyncBuffers::Deliveries().Release(std::move(deliveries));
+
+    // Superseded lights go back to the pool outside the channel lock
+    if (!dropped.empty())
+    {
+        LightSyncStats::Increment(LightSyncStats::Get().coalescedDeliveries, dropped.size() - backlogDrops);
+        LightSyncStats::Increment(LightSyncStats::Get().backlogDrops, backlogDrops);
+        for (auto& queued : dropped)
+        {
+            CLightEventWatcher::ReleaseDeliveryLights(queued.delivery);
+        }
+    }
+}
+
+/**
+ * @brief Queues what a receiver is missing from the resume log
+ *
+ * The keyframe's lights are encoded once, outside the publishing lock, and the
+ * encoding is shared by later resumes of the same keyframe. The keyframe goes
+ * out as a new scene, the merged deltas as one partial message after it. The
+ * deltas name their lights by id, since quantized scene handles are forgotten
+ * for a resuming receiver.
+ *
+ * @param port Receiver port
+ * @param receiverVersion Last version the receiver applied, -1 if none
+ * @return Control channel reply
+ */
+std::string LightDocumentPipeline::ResumeReceiver(int port, int64_t receiverVersion)
+{
+    // A resuming receiver may be a new decoder that never saw the scene the handles point into
+    LightQuantizedEncoder::ForgetReceiver(port);
+
+    const LightSnapshot::Ptr keyframe = m_resumeLog.Keyframe();
+    if (!keyframe)
+    {
+        return "{\"status\": \"ok\", \"resume\": \"none\"}";
+    }
+
+    std::shared_ptr<const std::string> keyframeBody = m_resumeLog.KeyframeBody(keyframe);
+    if (!keyframeBody)
+    {
+        keyframeBody = std::make_shared<const std::string>(CLightEventWatcher::EncodeLightRecords(keyframe, m_fragmentCache));
+        m_resumeLog.CacheKeyframeBody(keyframe, keyframeBody);
+    }
+
+    std::lock_guard<std::mutex> publishing(m_publishingMutex);
+
+    LightResumeLog::Plan plan;
+    if (!m_resumeLog.PlanResume(receiverVersion, plan))
+    {
+        return "{\"status\": \"ok\", \"resume\": \"none\"}";
+    }
+
+    std::vector<LightSyncSubscriptions::Delivery> deliveries;
+    if (plan.keyframe)
+    {
+        LightSyncSubscriptions::Delivery delivery;
+        delivery.port = port;
+        delivery.document = m_docSerial;
+        delivery.version = plan.keyframe->Version();
+        delivery.snapshot = plan.keyframe;
+        if (plan.keyframe == keyframe)
+        {
+            delivery.encodedLights = keyframeBody;
+        }
+        if (!LightSyncSubscriptions::ClaimSequence(port, m_docSerial, true, delivery))
+        {
+            return "{\"status\": \"error\", \"message\": \"port is not bound to the document\"}";
+        }
+        deliveries.push_back(std::move(delivery));
+    }
+    if (!plan.deltas.empty())
+    {
+        LightSyncSubscriptions::Delivery delivery;
+        delivery.port = port;
+        delivery.document = m_docSerial;
+        delivery.version = plan.version;
+        delivery.partial = true;
+        delivery.namedById = true;
+        if (!LightSyncSubscriptions::ClaimSequence(port, m_docSerial, false, delivery))
+        {
+            return "{\"status\": \"error\", \"message\": \"port is not bound to the document\"}";
+        }
+        delivery.lights = LightSyncBuffers::Lights().Acquire();
+        delivery.lights.assign(plan.deltas.begin(), plan.deltas.end());
+        deliveries.push_back(std::move(delivery));
+    }
+
+    const char* resumed = plan.keyframe ? "keyframe" : (plan.deltas.empty() ? "current" : "deltas");
+    if (plan.keyframe)
+        LightSyncStats::Increment(LightSyncStats::Get().resumeKeyframes);
+    else if (!plan.deltas.empty())
+        LightSyncStats::Increment(LightSyncStats::Get().resumeDeltas);
+    else
+        LightSyncStats::Increment(LightSyncStats::Get().resumeCurrent);
+
+    std::string reply = "{\"status\": \"ok\", \"resume\": \"";
+    reply += resumed;
+    reply += "\", \"document\": " + std::to_string(m_docSerial);
+    reply += ", \"version\": " + std::to_string(plan.version);
+    reply += ", \"deltas\": " + std::to_string(plan.deltas.size()) + "}";
+
+    Send(std::move(deliveries), L"Light Resume");
+    return reply;
+}
+
+/**
+ * @brief Stops the channel and discards the deliveries still queued
+ *
+ * Messages being sent right now are finished by the network thread.
+ */
+void LightDocumentPipeline::Close()
+{
+    std::vector<Queued> dropped;
+    {
+        std::lock_guard<std::mutex> lock(m_channelMutex);
+        m_closed = true;
+        for (auto& entry : m_ports)
+        {
+            for (auto& queued : entry.second.queue)
+            {
+                dropped.push_back(std::move(queued));
+            }
+            entry.second.queue.clear();
+        }
+    }
+
+    for (auto& queued : dropped)
+    {
+        CLightEventWatcher::ReleaseDeliveryLights(queued.delivery);
+    }
+}
+
+/**
+ * @brief Starts sending the oldest delivery queued for a port
+ *
+ * Runs on the network thread; Delivered calls it again once the message (or
+ * the last batch of a trickle) was sent, until the queue is empty.
+ *
+ * @param port Receiver port to send to
+ */
+void LightDocumentPipeline::SendNext(int port)
+{
+    Queued next;
+    {
+        std::lock_guard<std::mutex> lock(m_channelMutex);
+        Port& queue = m_ports[port];
+        if (queue.queue.empty())
+        {
+            queue.draining = false;
+            return;
+        }
+        next = std::move(queue.queue.front());
+        queue.queue.pop_front();
+    }
+
+    Ptr pipeline = shared_from_this();
+    CLightEventWatcher::SendDelivery(pipeline, next.delivery, next.eventType, [pipeline, port](bool sent)
+    {
+        pipeline->Delivered(port, sent);
+    });
+}
+
+/**
+ * @brief Continues a port's queue after a delivery was sent or failed
+ *
+ * After a failure the port pauses before its next attempt: BACKOFF_INITIAL_MS,
+ * doubled on every further failure up to BACKOFF_MAX_MS. The port counts as
+ * draining during the pause, so new deliveries only queue (and supersede).
+ *
+ * @param port Receiver port of the delivery
+ * @param sent Whether the receiver got the whole delivery
+ */
+void LightDocumentPipeline::Delivered(int port, bool sent)
+{
+    unsigned int failures = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_channelMutex);
+        Port& queue = m_ports[port];
+        queue.failures = sent ? 0 : queue.failures + 1;
+        failures = queue.failures;
+    }
+
+    if (sent)
+    {
+        SendNext(port);
+        return;
+    }
+
+    const int backoffMs = std::min(BACKOFF_MAX_MS, BACKOFF_INITIAL_MS << std::min(failures - 1, 6u));
+    LightSyncStats::Increment(LightSyncStats::Get().sendBackoffs);
+
+    Ptr pipeline = shared_from_this();
+    if (LightSyncReactor::AddTimer(std::chrono::milliseconds(backoffMs), [pipeline, port]() { pipeline->SendNext(port); }) == 0)
+    {
+        // The network thread is stopping; Close releases what is queued
+        std::lock_guard<std::mutex> lock(m_channelMutex);
+        m_ports[port].draining = false;
+    }
+}
+
+/**
+ * @brief Drops the deliveries a full scene makes obsolete
+ *
+ * Called with the channel lock held. Waiting scenes and partial updates for the
+ * port are replaced by newer; the enter/leave lists of replaced region-scoped
+ * scenes are folded into it so the receiver still hears about every light
+ * that left its regions.
+ *
+ * @param port Queue of the delivery's port
+ * @param newer Full delivery about to be queued
+ * @param dropped Receives the superseded deliveries
+ */
+void LightDocumentPipeline::Supersede(Port& port, LightSyncSubscriptions::Delivery& newer,
+    std::vector<Queued>& dropped)
+{
+    if (port.queue.empty())
+    {
+        return;
+    }
+
+    // Fold the waiting scenes oldest first, then into the newer delivery
+    LightSyncSubscriptions::Delivery membership;
+    for (auto& queued : port.queue)
+    {
+        if (newer.regionScoped && queued.delivery.regionScoped && !queued.delivery.partial)
+        {
+            CarryMembership(membership, queued.delivery);
+            membership.entered.swap(queued.delivery.entered);
+            membership.left.swap(queued.delivery.left);
+        }
+        dropped.push_back(std::move(queued));
+    }
+    port.queue.clear();
+
+    CarryMembership(membership, newer);
+}
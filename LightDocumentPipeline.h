@@ -0,0 +1,146 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+
+#pragma once
+
+#include "stdafx.h"
+#include "LightChangeTracker.h"
+#include "LightFragmentCache.h"
+#include "LightResumeLog.h"
+#include "LightSyncSubscriptions.h"
+#include "LightUtils.h"
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Sync state and sender channel of one open document
+ *
+ * Every document that raises light events gets its own pipeline: the change
+ * tracker mirroring what its receivers were sent, the scene buffer, the
+ * fragment cache and a sender channel. Nothing is shared between pipelines,
+ * so an event in one document never invalidates another document's state.
+ *
+ * The channel queues deliveries per receiver port and sends each port's queue
+ * in order from the network thread (LightSyncReactor), one message in flight
+ * per port, so a slow receiver or a prioritized trickle never holds up another
+ * receiver or document. A full scene queued for a port supersedes the
+ * deliveries still waiting for that port, since the receiver would replace them
+ * anyway; region enter/leave lists of superseded scenes are carried over.
+ *
+ * A port whose send failed backs off before its next delivery, doubling the
+ * pause on every further failure, and keeps at most MAX_BACKLOG_WHILE_FAILING
+ * deliveries waiting; the oldest are dropped, and the receiver catches up by
+ * resuming once it is back.
+ *
+ * The resume log keeps the last scene and the partial updates since, so a
+ * receiver that (re)connects can be caught up from the network thread without
+ * reading the document. Recording a change, claiming its sequence numbers and
+ * queueing it happen under the publishing lock, which a resume holds too, so a
+ * resume and an event never overtake each other on a port.
+ *
+ * Pipelines are created and removed on the UI thread. Sends and backoff timers
+ * hold a reference to theirs, so a closed document's pipeline lives until they finish.
+ */
+class LightDocumentPipeline : public std::enable_shared_from_this<LightDocumentPipeline>
+{
+public:
+    typedef std::shared_ptr<LightDocumentPipeline> Ptr;
+
+    // Pipeline of the document, created on first use (UI thread)
+    static Ptr ForDocument(CRhinoDoc& doc);
+
+    // Drops a closing document's pipeline; deliveries still queued are discarded
+    static void Remove(unsigned int docSerial);
+
+    // Drops every pipeline (plug-in unload)
+    static void Shutdown();
+
+    // Number of open pipelines
+    static size_t Count();
+
+    // Deliveries waiting in every pipeline's channel (any thread)
+    static size_t QueuedDeliveries();
+
+    // Pipeline of an open document, or null (any thread)
+    static Ptr Find(unsigned int docSerial);
+
+    // Catches a receiver of the document up from the resume log (network thread); returns the reply
+    static std::string Resume(unsigned int docSerial, int port, int64_t receiverVersion);
+
+    explicit LightDocumentPipeline(unsigned int docSerial);
+
+    unsigned int DocumentSerial() const { return m_docSerial; }
+
+    // What this document's receivers were last sent (UI thread only)
+    LightChangeTracker& ChangeTracker() { return m_changeTracker; }
+
+    // Active lights of the current event, reused across events (UI thread only)
+    std::vector<LightUtils::LightInfo>& SceneLights() { return m_sceneLights; }
+
+    // Encoded light records of this document (any thread)
+    LightFragmentCache& FragmentCache() { return m_fragmentCache; }
+
+    // Last scene and partial updates since, for resuming receivers (any thread)
+    LightResumeLog& ResumeLog() { return m_resumeLog; }
+
+    // Newest state of the document's lights, null if none was recorded yet (any thread)
+    LightSnapshot::Ptr LatestSnapshot() const;
+
+    // Held while a change is recorded in the resume log, resolved and queued
+    std::mutex& PublishingMutex() { return m_publishingMutex; }
+
+    // Queues deliveries on the channel, superseding those they replace, and starts idle ports
+    void Send(std::vector<LightSyncSubscriptions::Delivery>&& deliveries, const wchar_t* eventType);
+
+    // Constants
+    static constexpr int BACKOFF_INITIAL_MS = 100;         // Pause after a port's first failed send
+    static constexpr int BACKOFF_MAX_MS = 5000;            // Longest pause between attempts
+    static constexpr size_t MAX_BACKLOG_WHILE_FAILING = 32;  // Deliveries kept for a failing port
+
+private:
+    struct Queued
+    {
+        LightSyncSubscriptions::Delivery delivery;
+        const wchar_t* eventType;
+    };
+
+    struct Port
+    {
+        std::deque<Queued> queue;
+        bool draining;          // A send or backoff is in progress
+        unsigned int failures;  // Consecutive failed sends
+
+        Port() : draining(false), failures(0) {}
+    };
+
+    std::string ResumeReceiver(int port, int64_t receiverVersion);
+    void Close();
+    void SendNext(int port);
+    void Delivered(int port, bool sent);
+    static void Supersede(Port& port, LightSyncSubscriptions::Delivery& newer, std::vector<Queued>& dropped);
+
+    const unsigned int m_docSerial;
+    LightChangeTracker m_changeTracker;
+    std::vector<LightUtils::LightInfo> m_sceneLights;
+    LightFragmentCache m_fragmentCache;
+    LightResumeLog m_resumeLog;
+    std::mutex m_publishingMutex;
+
+    std::mutex m_channelMutex;
+    std::map<int, Port> m_ports;
+    bool m_closed;
+};
@@ -0,0 +1,392 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+#include "stdafx.h"
+#include "LightEventJournal.h"
+#include "LightSyncStats.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <unordered_set>
+
+const std::wstring LightEventJournal::DEFAULT_JOURNAL_PATH = L"C:/ProgramData/RhinoLightSync/Journal.lsj";
+
+namespace {
+    const char JOURNAL_MAGIC[4] = { 'L', 'S', 'J', '1' };
+    constexpr uint32_t JOURNAL_VERSION = 2;  // 2: document serial in every record
+    constexpr size_t HEADER_SIZE = sizeof(JOURNAL_MAGIC) + sizeof(uint32_t);
+
+    // Record flags
+    constexpr unsigned char HAS_LIGHT = 1 << 0;
+    constexpr unsigned char LIGHT_ENABLED = 1 << 1;
+    constexpr unsigned char LIGHT_SPOT = 1 << 2;
+
+    // event, flags, type, reserved, time, document serial, id, unit scale
+    constexpr size_t RECORD_FIXED_SIZE = 4 + sizeof(uint64_t) + sizeof(uint32_t) + sizeof(ON_UUID) + sizeof(double);
+    // location, direction, intensity, inner and outer angle, rgb
+    constexpr size_t RECORD_LIGHT_SIZE = 9 * sizeof(double) + 3;
+
+    constexpr size_t WRITE_BUFFER_SIZE = 64 * 1024;
+
+    std::mutex g_journalMutex;
+    FILE* g_file = nullptr;
+    std::wstring g_path;
+    size_t g_maxBytes = 0;
+    size_t g_fileBytes = 0;
+    std::unordered_set<unsigned int> g_baselineDocs;  // Documents whose baseline is in the current file
+    std::chrono::steady_clock::time_point g_start;
+    std::string g_record;
+
+    template <class T>
+    void Append(std::string& out, const T& value)
+    {
+        out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    template <class T>
+    bool Take(const unsigned char*& pos, const unsigned char* end, T& value)
+    {
+        if (static_cast<size_t>(end - pos) < sizeof(value))
+            return false;
+        memcpy(&value, pos, sizeof(value));
+        pos += sizeof(value);
+        return true;
+    }
+
+    uint64_t ElapsedMicroseconds()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - g_start).count());
+    }
+
+    void EncodeRecord(std::string& out, unsigned char event, uint64_t time, uint32_t docSerial, const ON_UUID& lightId,
+        double unitScale, const CRhinoLight* rhinoLight)
+    {
+        LightUtils::LightInfo light;
+        if (rhinoLight)
+        {
+            light = LightUtils::MakeLightInfo(*rhinoLight);
+        }
+
+        unsigned char flags = 0;
+        if (rhinoLight)
+            flags |= HAS_LIGHT;
+        if (light.enabled)
+            flags |= LIGHT_ENABLED;
+        if (light.isSpotLight)
+            flags |= LIGHT_SPOT;
+
+        out.clear();
+        out += static_cast<char>(event);
+        out += static_cast<char>(flags);
+        out += static_cast<char>(light.type);
+        out += '\0';
+        Append(out, time);
+        Append(out, docSerial);
+        Append(out, lightId);
+        Append(out, unitScale);
+        if (!rhinoLight)
+            return;
+
+        Append(out, light.location.x);
+        Append(out, light.location.y);
+        Append(out, light.location.z);
+        Append(out, light.direction.x);
+        Append(out, light.direction.y);
+        Append(out, light.direction.z);
+        Append(out, light.intensity);
+        Append(out, light.innerAngle);
+        Append(out, light.outerAngle);
+        out += static_cast<char>(light.color.Red());
+        out += static_cast<char>(light.color.Green());
+        out += static_cast<char>(light.color.Blue());
+    }
+
+    bool WriteBytes(const char* data, size_t size)
+    {
+        if (!g_file || fwrite(data, 1, size, g_file) != size)
+            return false;
+        g_fileBytes += size;
+        return true;
+    }
+
+    bool WriteHeader(FILE* file)
+    {
+        char header[HEADER_SIZE];
+        memcpy(header, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC));
+        memcpy(header + sizeof(JOURNAL_MAGIC), &JOURNAL_VERSION, sizeof(JOURNAL_VERSION));
+        return fwrite(header, 1, sizeof(header), file) == sizeof(header);
+    }
+
+    // Opens a new journal file with its header; caller holds g_journalMutex
+    bool OpenFile()
+    {
+        if (!LightUtils::EnsureDirectoryExists(g_path))
+            return false;
+
+        g_file = _wfopen(g_path.c_str(), L"wb");
+        if (!g_file)
+            return false;
+        setvbuf(g_file, nullptr, _IOFBF, WRITE_BUFFER_SIZE);
+
+        g_baselineDocs.clear();
+        g_fileBytes = HEADER_SIZE;
+        return WriteHeader(g_file);
+    }
+
+    void CloseFile()
+    {
+        if (g_file)
+        {
+            fclose(g_file);
+            g_file = nullptr;
+        }
+    }
+
+    // Keeps the full file as "<path>.1" and starts an empty one; caller holds g_journalMutex
+    bool RotateFile()
+    {
+        CloseFile();
+        const std::wstring previous = g_path + L".1";
+        MoveFileExW(g_path.c_str(), previous.c_str(), MOVEFILE_REPLACE_EXISTING);
+        return OpenFile();
+    }
+
+    // One record per light in the document, so replay starts from the right scene
+    void WriteBaseline(CRhinoDoc& doc, double unitScale)
+    {
+        const uint32_t docSerial = doc.RuntimeSerialNumber();
+        ON_SimpleArray<const CRhinoLight*> lights;
+        doc.m_light_table.GetSortedList(lights);
+        for (int i = 0; i < lights.Count(); ++i)
+        {
+            if (lights[i]->IsDeleted())
+                continue;
+            EncodeRecord(g_record, LightEventJournal::BASELINE_EVENT, ElapsedMicroseconds(), docSerial,
+                lights[i]->Attributes().m_uuid, unitScale, lights[i]);
+            WriteBytes(g_record.data(), g_record.size());
+        }
+        g_baselineDocs.insert(docSerial);
+    }
+}
+
+/**
+ * @brief Starts recording to a new journal file, replacing an existing one
+ *
+ * @param path Journal file; the rotated file is path + ".1"
+ * @param maxBytes Size at which the file is rotated
+ * @return False if the file could not be created
+ */
+bool LightEventJournal::Start(const std::wstring& path, size_t maxBytes)
+{
+    std::lock_guard<std::mutex> lock(g_journalMutex);
+    CloseFile();
+
+    g_path = path;
+    g_maxBytes = maxBytes;
+    g_start = std::chrono::steady_clock::now();
+    if (!OpenFile())
+    {
+        CloseFile();
+        return false;
+    }
+    return true;
+}
+
+void LightEventJournal::Stop()
+{
+    std::lock_guard<std::mutex> lock(g_journalMutex);
+    CloseFile();
+}
+
+bool LightEventJournal::IsRecording()
+{
+    std::lock_guard<std::mutex> lock(g_journalMutex);
+    return g_file != nullptr;
+}
+
+std::wstring LightEventJournal::Path()
+{
+    std::lock_guard<std::mutex> lock(g_journalMutex);
+    return g_path;
+}
+
+void LightEventJournal::Flush()
+{
+    std::lock_guard<std::mutex> lock(g_journalMutex);
+    if (g_file)
+    {
+        fflush(g_file);
+    }
+}
+
+/**
+ * @brief Appends a light table event with the light's resulting state
+ *
+ * Writes the document's baseline first when the current file (new or rotated)
+ * has none for it yet.
+ *
+ * @param doc Document the event belongs to
+ * @param event Light table event
+ * @param light Affected light, or null for events without one
+ * @param unitScale Model units to meters
+ */
+void LightEventJournal::Record(CRhinoDoc& doc, CRhinoEventWatcher::light_event event, const CRhinoLight* light,
+    double unitScale)
+{
+    std::lock_guard<std::mutex> lock(g_journalMutex);
+    if (!g_file)
+    {
+        return;
+    }
+
+    const size_t recordSize = RECORD_FIXED_SIZE + (light ? RECORD_LIGHT_SIZE : 0);
+    if (g_fileBytes + recordSize > g_maxBytes && g_fileBytes > HEADER_SIZE && !RotateFile())
+    {
+        CloseFile();
+        return;
+    }
+    if (g_baselineDocs.count(doc.RuntimeSerialNumber()) == 0)
+    {
+        WriteBaseline(doc, unitScale);
+    }
+
+    EncodeRecord(g_record, static_cast<unsigned char>(event), ElapsedMicroseconds(), doc.RuntimeSerialNumber(),
+        light ? light->Attributes().m_uuid : ON_nil_uuid, unitScale, light);
+    if (WriteBytes(g_record.data(), g_record.size()))
+    {
+        LightSyncStats::Increment(LightSyncStats::Get().journalRecords);
+    }
+}
+
+/**
+ * @brief Writes a journal file that holds only a baseline of the given lights
+ *
+ * The result is a binary snapshot of a scene that Read takes like any journal. Lights are encoded one at a time through a stdio buffer,
+ * so nothing is collected first. Independent of the recording journal.
+ *
+ * @param path File to write (replaced if it exists)
+ * @param docSerial Runtime serial number of the document the lights belong to
+ * @param lightCount Number of lights
+ * @param lightAt Returns the light at an index in [0, lightCount)
+ * @param unitScale Model units to meters
+ * @return False if the file could not be written completely
+ */
+bool LightEventJournal::WriteSnapshot(const std::wstring& path, unsigned int docSerial, size_t lightCount,
+    const std::function<const CRhinoLight&(size_t)>& lightAt, double unitScale)
+{
+    if (!LightUtils::EnsureDirectoryExists(path))
+    {
+        return false;
+    }
+    FILE* file = _wfopen(path.c_str(), L"wb");
+    if (!file)
+    {
+        return false;
+    }
+    setvbuf(file, nullptr, _IOFBF, WRITE_BUFFER_SIZE);
+
+    bool written = WriteHeader(file);
+    std::string record;
+    for (size_t i = 0; written && i < lightCount; ++i)
+    {
+        const CRhinoLight& light = lightAt(i);
+        EncodeRecord(record, BASELINE_EVENT, 0, docSerial, light.Attributes().m_uuid, unitScale, &light);
+        written = fwrite(record.data(), 1, record.size(), file) == record.size();
+    }
+    return fclose(file) == 0 && written;
+}
+
+/**
+ * @brief Reads every record of a journal file
+ *
+ * @param path Journal file written by Record
+ * @param entries Receives the records in file order
+ * @return False if the file cannot be opened or is not a journal
+ */
+bool LightEventJournal::Read(const std::wstring& path, std::vector<Entry>& entries)
+{
+    entries.clear();
+
+    FILE* file = _wfopen(path.c_str(), L"rb");
+    if (!file)
+    {
+        return false;
+    }
+
+    std::vector<unsigned char> bytes;
+    if (fseek(file, 0, SEEK_END) == 0)
+    {
+        const long size = ftell(file);
+        if (size > 0 && fseek(file, 0, SEEK_SET) == 0)
+        {
+            bytes.resize(static_cast<size_t>(size));
+            bytes.resize(fread(bytes.data(), 1, bytes.size(), file));
+        }
+    }
+    fclose(file);
+
+    uint32_t version = 0;
+    if (bytes.size() < HEADER_SIZE || memcmp(bytes.data(), JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) != 0)
+    {
+        return false;
+    }
+    memcpy(&version, bytes.data() + sizeof(JOURNAL_MAGIC), sizeof(version));
+    if (version != JOURNAL_VERSION)
+    {
+        return false;
+    }
+
+    const unsigned char* pos = bytes.data() + HEADER_SIZE;
+    const unsigned char* end = bytes.data() + bytes.size();
+    entries.reserve((bytes.size() - HEADER_SIZE) / RECORD_FIXED_SIZE);
+    while (static_cast<size_t>(end - pos) >= RECORD_FIXED_SIZE)
+    {
+        Entry entry;
+        const unsigned char flags = pos[1];
+        entry.event = pos[0];
+        entry.light.type = static_cast<LightUtils::LightType>(pos[2]);
+        pos += 4;
+        uint32_t docSerial = 0;
+        Take(pos, end, entry.timeMicroseconds);
+        Take(pos, end, docSerial);
+        entry.docSerial = docSerial;
+        Take(pos, end, entry.lightId);
+        Take(pos, end, entry.unitScale);
+
+        entry.hasLight = (flags & HAS_LIGHT) != 0;
+        if (entry.hasLight)
+        {
+            if (static_cast<size_t>(end - pos) < RECORD_LIGHT_SIZE)
+                break;
+
+            LightUtils::LightInfo& light = entry.light;
+            light.id = entry.lightId;
+            light.enabled = (flags & LIGHT_ENABLED) != 0;
+            light.isSpotLight = (flags & LIGHT_SPOT) != 0;
+            Take(pos, end, light.location.x);
+            Take(pos, end, light.location.y);
+            Take(pos, end, light.location.z);
+            Take(pos, end, light.direction.x);
+            Take(pos, end, light.direction.y);
+            Take(pos, end, light.direction.z);
+            Take(pos, end, light.intensity);
+            Take(pos, end, light.innerAngle);
+            Take(pos, end, light.outerAngle);
+            light.color = ON_Color(pos[0], pos[1], pos[2]);
+            pos += 3;
+        }
+        entries.push_back(entry);
+    }
+    return true;
+}
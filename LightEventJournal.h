@@ -0,0 +1,76 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+
+#pragma once
+
+#include "stdafx.h"
+#include "LightUtils.h"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Optional binary journal of light table events for offline replay
+ *
+ * Each event is appended with its time, its document's runtime serial number,
+ * the light's id and the light's state after the event (model units), so a
+ * session can be fed back through the sync core later by LightEventReplay.
+ * Before the first event of a document in a file, that document's baseline is
+ * written: one record per light it holds. Events of several open documents
+ * share the file and replay picks one by its serial. When a file would grow
+ * past the size limit it is renamed to "<path>.1" (replacing the previous one)
+ * and a new file is started, which gets fresh baselines, so at most twice the
+ * limit is kept.
+ *
+ * Recording happens on the UI thread; writes go through a stdio buffer.
+ */
+class LightEventJournal
+{
+public:
+    static const std::wstring DEFAULT_JOURNAL_PATH;
+    static const size_t DEFAULT_MAX_BYTES = 64 * 1024 * 1024;
+
+    // Event code of the baseline records written ahead of a document's first event in a file
+    static const unsigned char BASELINE_EVENT = 0xFF;
+
+    struct Entry
+    {
+        unsigned char event;        // CRhinoEventWatcher::light_event, or BASELINE_EVENT
+        uint64_t timeMicroseconds;  // Since recording started
+        unsigned int docSerial;     // Runtime serial number of the document
+        ON_UUID lightId;            // Nil for events without a light (sorting)
+        double unitScale;           // Model units to meters when the event happened
+        bool hasLight;
+        LightUtils::LightInfo light;  // State after the event, position in model units
+    };
+
+    static bool Start(const std::wstring& path, size_t maxBytes);
+    static void Stop();
+    static bool IsRecording();
+    static std::wstring Path();
+
+    // Pushes buffered records to disk so the file can be read while recording
+    static void Flush();
+
+    // Appends one event (UI thread); light is null for events without one
+    static void Record(CRhinoDoc& doc, CRhinoEventWatcher::light_event event, const CRhinoLight* light,
+        double unitScale);
+
+    // Writes a file of baseline records only, i.e. a binary snapshot of the given lights
+    static bool WriteSnapshot(const std::wstring& path, unsigned int docSerial, size_t lightCount,
+        const std::function<const CRhinoLight&(size_t)>& lightAt, double unitScale);
+
+    // Reads a journal file; a record cut short at the end (crash while writing) is dropped
+    static bool Read(const std::wstring& path, std::vector<Entry>& entries);
+};
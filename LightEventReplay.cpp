@@ -0,0 +1,335 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+#include "stdafx.h"
+#include "LightEventReplay.h"
+#include "LightChangeTracker.h"
+#include "LightEventWatcher.h"
+#include "LightFragmentCache.h"
+#include "LightSyncBuffers.h"
+#include "Receiver/LightMirror.h"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <unordered_map>
+
+namespace {
+    typedef std::chrono::steady_clock Clock;
+
+    // Time spent in each stage by one event, added to the report once the event is done
+    class EventStages
+    {
+    public:
+        explicit EventStages(LightEventReplay::Report& report) : m_report(report)
+        {
+            for (int stage = 0; stage < LightEventReplay::STAGE_COUNT; ++stage)
+            {
+                m_micros[stage] = 0.0;
+                m_reached[stage] = false;
+            }
+        }
+
+        ~EventStages()
+        {
+            for (int stage = 0; stage < LightEventReplay::STAGE_COUNT; ++stage)
+            {
+                if (m_reached[stage])
+                    m_report.stageMicroseconds[stage].push_back(m_micros[stage]);
+            }
+        }
+
+        // Adds the time since start to the stage and returns the new start
+        Clock::time_point Add(LightEventReplay::Stage stage, Clock::time_point start)
+        {
+            const Clock::time_point now = Clock::now();
+            m_micros[stage] += std::chrono::duration<double, std::micro>(now - start).count();
+            m_reached[stage] = true;
+            return now;
+        }
+
+    private:
+        LightEventReplay::Report& m_report;
+        double m_micros[LightEventReplay::STAGE_COUNT];
+        bool m_reached[LightEventReplay::STAGE_COUNT];
+    };
+
+    // Document stand-in: lights in the order they appeared, position in model units
+    class ReplayScene
+    {
+    public:
+        void Clear()
+        {
+            m_lights.clear();
+            m_slots.clear();
+        }
+
+        void Upsert(const LightUtils::LightInfo& light)
+        {
+            auto slot = m_slots.find(light.id);
+            if (slot != m_slots.end())
+            {
+                m_lights[slot->second] = light;
+                return;
+            }
+            m_slots.emplace(light.id, m_lights.size());
+            m_lights.push_back(light);
+        }
+
+        void Remove(const ON_UUID& lightId)
+        {
+            auto slot = m_slots.find(lightId);
+            if (slot == m_slots.end())
+                return;
+
+            const size_t index = slot->second;
+            m_slots.erase(slot);
+            m_lights.erase(m_lights.begin() + index);
+            for (size_t i = index; i < m_lights.size(); ++i)
+            {
+                m_slots[m_lights[i].id] = i;
+            }
+        }
+
+        // Enabled lights converted to meters, as GetAllLights and the watcher produce them
+        void CollectActive(double unitScale, std::vector<LightUtils::LightInfo>& active) const
+        {
+            active.clear();
+            for (const auto& light : m_lights)
+            {
+                if (!light.enabled)
+                    continue;
+                active.push_back(light);
+                CLightEventWatcher::ConvertLightToMeters(active.back(), unitScale);
+            }
+        }
+
+    private:
+        std::vector<LightUtils::LightInfo> m_lights;
+        std::unordered_map<ON_UUID, size_t, LightUtils::UuidHash> m_slots;
+    };
+
+    // Encodes a delivery, then decodes it into the mirror; returns the message size
+    size_t EncodeAndReceive(const LightSyncSubscriptions::Delivery& delivery, LightFragmentCache& cache,
+        LightSyncBuffers::EncodeBuffers& buffers, std::string& message, LightMessageDecoder& decoder,
+        LightMessage& decoded, LightMirror& mirror, EventStages& stages)
+    {
+        Clock::time_point start = Clock::now();
+        buffers.clear();
+        CLightEventWatcher::EncodeLightData(delivery, L"Replay", cache, buffers);
+        start = stages.Add(LightEventReplay::STAGE_ENCODE, start);
+
+        message.clear();
+        for (const auto& segment : buffers.segments)
+        {
+            message.append(segment.data, segment.size);
+        }
+        if (decoder.Decode(message.data(), message.size(), decoded))
+        {
+            mirror.Apply(decoded);
+        }
+        stages.Add(LightEventReplay::STAGE_RECEIVE, start);
+        return message.size();
+    }
+}
+
+double LightEventReplay::Report::Total(Stage stage) const
+{
+    double total = 0.0;
+    for (double sample : stageMicroseconds[stage])
+    {
+        total += sample;
+    }
+    return total;
+}
+
+/**
+ * @brief Nearest-rank percentile of a stage's per-event times
+ *
+ * @param stage Stage to look at
+ * @param fraction 0.5 for the median, 0.99 for p99, 1.0 for the maximum
+ * @return Microseconds, 0 if the stage never ran
+ */
+double LightEventReplay::Report::Percentile(Stage stage, double fraction) const
+{
+    std::vector<double> samples = stageMicroseconds[stage];
+    if (samples.empty())
+    {
+        return 0.0;
+    }
+
+    size_t rank = static_cast<size_t>(fraction * static_cast<double>(samples.size()));
+    if (rank >= samples.size())
+    {
+        rank = samples.size() - 1;
+    }
+    std::nth_element(samples.begin(), samples.begin() + rank, samples.end());
+    return samples[rank];
+}
+
+/**
+ * @brief Replays journal entries through the sync core
+ *
+ * Baseline records rebuild the scene without being timed. Each event then
+ * follows CLightEventWatcher::LightTableEvent: a modify is first compared with
+ * what was sent and either suppressed, sent as a field update or falls through
+ * to a full scene update, which is suppressed when the scene hash is unchanged.
+ *
+ * @param entries Records read with LightEventJournal::Read
+ * @param docSerial Document whose records are replayed; records of other documents are skipped
+ * @param originalSpeed Wait until each event's recorded time before replaying it
+ * @param report Receives counts and per-stage timings
+ */
+void LightEventReplay::Run(const std::vector<LightEventJournal::Entry>& entries, unsigned int docSerial,
+    bool originalSpeed, Report& report)
+{
+    report = Report();
+
+    ReplayScene scene;
+    LightChangeTracker tracker(false);
+    LightFragmentCache cache(&CLightEventWatcher::EncodeLightRecord);
+    LightSyncBuffers::EncodeBuffers buffers;
+    std::vector<LightUtils::LightInfo> activeLights;
+    std::string message;
+    LightMessageDecoder decoder;
+    LightMessage decoded;
+    LightMirror mirror;
+    unsigned int sequence = 0;
+
+    bool inBaseline = false;
+    bool haveFirstEvent = false;
+    uint64_t firstEventTime = 0;
+    const Clock::time_point replayStart = Clock::now();
+
+    for (const auto& entry : entries)
+    {
+        // Other documents' lights must not leak into this document's scene
+        if (entry.docSerial != docSerial)
+        {
+            continue;
+        }
+
+        // A baseline block (first event in a file) describes the whole document
+        if (entry.event == LightEventJournal::BASELINE_EVENT)
+        {
+            if (!inBaseline)
+            {
+                scene.Clear();
+                inBaseline = true;
+            }
+            if (entry.hasLight)
+            {
+                scene.Upsert(entry.light);
+            }
+            continue;
+        }
+        inBaseline = false;
+
+        if (!haveFirstEvent)
+        {
+            haveFirstEvent = true;
+            firstEventTime = entry.timeMicroseconds;
+        }
+        if (originalSpeed)
+        {
+            std::this_thread::sleep_until(replayStart +
+                std::chrono::microseconds(entry.timeMicroseconds - firstEventTime));
+        }
+        ++report.events;
+
+        EventStages stages(report);
+        Clock::time_point start = Clock::now();
+        if (entry.event == CRhinoEventWatcher::light_deleted)
+        {
+            scene.Remove(entry.lightId);
+        }
+        else if (entry.hasLight)
+        {
+            scene.Upsert(entry.light);
+        }
+
+        // Field update fast path, as for a live light_modified event
+        if (entry.event == CRhinoEventWatcher::light_modified && entry.hasLight)
+        {
+            LightUtils::LightInfo modified = entry.light;
+            CLightEventWatcher::ConvertLightToMeters(modified, entry.unitScale);
+            start = stages.Add(STAGE_SCENE, start);
+
+            const unsigned int changedFields = tracker.ChangedFields(modified, entry.unitScale);
+            if (changedFields == 0)
+            {
+                stages.Add(STAGE_TRACK, start);
+                ++report.suppressed;
+                continue;
+            }
+            if ((changedFields & LightUtils::FIELD_TYPE) == 0)
+            {
+                if (modified.enabled)
+                    tracker.UpdateLight(modified);
+                else
+                    tracker.RemoveLight(modified.id);
+                stages.Add(STAGE_TRACK, start);
+                ++report.fieldUpdates;
+
+                LightSyncSubscriptions::Delivery delivery;
+                delivery.sequence = sequence;
+                delivery.partial = true;
+                delivery.lights.push_back(modified);
+                delivery.lights.front().dirtyFields = changedFields;
+                report.bytesEncoded += EncodeAndReceive(delivery, cache, buffers, message, decoder, decoded,
+                    mirror, stages);
+                continue;
+            }
+            start = stages.Add(STAGE_TRACK, start);
+        }
+
+        scene.CollectActive(entry.unitScale, activeLights);
+        start = stages.Add(STAGE_SCENE, start);
+
+        const bool changed = tracker.UpdateScene(activeLights, entry.unitScale);
+        if (changed)
+        {
+            cache.Prune(activeLights);
+        }
+        stages.Add(STAGE_TRACK, start);
+        if (!changed)
+        {
+            ++report.suppressed;
+            continue;
+        }
+        ++report.sceneUpdates;
+
+        LightSyncSubscriptions::Delivery delivery;
+        delivery.sequence = ++sequence;
+        delivery.snapshot = tracker.Snapshot();
+        report.bytesEncoded += EncodeAndReceive(delivery, cache, buffers, message, decoder, decoded, mirror, stages);
+    }
+
+    report.mirroredLights = mirror.Count();
+    report.wallMilliseconds = std::chrono::duration<double, std::milli>(Clock::now() - replayStart).count();
+}
+
+const wchar_t* LightEventReplay::StageName(Stage stage)
+{
+    switch (stage)
+    {
+    case STAGE_SCENE:
+        return L"Scene";
+    case STAGE_TRACK:
+        return L"Track";
+    case STAGE_ENCODE:
+        return L"Encode";
+    case STAGE_RECEIVE:
+        return L"Receive";
+    default:
+        return L"Unknown";
+    }
+}
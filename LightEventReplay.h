@@ -0,0 +1,66 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+
+#pragma once
+
+#include "stdafx.h"
+#include "LightEventJournal.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Feeds a recorded journal back through the sync core and times each stage
+ *
+ * Replays the events against a private change tracker, fragment cache and
+ * receiver mirror, making the same suppression, field update and full scene
+ * decisions as CLightEventWatcher (without region subscribers) and encoding
+ * every message that would have been sent. Nothing is sent and the live
+ * tracker, cache and snapshot store are not touched.
+ */
+class LightEventReplay
+{
+public:
+    enum Stage
+    {
+        STAGE_SCENE,    // Applying the event and collecting the active lights in meters
+        STAGE_TRACK,    // Change detection and snapshot update
+        STAGE_ENCODE,   // Building the message
+        STAGE_RECEIVE,  // Decoding it with the receiver library and updating the mirror
+        STAGE_COUNT
+    };
+
+    struct Report
+    {
+        size_t events;
+        size_t suppressed;
+        size_t fieldUpdates;
+        size_t sceneUpdates;
+        uint64_t bytesEncoded;
+        size_t mirroredLights;       // Lights in the receiver mirror after the last event
+        double wallMilliseconds;
+        std::vector<double> stageMicroseconds[STAGE_COUNT];  // One sample per event that reached the stage
+
+        Report() : events(0), suppressed(0), fieldUpdates(0), sceneUpdates(0), bytesEncoded(0),
+            mirroredLights(0), wallMilliseconds(0.0) {}
+
+        double Total(Stage stage) const;
+        double Percentile(Stage stage, double fraction) const;
+    };
+
+    // Replays the records of one document; originalSpeed waits between events as
+    // recorded, otherwise events run back to back
+    static void Run(const std::vector<LightEventJournal::Entry>& entries, unsigned int docSerial, bool originalSpeed,
+        Report& report);
+
+    static const wchar_t* StageName(Stage stage);
+};
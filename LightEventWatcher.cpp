@@ -12,31 +12,155 @@
 
 #include "stdafx.h"
 #include "LightEventWatcher.h"
+#include "LightAgentLink.h"
+#include "LightDocumentPipeline.h"
+#include "LightEventJournal.h"
+#include "LightQuantizedEncoder.h"
+#include "LightSchema.h"
+#include "LightSyncBuffers.h"
+#include "LightSyncMetrics.h"
+#include "LightSyncStats.h"
+#include "LightSyncTrace.h"
 #include "LightUtils.h"
+#include "LiveDragStreamer.h"
+#include "LightSyncNetwork.h"
+#include "LightSyncReactor.h"
+#include "LightSyncRuntime.h"
+#include "LightSyncSubscriptions.h"
+#include "LightTombstoneStore.h"
 #include "rhinoSdkApp.h"
-#include <winsock2.h>
-#include <ws2tcpip.h>
-#include <sstream>
-#include <thread>
-#include <iomanip>
-#pragma comment(lib, "ws2_32.lib")
-
-// Constants for TCP communication
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cwchar>
+
 namespace {
-    constexpr int DEFAULT_TCP_PORT = 5173;
-    constexpr DWORD TCP_TIMEOUT_MS = 5000;
-    constexpr const char* LOCALHOST_IP = "127.0.0.1";
-}
+    // Typical size of a complete record, reserved up front so it is built in one allocation
+    constexpr size_t RECORD_RESERVE_BYTES = 512;
+
+    // Numbers are formatted through a stack buffer, so records cost no temporary allocations
+    void AppendNumber(std::string& json, double value, int precision)
+    {
+        char buffer[64];
+        const int length = snprintf(buffer, sizeof(buffer), "%.*f", precision, value);
+        if (length > 0)
+            json.append(buffer, static_cast<size_t>(length));
+    }
+
+    void AppendNumber(std::string& json, int value, int)
+    {
+        char buffer[16];
+        const int length = snprintf(buffer, sizeof(buffer), "%d", value);
+        if (length > 0)
+            json.append(buffer, static_cast<size_t>(length));
+    }
+
+    // Counters, sequences and versions of message headers
+    void AppendUnsigned(std::string& json, uint64_t value)
+    {
+        char buffer[24];
+        const int length = snprintf(buffer, sizeof(buffer), "%llu", static_cast<unsigned long long>(value));
+        if (length > 0)
+            json.append(buffer, static_cast<size_t>(length));
+    }
+
+    /**
+     * @brief Writes a JSON object of numeric members
+     *
+     * @param indent Indent of the member that holds the object; members go on their
+     *               own lines two spaces deeper. Null writes the object on one line.
+     * @param precision Fixed digits after the point, -1 for integers
+     */
+    template <class Number, size_t Count>
+    void WriteJSONObject(std::string& json, const char* const (&names)[Count], const Number (&values)[Count],
+        int precision, const char* indent)
+    {
+        json += "{";
+        for (size_t i = 0; i < Count; ++i)
+        {
+            if (indent)
+            {
+                json += (i == 0 ? "\n" : ",\n");
+                json += indent;
+                json += "  \"";
+            }
+            else
+            {
+                json += (i == 0 ? "\"" : ", \"");
+            }
+            json += names[i];
+            json += "\": ";
+            AppendNumber(json, values[i], precision);
+        }
+        if (indent)
+        {
+            json += "\n";
+            json += indent;
+        }
+        json += "}";
+    }
+
+    // JSON form of each schema value type, shared by full records and field updates
+    void WriteJSONValue(std::string& json, LightUtils::LightType type, int, const char*)
+    {
+        // Type names are ASCII
+        json += "\"";
+        for (const wchar_t* name = LightUtils::GetLightTypeName(type); *name; ++name)
+            json += static_cast<char>(*name);
+        json += "\"";
+    }
+
+    void WriteJSONValue(std::string& json, bool enabled, int, const char*)
+    {
+        json += enabled ? "true" : "false";
+    }
+
+    // Position in meters (already converted)
+    void WriteJSONValue(std::string& json, const ON_3dPoint& location, int precision, const char* indent)
+    {
+        static const char* const names[] = { "x", "y", "z" };
+        const double values[] = { location.x, location.y, location.z };
+        WriteJSONObject(json, names, values, precision, indent);
+    }
+
+    // Rotation rather than the direction vector, which avoids the vector-to-rotation
+    // conversion in Unreal
+    void WriteJSONValue(std::string& json, const ON_3dVector& direction, int precision, const char* indent)
+    {
+        static const char* const names[] = { "pitch", "yaw", "roll" };
+        const CLightEventWatcher::FRhinoRotation rotation = CLightEventWatcher::DirectionToRhinoRotation(direction);
+        const double values[] = { rotation.pitch, rotation.yaw, rotation.roll };
+        WriteJSONObject(json, names, values, precision, indent);
+    }
+
+    void WriteJSONValue(std::string& json, double value, int precision, const char*)
+    {
+        AppendNumber(json, value, precision);
+    }
+
+    // RGB color values (0-255 range)
+    void WriteJSONValue(std::string& json, const ON_Color& color, int, const char* indent)
+    {
+        static const char* const names[] = { "r", "g", "b" };
+        const int values[] = { static_cast<int>(color.Red()), static_cast<int>(color.Green()), static_cast<int>(color.Blue()) };
+        WriteJSONObject(json, names, values, -1, indent);
+    }
 
-// Static member initialization
-std::set<unsigned int> CLightEventWatcher::m_deletedLightsBlacklist;
+    void WriteJSONValue(std::string& json, const LightSchema::SpotAngles& angles, int precision, const char* indent)
+    {
+        static const char* const names[] = { "innerAngle", "outerAngle" };
+        const double values[] = { angles.inner, angles.outer };
+        WriteJSONObject(json, names, values, precision, indent);
+    }
+}
 
 /**
  * @brief Handles light table events and broadcasts light data via TCP
  *
  * This function is called whenever a light is added, deleted, undeleted, or modified in Rhino.
- * It manages a blacklist of deleted lights, collects all active lights, converts their coordinates
- * to meters, and sends the data to Unreal Engine via TCP connection.
+ * It keeps tombstones of deleted lights, collects all active lights, converts their coordinates
+ * to meters, and sends the data to Unreal Engine via TCP connection. All work happens in the
+ * pipeline of the document that owns the table, which need not be the active one.
  *
  * @param event The type of light event that occurred
  * @param table Reference to the light table
@@ -46,69 +170,148 @@ std::set<unsigned int> CLightEventWatcher::m_deletedLightsBlacklist;
 void CLightEventWatcher::LightTableEvent(CRhinoEventWatcher::light_event event,
     const CRhinoLightTable& table, int lightIndex, const ON_Light* light)
 {
+    LightSyncRuntime::EnsureStarted(L"light event");
+    LightSyncStats::Increment(LightSyncStats::Get().lightEvents);
+    LightSyncMetrics::CountLightEvent(event);
+    LightSyncTrace::Span eventSpan("LightTableEvent");
+
     try
     {
-        // Validate active document exists
-        CRhinoDoc* doc = RhinoApp().ActiveDoc();
-        if (!doc)
+        // The table's own document, which may be a background one
+        CRhinoDoc* doc = &table.Document();
+        LightDocumentPipeline::Ptr pipeline = LightDocumentPipeline::ForDocument(*doc);
+        LightChangeTracker& changeTracker = pipeline->ChangeTracker();
+
+        // Keep the event with the light's resulting state for offline replay
+        if (LightEventJournal::IsRecording())
         {
-            RhinoApp().Print(L"Warning: No active document found for light event.\n");
-            return;
+            LightEventJournal::Record(*doc, event, lightIndex >= 0 ? &table[lightIndex] : nullptr,
+                GetModelUnitScaleToMeters(doc));
         }
 
-        // Handle blacklist management based on event type
+        // Handle tombstones based on event type; they belong to the light's document
+        const unsigned int docSerial = doc->RuntimeSerialNumber();
         if (event == CRhinoEventWatcher::light_event::light_deleted && lightIndex >= 0)
         {
-            // Get the light that's being deleted and add to blacklist
+            // Get the light that's being deleted and tombstone it until undone or purged
             const CRhinoLight* rhinoLight = &table[lightIndex];
             if (rhinoLight)
             {
-                unsigned int serialNumber = rhinoLight->Attributes().m_uuid.Data1; // Using UUID as unique identifier
-                AddToBlacklist(serialNumber);
-                RhinoApp().Print(L"Added light (Serial: %u) to blacklist due to deletion.\n", serialNumber);
+                const ON_UUID& lightId = rhinoLight->Attributes().m_uuid;
+                LightTombstoneStore::Add(docSerial, lightId, doc->CurrentUndoRecordSerialNumber());
             }
         }
         else if (event == CRhinoEventWatcher::light_event::light_undeleted && lightIndex >= 0)
         {
-            // Get the light that's being undeleted and remove from blacklist
+            // Get the light that's being undeleted and drop its tombstone
             const CRhinoLight* rhinoLight = &table[lightIndex];
             if (rhinoLight)
             {
-                unsigned int serialNumber = rhinoLight->Attributes().m_uuid.Data1;
-                RemoveFromBlacklist(serialNumber);
-                RhinoApp().Print(L"Removed light (Serial: %u) from blacklist due to undeletion.\n", serialNumber);
+                const ON_UUID& lightId = rhinoLight->Attributes().m_uuid;
+                LightTombstoneStore::Remove(docSerial, lightId);
             }
         }
 
+        // A light streamed during a live drag only needs its own commit on release
+        if (event == CRhinoEventWatcher::light_event::light_modified && lightIndex >= 0 &&
+            table[lightIndex].Light().m_bOn &&
+            LiveDragStreamer::ConsumeStreamedLight(table[lightIndex].Attributes().m_uuid))
+        {
+            SendLiveDragCommit(*pipeline, doc, table[lightIndex]);
+            return;
+        }
+
         // Get model unit scale factor for conversion to meters (Unreal's standard unit)
         double unitScale = GetModelUnitScaleToMeters(doc);
 
-        // Retrieve all lights from the document (including deleted ones that are still in table)
-        std::vector<LightUtils::LightInfo> allLights = LightUtils::GetAllLights(doc);
+        // A modify only costs a comparison with what was last sent: nothing changed
+        // (name, attributes...) is dropped, a few changed fields go out on their own
+        if (event == CRhinoEventWatcher::light_event::light_modified && lightIndex >= 0)
+        {
+            LightUtils::LightInfo modified = LightUtils::MakeLightInfo(table[lightIndex]);
+            ConvertLightToMeters(modified, unitScale);
+
+            const unsigned int changedFields = changeTracker.ChangedFields(modified, unitScale);
+            if (changedFields == 0)
+            {
+                LightSyncStats::Increment(LightSyncStats::Get().suppressedEvents);
+                return;
+            }
+            if (SendFieldUpdate(*pipeline, modified, changedFields, unitScale))
+            {
+                return;
+            }
+        }
 
-        // Filter out blacklisted (deleted) lights
-        std::vector<LightUtils::LightInfo> activeLights = FilterBlacklistedLights(allLights, doc);
+        // Retrieve all lights from the document (including deleted ones that are still in table)
+        // into the scene buffer, which keeps its storage from one event to the next
+        std::vector<LightUtils::LightInfo>& activeLights = pipeline->SceneLights();
+        {
+            LightSyncTrace::Span span("scan");
+            LightUtils::GetAllLights(doc, activeLights);
+        }
+        // Filter out tombstoned (deleted) lights in place
+        {
+            LightSyncTrace::Span span("filter");
+            FilterDeletedLights(docSerial, activeLights);
+        }
 
         // Convert all active light coordinates to meters for Unreal compatibility
-        ConvertLightsToMeters(activeLights, unitScale);
-
-        // Log event information for debugging
-        std::wstring eventType = GetLightEventTypeString(event);
-        RhinoApp().Print(L"Light Event: %s (Total lights in table: %d, Active lights after filtering: %d, Unit scale: %.6f)\n",
-            eventType.c_str(), static_cast<int>(allLights.size()), static_cast<int>(activeLights.size()), unitScale);
-
-        // Send light data to Unreal Engine via TCP in background thread
-        // This prevents blocking the UI while network communication occurs
-        std::thread tcpThread([activeLights, eventType]() {
-            SendLightDataToTCP(activeLights, eventType, DEFAULT_TCP_PORT);
-            });
-        tcpThread.detach();
-
-        // Export to file as backup (optional safety measure)
-        if (LightUtils::ExportLightsToFile(activeLights, LightUtils::DEFAULT_EXPORT_PATH))
         {
-            RhinoApp().Print(L"Active light data exported to backup file successfully.\n");
+            LightSyncTrace::Span span("convert");
+            ConvertLightsToMeters(activeLights, unitScale);
+        }
+
+        // Nothing to resend if the transmitted scene is identical (e.g. an off light was edited)
+        bool sceneChanged = false;
+        {
+            LightSyncTrace::Span span("snapshot");
+            LightSyncMetrics::ScopedTimer timer(LightSyncMetrics::SnapshotBuild());
+            sceneChanged = changeTracker.UpdateScene(activeLights, unitScale);
+        }
+        if (!sceneChanged)
+        {
+            LightSyncStats::Increment(LightSyncStats::Get().suppressedEvents);
+            return;
+        }
+        LightSyncStats::Increment(LightSyncStats::Get().sceneUpdates);
+        pipeline->FragmentCache().Prune(activeLights);
+
+        // Events are counted in LightSyncStats rather than printed, which would allocate on every edit
+        const wchar_t* eventType = GetLightEventTypeString(event);
+
+        // Recording the scene, resolving and queueing it must not interleave with a resume
+        std::lock_guard<std::mutex> publishing(pipeline->PublishingMutex());
+        pipeline->ResumeLog().SetKeyframe(changeTracker.Snapshot());
+
+        // The sync agent encodes, sends and exports out of process
+        if (LightAgentLink::IsActive())
+        {
+            LightAgentLink::PushScene(docSerial, eventType, *changeTracker.Snapshot());
+            return;
+        }
+
+        // Keep the spatial index current and work out what each receiver should get
+        ON_UUID changedLightId = ON_nil_uuid;
+        if (lightIndex >= 0)
+        {
+            changedLightId = table[lightIndex].Attributes().m_uuid;
+        }
+        LightSyncBuffers::DeliveryList deliveries = LightSyncBuffers::Deliveries().Acquire();
+        {
+            LightSyncTrace::Span span("resolve");
+            LightSyncSubscriptions::UpdateSpatialIndex(docSerial, activeLights, changedLightId, unitScale);
+            LightSyncSubscriptions::ResolveDeliveries(docSerial, activeLights, changeTracker.Snapshot(), deliveries);
         }
+
+        // Send light data to Unreal Engine via TCP from the network thread
+        // This prevents blocking the UI while network communication occurs. The
+        // document's channel sends each receiver's deliveries in order, one at a
+        // time per receiver, so a prioritized trickle never delays the others, and
+        // drops scenes a newer one replaces before they went out.
+        // The backup file is written by LightSnapshotExporter from the published snapshot.
+        LightSyncTrace::Span span("queue");
+        pipeline->Send(std::move(deliveries), eventType);
     }
     catch (const std::exception& e)
     {
@@ -125,83 +328,320 @@ void CLightEventWatcher::LightTableEvent(CRhinoEventWatcher::light_event event,
 }
 
 /**
- * @brief Adds a light to the deletion blacklist
+ * @brief Sends the full properties of a light whose drag was streamed live
+ *
+ * During the drag receivers only got transform updates. On release the light's
+ * complete state is sent as a partial update, leaving the rest of the scene,
+ * the backup file and region membership to the next full event.
  *
- * @param lightSerialNumber Unique identifier for the light
+ * @param pipeline Pipeline of the light's document
+ * @param doc Document owning the light
+ * @param rhinoLight The light that was committed
  */
-void CLightEventWatcher::AddToBlacklist(unsigned int lightSerialNumber)
+void CLightEventWatcher::SendLiveDragCommit(LightDocumentPipeline& pipeline, CRhinoDoc* doc,
+    const CRhinoLight& rhinoLight)
 {
-    m_deletedLightsBlacklist.insert(lightSerialNumber);
+    const double unitScale = GetModelUnitScaleToMeters(doc);
+    const unsigned int docSerial = pipeline.DocumentSerial();
+
+    LightSyncBuffers::LightList committed = LightSyncBuffers::Lights().Acquire();
+    committed.push_back(LightUtils::MakeLightInfo(rhinoLight));
+    ConvertLightToMeters(committed.front(), unitScale);
+    LightSyncSubscriptions::UpdateSpatialIndexEntry(docSerial, committed.front(), unitScale);
+
+    // Always sent: receivers last saw a streamed transform, not the recorded state
+    std::lock_guard<std::mutex> publishing(pipeline.PublishingMutex());
+    {
+        LightSyncMetrics::ScopedTimer timer(LightSyncMetrics::SnapshotBuild());
+        pipeline.ChangeTracker().UpdateLight(committed.front());
+    }
+    const uint64_t version = pipeline.ChangeTracker().Snapshot()->Version();
+    pipeline.ResumeLog().AddDelta(committed, version);
+
+    if (LightAgentLink::IsActive())
+    {
+        PushToAgent(pipeline, committed, L"Light Commit");
+        LightSyncBuffers::Lights().Release(std::move(committed));
+        return;
+    }
+
+    LightSyncBuffers::DeliveryList deliveries = LightSyncBuffers::Deliveries().Acquire();
+    LightSyncSubscriptions::ResolvePartialDeliveries(docSerial, committed, version, deliveries);
+    LightSyncBuffers::Lights().Release(std::move(committed));
+
+    pipeline.Send(std::move(deliveries), L"Light Commit");
 }
 
 /**
- * @brief Removes a light from the deletion blacklist
+ * @brief Sends only the changed fields of a single modified light
+ *
+ * Type changes always need a full event. Moves and on/off switches change which
+ * regions a light is in, so they are only sent this way while no receiver is
+ * region-scoped. The backup file follows from the snapshot version the change
+ * tracker publishes, without rescanning the document.
  *
- * @param lightSerialNumber Unique identifier for the light
+ * @param pipeline Pipeline of the light's document
+ * @param light Modified light with position in meters
+ * @param changedFields Dirty mask from the change tracker
+ * @param unitScale Unit scale the position was converted with
+ * @return False if the event has to go through the full path
  */
-void CLightEventWatcher::RemoveFromBlacklist(unsigned int lightSerialNumber)
+bool CLightEventWatcher::SendFieldUpdate(LightDocumentPipeline& pipeline, const LightUtils::LightInfo& light,
+    unsigned int changedFields, double unitScale)
 {
-    m_deletedLightsBlacklist.erase(lightSerialNumber);
+    LightSyncTrace::Span fieldSpan("field update");
+    const unsigned int docSerial = pipeline.DocumentSerial();
+    const unsigned int membershipFields = LightUtils::FIELD_LOCATION | LightUtils::FIELD_ENABLED;
+    if ((changedFields & LightUtils::FIELD_TYPE) != 0 ||
+        ((changedFields & membershipFields) != 0 && LightSyncSubscriptions::HasRegionScopedSubscribers(docSerial)))
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> publishing(pipeline.PublishingMutex());
+    if (light.enabled)
+    {
+        {
+            LightSyncMetrics::ScopedTimer timer(LightSyncMetrics::SnapshotBuild());
+            pipeline.ChangeTracker().UpdateLight(light);
+        }
+        LightSyncSubscriptions::UpdateSpatialIndexEntry(docSerial, light, unitScale);
+    }
+    else
+    {
+        {
+            LightSyncMetrics::ScopedTimer timer(LightSyncMetrics::SnapshotBuild());
+            pipeline.ChangeTracker().RemoveLight(light.id);
+        }
+        LightSyncSubscriptions::RemoveSpatialIndexEntry(docSerial, light.id);
+    }
+    LightSyncStats::Increment(LightSyncStats::Get().fieldUpdates);
+
+    LightSyncBuffers::LightList updated = LightSyncBuffers::Lights().Acquire();
+    updated.push_back(light);
+    updated.front().dirtyFields = changedFields;
+
+    const LightSnapshot::Ptr& snapshot = pipeline.ChangeTracker().Snapshot();
+    const uint64_t version = snapshot ? snapshot->Version() : 0;
+    pipeline.ResumeLog().AddDelta(updated, version);
+
+    if (LightAgentLink::IsActive())
+    {
+        PushToAgent(pipeline, updated, L"Light Modified");
+        LightSyncBuffers::Lights().Release(std::move(updated));
+        return true;
+    }
+    LightSyncBuffers::DeliveryList deliveries = LightSyncBuffers::Deliveries().Acquire();
+    LightSyncSubscriptions::ResolvePartialDeliveries(docSerial, updated, version, deliveries);
+    LightSyncBuffers::Lights().Release(std::move(updated));
+
+    pipeline.Send(std::move(deliveries), L"Light Modified");
+    return true;
 }
 
 /**
- * @brief Checks if a light is blacklisted (deleted)
+ * @brief Hands a partial update to the sync agent
+ *
+ * A document that lost records to a full ring gets its complete scene instead,
+ * which the change tracker already holds.
  *
- * @param lightSerialNumber Unique identifier for the light
- * @return True if the light is blacklisted
+ * @param pipeline Pipeline of the lights' document
+ * @param lights Updated lights with positions in meters
+ * @param eventType Event name for the receivers' messages
  */
-bool CLightEventWatcher::IsBlacklisted(unsigned int lightSerialNumber)
+void CLightEventWatcher::PushToAgent(LightDocumentPipeline& pipeline, const std::vector<LightUtils::LightInfo>& lights,
+    const wchar_t* eventType)
 {
-    return m_deletedLightsBlacklist.find(lightSerialNumber) != m_deletedLightsBlacklist.end();
+    const unsigned int docSerial = pipeline.DocumentSerial();
+    const LightSnapshot::Ptr& snapshot = pipeline.ChangeTracker().Snapshot();
+    if (LightAgentLink::NeedsScene(docSerial) && snapshot)
+    {
+        LightAgentLink::PushScene(docSerial, eventType, *snapshot);
+    }
+    else
+    {
+        LightAgentLink::PushUpdate(docSerial, eventType, lights);
+    }
 }
 
 /**
- * @brief Filters out blacklisted lights from the complete lights list
+ * @brief Sends one queued delivery and hands its lights back to the pool
  *
- * @param allLights Vector containing all lights from the document
- * @param doc Pointer to the Rhino document
- * @return Vector containing only non-blacklisted lights
+ * Called on the network thread by the document's channel. Receivers that
+ * reported their view get the scene prioritized; everyone else gets one message.
+ *
+ * @param pipeline Pipeline of the delivery's document (for its fragment cache)
+ * @param delivery Delivery taken off the channel
+ * @param eventType Event name written into the message
+ * @param done Called once with whether everything was sent
+ */
+void CLightEventWatcher::SendDelivery(const std::shared_ptr<LightDocumentPipeline>& pipeline,
+    LightSyncSubscriptions::Delivery& delivery, const wchar_t* eventType, LightSyncNetwork::SendHandler done)
+{
+    if (delivery.camera.valid && !delivery.partial)
+    {
+        SendPrioritizedLightData(pipeline, delivery, eventType, std::move(done));
+    }
+    else
+    {
+        SendLightDataToTCP(delivery, eventType, pipeline->FragmentCache(), std::move(done));
+    }
+    ReleaseDeliveryLights(delivery);
+}
+
+/**
+ * @brief Hands a delivery's own light list back to the pool once it was sent
+ *
+ * Deliveries that only referenced the shared snapshot have no storage to return.
+ *
+ * @param delivery Delivery that is done with its lights
  */
-std::vector<LightUtils::LightInfo> CLightEventWatcher::FilterBlacklistedLights(
-    const std::vector<LightUtils::LightInfo>& allLights, CRhinoDoc* doc)
+void CLightEventWatcher::ReleaseDeliveryLights(LightSyncSubscriptions::Delivery& delivery)
 {
-    std::vector<LightUtils::LightInfo> filteredLights;
+    delivery.snapshot.reset();
+    if (delivery.lights.capacity() > 0)
+    {
+        LightSyncBuffers::Lights().Release(std::move(delivery.lights));
+    }
+}
 
-    if (!doc)
+/**
+ * @brief Removes tombstoned (deleted) lights from a light list
+ *
+ * Works in place so the scene buffer's storage is kept. Each light carries its
+ * own id, so lights that GetAllLights skipped (switched off) cannot shift the
+ * correlation.
+ *
+ * @param docSerial Document the lights belong to
+ * @param lights Lights from the document; tombstoned entries are erased
+ */
+void CLightEventWatcher::FilterDeletedLights(unsigned int docSerial, std::vector<LightUtils::LightInfo>& lights)
+{
+    if (LightTombstoneStore::Empty(docSerial))
     {
-        return filteredLights;
+        return;
     }
 
-    // Get all lights from the light table to correlate with our light info
-    ON_SimpleArray<const CRhinoLight*> rhinoLights;
-    doc->m_light_table.GetSortedList(rhinoLights);
+    // Only keep lights without a tombstone
+    lights.erase(std::remove_if(lights.begin(), lights.end(), [docSerial](const LightUtils::LightInfo& lightInfo) {
+        return LightTombstoneStore::Contains(docSerial, lightInfo.id);
+        }), lights.end());
+}
 
-    // Filter out blacklisted lights
-    for (size_t i = 0; i < allLights.size() && i < static_cast<size_t>(rhinoLights.Count()); ++i)
+/**
+ * @brief Compacts tombstones whose deletion left the undo history
+ *
+ * @param type Undo event type; only purge_record is handled
+ * @param undo_record_serialno Serial number of the affected undo record
+ * @param cmd Command that recorded it (unused)
+ */
+void CLightEventWatcher::UndoEvent(CRhinoEventWatcher::undo_event type, unsigned int undo_record_serialno,
+    const CRhinoCommand* cmd)
+{
+    if (type != CRhinoEventWatcher::purge_record)
     {
-        const CRhinoLight* rhinoLight = rhinoLights[static_cast<int>(i)];
-        if (rhinoLight)
-        {
-            unsigned int serialNumber = rhinoLight->Attributes().m_uuid.Data1;
+        return;
+    }
 
-            // Only include lights that are not blacklisted
-            if (!IsBlacklisted(serialNumber))
-            {
-                filteredLights.push_back(allLights[i]);
-            }
-        }
+    // The event does not name the document; records are purged in the one commands run in. A
+    // purge in another document leaves tombstones that only go when it closes or hits its cap
+    LightTombstoneStore::PurgeUndoRecord(CRhinoDoc::ModelessUserInterfaceDocSerialNumber(), undo_record_serialno);
+}
+
+/**
+ * @brief Drops the pipeline, tombstones and receiver bindings of a document that is closing
+ *
+ * @param doc Document being closed
+ */
+void CLightEventWatcher::OnCloseDocument(CRhinoDoc& doc)
+{
+    const unsigned int docSerial = doc.RuntimeSerialNumber();
+    LightTombstoneStore::RemoveDocument(docSerial);
+    LightDocumentPipeline::Remove(docSerial);
+    if (LightAgentLink::IsActive())
+    {
+        LightAgentLink::PushDocumentClosed(docSerial);
     }
+    LightSyncSubscriptions::RemoveDocument(docSerial);
+}
 
-    return filteredLights;
+/**
+ * @brief Makes a new document known to receivers before its first light event
+ *
+ * The empty document Rhino creates at startup is left alone, so a session that
+ * never has a light never starts the runtime.
+ *
+ * @param doc Document that was created
+ */
+void CLightEventWatcher::OnNewDocument(CRhinoDoc& doc)
+{
+    if (!LightSyncRuntime::IsStarted())
+    {
+        if (!LightSyncRuntime::HasLights(doc))
+            return;
+        LightSyncRuntime::EnsureStarted(L"new lit document");
+    }
+    SeedKeyframe(*LightDocumentPipeline::ForDocument(doc), doc);
+}
+
+/**
+ * @brief Makes an opened document known to receivers before its first light event
+ *
+ * @param doc Document that was opened
+ * @param filename File it was read from
+ * @param bMerge True if the file was merged into an existing document
+ * @param bReference True if the file was opened as a reference
+ */
+void CLightEventWatcher::OnEndOpenDocument(CRhinoDoc& doc, const wchar_t* filename, BOOL bMerge, BOOL bReference)
+{
+    if (bMerge || bReference)
+    {
+        return;
+    }
+    // Opening a model without lights does not start the runtime
+    if (!LightSyncRuntime::IsStarted())
+    {
+        if (!LightSyncRuntime::HasLights(doc))
+            return;
+        LightSyncRuntime::EnsureStarted(L"opened lit document");
+    }
+    SeedKeyframe(*LightDocumentPipeline::ForDocument(doc), doc);
+}
+
+/**
+ * @brief Records a document's lights as its first keyframe
+ *
+ * Receivers that resume before the first light event get the scene from it.
+ * A private change tracker builds the snapshot, so the first event still goes
+ * out as a complete scene to receivers that never resumed.
+ *
+ * @param pipeline Pipeline of the document
+ * @param doc Document that was created or opened
+ */
+void CLightEventWatcher::SeedKeyframe(LightDocumentPipeline& pipeline, CRhinoDoc& doc)
+{
+    const double unitScale = GetModelUnitScaleToMeters(&doc);
+    std::vector<LightUtils::LightInfo> lights;
+    LightUtils::GetAllLights(&doc, lights);
+    ConvertLightsToMeters(lights, unitScale);
+
+    LightChangeTracker seed(false);
+    seed.UpdateScene(lights, unitScale);
+
+    std::lock_guard<std::mutex> publishing(pipeline.PublishingMutex());
+    if (!pipeline.ResumeLog().Keyframe())
+    {
+        pipeline.ResumeLog().SetKeyframe(seed.Snapshot());
+    }
 }
 
 /**
  * @brief Converts light event enum to human-readable string
  *
  * @param event The light event type
- * @return Wide string representation of the event
+ * @return Wide string literal naming the event
  */
-std::wstring CLightEventWatcher::GetLightEventTypeString(CRhinoEventWatcher::light_event event)
+const wchar_t* CLightEventWatcher::GetLightEventTypeString(CRhinoEventWatcher::light_event event)
 {
     switch (event)
     {
@@ -271,178 +711,503 @@ void CLightEventWatcher::ConvertLightsToMeters(std::vector<LightUtils::LightInfo
 {
     for (auto& light : lights)
     {
-        // Convert position coordinates to meters
-        light.location.x *= unitScale;
-        light.location.y *= unitScale;
-        light.location.z *= unitScale;
-
-        // Note: Direction vectors are unit vectors, so they don't need scaling
-        // Intensity and color values remain unchanged as they are not spatial measurements
+        ConvertLightToMeters(light, unitScale);
     }
 }
 
+void CLightEventWatcher::ConvertLightToMeters(LightUtils::LightInfo& light, double unitScale)
+{
+    // Convert position coordinates to meters
+    light.location.x *= unitScale;
+    light.location.y *= unitScale;
+    light.location.z *= unitScale;
+
+    // Note: Direction vectors are unit vectors, so they don't need scaling
+    // Intensity and color values remain unchanged as they are not spatial measurements
+}
+
 /**
  * @brief Sends light data to Unreal Engine via TCP connection
  *
- * Creates a simplified JSON payload with light data and sends it asynchronously
- * to prevent blocking the main thread. Handles all socket operations and cleanup.
+ * Creates a simplified JSON payload with light data and queues it on the
+ * network thread, so nothing waits for the receiver. Socket handling is shared
+ * with the other sync commands through LightSyncNetwork. Light records come
+ * from the fragment cache and are gathered into one vectored send next to the
+ * small per-message pieces, so unchanged lights are neither re-encoded nor
+ * copied. The pooled buffers the segments point into go back to the pool once
+ * the message was written.
  *
- * @param lights Vector of light information (already converted to meters)
+ * @param delivery Lights for one receiver (already converted to meters) and its port
  * @param eventType String describing the event type
- * @param port TCP port number to connect to (should match Unreal's listener)
+ * @param fragmentCache Fragment cache of the delivery's document
+ * @param done Called once with whether the message was sent (may be empty)
  */
-void CLightEventWatcher::SendLightDataToTCP(const std::vector<LightUtils::LightInfo>& lights,
-    const std::wstring& eventType, int port)
+void CLightEventWatcher::SendLightDataToTCP(const LightSyncSubscriptions::Delivery& delivery,
+    const wchar_t* eventType, LightFragmentCache& fragmentCache, LightSyncNetwork::SendHandler done)
 {
-    WSADATA wsaData;
-    SOCKET connectSocket = INVALID_SOCKET;
-
     try
     {
-        // Initialize Winsock library for network operations
-        int result = WSAStartup(MAKEWORD(2, 2), &wsaData);
-        if (result != 0)
+        // All per-message storage, and the shared_ptr the handler holds it by, comes from the pool
+        std::shared_ptr<LightSyncBuffers::EncodeBuffers> buffers = LightSyncBuffers::Encoders().Acquire();
         {
-            return; // Failed to initialize Winsock
+            LightSyncTrace::Span span("serialize");
+            LightSyncMetrics::ScopedTimer timer(LightSyncMetrics::Encode());
+            EncodeLightData(delivery, eventType, fragmentCache, *buffers);
         }
 
-        // Create TCP socket for communication
-        connectSocket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
-        if (connectSocket == INVALID_SOCKET)
+        // Send data to Unreal Engine; the segments may also point into a shared keyframe body. The
+        // handler holds the only reference to the buffers, so it can hand them back to the pool
+        std::vector<LightSyncNetwork::Segment> segments(buffers->segments);
+        // Only a quantized message that was sent may lend its scene indices to later partials
+        std::shared_ptr<const std::string> encodedLights = delivery.encodedLights;
+        const int port = delivery.port;
+        const bool quantized = delivery.quantized;
+        if (LightSyncNetwork::SendPayload(std::move(segments), port,
+            [buffers = std::move(buffers), encodedLights, done, port, quantized](bool sent) mutable
+        {
+            if (quantized)
+                LightQuantizedEncoder::Delivered(port, sent);
+            LightSyncBuffers::Encoders().Release(std::move(buffers));
+            if (done)
+                done(sent);
+        }))
         {
-            WSACleanup();
             return;
         }
+    }
+    catch (...)
+    {
+        // A serialization failure ends this message only
+    }
+
+    if (delivery.quantized)
+        LightQuantizedEncoder::Delivered(delivery.port, false);
+    if (done)
+        done(false);
+}
+
+/**
+ * @brief Builds a light data message as segments over pooled buffers
+ *
+ * The segments point into buffers and into cached fragments held by buffers,
+ * so they stay valid until the buffers are cleared or released.
+ *
+ * @param delivery Lights and header fields of the message
+ * @param eventType Event name written into the message
+ * @param fragmentCache Cache the light records are gathered from
+ * @param buffers Cleared buffers; segments receives the message in order
+ */
+void CLightEventWatcher::EncodeLightData(const LightSyncSubscriptions::Delivery& delivery,
+    const wchar_t* eventType, LightFragmentCache& fragmentCache, LightSyncBuffers::EncodeBuffers& buffers)
+{
+    static const char RECORD_SEPARATOR[] = ",\n";
+    static const char LAST_RECORD_END[] = "\n";
+    static const char MESSAGE_FOOTER[] = "  ]\n}";
+    const size_t lightCount = delivery.LightCount();
+    const auto lightAt = [&delivery](size_t index) -> const LightUtils::LightInfo& {
+        return delivery.LightAt(index);
+    };
+
+    // Quantized receivers get the whole message as one binary buffer
+    if (delivery.quantized)
+    {
+        LightQuantizedEncoder::Encode(delivery, eventType, buffers.header);
+        buffers.segments.push_back({ buffers.header.data(), buffers.header.size() });
+        return;
+    }
+
+    // Message header up to the opening of the lights array
+    AppendLightDataHeaderJSON(buffers.header, delivery, eventType);
+
+    // A resumed keyframe's lights were encoded once for every receiver
+    if (delivery.encodedLights)
+    {
+        buffers.segments.push_back({ buffers.header.data(), buffers.header.size() });
+        buffers.segments.push_back({ delivery.encodedLights->data(), delivery.encodedLights->size() });
+        return;
+    }
 
-        // Configure server address structure (connecting to local Unreal instance)
-        sockaddr_in serverAddr = {};
-        serverAddr.sin_family = AF_INET;
-        serverAddr.sin_port = htons(static_cast<u_short>(port));
+    // Encoded records of the lights, cached across events
+    fragmentCache.Gather(lightCount, lightAt, buffers.fragments);
 
-        // Convert IP address string to binary form
-        if (inet_pton(AF_INET, LOCALHOST_IP, &serverAddr.sin_addr) <= 0)
+    // Full records open with their position in the scene, which the cache cannot hold
+    buffers.prefixEnds.resize(lightCount);
+    for (size_t i = 0; i < lightCount; ++i)
+    {
+        if (lightAt(i).dirtyFields == LightUtils::FIELD_ALL)
         {
-            closesocket(connectSocket);
-            WSACleanup();
-            return;
+            buffers.indexPrefixes += "    {\n      \"id\": ";
+            AppendUnsigned(buffers.indexPrefixes, delivery.firstLightIndex + i);
+            buffers.indexPrefixes += ",\n";
         }
+        buffers.prefixEnds[i] = buffers.indexPrefixes.size();
+    }
+
+    std::vector<LightSyncNetwork::Segment>& segments = buffers.segments;
+    segments.reserve(3 * lightCount + 2);
+    segments.push_back({ buffers.header.data(), buffers.header.size() });
+    size_t prefixBegin = 0;
+    for (size_t i = 0; i < lightCount; ++i)
+    {
+        const LightFragmentCache::Fragment& fragment = buffers.fragments[i];
+        segments.push_back({ buffers.indexPrefixes.data() + prefixBegin, buffers.prefixEnds[i] - prefixBegin });
+        segments.push_back({ fragment->data(), fragment->size() });
+        if (i + 1 < lightCount)
+            segments.push_back({ RECORD_SEPARATOR, sizeof(RECORD_SEPARATOR) - 1 });
+        else
+            segments.push_back({ LAST_RECORD_END, sizeof(LAST_RECORD_END) - 1 });
+        prefixBegin = buffers.prefixEnds[i];
+    }
+    segments.push_back({ MESSAGE_FOOTER, sizeof(MESSAGE_FOOTER) - 1 });
+}
+
+/**
+ * @brief Encodes everything of a whole-scene message after its header
+ *
+ * @param snapshot Lights to encode, in scene order
+ * @param fragmentCache Cache of the snapshot's document
+ * @return Lights array and closing brackets as UTF-8
+ */
+std::string CLightEventWatcher::EncodeLightRecords(const LightSnapshot::Ptr& snapshot, LightFragmentCache& fragmentCache)
+{
+    LightSyncSubscriptions::Delivery delivery;
+    delivery.snapshot = snapshot;
+
+    std::shared_ptr<LightSyncBuffers::EncodeBuffers> pooled = LightSyncBuffers::Encoders().Acquire();
+    LightSyncBuffers::EncodeBuffers& buffers = *pooled;
+    EncodeLightData(delivery, L"", fragmentCache, buffers);
+
+    // The first segment is the header
+    size_t size = 0;
+    for (size_t i = 1; i < buffers.segments.size(); ++i)
+    {
+        size += buffers.segments[i].size;
+    }
+    std::string records;
+    records.reserve(size);
+    for (size_t i = 1; i < buffers.segments.size(); ++i)
+    {
+        records.append(buffers.segments[i].data, buffers.segments[i].size);
+    }
+    LightSyncBuffers::Encoders().Release(std::move(pooled));
+    return records;
+}
+
+struct CLightEventWatcher::Trickle
+{
+    std::shared_ptr<LightDocumentPipeline> pipeline;
+    LightSyncSubscriptions::Delivery delivery;  // Owns the lights in send order
+    const wchar_t* eventType;
+    LightSyncNetwork::SendHandler done;
+    size_t firstBatch;
+    size_t batchCount;
+    size_t batchIndex;  // Next batch to send
+    size_t begin;       // First light of the next batch
+
+    Trickle() : eventType(L""), firstBatch(0), batchCount(0), batchIndex(0), begin(0) {}
+};
 
-        // Set socket timeout to prevent hanging if Unreal isn't responding
-        setsockopt(connectSocket, SOL_SOCKET, SO_SNDTIMEO,
-            reinterpret_cast<const char*>(&TCP_TIMEOUT_MS), sizeof(TCP_TIMEOUT_MS));
+/**
+ * @brief Sends a receiver's lights ordered by their contribution to its view
+ *
+ * The visible lights closest to the receiver's camera go out immediately in the
+ * first message; the remaining lights follow in batches at a fixed interval,
+ * each one started by a network thread timer once the previous one was sent.
+ * Trickling stops as soon as a newer event has been resolved for the receiver,
+ * or when a batch could not be sent.
+ *
+ * @param pipeline Pipeline of the delivery's document, kept alive while trickling
+ * @param delivery Lights for one receiver with a valid camera (taken over)
+ * @param eventType String describing the event type
+ * @param done Called once the last batch was sent or trickling stopped
+ */
+void CLightEventWatcher::SendPrioritizedLightData(const std::shared_ptr<LightDocumentPipeline>& pipeline,
+    LightSyncSubscriptions::Delivery& delivery, const wchar_t* eventType, LightSyncNetwork::SendHandler done)
+{
+    std::shared_ptr<Trickle> trickle = std::make_shared<Trickle>();
+    trickle->pipeline = pipeline;
+    trickle->eventType = eventType;
+    trickle->done = std::move(done);
 
-        // Attempt connection to Unreal Engine's TCP listener
-        result = connect(connectSocket, reinterpret_cast<SOCKADDR*>(&serverAddr), sizeof(serverAddr));
-        if (result == SOCKET_ERROR)
+    try
+    {
+        // The receiver's own ordering needs its own copy of a shared snapshot
+        if (delivery.snapshot)
         {
-            closesocket(connectSocket);
-            WSACleanup();
-            return;
+            delivery.lights = LightSyncBuffers::Lights().Acquire();
+            delivery.snapshot->CopyTo(delivery.lights);
+            delivery.snapshot.reset();
         }
 
-        // Create simplified JSON payload with light data including rotation
-        std::wstring jsonData = CreateLightDataJSON(lights, eventType);
-        std::string utf8Data = WStringToUTF8(jsonData);
+        const size_t totalLights = delivery.lights.size();
+        const size_t visibleCount = LightPrioritizer::SortByContribution(delivery.lights, delivery.camera);
+
+        // Visible lights first (capped), or the top ranked lights if nothing is in view
+        trickle->firstBatch = std::min(visibleCount > 0 ? visibleCount : totalLights,
+            LightPrioritizer::FIRST_BATCH_SIZE);
+        const size_t remaining = totalLights - trickle->firstBatch;
+        trickle->batchCount = 1 + (remaining + LightPrioritizer::TRICKLE_BATCH_SIZE - 1) /
+            LightPrioritizer::TRICKLE_BATCH_SIZE;
+        trickle->delivery = std::move(delivery);
+    }
+    catch (...)
+    {
+        FinishTrickle(trickle, false);
+        return;
+    }
 
-        // Send data to Unreal Engine
-        result = send(connectSocket, utf8Data.c_str(), static_cast<int>(utf8Data.length()), 0);
+    SendTrickleBatch(trickle);
+}
 
-        // Clean up connection
-        closesocket(connectSocket);
-        WSACleanup();
+/**
+ * @brief Sends the next batch of a trickle and schedules the one after it
+ *
+ * @param trickle Trickle with at least one batch left
+ */
+void CLightEventWatcher::SendTrickleBatch(const std::shared_ptr<Trickle>& trickle)
+{
+    const LightSyncSubscriptions::Delivery& delivery = trickle->delivery;
+    const size_t batchIndex = trickle->batchIndex;
+    const size_t totalLights = delivery.lights.size();
+    const size_t end = std::min(totalLights,
+        trickle->begin + (batchIndex == 0 ? trickle->firstBatch : LightPrioritizer::TRICKLE_BATCH_SIZE));
 
-        // Note: Can't use RhinoApp().Print() here as this runs in a separate thread
+    LightSyncSubscriptions::Delivery batch;
+    batch.port = delivery.port;
+    batch.document = delivery.document;
+    batch.sequence = delivery.sequence;
+    batch.transformSequence = delivery.transformSequence;
+    batch.regionScoped = delivery.regionScoped;
+    batch.quantized = delivery.quantized;
+    batch.positionStep = delivery.positionStep;
+    batch.batchIndex = batchIndex;
+    batch.batchCount = trickle->batchCount;
+    batch.firstLightIndex = trickle->begin;
+    batch.totalLightCount = totalLights;
+    batch.lights = LightSyncBuffers::Lights().Acquire();
+    batch.lights.assign(delivery.lights.begin() + trickle->begin, delivery.lights.begin() + end);
+    if (batchIndex == 0)
+    {
+        batch.entered.swap(trickle->delivery.entered);
+        batch.left.swap(trickle->delivery.left);
     }
-    catch (...)
+
+    trickle->batchIndex = batchIndex + 1;
+    trickle->begin = end;
+
+    SendLightDataToTCP(batch, trickle->eventType, trickle->pipeline->FragmentCache(), [trickle](bool sent)
     {
-        // Ensure cleanup on any exception to prevent resource leaks
-        if (connectSocket != INVALID_SOCKET)
+        if (!sent || trickle->batchIndex >= trickle->batchCount)
         {
-            closesocket(connectSocket);
+            FinishTrickle(trickle, sent);
+            return;
         }
-        WSACleanup();
-    }
+
+        const LightSyncReactor::TimerId timer = LightSyncReactor::AddTimer(
+            std::chrono::milliseconds(LightPrioritizer::TRICKLE_INTERVAL_MS), [trickle]()
+        {
+            if (!LightSyncSubscriptions::IsCurrentSequence(trickle->delivery.port, trickle->delivery.sequence))
+            {
+                FinishTrickle(trickle, true); // A newer scene is on its way
+                return;
+            }
+            SendTrickleBatch(trickle);
+        });
+        if (timer == 0)
+        {
+            FinishTrickle(trickle, false);
+        }
+    });
+    LightSyncBuffers::Lights().Release(std::move(batch.lights));
+}
+
+/**
+ * @brief Releases a trickle's lights and reports it to the channel
+ *
+ * @param trickle Trickle that sent its last batch or stopped
+ * @param sent False if a batch failed
+ */
+void CLightEventWatcher::FinishTrickle(const std::shared_ptr<Trickle>& trickle, bool sent)
+{
+    ReleaseDeliveryLights(trickle->delivery);
+    LightSyncNetwork::SendHandler done = std::move(trickle->done);
+    if (done)
+        done(sent);
 }
 
 /**
- * @brief Creates simplified JSON representation of light data with rotation
+ * @brief Writes the JSON root object up to the opening of its lights array
  *
  * Creates a streamlined JSON structure optimized for Unreal Engine consumption.
- * Includes rotation data directly instead of direction vectors to avoid conversion issues.
+ * Region-scoped deliveries additionally list the ids of lights that entered or
+ * left the receiver's regions since its previous message. The light records and
+ * the closing brackets are appended by EncodeLightData. Written straight as
+ * UTF-8 into a pooled buffer.
  *
- * @param lights Vector of light information (already converted to meters)
+ * @param out Buffer to append to
+ * @param delivery Lights for one receiver (already converted to meters)
  * @param eventType String describing the event type
- * @return JSON string containing all light data
  */
-std::wstring CLightEventWatcher::CreateLightDataJSON(const std::vector<LightUtils::LightInfo>& lights,
-    const std::wstring& eventType)
+void CLightEventWatcher::AppendLightDataHeaderJSON(std::string& out,
+    const LightSyncSubscriptions::Delivery& delivery, const wchar_t* eventType)
 {
-    std::wstringstream json;
-
     // JSON root object - simplified structure
-    json << L"{\n";
-    json << L"  \"event\": \"" << eventType << L"\",\n";
-    json << L"  \"lightCount\": " << lights.size() << L",\n";
-    json << L"  \"lights\": [\n";
-
-    // Serialize each light with rotation data
-    for (size_t i = 0; i < lights.size(); ++i)
-    {
-        const auto& light = lights[i];
-
-        json << L"    {\n";
-        json << L"      \"id\": " << i << L",\n";
-        json << L"      \"type\": \"" << light.type << L"\",\n";
-
-        // Position in meters (already converted)
-        json << L"      \"location\": {\n";
-        json << L"        \"x\": " << std::fixed << std::setprecision(6) << light.location.x << L",\n";
-        json << L"        \"y\": " << std::fixed << std::setprecision(6) << light.location.y << L",\n";
-        json << L"        \"z\": " << std::fixed << std::setprecision(6) << light.location.z << L"\n";
-        json << L"      },\n";
-
-        // Calculate and send rotation directly instead of direction vector
-        // This avoids complex vector-to-rotation conversion in Unreal
-        FRhinoRotation rotation = DirectionToRhinoRotation(light.direction);
-        json << L"      \"rotation\": {\n";
-        json << L"        \"pitch\": " << std::fixed << std::setprecision(3) << rotation.pitch << L",\n";
-        json << L"        \"yaw\": " << std::fixed << std::setprecision(3) << rotation.yaw << L",\n";
-        json << L"        \"roll\": " << std::fixed << std::setprecision(3) << rotation.roll << L"\n";
-        json << L"      },\n";
-
-        json << L"      \"intensity\": " << light.intensity << L",\n";
-
-        // RGB color values (0-255 range)
-        json << L"      \"color\": {\n";
-        json << L"        \"r\": " << static_cast<int>(light.color.Red()) << L",\n";
-        json << L"        \"g\": " << static_cast<int>(light.color.Green()) << L",\n";
-        json << L"        \"b\": " << static_cast<int>(light.color.Blue()) << L"\n";
-        json << L"      }";
-
-        // Optional spotlight parameters
-        if (light.isSpotLight)
+    out += "{\n";
+    out += "  \"event\": \"";
+    LightSyncNetwork::AppendUTF8(out, eventType, wcslen(eventType));
+    out += "\",\n";
+    out += "  \"document\": ";
+    AppendUnsigned(out, delivery.document);
+    out += ",\n";
+    out += "  \"sequence\": ";
+    AppendUnsigned(out, delivery.sequence);
+    out += ",\n";
+
+    // Receivers report the last version they applied when they resume
+    if (delivery.version > 0)
+    {
+        out += "  \"version\": ";
+        AppendUnsigned(out, delivery.version);
+        out += ",\n";
+    }
+
+    // Live drag samples with a lower transform sequence are older than these lights
+    if (delivery.transformSequence > 0)
+    {
+        out += "  \"transformSequence\": ";
+        AppendUnsigned(out, delivery.transformSequence);
+        out += ",\n";
+    }
+    out += "  \"lightCount\": ";
+    AppendUnsigned(out, delivery.LightCount());
+    out += ",\n";
+
+    // Partial messages update the listed lights and leave all others untouched
+    if (delivery.partial)
+    {
+        out += "  \"partial\": true,\n";
+    }
+
+    // Prioritized scenes arrive in several messages that share the same sequence
+    if (delivery.batchCount > 1)
+    {
+        out += "  \"batch\": {\"index\": ";
+        AppendUnsigned(out, delivery.batchIndex);
+        out += ", \"count\": ";
+        AppendUnsigned(out, delivery.batchCount);
+        out += ", \"totalLightCount\": ";
+        AppendUnsigned(out, delivery.totalLightCount);
+        out += "},\n";
+    }
+
+    if (delivery.regionScoped)
+    {
+        out += "  \"regionScoped\": true,\n";
+        AppendUuidArrayJSON(out, "entered", delivery.entered);
+        AppendUuidArrayJSON(out, "left", delivery.left);
+    }
+
+    out += "  \"lights\": [\n";
+}
+
+/**
+ * @brief Encodes one light record as UTF-8 for the fragment cache
+ *
+ * Full records start after their "id" member, which depends on the light's
+ * position in the message and is written by the sender. Includes rotation data
+ * directly instead of direction vectors to avoid conversion issues. Field
+ * updates are written as a single line holding only their dirty fields.
+ *
+ * @param light Light with position already converted to meters
+ * @return UTF-8 record without trailing separator
+ */
+std::string CLightEventWatcher::EncodeLightRecord(const LightUtils::LightInfo& light)
+{
+    std::string json;
+    json.reserve(RECORD_RESERVE_BYTES);
+
+    // Field updates carry only the dirty fields on one line
+    if (light.dirtyFields != LightUtils::FIELD_ALL)
+    {
+        json += "    ";
+        AppendSparseLightJSON(json, light);
+        return json;
+    }
+
+    json += "      \"uuid\": \"";
+    LightUtils::AppendUuid(json, light.id);
+    json += "\"";
+
+    // Every field of the schema that applies to this light, one member per line
+    LightSchema::ForEachField([&json, &light](const auto& field) {
+        const auto value = field.get(light);
+        if (field.complete && LightSchema::IsPresent(value))
         {
-            json << L",\n";
-            json << L"      \"spotLight\": {\n";
-            json << L"        \"innerAngle\": " << light.innerAngle << L",\n";
-            json << L"        \"outerAngle\": " << light.outerAngle << L"\n";
-            json << L"      }";
+            json += ",\n      \"";
+            json += field.name;
+            json += "\": ";
+            WriteJSONValue(json, value, field.precision, "      ");
         }
+    });
 
-        json << L"\n    }";
+    json += "\n    }";
+    return json;
+}
 
-        // Add comma if not the last element
-        if (i < lights.size() - 1)
+/**
+ * @brief Writes a light record holding only its dirty fields
+ *
+ * Layout: {"uuid": "...", "fields": <mask>, ...} followed by the members of the
+ * set bits in schema order, in the same units and precision as full records.
+ * Bits: 1 location, 2 rotation, 4 intensity, 8 color, 16 spot angles,
+ * 32 enabled. A record with the FIELD_ENABLED bit and "enabled": false tells
+ * the receiver to drop the light.
+ *
+ * @param json UTF-8 text the record is appended to
+ * @param light Light whose dirtyFields select the members written
+ */
+void CLightEventWatcher::AppendSparseLightJSON(std::string& json, const LightUtils::LightInfo& light)
+{
+    const unsigned int fields = light.dirtyFields;
+
+    json += "{\"uuid\": \"";
+    LightUtils::AppendUuid(json, light.id);
+    json += "\", \"fields\": ";
+    AppendNumber(json, static_cast<int>(fields), -1);
+
+    LightSchema::ForEachField([&json, &light, fields](const auto& field) {
+        if (fields & field.bit)
         {
-            json << L",";
+            json += ", \"";
+            json += field.name;
+            json += "\": ";
+            WriteJSONValue(json, field.get(light), field.precision, nullptr);
         }
-        json << L"\n";
-    }
+    });
 
-    json << L"  ]\n";
-    json << L"}";
+    json += "}";
+}
 
-    return json.str();
+/**
+ * @brief Writes a named JSON array of light ids followed by a comma
+ *
+ * @param out Buffer the root object is being written to
+ * @param name Member name
+ * @param ids Light ids to list
+ */
+void CLightEventWatcher::AppendUuidArrayJSON(std::string& out, const char* name,
+    const std::vector<ON_UUID>& ids)
+{
+    out += "  \"";
+    out += name;
+    out += "\": [";
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+        out += (i == 0 ? "\"" : ", \"");
+        LightUtils::AppendUuid(out, ids[i]);
+        out += "\"";
+    }
+    out += "],\n";
 }
 
 /**
@@ -475,28 +1240,3 @@ CLightEventWatcher::FRhinoRotation CLightEventWatcher::DirectionToRhinoRotation(
 
     return rotation;
 }
-
-/**
- * @brief Converts wide string to UTF-8 encoded string for network transmission
- *
- * @param wstr Wide string to convert
- * @return UTF-8 encoded string suitable for network transmission
- */
-std::string CLightEventWatcher::WStringToUTF8(const std::wstring& wstr)
-{
-    if (wstr.empty())
-        return std::string();
-
-    // Calculate required buffer size
-    int size_needed = WideCharToMultiByte(CP_UTF8, 0, wstr.data(), static_cast<int>(wstr.size()),
-        nullptr, 0, nullptr, nullptr);
-    if (size_needed <= 0)
-        return std::string();
-
-    // Perform the conversion
-    std::string strTo(size_needed, 0);
-    WideCharToMultiByte(CP_UTF8, 0, wstr.data(), static_cast<int>(wstr.size()),
-        &strTo[0], size_needed, nullptr, nullptr);
-
-    return strTo;
-}
\ No newline at end of file
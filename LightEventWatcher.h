@@ -13,15 +13,23 @@
 #pragma once
 
 #include "stdafx.h"
+#include "LightChangeTracker.h"
+#include "LightFragmentCache.h"
+#include "LightSyncBuffers.h"
+#include "LightSyncNetwork.h"
+#include "LightSyncSubscriptions.h"
 #include "LightUtils.h"
-#include <set>
+#include <memory>
+
+class LightDocumentPipeline;
 
 /**
  * @brief Event watcher class for monitoring Rhino light table changes
  *
  * This class inherits from CRhinoEventWatcher and monitors light-related events
  * in Rhino (add, delete, modify operations). When events occur, it synchronizes
- * the light data with Unreal Engine via TCP communication.
+ * the light data with Unreal Engine via TCP communication. Each document is
+ * synchronized through its own LightDocumentPipeline.
  */
 class CLightEventWatcher : public CRhinoEventWatcher
 {
@@ -50,28 +58,102 @@ public:
     virtual void LightTableEvent(CRhinoEventWatcher::light_event event,
         const CRhinoLightTable& table, int lightIndex, const ON_Light* light) override;
 
+    /**
+     * @brief Compacts deleted-light tombstones when their undo record is purged
+     */
+    virtual void UndoEvent(CRhinoEventWatcher::undo_event type, unsigned int undo_record_serialno,
+        const CRhinoCommand* cmd) override;
+
+    /**
+     * @brief Drops the closing document's pipeline, tombstones and receiver bindings
+     */
+    virtual void OnCloseDocument(CRhinoDoc& doc) override;
+
+    /**
+     * @brief Lists new and opened documents for receivers to subscribe to
+     */
+    virtual void OnNewDocument(CRhinoDoc& doc) override;
+    virtual void OnEndOpenDocument(CRhinoDoc& doc, const wchar_t* filename, BOOL bMerge, BOOL bReference) override;
+
+    /**
+     * @brief Converts a light direction to the pitch/yaw/roll sent to Unreal
+     *
+     * Shared with the sun study command so keyframes use the same convention.
+     */
+    static FRhinoRotation DirectionToRhinoRotation(const ON_3dVector& direction);
+
+    /**
+     * @brief Gets the scale factor to convert model units to meters
+     */
+    static double GetModelUnitScaleToMeters(CRhinoDoc* doc);
+
+    /**
+     * @brief Scales a light's position from model units to meters
+     */
+    static void ConvertLightToMeters(LightUtils::LightInfo& light, double unitScale);
+
+    /**
+     * @brief Encodes one light record as sent in light data messages
+     *
+     * Used by the fragment cache and by the encoding benchmark.
+     */
+    static std::string EncodeLightRecord(const LightUtils::LightInfo& light);
+
+    /**
+     * @brief Builds a complete light data message as send segments
+     *
+     * Records come from fragmentCache (encoded with EncodeLightRecord). Used by
+     * the network thread and by the encoding benchmark.
+     */
+    static void EncodeLightData(const LightSyncSubscriptions::Delivery& delivery, const wchar_t* eventType,
+        LightFragmentCache& fragmentCache, LightSyncBuffers::EncodeBuffers& buffers);
+
+    /**
+     * @brief Encodes a snapshot's lights array and closing brackets as one string
+     *
+     * The message without its header; resumed keyframes are sent from it.
+     */
+    static std::string EncodeLightRecords(const LightSnapshot::Ptr& snapshot, LightFragmentCache& fragmentCache);
+
+    /**
+     * @brief Sends one delivery taken off a document's channel and releases its lights
+     *
+     * done is called once the delivery (every batch of a trickle) was sent or failed.
+     */
+    static void SendDelivery(const std::shared_ptr<LightDocumentPipeline>& pipeline,
+        LightSyncSubscriptions::Delivery& delivery, const wchar_t* eventType, LightSyncNetwork::SendHandler done);
+
+    /**
+     * @brief Hands a delivery's own light list back to the pool (sent or superseded)
+     */
+    static void ReleaseDeliveryLights(LightSyncSubscriptions::Delivery& delivery);
+
 private:
-    // Blacklist to track deleted lights by their serial number
-    static std::set<unsigned int> m_deletedLightsBlacklist;
+    // Prioritized delivery whose batches are being sent
+    struct Trickle;
 
     // Event processing functions
-    static std::wstring GetLightEventTypeString(CRhinoEventWatcher::light_event event);
-    static double GetModelUnitScaleToMeters(CRhinoDoc* doc);
+    static const wchar_t* GetLightEventTypeString(CRhinoEventWatcher::light_event event);
     static void ConvertLightsToMeters(std::vector<LightUtils::LightInfo>& lights, double unitScale);
+    static void SendLiveDragCommit(LightDocumentPipeline& pipeline, CRhinoDoc* doc, const CRhinoLight& rhinoLight);
+    static bool SendFieldUpdate(LightDocumentPipeline& pipeline, const LightUtils::LightInfo& light,
+        unsigned int changedFields, double unitScale);
+    static void PushToAgent(LightDocumentPipeline& pipeline, const std::vector<LightUtils::LightInfo>& lights,
+        const wchar_t* eventType);
+    static void SeedKeyframe(LightDocumentPipeline& pipeline, CRhinoDoc& doc);
 
-    // Blacklist management functions
-    static void AddToBlacklist(unsigned int lightSerialNumber);
-    static void RemoveFromBlacklist(unsigned int lightSerialNumber);
-    static bool IsBlacklisted(unsigned int lightSerialNumber);
-    static std::vector<LightUtils::LightInfo> FilterBlacklistedLights(const std::vector<LightUtils::LightInfo>& allLights, CRhinoDoc* doc);
+    // Deleted lights are tracked per document in LightTombstoneStore
+    static void FilterDeletedLights(unsigned int docSerial, std::vector<LightUtils::LightInfo>& lights);
 
     // Network communication functions
-    static void SendLightDataToTCP(const std::vector<LightUtils::LightInfo>& lights,
-        const std::wstring& eventType, int port);
-    static std::wstring CreateLightDataJSON(const std::vector<LightUtils::LightInfo>& lights,
-        const std::wstring& eventType);
-
-    // Utility functions
-    static FRhinoRotation DirectionToRhinoRotation(const ON_3dVector& direction);
-    static std::string WStringToUTF8(const std::wstring& wstr);
+    static void SendLightDataToTCP(const LightSyncSubscriptions::Delivery& delivery,
+        const wchar_t* eventType, LightFragmentCache& fragmentCache, LightSyncNetwork::SendHandler done);
+    static void SendPrioritizedLightData(const std::shared_ptr<LightDocumentPipeline>& pipeline,
+        LightSyncSubscriptions::Delivery& delivery, const wchar_t* eventType, LightSyncNetwork::SendHandler done);
+    static void SendTrickleBatch(const std::shared_ptr<Trickle>& trickle);
+    static void FinishTrickle(const std::shared_ptr<Trickle>& trickle, bool sent);
+    static void AppendLightDataHeaderJSON(std::string& out, const LightSyncSubscriptions::Delivery& delivery,
+        const wchar_t* eventType);
+    static void AppendSparseLightJSON(std::string& json, const LightUtils::LightInfo& light);
+    static void AppendUuidArrayJSON(std::string& out, const char* name, const std::vector<ON_UUID>& ids);
 };
\ No newline at end of file
@@ -0,0 +1,107 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+
+#include "stdafx.h"
+#include "LightFragmentCache.h"
+#include "LightChangeTracker.h"
+#include <unordered_set>
+#include <utility>
+
+LightFragmentCache::LightFragmentCache(Encoder encoder)
+    : m_encoder(std::move(encoder))
+{
+}
+
+/**
+ * @brief Looks up or encodes the record of every light
+ *
+ * @param lights Lights in message order (positions in meters)
+ * @param fragments Receives one fragment per light, replacing its contents
+ * @param maxThreads Encoding threads to use, 0 for the whole worker pool
+ */
+void LightFragmentCache::Gather(const std::vector<LightUtils::LightInfo>& lights, std::vector<Fragment>& fragments,
+    size_t maxThreads)
+{
+    Gather(lights.size(), [&lights](size_t index) -> const LightUtils::LightInfo& { return lights[index]; },
+        fragments, maxThreads);
+}
+
+LightFragmentCache::Fragment LightFragmentCache::CachedFragment(const LightUtils::LightInfo& light,
+    uint64_t& hash) const
+{
+    if (light.dirtyFields != LightUtils::FIELD_ALL)
+    {
+        return Fragment();
+    }
+
+    hash = LightChangeTracker::HashLight(light);
+    auto entry = m_entries.find(light.id);
+    if (entry == m_entries.end() || entry->second.hash != hash)
+    {
+        return Fragment();
+    }
+    return entry->second.fragment;
+}
+
+void LightFragmentCache::Store(const LightUtils::LightInfo& light, uint64_t hash, const Fragment& fragment)
+{
+    if (light.dirtyFields != LightUtils::FIELD_ALL)
+    {
+        return;
+    }
+
+    Entry& entry = m_entries[light.id];
+    entry.hash = hash;
+    entry.fragment = fragment;
+}
+
+/**
+ * @brief Removes the entries of deleted or switched-off lights
+ *
+ * Only walks the cache when it holds more entries than there are active lights.
+ *
+ * @param activeLights Lights of the current scene
+ */
+void LightFragmentCache::Prune(const std::vector<LightUtils::LightInfo>& activeLights)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_entries.size() <= activeLights.size())
+    {
+        return;
+    }
+
+    std::unordered_set<ON_UUID, LightUtils::UuidHash> active;
+    active.reserve(activeLights.size());
+    for (const auto& light : activeLights)
+    {
+        active.insert(light.id);
+    }
+
+    for (auto entry = m_entries.begin(); entry != m_entries.end();)
+    {
+        if (active.find(entry->first) == active.end())
+        {
+            entry = m_entries.erase(entry);
+        }
+        else
+        {
+            ++entry;
+        }
+    }
+}
+
+size_t LightFragmentCache::Count() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.size();
+}
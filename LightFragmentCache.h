@@ -0,0 +1,124 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+
+#pragma once
+
+#include "stdafx.h"
+#include "LightUtils.h"
+#include "LightWorkerPool.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Cache of each light's encoded record, keyed by UUID
+ *
+ * A full-scene message is mostly lights that did not change since the last
+ * one, so their encoded bytes are kept and handed out as shared fragments that
+ * a sender can gather into one vectored send. An entry is re-encoded only when
+ * the light's content hash differs from the one it was encoded with. Fragments
+ * are immutable and reference counted, so a sender still holding one is not
+ * affected when the light changes. Safe to use from any thread.
+ *
+ * Records that are not cached (a cold resync) are encoded outside the lock in
+ * chunks of ENCODE_CHUNK_SIZE lights spread over LightWorkerPool. Every record
+ * lands in its own slot, so the gathered message is byte-identical whatever
+ * the thread count.
+ */
+class LightFragmentCache
+{
+public:
+    typedef std::shared_ptr<const std::string> Fragment;
+    typedef std::function<std::string(const LightUtils::LightInfo&)> Encoder;
+
+    // Lights encoded per worker task
+    static const size_t ENCODE_CHUNK_SIZE = 512;
+
+    explicit LightFragmentCache(Encoder encoder);
+
+    // One fragment per light, in order; partial records (dirtyFields != FIELD_ALL) are never cached.
+    // maxThreads limits the encoding threads (0 = whole worker pool).
+    void Gather(const std::vector<LightUtils::LightInfo>& lights, std::vector<Fragment>& fragments,
+        size_t maxThreads = 0);
+
+    // Same for lights read through an accessor (snapshots): lightAt(i) returns the i-th light
+    template <class LightAt>
+    void Gather(size_t lightCount, const LightAt& lightAt, std::vector<Fragment>& fragments,
+        size_t maxThreads = 0)
+    {
+        fragments.clear();
+        fragments.resize(lightCount);
+
+        // Cached records are handed out under the lock; the rest are only noted
+        std::vector<size_t> missing;
+        std::vector<uint64_t> missingHashes;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (size_t i = 0; i < lightCount; ++i)
+            {
+                uint64_t hash = 0;
+                fragments[i] = CachedFragment(lightAt(i), hash);
+                if (!fragments[i])
+                {
+                    missing.push_back(i);
+                    missingHashes.push_back(hash);
+                }
+            }
+        }
+        if (missing.empty())
+        {
+            return;
+        }
+
+        // Encoding is the expensive part and needs no shared state
+        LightWorkerPool::ParallelFor(missing.size(), ENCODE_CHUNK_SIZE,
+            [&](size_t begin, size_t end) {
+                for (size_t m = begin; m < end; ++m)
+                {
+                    fragments[missing[m]] = std::make_shared<const std::string>(m_encoder(lightAt(missing[m])));
+                }
+            }, maxThreads);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (size_t m = 0; m < missing.size(); ++m)
+        {
+            Store(lightAt(missing[m]), missingHashes[m], fragments[missing[m]]);
+        }
+    }
+
+    // Drops entries of lights that are no longer active
+    void Prune(const std::vector<LightUtils::LightInfo>& activeLights);
+
+    size_t Count() const;
+
+private:
+    // Cached record, or null with hash set to the light's content hash; caller holds m_mutex
+    Fragment CachedFragment(const LightUtils::LightInfo& light, uint64_t& hash) const;
+
+    // Keeps a freshly encoded complete record; caller holds m_mutex
+    void Store(const LightUtils::LightInfo& light, uint64_t hash, const Fragment& fragment);
+
+    struct Entry
+    {
+        uint64_t hash;
+        Fragment fragment;
+    };
+
+    Encoder m_encoder;
+    mutable std::mutex m_mutex;
+    std::unordered_map<ON_UUID, Entry, LightUtils::UuidHash> m_entries;
+};
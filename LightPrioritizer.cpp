@@ -0,0 +1,143 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+#include "stdafx.h"
+#include "LightPrioritizer.h"
+#include "LightSyncBuffers.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace {
+    constexpr double DEG_TO_RAD = ON_PI / 180.0;
+
+    // Lights outside the view cone still light visible surfaces, just less often
+    constexpr double OUTSIDE_VIEW_FACTOR = 0.2;
+
+    // Spot lights aimed away from the viewed area contribute little
+    constexpr double SPOT_AWAY_FACTOR = 0.3;
+
+    // Extra cone margin so lights just off screen that spill into view count as visible
+    constexpr double VIEW_MARGIN_DEGREES = 10.0;
+
+    // Distances closer than this (meters) do not raise the score further
+    constexpr double MIN_DISTANCE = 1.0;
+}
+
+/**
+ * @brief Estimates how much a light contributes to the receiver's view
+ *
+ * Directional lights affect the whole view and always rank first. Point and spot
+ * lights fall off with the squared distance to the camera.
+ *
+ * @param light Light with position in meters
+ * @param camera Receiver camera
+ * @param visible Receives whether the light lies inside the view cone
+ * @return Relative contribution score (higher is more important)
+ */
+double LightPrioritizer::EstimateContribution(const LightUtils::LightInfo& light, const Camera& camera, bool& visible)
+{
+    if (light.type == LightUtils::LightType::Directional)
+    {
+        visible = true;
+        return std::numeric_limits<double>::max();
+    }
+
+    ON_3dVector toLight(light.location.x - camera.position.x,
+        light.location.y - camera.position.y,
+        light.location.z - camera.position.z);
+    const double distance = std::max(toLight.Length(), MIN_DISTANCE);
+
+    double score = fabs(light.intensity) / (distance * distance);
+
+    // View cone test against the camera forward axis
+    const double halfAngle = (0.5 * camera.fovDegrees + VIEW_MARGIN_DEGREES) * DEG_TO_RAD;
+    const double cosToLight = ON_DotProduct(toLight, camera.forward) / distance;
+    visible = cosToLight >= cos(std::min(halfAngle, ON_PI));
+    if (!visible)
+    {
+        score *= OUTSIDE_VIEW_FACTOR;
+    }
+
+    // A spot light only matters if its cone reaches the area the camera looks at
+    if (light.isSpotLight)
+    {
+        ON_3dPoint viewedPoint(camera.position.x + camera.forward.x * distance,
+            camera.position.y + camera.forward.y * distance,
+            camera.position.z + camera.forward.z * distance);
+        ON_3dVector toViewed(viewedPoint.x - light.location.x,
+            viewedPoint.y - light.location.y,
+            viewedPoint.z - light.location.z);
+        ON_3dVector spotAxis = light.direction;
+
+        if (toViewed.Unitize() && spotAxis.Unitize())
+        {
+            const double coneAngle = std::max(light.innerAngle, light.outerAngle) * DEG_TO_RAD;
+            if (ON_DotProduct(toViewed, spotAxis) < cos(std::min(coneAngle, ON_PI)))
+            {
+                score *= SPOT_AWAY_FACTOR;
+            }
+        }
+    }
+
+    return score;
+}
+
+/**
+ * @brief Sorts lights so the most important ones come first
+ *
+ * Visible lights are ordered before invisible ones, each group by descending score.
+ *
+ * @param lights Lights to reorder in place
+ * @param camera Receiver camera
+ * @return Number of visible lights at the front of the vector
+ */
+size_t LightPrioritizer::SortByContribution(std::vector<LightUtils::LightInfo>& lights, const Camera& camera)
+{
+    struct Ranked
+    {
+        double score;
+        bool visible;
+        size_t index;
+    };
+
+    std::vector<Ranked> ranking;
+    ranking.reserve(lights.size());
+    for (size_t i = 0; i < lights.size(); ++i)
+    {
+        Ranked ranked;
+        ranked.index = i;
+        ranked.score = EstimateContribution(lights[i], camera, ranked.visible);
+        ranking.push_back(ranked);
+    }
+
+    std::stable_sort(ranking.begin(), ranking.end(), [](const Ranked& a, const Ranked& b) {
+        if (a.visible != b.visible)
+            return a.visible;
+        return a.score > b.score;
+        });
+
+    LightSyncBuffers::LightList sorted = LightSyncBuffers::Lights().Acquire();
+    sorted.reserve(lights.size());
+    size_t visibleCount = 0;
+    for (const auto& ranked : ranking)
+    {
+        sorted.push_back(std::move(lights[ranked.index]));
+        if (ranked.visible)
+            ++visibleCount;
+    }
+    lights.swap(sorted);
+    LightSyncBuffers::Lights().Release(std::move(sorted));
+
+    return visibleCount;
+}
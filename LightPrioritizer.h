@@ -0,0 +1,51 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+#pragma once
+
+#include "stdafx.h"
+#include "LightUtils.h"
+#include <vector>
+
+/**
+ * @brief Orders lights by their estimated on-screen contribution for a receiver camera
+ *
+ * Receivers report their camera through the control channel. Lights are scored
+ * from intensity and distance, boosted when they fall inside the view cone and
+ * damped when a spot light's cone points away from what the camera looks at.
+ * The highest scoring lights are sent first and the rest trickle in afterwards.
+ */
+class LightPrioritizer
+{
+public:
+    // Receiver camera in meters (same frame as the light positions sent)
+    struct Camera
+    {
+        bool valid;
+        ON_3dPoint position;
+        ON_3dVector forward;     // Unit view direction
+        double fovDegrees;       // Full horizontal field of view
+
+        Camera() : valid(false), forward(1.0, 0.0, 0.0), fovDegrees(90.0) {}
+    };
+
+    // Scores one light; visible is set when the light lies inside the view cone
+    static double EstimateContribution(const LightUtils::LightInfo& light, const Camera& camera, bool& visible);
+
+    // Sorts lights by descending contribution and returns how many are visible
+    static size_t SortByContribution(std::vector<LightUtils::LightInfo>& lights, const Camera& camera);
+
+    // Batching of prioritized sends
+    static constexpr size_t FIRST_BATCH_SIZE = 256;     // Visible lights sent immediately
+    static constexpr size_t TRICKLE_BATCH_SIZE = 512;   // Remaining lights per trickle message
+    static constexpr unsigned int TRICKLE_INTERVAL_MS = 50;
+};
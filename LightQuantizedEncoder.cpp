@@ -0,0 +1,256 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+#include "stdafx.h"
+#include "LightQuantizedEncoder.h"
+#include "LightQuantizedHandles.h"
+#include "LightSchema.h"
+#include "LightSyncNetwork.h"
+#include "Receiver/LightQuantizedFormat.h"
+#include <cmath>
+#include <cwchar>
+#include <map>
+#include <mutex>
+
+namespace {
+    typedef LightQuantizedHandles<ON_UUID, LightUtils::UuidHash> HandleTable;
+
+    std::mutex g_tablesMutex;
+    std::map<int, HandleTable> g_tables;
+
+    void AppendUuid(std::string& out, const ON_UUID& id)
+    {
+        // Text order: Data1, Data2 and Data3 big-endian, then Data4
+        for (int shift = 24; shift >= 0; shift -= 8)
+            out += static_cast<char>((id.Data1 >> shift) & 0xFF);
+        out += static_cast<char>(id.Data2 >> 8);
+        out += static_cast<char>(id.Data2 & 0xFF);
+        out += static_cast<char>(id.Data3 >> 8);
+        out += static_cast<char>(id.Data3 & 0xFF);
+        out.append(reinterpret_cast<const char*>(id.Data4), sizeof(id.Data4));
+    }
+
+    int64_t ToSteps(double meters, double step)
+    {
+        return static_cast<int64_t>(std::llround(meters / step));
+    }
+
+    // Position grid of one message
+    struct Grid
+    {
+        double step;
+        const int64_t* origin;
+    };
+
+    // Quantized form of each schema value type, see LightQuantizedFormat.h
+    void AppendValue(std::string& out, LightUtils::LightType type, const Grid&)
+    {
+        out += static_cast<char>(type);
+    }
+
+    void AppendValue(std::string& out, bool enabled, const Grid&)
+    {
+        out += static_cast<char>(enabled ? 1 : 0);
+    }
+
+    void AppendValue(std::string& out, const ON_3dPoint& location, const Grid& grid)
+    {
+        const double coordinates[3] = { location.x, location.y, location.z };
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            LightQuantizedFormat::AppendVarint(out, static_cast<uint64_t>(ToSteps(coordinates[axis], grid.step) - grid.origin[axis]));
+        }
+    }
+
+    void AppendValue(std::string& out, const ON_3dVector& direction, const Grid&)
+    {
+        uint16_t u = 0;
+        uint16_t v = 0;
+        LightQuantizedFormat::EncodeOctahedral(direction.x, direction.y, direction.z, u, v);
+        LightQuantizedFormat::AppendU16(out, u);
+        LightQuantizedFormat::AppendU16(out, v);
+    }
+
+    void AppendValue(std::string& out, double value, const Grid&)
+    {
+        LightQuantizedFormat::AppendFloat(out, static_cast<float>(value));
+    }
+
+    void AppendValue(std::string& out, const ON_Color& color, const Grid&)
+    {
+        out += static_cast<char>(color.Red());
+        out += static_cast<char>(color.Green());
+        out += static_cast<char>(color.Blue());
+    }
+
+    void AppendValue(std::string& out, const LightSchema::SpotAngles& angles, const Grid&)
+    {
+        LightQuantizedFormat::AppendU16(out, LightQuantizedFormat::QuantizeAngle(angles.inner));
+        LightQuantizedFormat::AppendU16(out, LightQuantizedFormat::QuantizeAngle(angles.outer));
+    }
+
+    void AppendIdArray(std::string& out, const std::vector<ON_UUID>& ids)
+    {
+        LightQuantizedFormat::AppendVarint(out, ids.size());
+        for (const ON_UUID& id : ids)
+        {
+            AppendUuid(out, id);
+        }
+    }
+}
+
+/**
+ * @brief Encodes one delivery as a quantized message
+ *
+ * Complete messages record the scene index of each of their lights for the
+ * receiver (a first batch or a new sequence starts over); partial messages of
+ * the same sequence refer to those lights by index.
+ *
+ * @param delivery Lights (in meters) and header fields of the message
+ * @param eventType Event name written into the message
+ * @param out Buffer the message is appended to
+ */
+void LightQuantizedEncoder::Encode(const LightSyncSubscriptions::Delivery& delivery, const wchar_t* eventType,
+    std::string& out)
+{
+    const size_t lightCount = delivery.LightCount();
+    const bool batched = delivery.batchCount > 1;
+
+    unsigned char flags = 0;
+    if (delivery.partial)
+        flags |= LightQuantizedFormat::FLAG_PARTIAL;
+    if (delivery.regionScoped)
+        flags |= LightQuantizedFormat::FLAG_REGION_SCOPED;
+    if (batched)
+        flags |= LightQuantizedFormat::FLAG_BATCHED;
+
+    out += static_cast<char>(LightQuantizedFormat::MAGIC[0]);
+    out += static_cast<char>(LightQuantizedFormat::MAGIC[1]);
+    out += static_cast<char>(LightQuantizedFormat::FORMAT_VERSION);
+    out += static_cast<char>(flags);
+    LightQuantizedFormat::AppendVarint(out, delivery.document);
+    LightQuantizedFormat::AppendVarint(out, delivery.sequence);
+    LightQuantizedFormat::AppendVarint(out, delivery.version);
+    LightQuantizedFormat::AppendVarint(out, delivery.transformSequence);
+
+    const std::string event = LightSyncNetwork::WStringToUTF8(eventType);
+    LightQuantizedFormat::AppendVarint(out, event.size());
+    out += event;
+
+    if (batched)
+    {
+        LightQuantizedFormat::AppendVarint(out, delivery.batchIndex);
+        LightQuantizedFormat::AppendVarint(out, delivery.batchCount);
+        LightQuantizedFormat::AppendVarint(out, delivery.totalLightCount);
+    }
+    if (!delivery.partial)
+    {
+        LightQuantizedFormat::AppendVarint(out, delivery.firstLightIndex);
+    }
+
+    // The origin is the lowest corner of the positions sent, so every offset is non-negative
+    const long long requestedStep = std::llround(delivery.positionStep * 1e6);
+    const uint64_t stepMicrometers = requestedStep > 0 ? static_cast<uint64_t>(requestedStep) : 1;
+    const double step = static_cast<double>(stepMicrometers) * 1e-6;
+    int64_t origin[3] = { 0, 0, 0 };
+    bool haveOrigin = false;
+    for (size_t i = 0; i < lightCount; ++i)
+    {
+        const LightUtils::LightInfo& light = delivery.LightAt(i);
+        if (light.dirtyFields != LightUtils::FIELD_ALL && (light.dirtyFields & LightUtils::FIELD_LOCATION) == 0)
+            continue;
+        const int64_t steps[3] = { ToSteps(light.location.x, step), ToSteps(light.location.y, step), ToSteps(light.location.z, step) };
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            if (!haveOrigin || steps[axis] < origin[axis])
+                origin[axis] = steps[axis];
+        }
+        haveOrigin = true;
+    }
+    LightQuantizedFormat::AppendVarint(out, stepMicrometers);
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        LightQuantizedFormat::AppendVarint(out, LightQuantizedFormat::ZigZag(origin[axis]));
+    }
+
+    if (delivery.regionScoped)
+    {
+        AppendIdArray(out, delivery.entered);
+        AppendIdArray(out, delivery.left);
+    }
+    LightQuantizedFormat::AppendVarint(out, lightCount);
+
+    std::lock_guard<std::mutex> lock(g_tablesMutex);
+    HandleTable& table = g_tables[delivery.port];
+    if (!delivery.partial)
+        table.Stage(delivery.sequence, delivery.batchIndex);
+    const bool handlesUsable = delivery.partial && !delivery.namedById;
+    const Grid grid = { step, origin };
+
+    for (size_t i = 0; i < lightCount; ++i)
+    {
+        const LightUtils::LightInfo& light = delivery.LightAt(i);
+
+        if (light.dirtyFields == LightUtils::FIELD_ALL)
+        {
+            // The type is implied by RECORD_COMPLETE; the other bits name the fields that apply
+            unsigned int fields = 0;
+            LightSchema::ForEachField([&fields, &light](const auto& field) {
+                if (field.complete && field.bit != LightUtils::FIELD_TYPE && LightSchema::IsPresent(field.get(light)))
+                    fields |= field.bit;
+            });
+            out += static_cast<char>(LightQuantizedFormat::RECORD_COMPLETE | fields);
+            AppendUuid(out, light.id);
+            LightSchema::ForEachField([&](const auto& field) {
+                if (field.bit == LightUtils::FIELD_TYPE || (fields & field.bit))
+                    AppendValue(out, field.get(light), grid);
+            });
+
+            if (!delivery.partial)
+                table.StageLight(light.id, delivery.firstLightIndex + i);
+            continue;
+        }
+
+        // Partial records: the light's index in the receiver's scene when it has one
+        const unsigned int fields = light.dirtyFields & (LightUtils::FIELD_ALL & ~LightUtils::FIELD_TYPE);
+        size_t handle = 0;
+        const bool useHandle = handlesUsable && table.Find(delivery.sequence, light.id, handle);
+        out += static_cast<char>(fields | (useHandle ? LightQuantizedFormat::RECORD_HANDLE : 0));
+        if (useHandle)
+            LightQuantizedFormat::AppendVarint(out, handle);
+        else
+            AppendUuid(out, light.id);
+
+        LightSchema::ForEachField([&](const auto& field) {
+            if (fields & field.bit)
+                AppendValue(out, field.get(light), grid);
+        });
+    }
+}
+
+void LightQuantizedEncoder::Delivered(int port, bool sent)
+{
+    std::lock_guard<std::mutex> lock(g_tablesMutex);
+    auto table = g_tables.find(port);
+    if (table == g_tables.end())
+        return;
+    if (sent)
+        table->second.Delivered(true);
+    else
+        g_tables.erase(table);
+}
+
+void LightQuantizedEncoder::ForgetReceiver(int port)
+{
+    std::lock_guard<std::mutex> lock(g_tablesMutex);
+    g_tables.erase(port);
+}
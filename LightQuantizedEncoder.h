@@ -0,0 +1,46 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+#pragma once
+
+#include "stdafx.h"
+#include "LightSyncSubscriptions.h"
+#include <string>
+
+/**
+ * @brief Encodes light data messages in the compact quantized form
+ *
+ * Used instead of the JSON encoder for receivers that subscribed with
+ * "encoding": "quantized" (layout and error bounds in
+ * Receiver/LightQuantizedFormat.h). Positions are fixed-point offsets from a
+ * per-message origin at the receiver's precision, directions octahedral
+ * normals and colors RGB8.
+ *
+ * Partial records name a light by its index in the receiver's current scene
+ * instead of its id. The encoder remembers, per receiver port, the ids of the
+ * complete messages that were delivered for the newest sequence (see
+ * LightQuantizedHandles.h); a light the receiver did not get in that scene, and
+ * every light after a failed send or a resume, is written with its id.
+ */
+class LightQuantizedEncoder
+{
+public:
+    // Appends the whole message for the delivery to out
+    static void Encode(const LightSyncSubscriptions::Delivery& delivery, const wchar_t* eventType, std::string& out);
+
+    // Called once the message encoded last for the port was sent or failed: a sent complete
+    // message makes its lights' indices usable as handles, a failure forgets them all
+    static void Delivered(int port, bool sent);
+
+    // Drops the scene ids remembered for a receiver that unsubscribed or resumed
+    static void ForgetReceiver(int port);
+};
@@ -0,0 +1,109 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+
+#pragma once
+
+#include <cstddef>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Scene handles the quantized encoder may use for one receiver
+ *
+ * A partial record can name a light by its index in the receiver's complete
+ * scene, but only once the receiver has that scene. The indices of a complete
+ * message are therefore staged while it is encoded and only become handles
+ * when the message was sent; a message that failed, or a receiver that resumed,
+ * forgets them all, so later partials name their lights by id. Follows the
+ * decoder's rule: a new sequence or its batch 0 replaces the table, later
+ * batches of the same sequence extend it. Expects one message in flight per
+ * receiver, which the document pipeline's channel guarantees. Not thread-safe.
+ *
+ * Does not use the Rhino SDK, so the handle test builds it with the receiver's ids.
+ */
+template <class Id, class Hash>
+class LightQuantizedHandles
+{
+public:
+    LightQuantizedHandles() : m_valid(false), m_sequence(0), m_staged(false), m_stagedSequence(0), m_stagedBatch(0) {}
+
+    // Starts recording the complete message (or batch) about to be encoded
+    void Stage(unsigned int sequence, size_t batchIndex)
+    {
+        m_staged = true;
+        m_stagedSequence = sequence;
+        m_stagedBatch = batchIndex;
+        m_stagedIndices.clear();
+    }
+
+    void StageLight(const Id& id, size_t sceneIndex)
+    {
+        m_stagedIndices.emplace_back(id, sceneIndex);
+    }
+
+    // The message encoded last was sent (true) or lost (false)
+    void Delivered(bool sent)
+    {
+        if (!sent)
+        {
+            Forget();
+            return;
+        }
+        if (!m_staged)
+            return;
+
+        if (!m_valid || m_sequence != m_stagedSequence || m_stagedBatch == 0)
+        {
+            m_indices.clear();
+            m_sequence = m_stagedSequence;
+            m_valid = true;
+        }
+        for (const auto& staged : m_stagedIndices)
+        {
+            m_indices[staged.first] = staged.second;
+        }
+        m_staged = false;
+        m_stagedIndices.clear();
+    }
+
+    // The handle of a light in a partial message of the sequence; false if it must be named by id
+    bool Find(unsigned int sequence, const Id& id, size_t& sceneIndex) const
+    {
+        if (!m_valid || m_sequence != sequence)
+            return false;
+        auto found = m_indices.find(id);
+        if (found == m_indices.end())
+            return false;
+        sceneIndex = found->second;
+        return true;
+    }
+
+    void Forget()
+    {
+        m_valid = false;
+        m_indices.clear();
+        m_staged = false;
+        m_stagedIndices.clear();
+    }
+
+private:
+    bool m_valid;
+    unsigned int m_sequence;
+    std::unordered_map<Id, size_t, Hash> m_indices;
+
+    bool m_staged;
+    unsigned int m_stagedSequence;
+    size_t m_stagedBatch;
+    std::vector<std::pair<Id, size_t>> m_stagedIndices;
+};
@@ -0,0 +1,248 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+#include "stdafx.h"
+#include "LightResumeLog.h"
+#include <unordered_map>
+#include <utility>
+
+/**
+ * @brief Records a complete scene that receivers were sent
+ *
+ * @param snapshot Snapshot the scene was sent from
+ */
+void LightResumeLog::SetKeyframe(const LightSnapshot::Ptr& snapshot)
+{
+    if (!snapshot)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_keyframe = snapshot;
+    m_deltas.clear();
+}
+
+/**
+ * @brief Appends the lights of a partial update to the delta log
+ *
+ * A full log is folded into the keyframe first.
+ *
+ * @param lights Lights as sent (dirtyFields tell what each record carried)
+ * @param version Snapshot version the update produced
+ */
+void LightResumeLog::AddDelta(const std::vector<LightUtils::LightInfo>& lights, uint64_t version)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Without a keyframe there is nothing the deltas could be applied to
+    if (!m_keyframe)
+    {
+        return;
+    }
+
+    if (m_deltas.size() + lights.size() > MAX_DELTAS)
+    {
+        CompactLocked();
+    }
+    for (const auto& light : lights)
+    {
+        m_deltas.push_back({ version, light });
+    }
+}
+
+/**
+ * @brief Works out what a (re)connecting receiver has to be sent
+ *
+ * A receiver at the newest version needs nothing. One at the keyframe or a
+ * later version gets the deltas after it. Anything else (no version, an older
+ * keyframe, another session) gets the keyframe and then every delta.
+ *
+ * @param receiverVersion Last version the receiver applied, -1 if none
+ * @param plan Filled with the keyframe (if needed), the merged deltas and the resulting version
+ * @return False if no scene was recorded yet
+ */
+bool LightResumeLog::PlanResume(int64_t receiverVersion, Plan& plan) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (!m_keyframe)
+    {
+        return false;
+    }
+
+    const uint64_t keyframeVersion = m_keyframe->Version();
+    plan.version = m_deltas.empty() ? keyframeVersion : m_deltas.back().version;
+    plan.keyframe.reset();
+    plan.deltas.clear();
+
+    if (receiverVersion >= 0 && static_cast<uint64_t>(receiverVersion) == plan.version)
+    {
+        return true;
+    }
+
+    auto firstMissing = m_deltas.cbegin();
+    if (receiverVersion >= 0 && static_cast<uint64_t>(receiverVersion) >= keyframeVersion &&
+        static_cast<uint64_t>(receiverVersion) < plan.version)
+    {
+        while (firstMissing != m_deltas.cend() && firstMissing->version <= static_cast<uint64_t>(receiverVersion))
+        {
+            ++firstMissing;
+        }
+    }
+    else
+    {
+        plan.keyframe = m_keyframe;
+    }
+
+    MergeDeltas(firstMissing, m_deltas.cend(), plan.deltas);
+    return true;
+}
+
+LightSnapshot::Ptr LightResumeLog::Keyframe() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_keyframe;
+}
+
+std::shared_ptr<const std::string> LightResumeLog::KeyframeBody(const LightSnapshot::Ptr& keyframe) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!keyframe || keyframe->Version() != m_keyframeBodyVersion)
+    {
+        return nullptr;
+    }
+    return m_keyframeBody;
+}
+
+void LightResumeLog::CacheKeyframeBody(const LightSnapshot::Ptr& keyframe, std::shared_ptr<const std::string> body)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // A keyframe replaced while it was being encoded is not worth keeping
+    if (keyframe && keyframe == m_keyframe)
+    {
+        m_keyframeBody = std::move(body);
+        m_keyframeBodyVersion = keyframe->Version();
+    }
+}
+
+size_t LightResumeLog::DeltaCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_deltas.size();
+}
+
+/**
+ * @brief Collapses deltas into one record per light, in order of first change
+ *
+ * The newest record of a light wins and carries every field any of its
+ * records carried. A light whose newest record switched it off only says so,
+ * so a receiver that never had it does not add it.
+ */
+void LightResumeLog::MergeDeltas(std::vector<Delta>::const_iterator begin, std::vector<Delta>::const_iterator end,
+    std::vector<LightUtils::LightInfo>& merged)
+{
+    std::unordered_map<ON_UUID, size_t, LightUtils::UuidHash> slots;
+    for (auto delta = begin; delta != end; ++delta)
+    {
+        auto slot = slots.find(delta->light.id);
+        if (slot == slots.end())
+        {
+            slots.emplace(delta->light.id, merged.size());
+            merged.push_back(delta->light);
+            continue;
+        }
+
+        LightUtils::LightInfo& light = merged[slot->second];
+        const unsigned int fields = light.dirtyFields | delta->light.dirtyFields;
+        light = delta->light;
+        light.dirtyFields = fields;
+    }
+
+    for (auto& light : merged)
+    {
+        if (!light.enabled)
+        {
+            light.dirtyFields = LightUtils::FIELD_ENABLED;
+        }
+    }
+}
+
+/**
+ * @brief Folds the delta log into a new keyframe at the newest version
+ *
+ * Deltas hold each light's complete state, so applying them to the keyframe's
+ * lights gives exactly what receivers were sent. The cached encoding is
+ * dropped with the old keyframe.
+ */
+void LightResumeLog::CompactLocked()
+{
+    if (m_deltas.empty())
+    {
+        return;
+    }
+
+    std::vector<LightUtils::LightInfo> lights;
+    m_keyframe->CopyTo(lights);
+
+    std::unordered_map<ON_UUID, size_t, LightUtils::UuidHash> slots;
+    slots.reserve(lights.size());
+    for (size_t i = 0; i < lights.size(); ++i)
+    {
+        slots.emplace(lights[i].id, i);
+    }
+
+    std::vector<LightUtils::LightInfo> merged;
+    MergeDeltas(m_deltas.cbegin(), m_deltas.cend(), merged);
+    std::vector<bool> removed(lights.size(), false);
+    for (const auto& light : merged)
+    {
+        auto slot = slots.find(light.id);
+        if (!light.enabled)
+        {
+            if (slot != slots.end())
+                removed[slot->second] = true;
+        }
+        else if (slot != slots.end())
+        {
+            lights[slot->second] = light;
+            removed[slot->second] = false;
+        }
+        else
+        {
+            slots.emplace(light.id, lights.size());
+            lights.push_back(light);
+            removed.push_back(false);
+        }
+    }
+
+    std::vector<LightUtils::LightInfo> kept;
+    kept.reserve(lights.size());
+    for (size_t i = 0; i < lights.size(); ++i)
+    {
+        if (!removed[i])
+            kept.push_back(lights[i]);
+    }
+
+    std::vector<LightSnapshot::ChunkPtr> chunks;
+    for (size_t begin = 0; begin < kept.size(); begin += LightSnapshot::CHUNK_SIZE)
+    {
+        const size_t remaining = kept.size() - begin;
+        chunks.push_back(LightSnapshot::MakeChunk(&kept[begin],
+            remaining < LightSnapshot::CHUNK_SIZE ? remaining : LightSnapshot::CHUNK_SIZE));
+    }
+
+    m_keyframe = std::make_shared<const LightSnapshot>(m_deltas.back().version, m_keyframe->UnitScale(),
+        std::move(chunks), kept.size());
+    m_deltas.clear();
+}
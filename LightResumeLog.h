@@ -0,0 +1,90 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+#pragma once
+
+#include "stdafx.h"
+#include "LightSnapshot.h"
+#include "LightUtils.h"
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief What a document's receivers were sent, kept for receivers that (re)connect
+ *
+ * The keyframe is the last complete scene (a snapshot, so it costs no copy);
+ * partial updates sent after it are appended to a bounded delta log, each
+ * under the snapshot version it produced. A receiver that reports the last
+ * version it applied is sent only the deltas after it when the log still
+ * covers that version, otherwise the keyframe followed by all deltas. When the
+ * log is full its deltas are folded into a new keyframe, so the log never
+ * needs anything from the document to catch a receiver up.
+ *
+ * The keyframe's lights array is encoded at most once, on the first resume
+ * that needs it, and shared by every later resume until the keyframe changes.
+ */
+class LightResumeLog
+{
+public:
+    // What to send a resuming receiver
+    struct Plan
+    {
+        LightSnapshot::Ptr keyframe;                // Null when the receiver only needs deltas
+        std::vector<LightUtils::LightInfo> deltas;  // Merged, one record per light
+        uint64_t version;                           // Version the receiver is at afterwards
+
+        Plan() : version(0) {}
+    };
+
+    LightResumeLog() : m_keyframeBodyVersion(0) {}
+
+    // Records a complete scene that was sent; the delta log starts over
+    void SetKeyframe(const LightSnapshot::Ptr& snapshot);
+
+    // Records lights sent as a partial update under the version it produced
+    void AddDelta(const std::vector<LightUtils::LightInfo>& lights, uint64_t version);
+
+    // Works out what brings a receiver at the given version (-1 if none) to the newest one;
+    // false if nothing was recorded yet
+    bool PlanResume(int64_t receiverVersion, Plan& plan) const;
+
+    LightSnapshot::Ptr Keyframe() const;
+
+    // Encoded lights array of the keyframe, null if it was not encoded yet
+    std::shared_ptr<const std::string> KeyframeBody(const LightSnapshot::Ptr& keyframe) const;
+    void CacheKeyframeBody(const LightSnapshot::Ptr& keyframe, std::shared_ptr<const std::string> body);
+
+    size_t DeltaCount() const;
+
+    // Constants
+    static constexpr size_t MAX_DELTAS = 256;  // Light records kept before they are folded into the keyframe
+
+private:
+    struct Delta
+    {
+        uint64_t version;
+        LightUtils::LightInfo light;
+    };
+
+    static void MergeDeltas(std::vector<Delta>::const_iterator begin, std::vector<Delta>::const_iterator end,
+        std::vector<LightUtils::LightInfo>& merged);
+    void CompactLocked();
+
+    mutable std::mutex m_mutex;
+    LightSnapshot::Ptr m_keyframe;
+    std::shared_ptr<const std::string> m_keyframeBody;
+    uint64_t m_keyframeBodyVersion;
+    std::vector<Delta> m_deltas;  // One per light sent, oldest first
+};
@@ -0,0 +1,103 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+#pragma once
+
+#include "stdafx.h"
+#include "LightUtils.h"
+#include <tuple>
+#include <utility>
+
+/**
+ * @brief Compile-time list of the fields a light is synchronized with
+ *
+ * Every encoder (JSON records and field updates, the quantized form, the
+ * backup file, the inventory report) and the change tracker's hash and diff
+ * walk FIELDS with ForEachField instead of naming the members themselves.
+ * Each provides an overload per value type, so the walk is resolved at
+ * compile time and costs the same as the hand-written code. A new property
+ * is added here (plus overloads if its value type is new) and every encoder
+ * picks it up; a missing overload is a compile error.
+ *
+ * The light id is the record's key rather than a field and is written by
+ * each encoder itself.
+ */
+namespace LightSchema
+{
+    // A spot light's cone in degrees; present is false for every other light
+    struct SpotAngles
+    {
+        bool present;
+        double inner;
+        double outer;
+
+        bool operator==(const SpotAngles& other) const
+        {
+            return present == other.present && (!present || (inner == other.inner && outer == other.outer));
+        }
+        bool operator!=(const SpotAngles& other) const { return !(*this == other); }
+    };
+
+    template <class Value>
+    struct Field
+    {
+        typedef Value ValueType;
+
+        const char* name;        // JSON member name
+        const wchar_t* label;    // Name in the inventory report and export header
+        unsigned int bit;        // LightUtils::Field bit set when the field changed
+        int precision;           // Digits after the point in JSON, -1 when not a decimal
+        bool complete;           // Part of complete records (otherwise only sent as a changed field)
+        Value (*get)(const LightUtils::LightInfo& light);
+    };
+
+    // In record order; field updates list their changed fields in the same order
+    constexpr auto FIELDS = std::make_tuple(
+        Field<LightUtils::LightType>{ "type", L"Type", LightUtils::FIELD_TYPE, -1, true,
+            [](const LightUtils::LightInfo& light) { return light.type; } },
+        Field<bool>{ "enabled", L"Enabled", LightUtils::FIELD_ENABLED, -1, false,
+            [](const LightUtils::LightInfo& light) { return light.enabled; } },
+        Field<ON_3dPoint>{ "location", L"Position", LightUtils::FIELD_LOCATION, 6, true,
+            [](const LightUtils::LightInfo& light) { return light.location; } },
+        Field<ON_3dVector>{ "rotation", L"Direction", LightUtils::FIELD_DIRECTION, 3, true,
+            [](const LightUtils::LightInfo& light) { return light.direction; } },
+        Field<double>{ "intensity", L"Intensity", LightUtils::FIELD_INTENSITY, 3, true,
+            [](const LightUtils::LightInfo& light) { return light.intensity; } },
+        Field<ON_Color>{ "color", L"Color", LightUtils::FIELD_COLOR, -1, true,
+            [](const LightUtils::LightInfo& light) { return light.color; } },
+        Field<SpotAngles>{ "spotLight", L"Spot Angles", LightUtils::FIELD_SPOT_ANGLES, 3, true,
+            [](const LightUtils::LightInfo& light) { return SpotAngles{ light.isSpotLight, light.innerAngle, light.outerAngle }; } });
+
+    // Calls visitor(field) for every field, in order
+    template <class Visitor>
+    void ForEachField(Visitor&& visitor)
+    {
+        std::apply([&visitor](const auto&... field) { (visitor(field), ...); }, FIELDS);
+    }
+
+    // Optional fields are left out of records where they do not apply
+    template <class Value>
+    bool IsPresent(const Value&) { return true; }
+    inline bool IsPresent(const SpotAngles& angles) { return angles.present; }
+
+    namespace Detail
+    {
+        template <size_t... Index>
+        constexpr unsigned int CombinedBits(std::index_sequence<Index...>)
+        {
+            return (0u | ... | std::get<Index>(FIELDS).bit);
+        }
+    }
+
+    static_assert(Detail::CombinedBits(std::make_index_sequence<std::tuple_size<decltype(FIELDS)>::value>()) ==
+        LightUtils::FIELD_ALL, "every LightUtils::Field bit needs exactly one schema field");
+}
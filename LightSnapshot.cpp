@@ -0,0 +1,40 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+
+#include "stdafx.h"
+#include "LightSnapshot.h"
+#include <utility>
+
+LightSnapshot::LightSnapshot(uint64_t version, double unitScale, std::vector<ChunkPtr> chunks, size_t lightCount)
+    : m_version(version), m_unitScale(unitScale), m_chunks(std::move(chunks)), m_lightCount(lightCount)
+{
+}
+
+void LightSnapshot::CopyTo(std::vector<LightUtils::LightInfo>& lights) const
+{
+    lights.reserve(lights.size() + m_lightCount);
+    for (const auto& chunk : m_chunks)
+    {
+        lights.insert(lights.end(), chunk->begin(), chunk->end());
+    }
+}
+
+LightSnapshot::ChunkPtr LightSnapshot::MakeChunk(const LightUtils::LightInfo* lights, size_t count)
+{
+    auto chunk = std::make_shared<Chunk>(lights, lights + count);
+    for (auto& light : *chunk)
+    {
+        light.dirtyFields = LightUtils::FIELD_ALL;
+    }
+    return chunk;
+}
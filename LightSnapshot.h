@@ -0,0 +1,64 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+
+#pragma once
+
+#include "stdafx.h"
+#include "LightUtils.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Immutable, versioned state of every light sent to receivers
+ *
+ * Lights are stored in fixed-size chunks held by shared pointers, so a new
+ * version that changes one light copies one chunk and shares all others with
+ * the previous version. Snapshots are never modified after construction and
+ * are passed around as LightSnapshot::Ptr; any thread may read one without
+ * locking, and a version is freed when its last reader lets go of it.
+ */
+class LightSnapshot
+{
+public:
+    typedef std::shared_ptr<const LightSnapshot> Ptr;
+    typedef std::vector<LightUtils::LightInfo> Chunk;
+    typedef std::shared_ptr<const Chunk> ChunkPtr;
+
+    // Lights per chunk; every chunk but the last is full
+    static constexpr size_t CHUNK_SIZE = 256;
+
+    LightSnapshot(uint64_t version, double unitScale, std::vector<ChunkPtr> chunks, size_t lightCount);
+
+    uint64_t Version() const { return m_version; }
+    double UnitScale() const { return m_unitScale; }
+    size_t Count() const { return m_lightCount; }
+    const std::vector<ChunkPtr>& Chunks() const { return m_chunks; }
+
+    const LightUtils::LightInfo& At(size_t index) const
+    {
+        return (*m_chunks[index / CHUNK_SIZE])[index % CHUNK_SIZE];
+    }
+
+    // Appends every light in order (for consumers that need their own ordering)
+    void CopyTo(std::vector<LightUtils::LightInfo>& lights) const;
+
+    // Copies lights into a new chunk, marking each as a complete record
+    static ChunkPtr MakeChunk(const LightUtils::LightInfo* lights, size_t count);
+
+private:
+    const uint64_t m_version;
+    const double m_unitScale;
+    const std::vector<ChunkPtr> m_chunks;
+    const size_t m_lightCount;
+};
@@ -0,0 +1,89 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+
+#include "stdafx.h"
+#include "LightSnapshotExporter.h"
+#include "LightSnapshotStore.h"
+#include "LightSyncStats.h"
+#include "LightSyncTrace.h"
+#include "LightUtils.h"
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+namespace {
+    std::mutex g_exporterMutex;
+    std::thread g_exporterThread;
+    std::atomic<bool> g_running(false);
+
+    void ExportLoop(std::wstring filePath)
+    {
+        LightSyncTrace::NameThread("Exporter");
+        uint64_t writtenVersion = 0;
+        while (g_running.load())
+        {
+            LightSnapshot::Ptr snapshot = LightSnapshotStore::WaitForNewer(writtenVersion,
+                LightSnapshotExporter::POLL_INTERVAL_MS);
+            if (!snapshot)
+                continue;
+
+            bool exported = false;
+            {
+                LightSyncTrace::Span span("file export");
+                exported = LightUtils::ExportLightsToFile(snapshot->Count(),
+                    [&snapshot](size_t index) -> const LightUtils::LightInfo& { return snapshot->At(index); },
+                    filePath);
+            }
+            LightSyncStats::Increment(exported ? LightSyncStats::Get().fileExports : LightSyncStats::Get().exportFailures);
+
+            // A failed write is not retried until the next version
+            writtenVersion = snapshot->Version();
+        }
+    }
+}
+
+/**
+ * @brief Starts the exporter thread (no-op if it is already running)
+ *
+ * @param filePath File rewritten with every new snapshot version
+ */
+void LightSnapshotExporter::Start(const std::wstring& filePath)
+{
+    std::lock_guard<std::mutex> lock(g_exporterMutex);
+    if (g_running.exchange(true))
+    {
+        return;
+    }
+    g_exporterThread = std::thread(ExportLoop, filePath);
+}
+
+/**
+ * @brief Stops the exporter thread and waits for a write in progress to finish
+ */
+void LightSnapshotExporter::Stop()
+{
+    std::lock_guard<std::mutex> lock(g_exporterMutex);
+    if (!g_running.exchange(false))
+    {
+        return;
+    }
+    if (g_exporterThread.joinable())
+    {
+        g_exporterThread.join();
+    }
+}
+
+bool LightSnapshotExporter::IsRunning()
+{
+    return g_running.load();
+}
@@ -0,0 +1,35 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+
+#pragma once
+
+#include "stdafx.h"
+#include <string>
+
+/**
+ * @brief Writes the backup light file from published snapshots on its own thread
+ *
+ * The light watcher no longer writes the file on the UI thread. This thread
+ * waits for new snapshot versions and writes only the newest one, so a burst
+ * of events costs one file write.
+ */
+class LightSnapshotExporter
+{
+public:
+    static void Start(const std::wstring& filePath);
+    static void Stop();
+    static bool IsRunning();
+
+    // How long the thread sleeps between checks for a newer version
+    static constexpr unsigned int POLL_INTERVAL_MS = 100;
+};
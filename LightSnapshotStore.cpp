@@ -0,0 +1,64 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+
+#include "stdafx.h"
+#include "LightSnapshotStore.h"
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+namespace {
+    LightSnapshot::Ptr g_latest;
+
+    // Only used by waiting consumers; the publisher never takes the mutex
+    std::mutex g_waitMutex;
+    std::condition_variable g_published;
+}
+
+void LightSnapshotStore::Publish(LightSnapshot::Ptr snapshot)
+{
+    std::atomic_store(&g_latest, std::move(snapshot));
+    g_published.notify_all();
+}
+
+LightSnapshot::Ptr LightSnapshotStore::Latest()
+{
+    return std::atomic_load(&g_latest);
+}
+
+/**
+ * @brief Waits for a snapshot newer than the one a consumer already has
+ *
+ * A notification that races with the wait is picked up when the timeout
+ * expires, so consumers should use a short timeout and loop.
+ *
+ * @param afterVersion Version the caller already processed (0 for none)
+ * @param timeoutMs Maximum time to wait
+ * @return Newer snapshot, or null if none was published in time
+ */
+LightSnapshot::Ptr LightSnapshotStore::WaitForNewer(uint64_t afterVersion, unsigned int timeoutMs)
+{
+    LightSnapshot::Ptr snapshot;
+    std::unique_lock<std::mutex> lock(g_waitMutex);
+    g_published.wait_for(lock, std::chrono::milliseconds(timeoutMs), [&snapshot, afterVersion]() {
+        snapshot = Latest();
+        return snapshot && snapshot->Version() > afterVersion;
+        });
+
+    if (snapshot && snapshot->Version() > afterVersion)
+    {
+        return snapshot;
+    }
+    return LightSnapshot::Ptr();
+}
@@ -0,0 +1,39 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+
+#pragma once
+
+#include "stdafx.h"
+#include "LightSnapshot.h"
+#include <cstdint>
+
+/**
+ * @brief Latest published light snapshot, readable from any thread
+ *
+ * The UI thread publishes a new version after every change it sends; readers
+ * take a reference to whichever version is current and keep it for as long as
+ * they need. Publishing swaps one pointer and never waits for readers. With
+ * several documents open, the latest version is that of the document that
+ * changed last; version numbers increase across documents.
+ */
+class LightSnapshotStore
+{
+public:
+    static void Publish(LightSnapshot::Ptr snapshot);
+
+    // Current version, or null before the first event
+    static LightSnapshot::Ptr Latest();
+
+    // Blocks until a version newer than afterVersion is published or the timeout passes
+    static LightSnapshot::Ptr WaitForNewer(uint64_t afterVersion, unsigned int timeoutMs);
+};
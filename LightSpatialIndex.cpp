@@ -0,0 +1,202 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+#include "stdafx.h"
+#include "LightSpatialIndex.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // Cell coordinates are packed into 21 bits per axis (about +/-33,000 km at 32 m cells)
+    constexpr long long CELL_BITS = 21;
+    constexpr long long CELL_MASK = (1LL << CELL_BITS) - 1;
+    constexpr long long CELL_BIAS = 1LL << (CELL_BITS - 1);
+}
+
+bool LightSpatialIndex::Box::Contains(const ON_3dPoint& point) const
+{
+    return point.x >= min.x && point.x <= max.x &&
+        point.y >= min.y && point.y <= max.y &&
+        point.z >= min.z && point.z <= max.z;
+}
+
+LightSpatialIndex::LightSpatialIndex(double cellSize)
+    : m_cellSize(cellSize > 0.0 ? cellSize : DEFAULT_CELL_SIZE)
+{
+}
+
+/**
+ * @brief Inserts a light or moves it to its new position
+ *
+ * @param lightId Rhino object id of the light
+ * @param position Light position in meters
+ */
+void LightSpatialIndex::Update(const ON_UUID& lightId, const ON_3dPoint& position)
+{
+    const long long cellKey = CellKey(CellCoordinate(position.x), CellCoordinate(position.y), CellCoordinate(position.z));
+
+    auto found = m_entries.find(lightId);
+    if (found != m_entries.end())
+    {
+        found->second.position = position;
+        if (found->second.cellKey == cellKey)
+        {
+            return; // Moved within its cell
+        }
+        RemoveFromCell(found->second.cellKey, lightId);
+        found->second.cellKey = cellKey;
+    }
+    else
+    {
+        m_entries.emplace(lightId, Entry{ position, cellKey });
+    }
+
+    m_cells[cellKey].push_back(lightId);
+}
+
+/**
+ * @brief Removes a light from the index (no-op if it is not indexed)
+ *
+ * @param lightId Rhino object id of the light
+ */
+void LightSpatialIndex::Remove(const ON_UUID& lightId)
+{
+    auto found = m_entries.find(lightId);
+    if (found == m_entries.end())
+    {
+        return;
+    }
+
+    RemoveFromCell(found->second.cellKey, lightId);
+    m_entries.erase(found);
+}
+
+void LightSpatialIndex::Clear()
+{
+    m_entries.clear();
+    m_cells.clear();
+}
+
+/**
+ * @brief Replaces the index contents with the given lights
+ *
+ * Used on first use and whenever positions change wholesale (unit change).
+ *
+ * @param lights Lights with positions already converted to meters
+ */
+void LightSpatialIndex::Rebuild(const std::vector<LightUtils::LightInfo>& lights)
+{
+    Clear();
+    m_entries.reserve(lights.size());
+    for (const auto& light : lights)
+    {
+        Update(light.id, light.location);
+    }
+}
+
+/**
+ * @brief Collects the lights inside an axis-aligned box
+ *
+ * Visits the cells overlapped by the box; when the box spans more cells than
+ * there are lights, scanning the entries directly is cheaper.
+ *
+ * @param box Query box in meters
+ * @param results Receives matching light ids (appended)
+ */
+void LightSpatialIndex::Query(const Box& box, std::vector<ON_UUID>& results) const
+{
+    if (box.max.x < box.min.x || box.max.y < box.min.y || box.max.z < box.min.z)
+    {
+        return;
+    }
+
+    const long long minX = CellCoordinate(box.min.x), maxX = CellCoordinate(box.max.x);
+    const long long minY = CellCoordinate(box.min.y), maxY = CellCoordinate(box.max.y);
+    const long long minZ = CellCoordinate(box.min.z), maxZ = CellCoordinate(box.max.z);
+
+    const double cellCount = static_cast<double>(maxX - minX + 1) *
+        static_cast<double>(maxY - minY + 1) * static_cast<double>(maxZ - minZ + 1);
+
+    if (cellCount > static_cast<double>(m_entries.size()))
+    {
+        for (const auto& entry : m_entries)
+        {
+            if (box.Contains(entry.second.position))
+            {
+                results.push_back(entry.first);
+            }
+        }
+        return;
+    }
+
+    for (long long cx = minX; cx <= maxX; ++cx)
+    {
+        for (long long cy = minY; cy <= maxY; ++cy)
+        {
+            for (long long cz = minZ; cz <= maxZ; ++cz)
+            {
+                auto cell = m_cells.find(CellKey(cx, cy, cz));
+                if (cell == m_cells.end())
+                    continue;
+
+                for (const ON_UUID& lightId : cell->second)
+                {
+                    // Cells on the box border are only partially covered
+                    if (box.Contains(m_entries.at(lightId).position))
+                    {
+                        results.push_back(lightId);
+                    }
+                }
+            }
+        }
+    }
+}
+
+long long LightSpatialIndex::CellKey(long long cx, long long cy, long long cz) const
+{
+    return (((cx + CELL_BIAS) & CELL_MASK) << (2 * CELL_BITS)) |
+        (((cy + CELL_BIAS) & CELL_MASK) << CELL_BITS) |
+        ((cz + CELL_BIAS) & CELL_MASK);
+}
+
+long long LightSpatialIndex::CellCoordinate(double value) const
+{
+    const double cell = floor(value / m_cellSize);
+    const double limit = static_cast<double>(CELL_BIAS - 1);
+    return static_cast<long long>(std::max(-limit, std::min(limit, cell)));
+}
+
+void LightSpatialIndex::RemoveFromCell(long long cellKey, const ON_UUID& lightId)
+{
+    auto cell = m_cells.find(cellKey);
+    if (cell == m_cells.end())
+    {
+        return;
+    }
+
+    // Cells hold few lights; swap-and-pop keeps removal O(cell size)
+    std::vector<ON_UUID>& ids = cell->second;
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+        if (ids[i] == lightId)
+        {
+            ids[i] = ids.back();
+            ids.pop_back();
+            break;
+        }
+    }
+
+    if (ids.empty())
+    {
+        m_cells.erase(cell);
+    }
+}
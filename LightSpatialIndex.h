@@ -0,0 +1,70 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+#pragma once
+
+#include "stdafx.h"
+#include "LightUtils.h"
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Uniform grid over light positions (in meters)
+ *
+ * Lights are bucketed by the grid cell containing their position. Moving, adding
+ * or removing a light touches at most two cells, so the index is kept current
+ * per event instead of being rebuilt. Region queries visit only the cells the
+ * query box overlaps.
+ */
+class LightSpatialIndex
+{
+public:
+    // Axis-aligned box in meters
+    struct Box
+    {
+        ON_3dPoint min;
+        ON_3dPoint max;
+
+        bool Contains(const ON_3dPoint& point) const;
+    };
+
+    explicit LightSpatialIndex(double cellSize = DEFAULT_CELL_SIZE);
+
+    // Incremental maintenance
+    void Update(const ON_UUID& lightId, const ON_3dPoint& position);
+    void Remove(const ON_UUID& lightId);
+    void Clear();
+    void Rebuild(const std::vector<LightUtils::LightInfo>& lights);
+
+    // Appends ids of lights inside the box (boundary inclusive) to results
+    void Query(const Box& box, std::vector<ON_UUID>& results) const;
+
+    size_t Count() const { return m_entries.size(); }
+
+    // Default cell edge length in meters, sized for building-scale light spacing
+    static constexpr double DEFAULT_CELL_SIZE = 32.0;
+
+private:
+    struct Entry
+    {
+        ON_3dPoint position;
+        long long cellKey;
+    };
+
+    long long CellKey(long long cx, long long cy, long long cz) const;
+    long long CellCoordinate(double value) const;
+    void RemoveFromCell(long long cellKey, const ON_UUID& lightId);
+
+    double m_cellSize;
+    std::unordered_map<ON_UUID, Entry, LightUtils::UuidHash> m_entries;
+    std::unordered_map<long long, std::vector<ON_UUID>> m_cells;
+};
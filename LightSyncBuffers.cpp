@@ -0,0 +1,43 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+
+#include "stdafx.h"
+#include "LightSyncBuffers.h"
+#include "LightSyncStats.h"
+
+void LightSyncBuffers::EncodeBuffers::clear()
+{
+    header.clear();
+    indexPrefixes.clear();
+    prefixEnds.clear();
+    fragments.clear();
+    segments.clear();
+}
+
+LightBufferPool<LightSyncBuffers::LightList>& LightSyncBuffers::Lights()
+{
+    static LightBufferPool<LightList> pool(MAX_POOLED_LIGHT_LISTS, &LightSyncStats::Get().bufferPoolMisses);
+    return pool;
+}
+
+LightBufferPool<std::shared_ptr<LightSyncBuffers::EncodeBuffers>>& LightSyncBuffers::Encoders()
+{
+    static LightBufferPool<std::shared_ptr<EncodeBuffers>> pool(MAX_POOLED_ENCODERS, &LightSyncStats::Get().bufferPoolMisses);
+    return pool;
+}
+
+LightBufferPool<LightSyncBuffers::DeliveryList>& LightSyncBuffers::Deliveries()
+{
+    static LightBufferPool<DeliveryList> pool(MAX_POOLED_DELIVERY_LISTS, &LightSyncStats::Get().bufferPoolMisses);
+    return pool;
+}
@@ -0,0 +1,62 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+
+#pragma once
+
+#include "stdafx.h"
+#include "LightBufferPool.h"
+#include "LightFragmentCache.h"
+#include "LightSyncNetwork.h"
+#include "LightSyncSubscriptions.h"
+#include "LightUtils.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Process-wide buffer pools shared by the event pipeline
+ *
+ * Light lists travel from the UI thread to the network thread inside
+ * deliveries and come back here once the message is encoded. Encode buffers
+ * hold everything needed to assemble one message and come back once it was sent;
+ * they are shared with the send handler, so the pool keeps them behind their
+ * shared_ptr and a message does not allocate a new one. Delivery lists carry an
+ * event's deliveries from resolving to the document's channel.
+ */
+class LightSyncBuffers
+{
+public:
+    typedef std::vector<LightUtils::LightInfo> LightList;
+    typedef std::vector<LightSyncSubscriptions::Delivery> DeliveryList;
+
+    struct EncodeBuffers
+    {
+        std::string header;
+        std::string indexPrefixes;
+        std::vector<size_t> prefixEnds;
+        std::vector<LightFragmentCache::Fragment> fragments;
+        std::vector<LightSyncNetwork::Segment> segments;
+
+        // Keeps capacity; drops fragment references so changed lights are not held
+        void clear();
+    };
+
+    static LightBufferPool<LightList>& Lights();
+    static LightBufferPool<std::shared_ptr<EncodeBuffers>>& Encoders();
+    static LightBufferPool<DeliveryList>& Deliveries();
+
+    // Buffers kept per pool; one per receiver and batch in flight is enough
+    static constexpr size_t MAX_POOLED_LIGHT_LISTS = 16;
+    static constexpr size_t MAX_POOLED_ENCODERS = 8;
+    static constexpr size_t MAX_POOLED_DELIVERY_LISTS = 4;
+};
@@ -0,0 +1,80 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+#include "stdafx.h"
+#include "LightSyncControlServer.h"
+#include "LightSyncReactor.h"
+#include "LightSyncTrace.h"
+#include <atomic>
+#include <mutex>
+
+namespace {
+    constexpr int CONTROL_RECEIVE_TIMEOUT_MS = 2000;
+    constexpr size_t MAX_REQUEST_BYTES = 1024 * 1024;
+
+    std::mutex g_serverMutex;
+    std::atomic<bool> g_running(false);
+    int g_port = 0;
+}
+
+/**
+ * @brief Starts listening on the loopback interface
+ *
+ * Connections are served by the network thread, which must be running.
+ *
+ * @param port TCP port receivers connect to
+ * @param handler Called on the network thread for every request
+ * @return True if the listener is running
+ */
+bool LightSyncControlServer::Start(int port, Handler handler)
+{
+    std::lock_guard<std::mutex> lock(g_serverMutex);
+    if (g_running.load())
+    {
+        return true;
+    }
+
+    // Only local receivers may control the plugin; a request ends when the client half-closes
+    if (!LightSyncReactor::Listen(port, LightSyncReactor::Framing::HalfClose, MAX_REQUEST_BYTES,
+        std::chrono::milliseconds(CONTROL_RECEIVE_TIMEOUT_MS), [handler](const std::string& request)
+        {
+            LightSyncTrace::Span span("request");
+            return handler(request);
+        }))
+    {
+        return false;
+    }
+
+    g_port = port;
+    g_running.store(true);
+    return true;
+}
+
+/**
+ * @brief Stops accepting control connections
+ */
+void LightSyncControlServer::Stop()
+{
+    std::lock_guard<std::mutex> lock(g_serverMutex);
+    if (!g_running.exchange(false))
+    {
+        return;
+    }
+
+    LightSyncReactor::CloseListener(g_port);
+    g_port = 0;
+}
+
+bool LightSyncControlServer::IsRunning()
+{
+    return g_running.load();
+}
@@ -0,0 +1,40 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+#pragma once
+
+#include "stdafx.h"
+#include <functional>
+#include <string>
+
+/**
+ * @brief Loopback TCP listener for messages sent by receivers to the plugin
+ *
+ * Light data flows from the plugin to Unreal; this is the reverse channel where
+ * receivers register what they want to receive. Each connection carries one
+ * UTF-8 JSON request terminated by the client shutting down its sending side.
+ * The handler's reply (if any) is written back before the connection is closed.
+ * Connections are served by LightSyncReactor's network thread.
+ */
+class LightSyncControlServer
+{
+public:
+    // Receives the request text on the network thread and returns the reply text
+    typedef std::function<std::string(const std::string&)> Handler;
+
+    static bool Start(int port, Handler handler);
+    static void Stop();
+    static bool IsRunning();
+
+    // Constants
+    static constexpr int DEFAULT_CONTROL_PORT = 5174;
+};
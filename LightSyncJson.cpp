@@ -0,0 +1,299 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+#include "stdafx.h"
+#include "LightSyncJson.h"
+#include <cstdlib>
+
+namespace {
+    // Control messages are tiny; anything nested deeper is rejected
+    constexpr int MAX_DEPTH = 32;
+
+    class Parser
+    {
+    public:
+        explicit Parser(const std::string& text) : m_text(text), m_pos(0) {}
+
+        bool ParseDocument(LightSyncJson::Value& root)
+        {
+            if (!ParseValue(root, 0))
+                return false;
+            SkipWhitespace();
+            return m_pos == m_text.size();
+        }
+
+    private:
+        const std::string& m_text;
+        size_t m_pos;
+
+        void SkipWhitespace()
+        {
+            while (m_pos < m_text.size() &&
+                (m_text[m_pos] == ' ' || m_text[m_pos] == '\t' || m_text[m_pos] == '\n' || m_text[m_pos] == '\r'))
+            {
+                ++m_pos;
+            }
+        }
+
+        bool Consume(char expected)
+        {
+            SkipWhitespace();
+            if (m_pos < m_text.size() && m_text[m_pos] == expected)
+            {
+                ++m_pos;
+                return true;
+            }
+            return false;
+        }
+
+        bool ConsumeLiteral(const char* literal)
+        {
+            const size_t length = strlen(literal);
+            if (m_text.compare(m_pos, length, literal) != 0)
+                return false;
+            m_pos += length;
+            return true;
+        }
+
+        bool ParseValue(LightSyncJson::Value& value, int depth)
+        {
+            if (depth > MAX_DEPTH)
+                return false;
+
+            SkipWhitespace();
+            if (m_pos >= m_text.size())
+                return false;
+
+            const char c = m_text[m_pos];
+            if (c == '{')
+                return ParseObject(value, depth);
+            if (c == '[')
+                return ParseArray(value, depth);
+            if (c == '"')
+            {
+                value.type = LightSyncJson::Type::String;
+                return ParseString(value.string);
+            }
+            if (c == 't' || c == 'f')
+            {
+                value.type = LightSyncJson::Type::Bool;
+                value.boolean = (c == 't');
+                return ConsumeLiteral(value.boolean ? "true" : "false");
+            }
+            if (c == 'n')
+            {
+                value.type = LightSyncJson::Type::Null;
+                return ConsumeLiteral("null");
+            }
+            return ParseNumber(value);
+        }
+
+        bool ParseObject(LightSyncJson::Value& value, int depth)
+        {
+            value.type = LightSyncJson::Type::Object;
+            ++m_pos; // '{'
+
+            if (Consume('}'))
+                return true;
+
+            for (;;)
+            {
+                SkipWhitespace();
+                std::pair<std::string, LightSyncJson::Value> member;
+                if (m_pos >= m_text.size() || m_text[m_pos] != '"' || !ParseString(member.first))
+                    return false;
+                if (!Consume(':'))
+                    return false;
+                if (!ParseValue(member.second, depth + 1))
+                    return false;
+                value.members.push_back(std::move(member));
+
+                if (Consume(','))
+                    continue;
+                return Consume('}');
+            }
+        }
+
+        bool ParseArray(LightSyncJson::Value& value, int depth)
+        {
+            value.type = LightSyncJson::Type::Array;
+            ++m_pos; // '['
+
+            if (Consume(']'))
+                return true;
+
+            for (;;)
+            {
+                LightSyncJson::Value item;
+                if (!ParseValue(item, depth + 1))
+                    return false;
+                value.items.push_back(std::move(item));
+
+                if (Consume(','))
+                    continue;
+                return Consume(']');
+            }
+        }
+
+        bool ParseNumber(LightSyncJson::Value& value)
+        {
+            const char* start = m_text.c_str() + m_pos;
+            char* end = nullptr;
+            value.number = strtod(start, &end);
+            if (end == start)
+                return false;
+            value.type = LightSyncJson::Type::Number;
+            m_pos += static_cast<size_t>(end - start);
+            return true;
+        }
+
+        static void AppendUTF8(std::string& out, unsigned int codePoint)
+        {
+            if (codePoint < 0x80)
+            {
+                out += static_cast<char>(codePoint);
+            }
+            else if (codePoint < 0x800)
+            {
+                out += static_cast<char>(0xC0 | (codePoint >> 6));
+                out += static_cast<char>(0x80 | (codePoint & 0x3F));
+            }
+            else if (codePoint < 0x10000)
+            {
+                out += static_cast<char>(0xE0 | (codePoint >> 12));
+                out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (codePoint & 0x3F));
+            }
+            else
+            {
+                out += static_cast<char>(0xF0 | (codePoint >> 18));
+                out += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+                out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (codePoint & 0x3F));
+            }
+        }
+
+        bool ParseHex4(unsigned int& codeUnit)
+        {
+            if (m_pos + 4 > m_text.size())
+                return false;
+            codeUnit = 0;
+            for (int i = 0; i < 4; ++i)
+            {
+                const char h = m_text[m_pos++];
+                codeUnit <<= 4;
+                if (h >= '0' && h <= '9') codeUnit |= static_cast<unsigned int>(h - '0');
+                else if (h >= 'a' && h <= 'f') codeUnit |= static_cast<unsigned int>(h - 'a' + 10);
+                else if (h >= 'A' && h <= 'F') codeUnit |= static_cast<unsigned int>(h - 'A' + 10);
+                else return false;
+            }
+            return true;
+        }
+
+        bool ParseString(std::string& out)
+        {
+            ++m_pos; // opening quote
+            while (m_pos < m_text.size())
+            {
+                const char c = m_text[m_pos++];
+                if (c == '"')
+                    return true;
+                if (c != '\\')
+                {
+                    out += c;
+                    continue;
+                }
+
+                if (m_pos >= m_text.size())
+                    return false;
+                const char escape = m_text[m_pos++];
+                switch (escape)
+                {
+                case '"': out += '"'; break;
+                case '\\': out += '\\'; break;
+                case '/': out += '/'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case 't': out += '\t'; break;
+                case 'u':
+                {
+                    unsigned int codePoint = 0;
+                    if (!ParseHex4(codePoint))
+                        return false;
+                    // Combine UTF-16 surrogate pairs
+                    if (codePoint >= 0xD800 && codePoint <= 0xDBFF &&
+                        m_text.compare(m_pos, 2, "\\u") == 0)
+                    {
+                        m_pos += 2;
+                        unsigned int low = 0;
+                        if (!ParseHex4(low))
+                            return false;
+                        codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                    }
+                    AppendUTF8(out, codePoint);
+                    break;
+                }
+                default:
+                    return false;
+                }
+            }
+            return false; // Unterminated string
+        }
+    };
+}
+
+const LightSyncJson::Value* LightSyncJson::Value::Find(const char* key) const
+{
+    if (type != Type::Object)
+        return nullptr;
+
+    for (const auto& member : members)
+    {
+        if (member.first == key)
+            return &member.second;
+    }
+    return nullptr;
+}
+
+double LightSyncJson::Value::GetNumber(const char* key, double fallback) const
+{
+    const Value* member = Find(key);
+    return (member && member->type == Type::Number) ? member->number : fallback;
+}
+
+std::string LightSyncJson::Value::GetString(const char* key, const std::string& fallback) const
+{
+    const Value* member = Find(key);
+    return (member && member->type == Type::String) ? member->string : fallback;
+}
+
+bool LightSyncJson::Value::GetBool(const char* key, bool fallback) const
+{
+    const Value* member = Find(key);
+    return (member && member->type == Type::Bool) ? member->boolean : fallback;
+}
+
+/**
+ * @brief Parses a complete UTF-8 JSON document
+ *
+ * @param text JSON text received from a receiver
+ * @param root Receives the parsed tree
+ * @return True if the whole text is a single valid JSON value
+ */
+bool LightSyncJson::Parse(const std::string& text, Value& root)
+{
+    root = Value();
+    Parser parser(text);
+    return parser.ParseDocument(root);
+}
@@ -0,0 +1,54 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+#pragma once
+
+#include "stdafx.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Minimal JSON reader for control messages sent by receivers
+ *
+ * Outgoing messages are written directly with string streams; this reader only
+ * needs to understand the small request objects Unreal and tools send back
+ * (subscriptions and similar), so it builds a simple tree without any dependency.
+ */
+class LightSyncJson
+{
+public:
+    enum class Type { Null, Bool, Number, String, Array, Object };
+
+    struct Value
+    {
+        Type type;
+        bool boolean;
+        double number;
+        std::string string;                                  // UTF-8
+        std::vector<Value> items;                            // Array elements
+        std::vector<std::pair<std::string, Value>> members;  // Object members in document order
+
+        Value() : type(Type::Null), boolean(false), number(0.0) {}
+
+        // Returns the member with the given key, or nullptr if absent or not an object
+        const Value* Find(const char* key) const;
+
+        // Typed accessors returning the fallback when the member is missing or of another type
+        double GetNumber(const char* key, double fallback) const;
+        std::string GetString(const char* key, const std::string& fallback) const;
+        bool GetBool(const char* key, bool fallback) const;
+    };
+
+    // Parses a complete UTF-8 JSON document, returns false on malformed input
+    static bool Parse(const std::string& text, Value& root);
+};
@@ -0,0 +1,397 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+#include "stdafx.h"
+#include "LightSyncMetrics.h"
+#include "LightDocumentPipeline.h"
+#include "LightSnapshotStore.h"
+#include "LightSyncReactor.h"
+#include "LightSyncRuntime.h"
+#include "LightSyncStats.h"
+#include "LightSyncTrace.h"
+#include "LightTombstoneStore.h"
+#include <mutex>
+
+namespace {
+    constexpr int METRICS_RECEIVE_TIMEOUT_MS = 2000;
+    constexpr size_t MAX_REQUEST_HEADER_BYTES = 8192;
+
+    // Upper bucket bounds in microseconds, reported in seconds
+    const uint64_t BUCKET_BOUNDS_US[LightSyncMetrics::Histogram::BUCKET_COUNT] = {
+        100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 1000000
+    };
+
+    const char* const EVENT_TYPES[] = { "added", "deleted", "undeleted", "modified", "sorted", "other" };
+    const size_t EVENT_TYPE_COUNT = sizeof(EVENT_TYPES) / sizeof(EVENT_TYPES[0]);
+
+    struct PortCounters
+    {
+        std::atomic<int> port;  // 0 while the slot is free
+        std::atomic<uint64_t> messages;
+        std::atomic<uint64_t> bytes;
+        std::atomic<uint64_t> failures;
+
+        PortCounters() : port(0), messages(0), bytes(0), failures(0) {}
+    };
+
+    std::atomic<uint64_t> g_events[EVENT_TYPE_COUNT];
+    PortCounters g_ports[LightSyncMetrics::MAX_PORTS];
+    PortCounters g_otherPorts;
+    LightSyncMetrics::Histogram g_snapshotBuild;
+    LightSyncMetrics::Histogram g_encode;
+
+    std::atomic<bool> g_enabled(false);
+    std::atomic<int> g_port(0);
+    std::mutex g_serverMutex;
+
+    // Slot of a receiver port; claimed on its first send and kept for the session
+    PortCounters& CountersFor(int port)
+    {
+        const size_t start = static_cast<size_t>(port) % LightSyncMetrics::MAX_PORTS;
+        for (size_t probe = 0; probe < LightSyncMetrics::MAX_PORTS; ++probe)
+        {
+            PortCounters& slot = g_ports[(start + probe) % LightSyncMetrics::MAX_PORTS];
+            int owner = slot.port.load(std::memory_order_acquire);
+            if (owner == 0 && slot.port.compare_exchange_strong(owner, port, std::memory_order_acq_rel))
+            {
+                return slot;
+            }
+            if (owner == port)
+            {
+                return slot;
+            }
+        }
+        return g_otherPorts;
+    }
+
+    uint64_t Load(const std::atomic<uint64_t>& counter)
+    {
+        return counter.load(std::memory_order_relaxed);
+    }
+
+    void AppendHeader(std::string& out, const char* name, const char* type, const char* help)
+    {
+        out += "# HELP ";
+        out += name;
+        out += " ";
+        out += help;
+        out += "\n# TYPE ";
+        out += name;
+        out += " ";
+        out += type;
+        out += "\n";
+    }
+
+    void AppendMetric(std::string& out, const char* name, const char* type, const char* help, uint64_t value)
+    {
+        AppendHeader(out, name, type, help);
+        out += name;
+        out += " ";
+        out += std::to_string(value);
+        out += "\n";
+    }
+
+    void AppendSeconds(std::string& out, const char* name, const char* help, double milliseconds)
+    {
+        AppendHeader(out, name, "gauge", help);
+        out += name;
+        out += " ";
+        out += std::to_string(milliseconds / 1e3);
+        out += "\n";
+    }
+
+    void AppendSample(std::string& out, const char* name, const char* label, const std::string& labelValue, uint64_t value)
+    {
+        out += name;
+        out += "{";
+        out += label;
+        out += "=\"";
+        out += labelValue;
+        out += "\"} ";
+        out += std::to_string(value);
+        out += "\n";
+    }
+
+    void AppendPortSeries(std::string& out, const char* name, const char* help,
+        std::atomic<uint64_t> PortCounters::*counter)
+    {
+        AppendHeader(out, name, "counter", help);
+        for (const PortCounters& slot : g_ports)
+        {
+            const int port = slot.port.load(std::memory_order_acquire);
+            if (port != 0)
+                AppendSample(out, name, "port", std::to_string(port), Load(slot.*counter));
+        }
+        if (g_otherPorts.messages.load(std::memory_order_relaxed) != 0 || g_otherPorts.failures.load(std::memory_order_relaxed) != 0)
+            AppendSample(out, name, "port", "other", Load(g_otherPorts.*counter));
+    }
+
+    // Answers GET /metrics on the network thread; anything else gets 404
+    std::string Respond(const std::string& request)
+    {
+        LightSyncTrace::Span span("request");
+        if (request.compare(0, 13, "GET /metrics ") == 0 || request.compare(0, 14, "GET /metrics?") == 0)
+        {
+            const std::string body = LightSyncMetrics::Render();
+            return "HTTP/1.1 200 OK\r\nContent-Type: text/plain; version=0.0.4; charset=utf-8\r\nContent-Length: " +
+                std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+        }
+        return "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+    }
+}
+
+LightSyncMetrics::Histogram::Histogram() : m_sumMicroseconds(0)
+{
+    for (auto& bucket : m_buckets)
+    {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+void LightSyncMetrics::Histogram::Observe(uint64_t microseconds)
+{
+    size_t bucket = 0;
+    while (bucket < BUCKET_COUNT && microseconds > BUCKET_BOUNDS_US[bucket])
+    {
+        ++bucket;
+    }
+    m_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    m_sumMicroseconds.fetch_add(microseconds, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Writes the cumulative buckets, sum and count of the histogram
+ *
+ * Buckets are read one by one while other threads may still observe, so a
+ * scrape can be off by the observations that raced with it.
+ *
+ * @param out Exposition text to append to
+ * @param name Metric name (without the _bucket/_sum/_count suffixes)
+ * @param help Help line
+ */
+void LightSyncMetrics::Histogram::Append(std::string& out, const char* name, const char* help) const
+{
+    AppendHeader(out, name, "histogram", help);
+
+    const std::string bucketName = std::string(name) + "_bucket";
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i <= BUCKET_COUNT; ++i)
+    {
+        cumulative += Load(m_buckets[i]);
+        const std::string bound = i < BUCKET_COUNT ? std::to_string(BUCKET_BOUNDS_US[i] / 1e6) : "+Inf";
+        AppendSample(out, bucketName.c_str(), "le", bound, cumulative);
+    }
+
+    const uint64_t sum = Load(m_sumMicroseconds);
+    out += name;
+    out += "_sum ";
+    out += std::to_string(sum / 1e6);
+    out += "\n";
+    out += name;
+    out += "_count ";
+    out += std::to_string(cumulative);
+    out += "\n";
+}
+
+LightSyncMetrics::ScopedTimer::ScopedTimer(Histogram& histogram)
+    : m_histogram(histogram), m_timed(g_enabled.load(std::memory_order_relaxed))
+{
+    if (m_timed)
+    {
+        m_start = std::chrono::steady_clock::now();
+    }
+}
+
+LightSyncMetrics::ScopedTimer::~ScopedTimer()
+{
+    if (m_timed)
+    {
+        const auto elapsed = std::chrono::steady_clock::now() - m_start;
+        m_histogram.Observe(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()));
+    }
+}
+
+/**
+ * @brief Starts the metrics listener on the loopback interface
+ *
+ * Scrapes are answered by the network thread, which must be running.
+ *
+ * @param port TCP port the scraper connects to
+ * @return True if the endpoint is serving
+ */
+bool LightSyncMetrics::Enable(int port)
+{
+    std::lock_guard<std::mutex> lock(g_serverMutex);
+    if (g_enabled.load())
+    {
+        return g_port.load() == port;
+    }
+
+    // Metrics are for the local scraper only; the request head ends with a blank line
+    if (!LightSyncReactor::Listen(port, LightSyncReactor::Framing::HeaderEnd, MAX_REQUEST_HEADER_BYTES,
+        std::chrono::milliseconds(METRICS_RECEIVE_TIMEOUT_MS), Respond))
+    {
+        return false;
+    }
+
+    g_port.store(port);
+    g_enabled.store(true);
+    return true;
+}
+
+/**
+ * @brief Stops the metrics listener and latency timing
+ */
+void LightSyncMetrics::Disable()
+{
+    std::lock_guard<std::mutex> lock(g_serverMutex);
+    if (!g_enabled.exchange(false))
+    {
+        return;
+    }
+
+    LightSyncReactor::CloseListener(g_port.load());
+    g_port.store(0);
+}
+
+bool LightSyncMetrics::IsEnabled()
+{
+    return g_enabled.load();
+}
+
+int LightSyncMetrics::Port()
+{
+    return g_port.load();
+}
+
+void LightSyncMetrics::CountLightEvent(CRhinoEventWatcher::light_event event)
+{
+    size_t type = EVENT_TYPE_COUNT - 1;
+    switch (event)
+    {
+    case CRhinoEventWatcher::light_event::light_added:
+        type = 0;
+        break;
+    case CRhinoEventWatcher::light_event::light_deleted:
+        type = 1;
+        break;
+    case CRhinoEventWatcher::light_event::light_undeleted:
+        type = 2;
+        break;
+    case CRhinoEventWatcher::light_event::light_modified:
+        type = 3;
+        break;
+    case CRhinoEventWatcher::light_event::light_sorted:
+        type = 4;
+        break;
+    default:
+        break;
+    }
+    g_events[type].fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Counts what one send call handed to a receiver's socket
+ *
+ * @param port Receiver port
+ * @param messages Messages or datagrams fully sent
+ * @param bytes Bytes of those messages
+ * @param failures Messages that could not be sent
+ */
+void LightSyncMetrics::CountSends(int port, uint64_t messages, uint64_t bytes, uint64_t failures)
+{
+    PortCounters& counters = CountersFor(port);
+    counters.messages.fetch_add(messages, std::memory_order_relaxed);
+    counters.bytes.fetch_add(bytes, std::memory_order_relaxed);
+    counters.failures.fetch_add(failures, std::memory_order_relaxed);
+}
+
+LightSyncMetrics::Histogram& LightSyncMetrics::SnapshotBuild()
+{
+    return g_snapshotBuild;
+}
+
+LightSyncMetrics::Histogram& LightSyncMetrics::Encode()
+{
+    return g_encode;
+}
+
+/**
+ * @brief Builds the exposition text served on /metrics
+ *
+ * Counters are read without locks. The gauges (queued deliveries, pipelines,
+ * tombstones) are read at scrape time and take the short locks of their owners.
+ *
+ * @return Prometheus text format, version 0.0.4
+ */
+std::string LightSyncMetrics::Render()
+{
+    const LightSyncStats::Counters& stats = LightSyncStats::Get();
+    std::string out;
+    out.reserve(8192);
+
+    AppendHeader(out, "lightsync_light_events_total", "counter", "Light table events received, by event type.");
+    for (size_t i = 0; i < EVENT_TYPE_COUNT; ++i)
+    {
+        AppendSample(out, "lightsync_light_events_total", "type", EVENT_TYPES[i], Load(g_events[i]));
+    }
+    AppendMetric(out, "lightsync_suppressed_events_total", "counter",
+        "Events that changed nothing transmitted.", Load(stats.suppressedEvents));
+    AppendMetric(out, "lightsync_scene_updates_total", "counter",
+        "Events that resolved and sent a whole scene.", Load(stats.sceneUpdates));
+    AppendMetric(out, "lightsync_field_updates_total", "counter",
+        "Events sent as the changed fields of one light.", Load(stats.fieldUpdates));
+    AppendMetric(out, "lightsync_coalesced_deliveries_total", "counter",
+        "Queued deliveries superseded by a newer scene before they were sent.", Load(stats.coalescedDeliveries));
+
+    AppendPortSeries(out, "lightsync_messages_sent_total",
+        "Messages and datagrams fully handed to a receiver's socket.", &PortCounters::messages);
+    AppendPortSeries(out, "lightsync_bytes_sent_total", "Bytes sent to a receiver.", &PortCounters::bytes);
+    AppendPortSeries(out, "lightsync_send_failures_total", "Failed connects or sends to a receiver.",
+        &PortCounters::failures);
+    AppendMetric(out, "lightsync_send_backoffs_total", "counter",
+        "Pauses of a receiver's channel after a failed send.", Load(stats.sendBackoffs));
+    AppendMetric(out, "lightsync_backlog_drops_total", "counter",
+        "Deliveries dropped because a failing receiver's backlog was full.", Load(stats.backlogDrops));
+
+    AppendHeader(out, "lightsync_receiver_resumes_total", "counter",
+        "Reconnecting receivers caught up through a resume request, by what they were sent.");
+    AppendSample(out, "lightsync_receiver_resumes_total", "result", "keyframe", Load(stats.resumeKeyframes));
+    AppendSample(out, "lightsync_receiver_resumes_total", "result", "deltas", Load(stats.resumeDeltas));
+    AppendSample(out, "lightsync_receiver_resumes_total", "result", "current", Load(stats.resumeCurrent));
+    AppendMetric(out, "lightsync_queries_total", "counter", "Light queries answered.", Load(stats.queries));
+    AppendMetric(out, "lightsync_leases_expired_total", "counter",
+        "Receivers unsubscribed because they stopped renewing their lease.", Load(stats.leasesExpired));
+
+    AppendMetric(out, "lightsync_queued_deliveries", "gauge",
+        "Deliveries waiting in the document channels.", LightDocumentPipeline::QueuedDeliveries());
+    AppendMetric(out, "lightsync_document_pipelines", "gauge",
+        "Documents with a sync pipeline.", LightDocumentPipeline::Count());
+    AppendMetric(out, "lightsync_tombstones", "gauge",
+        "Deleted-light tombstones kept across all documents.", LightTombstoneStore::Count());
+    const LightSnapshot::Ptr snapshot = LightSnapshotStore::Latest();
+    AppendMetric(out, "lightsync_snapshot_version", "gauge",
+        "Version of the latest published light snapshot.", snapshot ? snapshot->Version() : 0);
+
+    AppendSeconds(out, "lightsync_plugin_load_seconds",
+        "Time the plug-in added to Rhino's startup (registering the light watcher).",
+        LightSyncRuntime::LoadMilliseconds());
+    AppendSeconds(out, "lightsync_runtime_start_seconds",
+        "Time to start the network thread, control port and backup file writer on first use.",
+        LightSyncRuntime::StartMilliseconds());
+
+    g_snapshotBuild.Append(out, "lightsync_snapshot_build_seconds",
+        "Time to record an event's lights into a new snapshot.");
+    g_encode.Append(out, "lightsync_encode_seconds", "Time to encode one light data message.");
+    return out;
+}
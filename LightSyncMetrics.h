@@ -0,0 +1,86 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+#pragma once
+
+#include "stdafx.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Loopback HTTP endpoint serving the sync pipeline's metrics
+ *
+ * While enabled, GET /metrics on the metrics port returns the counters of
+ * LightSyncStats, per-receiver send counters, gauges read at scrape time and
+ * latency histograms in the Prometheus text format. Everything the hot path
+ * touches is a relaxed atomic in a fixed-size table; receiver ports claim a
+ * slot with one compare-and-swap, so recording never takes a lock or
+ * allocates. Latencies are only timed while the endpoint is enabled.
+ */
+class LightSyncMetrics
+{
+public:
+    /**
+     * @brief Latency histogram with fixed buckets, updated without locks
+     */
+    class Histogram
+    {
+    public:
+        static const size_t BUCKET_COUNT = 12;
+
+        Histogram();
+
+        void Observe(uint64_t microseconds);
+
+        // Appends the histogram's exposition lines (seconds) under the metric name
+        void Append(std::string& out, const char* name, const char* help) const;
+
+    private:
+        std::atomic<uint64_t> m_buckets[BUCKET_COUNT + 1];  // Last one is +Inf
+        std::atomic<uint64_t> m_sumMicroseconds;
+    };
+
+    /**
+     * @brief Adds the lifetime of the scope to a histogram while metrics are enabled
+     */
+    class ScopedTimer
+    {
+    public:
+        explicit ScopedTimer(Histogram& histogram);
+        ~ScopedTimer();
+
+    private:
+        Histogram& m_histogram;
+        const bool m_timed;
+        std::chrono::steady_clock::time_point m_start;
+    };
+
+    // Starts serving on the loopback port; true if it is running
+    static bool Enable(int port);
+    static void Disable();
+    static bool IsEnabled();
+    static int Port();
+
+    // Hot-path recording (any thread)
+    static void CountLightEvent(CRhinoEventWatcher::light_event event);
+    static void CountSends(int port, uint64_t messages, uint64_t bytes, uint64_t failures);
+    static Histogram& SnapshotBuild();
+    static Histogram& Encode();
+
+    // Complete exposition text
+    static std::string Render();
+
+    static constexpr int DEFAULT_METRICS_PORT = 9464;
+    static const size_t MAX_PORTS = 64;  // Receivers past this share the port="other" series
+};
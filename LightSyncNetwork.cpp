@@ -0,0 +1,162 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+#include "stdafx.h"
+#include "LightSyncNetwork.h"
+#include "LightSyncMetrics.h"
+#include "LightSyncReactor.h"
+#include "LightSyncStats.h"
+#include "LightSyncTrace.h"
+#include <memory>
+
+/**
+ * @brief Queues a single payload for Unreal Engine
+ *
+ * The network thread opens a connection to the local Unreal listener, writes
+ * the payload and closes the connection so the receiver can treat connection
+ * close as end of message. The payload is kept alive until then.
+ *
+ * @param utf8Data UTF-8 encoded payload
+ * @param port TCP port number to connect to (should match Unreal's listener)
+ * @param handler Called on the network thread with the result (may be empty)
+ * @return True if the payload was queued; otherwise the handler is not called
+ */
+bool LightSyncNetwork::SendPayload(std::string utf8Data, int port, SendHandler handler)
+{
+    std::shared_ptr<const std::string> payload = std::make_shared<const std::string>(std::move(utf8Data));
+    std::vector<Segment> segments(1, Segment{ payload->data(), payload->length() });
+    return SendPayload(std::move(segments), port, [payload, handler = std::move(handler)](bool sent)
+    {
+        if (handler)
+            handler(sent);
+    });
+}
+
+/**
+ * @brief Queues a payload made of several buffers as one message
+ *
+ * The buffers are written back to back with vectored sends, so a message
+ * gathered from cached fragments never has to be concatenated first. Sent
+ * messages, bytes and failures are counted before the handler runs.
+ *
+ * @param segments Buffers in payload order; they must stay valid until the handler ran
+ * @param port TCP port number to connect to
+ * @param handler Called on the network thread with the result (may be empty)
+ * @return True if the payload was queued; otherwise the handler is not called
+ */
+bool LightSyncNetwork::SendPayload(std::vector<Segment> segments, int port, SendHandler handler)
+{
+    size_t totalBytes = 0;
+    for (const auto& segment : segments)
+    {
+        totalBytes += segment.size;
+    }
+
+    const bool queued = LightSyncReactor::Send(port, std::move(segments), [port, totalBytes, handler = std::move(handler)](bool sent)
+    {
+        if (sent)
+        {
+            LightSyncStats::Increment(LightSyncStats::Get().messagesSent);
+            LightSyncStats::Increment(LightSyncStats::Get().bytesSent, totalBytes);
+            LightSyncMetrics::CountSends(port, 1, totalBytes, 0);
+        }
+        else
+        {
+            LightSyncStats::Increment(LightSyncStats::Get().sendFailures);
+            LightSyncMetrics::CountSends(port, 0, 0, 1);
+        }
+
+        if (handler)
+            handler(sent);
+    });
+
+    if (!queued)
+    {
+        // The network thread is stopped (plug-in unloading)
+        LightSyncStats::Increment(LightSyncStats::Get().sendFailures);
+        LightSyncMetrics::CountSends(port, 0, 0, 1);
+    }
+    return queued;
+}
+
+/**
+ * @brief Sends transform samples as UDP datagrams
+ *
+ * The datagrams go out over the network thread's UDP socket, which stays open
+ * for the plug-in's lifetime. Nothing is acknowledged: the receiver drops
+ * samples it already has newer state for, and the next sample replaces a
+ * lost one. Called off the network thread, the sample is posted to it.
+ *
+ * @param datagrams Payloads of at most MAX_DATAGRAM_BYTES each
+ * @param port UDP port number the receiver listens on
+ * @return True if every datagram was handed to the socket (or the sample was posted)
+ */
+bool LightSyncNetwork::SendDatagrams(const std::vector<std::string>& datagrams, int port)
+{
+    if (!LightSyncReactor::IsNetworkThread())
+    {
+        const bool posted = LightSyncReactor::Post([datagrams, port]() { SendDatagrams(datagrams, port); });
+        if (!posted)
+        {
+            LightSyncStats::Increment(LightSyncStats::Get().datagramFailures, datagrams.size());
+            LightSyncMetrics::CountSends(port, 0, 0, datagrams.size());
+        }
+        return posted;
+    }
+
+    size_t sentBytes = 0;
+    const size_t sentCount = LightSyncReactor::SendDatagrams(port, datagrams, sentBytes);
+    LightSyncStats::Increment(LightSyncStats::Get().datagramsSent, sentCount);
+    LightSyncStats::Increment(LightSyncStats::Get().bytesSent, sentBytes);
+    LightSyncStats::Increment(LightSyncStats::Get().datagramFailures, datagrams.size() - sentCount);
+    LightSyncMetrics::CountSends(port, sentCount, sentBytes, datagrams.size() - sentCount);
+    return sentCount == datagrams.size();
+}
+
+/**
+ * @brief Converts wide string to UTF-8 encoded string for network transmission
+ *
+ * @param wstr Wide string to convert
+ * @return UTF-8 encoded string suitable for network transmission
+ */
+std::string LightSyncNetwork::WStringToUTF8(const std::wstring& wstr)
+{
+    LightSyncTrace::Span span("utf8");
+    std::string strTo;
+    AppendUTF8(strTo, wstr.data(), wstr.size());
+    return strTo;
+}
+
+/**
+ * @brief Appends the UTF-8 encoding of wide text to an existing buffer
+ *
+ * @param out Buffer to append to (grows only if its capacity is too small)
+ * @param text Wide characters to convert
+ * @param length Number of characters in text
+ */
+void LightSyncNetwork::AppendUTF8(std::string& out, const wchar_t* text, size_t length)
+{
+    if (length == 0)
+        return;
+
+    // Calculate required buffer size
+    int size_needed = WideCharToMultiByte(CP_UTF8, 0, text, static_cast<int>(length),
+        nullptr, 0, nullptr, nullptr);
+    if (size_needed <= 0)
+        return;
+
+    // Perform the conversion at the end of the buffer
+    const size_t offset = out.size();
+    out.resize(offset + size_needed);
+    WideCharToMultiByte(CP_UTF8, 0, text, static_cast<int>(length),
+        &out[offset], size_needed, nullptr, nullptr);
+}
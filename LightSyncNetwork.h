@@ -0,0 +1,58 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+#pragma once
+
+#include "stdafx.h"
+#include "LightSyncReactor.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Shared TCP transport used by every message the plugin sends to Unreal
+ *
+ * The light watcher and the sync commands all deliver a single UTF-8 payload per
+ * connection to the Unreal listener, so the socket handling lives here once.
+ * Payloads are written by LightSyncReactor's network thread; the caller never
+ * waits on a receiver. Live drag transforms can instead go out as UDP
+ * datagrams to the same port number, where a lost or late sample does not
+ * hold up the ones after it.
+ */
+class LightSyncNetwork
+{
+public:
+    // Piece of a payload that is sent in place, without being copied into one buffer
+    typedef LightSyncReactor::Segment Segment;
+
+    // Result of a queued payload, called on the network thread
+    typedef LightSyncReactor::SendHandler SendHandler;
+
+    // Queues the payload for the local Unreal listener (connect, send, close); false if not queued
+    static bool SendPayload(std::string utf8Data, int port, SendHandler handler = SendHandler());
+
+    // Same as SendPayload for a payload split across several buffers that must stay valid until the handler ran
+    static bool SendPayload(std::vector<Segment> segments, int port, SendHandler handler);
+
+    // Sends each payload as one UDP datagram to the local listener; false if any was not sent
+    static bool SendDatagrams(const std::vector<std::string>& datagrams, int port);
+
+    // Converts wide strings produced by the JSON builders to UTF-8 for transmission
+    static std::string WStringToUTF8(const std::wstring& wstr);
+
+    // Appends the UTF-8 form of wide text, reusing the output's capacity
+    static void AppendUTF8(std::string& out, const wchar_t* text, size_t length);
+
+    // Constants
+    static constexpr int DEFAULT_TCP_PORT = 5173;
+    static constexpr size_t MAX_DATAGRAM_BYTES = 1200;  // Stays below common path MTUs
+};
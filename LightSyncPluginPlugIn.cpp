@@ -17,6 +17,18 @@
 #include "LightSyncPluginPlugIn.h"
 #include "Resource.h"
 #include "LightEventWatcher.h"
+#include "LightAgentLink.h"
+#include "LightDocumentPipeline.h"
+#include "LightSyncControlServer.h"
+#include "LightSyncMetrics.h"
+#include "LightSyncReactor.h"
+#include "LightSyncRuntime.h"
+#include "LightSyncTrace.h"
+#include "LightEventJournal.h"
+#include "LightSnapshotExporter.h"
+#include "LightWorkerPool.h"
+#include "LiveDragStreamer.h"
+#include <chrono>
 
 // The plug-in object must be constructed before any plug-in classes derived
 // from CRhinoCommand. The #pragma init_seg(lib) ensures that this happens.
@@ -106,10 +118,14 @@ BOOL CLightSyncPluginPlugIn::OnLoadPlugIn()
 	// Called after the plug-in is loaded and the constructor has been run.
 	// This is where significant initialization should be performed.
 	// This function must return TRUE for the plug-in to continue loading.
+	const auto loadStart = std::chrono::steady_clock::now();
 	// Turn on event watcher
 	g_LightEventWatcher.Register();
 	g_LightEventWatcher.Enable(TRUE);
-	// Initialize the light sync system
+	// Everything else (network thread, control port, backup file) waits for the
+	// first light event or sync command, so loading at startup costs next to nothing
+	LightSyncRuntime::RecordLoad(
+		std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart).count());
 	return TRUE;
 }
 
@@ -120,5 +136,18 @@ void CLightSyncPluginPlugIn::OnUnloadPlugIn()
 	// Turn off event watcher
 	g_LightEventWatcher.Enable(FALSE);
 	// Clean up any resources used by the light sync system
+	LightSyncControlServer::Stop();
+	LightSyncMetrics::Disable();
+	LiveDragStreamer::Disable();
+	LightDocumentPipeline::Shutdown();
+	LightAgentLink::Stop();
+	LightSyncReactor::Stop();
+	LightSnapshotExporter::Stop();
+	LightWorkerPool::Shutdown();
+	LightEventJournal::Stop();
+	// A trace still running keeps what it recorded
+	size_t traceSpans = 0;
+	size_t traceDropped = 0;
+	LightSyncTrace::Stop(LightSyncTrace::DEFAULT_TRACE_PATH, traceSpans, traceDropped);
 }
 
@@ -37,7 +37,8 @@ public:
 
   // Required overrides
 
-  // Load the plugin at startup
+  // Load the plugin at startup so the light watcher sees every event; loading
+  // only registers the watcher (see LightSyncRuntime for the deferred rest)
   CRhinoPlugIn::plugin_load_time CLightSyncPluginPlugIn::PlugInLoadTime()
   {
 	  return CRhinoPlugIn::load_plugin_at_startup;
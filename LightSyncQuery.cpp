@@ -0,0 +1,208 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+#include "stdafx.h"
+#include "LightSyncQuery.h"
+#include "LightDocumentPipeline.h"
+#include "LightSyncNetwork.h"
+#include "LightSyncStats.h"
+#include <deque>
+#include <mutex>
+#include <unordered_set>
+#include <utility>
+
+namespace {
+    typedef std::unordered_set<ON_UUID, LightUtils::UuidHash> IdSet;
+
+    // Kinds reported in the per-type counts, in reply order
+    const LightUtils::LightType COUNTED_TYPES[] = {
+        LightUtils::LightType::Directional,
+        LightUtils::LightType::Point,
+        LightUtils::LightType::Spot,
+        LightUtils::LightType::Ambient,
+        LightUtils::LightType::Unknown
+    };
+
+    // Snapshots paged through, newest first, with the document they belong to
+    std::mutex g_retainedMutex;
+    std::deque<std::pair<unsigned int, LightSnapshot::Ptr>> g_retained;
+
+    unsigned int TypeBit(LightUtils::LightType type)
+    {
+        return 1u << static_cast<unsigned int>(type);
+    }
+
+    bool Matches(const LightUtils::LightInfo& light, const LightSyncQuery::Filter& filter, const IdSet& ids)
+    {
+        if (filter.changedSince != 0 && light.version <= filter.changedSince)
+            return false;
+        if (filter.typeMask != 0 && (filter.typeMask & TypeBit(light.type)) == 0)
+            return false;
+        if (filter.hasRegion && !filter.region.Contains(light.location))
+            return false;
+        return ids.empty() || ids.count(light.id) > 0;
+    }
+
+    std::string ReplyError(const std::string& message)
+    {
+        return "{\"status\": \"error\", \"message\": \"" + message + "\"}";
+    }
+}
+
+bool LightSyncQuery::ParseLightType(const std::string& name, LightUtils::LightType& type)
+{
+    for (LightUtils::LightType candidate : COUNTED_TYPES)
+    {
+        if (name == LightSyncNetwork::WStringToUTF8(LightUtils::GetLightTypeName(candidate)))
+        {
+            type = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Runs a query against the latest (or a retained) snapshot of a document
+ *
+ * Reply:
+ *   {"status": "ok", "document": 2, "version": 1234, "total": 40, "offset": 0,
+ *    "counts": {"Directional": 1, "Point": 12, "Spot": 27, "Ambient": 0, "Unknown": 0},
+ *    "next": 256, "lights": [...]}
+ * "total" and "counts" cover every matching light, "lights" only the page.
+ * "next" is the offset of the following page and is left out on the last one.
+ * Records carry their position in the scene as "id".
+ *
+ * @param docSerial Open document to query
+ * @param filter Filters and page
+ * @return UTF-8 JSON reply with a status field
+ */
+std::string LightSyncQuery::Run(unsigned int docSerial, const Filter& filter)
+{
+    LightDocumentPipeline::Ptr pipeline = LightDocumentPipeline::Find(docSerial);
+    LightSnapshot::Ptr snapshot;
+    if (filter.version != 0)
+    {
+        snapshot = Retained(docSerial, filter.version);
+        if (!snapshot)
+        {
+            return ReplyError("version " + std::to_string(filter.version) + " is no longer kept; restart the query");
+        }
+    }
+    else if (pipeline)
+    {
+        snapshot = pipeline->LatestSnapshot();
+    }
+    LightSyncStats::Increment(LightSyncStats::Get().queries);
+
+    std::string reply = "{\"status\": \"ok\", \"document\": " + std::to_string(docSerial);
+    if (!snapshot || !pipeline)
+    {
+        // Nothing was recorded for the document yet
+        reply += ", \"version\": 0, \"total\": 0, \"offset\": 0, \"counts\": {}, \"lights\": []}";
+        return reply;
+    }
+    if (filter.offset == 0 && filter.limit > 0)
+    {
+        Retain(docSerial, snapshot);
+    }
+
+    const IdSet ids(filter.ids.begin(), filter.ids.end());
+    const size_t limit = filter.limit < MAX_PAGE_SIZE ? filter.limit : MAX_PAGE_SIZE;
+    size_t counts[sizeof(COUNTED_TYPES) / sizeof(COUNTED_TYPES[0])] = {};
+    size_t total = 0;
+    std::vector<size_t> page;
+    page.reserve(limit);
+
+    for (size_t i = 0; i < snapshot->Count(); ++i)
+    {
+        const LightUtils::LightInfo& light = snapshot->At(i);
+        if (!Matches(light, filter, ids))
+            continue;
+
+        for (size_t t = 0; t < sizeof(COUNTED_TYPES) / sizeof(COUNTED_TYPES[0]); ++t)
+        {
+            if (COUNTED_TYPES[t] == light.type)
+                ++counts[t];
+        }
+        if (total >= filter.offset && page.size() < limit)
+        {
+            page.push_back(i);
+        }
+        ++total;
+    }
+
+    reply += ", \"version\": " + std::to_string(snapshot->Version());
+    reply += ", \"total\": " + std::to_string(total);
+    reply += ", \"offset\": " + std::to_string(filter.offset);
+    reply += ", \"counts\": {";
+    for (size_t t = 0; t < sizeof(COUNTED_TYPES) / sizeof(COUNTED_TYPES[0]); ++t)
+    {
+        if (t > 0)
+            reply += ", ";
+        reply += "\"" + LightSyncNetwork::WStringToUTF8(LightUtils::GetLightTypeName(COUNTED_TYPES[t])) + "\": ";
+        reply += std::to_string(counts[t]);
+    }
+    reply += "}";
+    if (filter.offset + page.size() < total && limit > 0)
+    {
+        reply += ", \"next\": " + std::to_string(filter.offset + page.size());
+    }
+
+    // Page records come from the document's fragment cache like every other message
+    std::vector<LightFragmentCache::Fragment> fragments;
+    pipeline->FragmentCache().Gather(page.size(),
+        [&snapshot, &page](size_t index) -> const LightUtils::LightInfo& { return snapshot->At(page[index]); },
+        fragments);
+
+    reply += ", \"lights\": [";
+    for (size_t i = 0; i < page.size(); ++i)
+    {
+        reply += i > 0 ? ",\n    {\n      \"id\": " : "\n    {\n      \"id\": ";
+        reply += std::to_string(page[i]);
+        reply += ",\n";
+        reply += *fragments[i];
+    }
+    reply += page.empty() ? "]}" : "\n  ]}";
+    return reply;
+}
+
+LightSnapshot::Ptr LightSyncQuery::Retained(unsigned int docSerial, uint64_t version)
+{
+    std::lock_guard<std::mutex> lock(g_retainedMutex);
+    for (const auto& retained : g_retained)
+    {
+        if (retained.first == docSerial && retained.second->Version() == version)
+        {
+            return retained.second;
+        }
+    }
+    return LightSnapshot::Ptr();
+}
+
+void LightSyncQuery::Retain(unsigned int docSerial, const LightSnapshot::Ptr& snapshot)
+{
+    std::lock_guard<std::mutex> lock(g_retainedMutex);
+    for (auto retained = g_retained.begin(); retained != g_retained.end(); ++retained)
+    {
+        if (retained->second == snapshot)
+        {
+            g_retained.erase(retained);
+            break;
+        }
+    }
+    g_retained.emplace_front(docSerial, snapshot);
+    if (g_retained.size() > RETAINED_SNAPSHOTS)
+    {
+        g_retained.pop_back();
+    }
+}
@@ -0,0 +1,67 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+#pragma once
+
+#include "stdafx.h"
+#include "LightSnapshot.h"
+#include "LightSpatialIndex.h"
+#include "LightUtils.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Answers light queries sent on the control channel
+ *
+ * Tools that need a few lights, or only how many there are, ask for them
+ * instead of listening to the whole scene. A query is answered from the
+ * document's latest snapshot, so it never touches the Rhino document and runs
+ * on the network thread. Matching lights come back in scene order, a page at a
+ * time, encoded like the records of light data messages; the per-type counts
+ * cover every match. Snapshots that were paged through are kept for a while,
+ * so the following pages of a query can name the version of the first one and
+ * read the same scene.
+ */
+class LightSyncQuery
+{
+public:
+    struct Filter
+    {
+        std::vector<ON_UUID> ids;          // Only these lights, every light if empty
+        unsigned int typeMask;             // Bits 1 << LightType, 0 for every type
+        bool hasRegion;
+        LightSpatialIndex::Box region;     // Lights inside (boundary inclusive), in meters
+        uint64_t changedSince;             // Only lights changed after this version, 0 for all
+        uint64_t version;                  // Snapshot a previous page came from, 0 for the latest
+        size_t offset;                     // Matches skipped before the page
+        size_t limit;                      // Lights in the page, 0 for counts only
+
+        Filter() : typeMask(0), hasRegion(false), changedSince(0), version(0), offset(0), limit(DEFAULT_PAGE_SIZE) {}
+    };
+
+    static const size_t DEFAULT_PAGE_SIZE = 256;
+    static const size_t MAX_PAGE_SIZE = 4096;
+
+    // Snapshots kept for paging, newest first
+    static const size_t RETAINED_SNAPSHOTS = 8;
+
+    // Light type named in a query ("Spot", ...), false if unknown
+    static bool ParseLightType(const std::string& name, LightUtils::LightType& type);
+
+    // Runs a query against a document; returns the UTF-8 JSON reply
+    static std::string Run(unsigned int docSerial, const Filter& filter);
+
+private:
+    static LightSnapshot::Ptr Retained(unsigned int docSerial, uint64_t version);
+    static void Retain(unsigned int docSerial, const LightSnapshot::Ptr& snapshot);
+};
@@ -0,0 +1,1395 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+#include "LightSyncReactor.h"
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <mswsock.h>
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+
+namespace {
+#ifndef _WIN32
+    typedef int SOCKET;
+    constexpr SOCKET INVALID_SOCKET = -1;
+
+    void closesocket(SOCKET socket)
+    {
+        close(socket);
+    }
+#endif
+
+    typedef std::chrono::steady_clock Clock;
+    typedef LightSyncReactor::Segment Segment;
+
+    constexpr size_t MAX_BUFFERS_PER_SEND = 1024;  // Keeps each vectored send's buffer array bounded
+    constexpr size_t RECEIVE_BUFFER_BYTES = 4096;
+    constexpr int ACCEPT_RETRY_MS = 100;           // Pause before accepting again after a failed accept
+    constexpr uint64_t WAKE_KEY = 0;               // Completion key of wake-ups; handles start at 1
+
+    enum class Kind { Outbound, Inbound, Listener };
+    enum class Operation { None, Connect, Send, Receive, Accept };
+
+    /**
+     * @brief Socket owned by the network thread, with at most one operation in flight
+     *
+     * A handle is only destroyed while no operation is in flight: cancelling
+     * completes the operation with a failure first.
+     */
+    struct Handle
+    {
+#ifdef _WIN32
+        OVERLAPPED overlapped;
+#else
+        bool registered;  // Added to the epoll set
+#endif
+        const uint64_t id;
+        const Kind kind;
+        SOCKET socket;
+        Operation operation;
+        LightSyncReactor::TimerId timer;  // Timeout of the current phase
+        bool cancelled;                   // Timed out, closed or stopping: the next completion fails
+
+        Handle(uint64_t handleId, Kind handleKind, SOCKET handleSocket)
+            : id(handleId), kind(handleKind), socket(handleSocket), operation(Operation::None), timer(0), cancelled(false)
+        {
+#ifdef _WIN32
+            ZeroMemory(&overlapped, sizeof(overlapped));
+#else
+            registered = false;
+#endif
+        }
+
+        virtual ~Handle()
+        {
+            if (socket != INVALID_SOCKET)
+            {
+                closesocket(socket);
+            }
+        }
+    };
+
+    // Remaining part of a message being written
+    struct Outgoing
+    {
+        std::vector<Segment> segments;
+        size_t segment;  // First segment not completely written
+        size_t offset;   // Bytes of that segment already written
+
+        Outgoing() : segment(0), offset(0) {}
+
+        void Advance(size_t bytes)
+        {
+            offset += bytes;
+            while (segment < segments.size() && offset >= segments[segment].size)
+            {
+                offset -= segments[segment].size;
+                ++segment;
+            }
+        }
+
+        bool Done() const
+        {
+            return segment >= segments.size();
+        }
+    };
+
+    struct Connection : Handle
+    {
+        Outgoing out;
+#ifdef _WIN32
+        std::vector<WSABUF> buffers;  // Must stay valid while WSASend is in flight
+#endif
+
+        Connection(uint64_t handleId, Kind handleKind, SOCKET handleSocket) : Handle(handleId, handleKind, handleSocket) {}
+    };
+
+    struct Outbound : Connection
+    {
+        LightSyncReactor::SendHandler handler;
+        int port;
+        Clock::time_point phaseStart;  // When the current connect or write phase began
+
+        Outbound(uint64_t handleId, SOCKET handleSocket, int targetPort)
+            : Connection(handleId, Kind::Outbound, handleSocket), port(targetPort) {}
+    };
+
+    // Listening port settings shared by the listener and the connections it accepted
+    struct Service
+    {
+        int port;
+        LightSyncReactor::Framing framing;
+        size_t maxRequestBytes;
+        std::chrono::milliseconds receiveTimeout;
+        LightSyncReactor::RequestHandler handler;
+    };
+
+    struct Inbound : Connection
+    {
+        std::shared_ptr<const Service> service;
+        std::string request;
+        std::string reply;
+        char buffer[RECEIVE_BUFFER_BYTES];
+#ifdef _WIN32
+        WSABUF receiveBuffer;
+#endif
+
+        Inbound(uint64_t handleId, SOCKET handleSocket, std::shared_ptr<const Service> handleService)
+            : Connection(handleId, Kind::Inbound, handleSocket), service(std::move(handleService))
+        {
+#ifdef _WIN32
+            receiveBuffer.buf = buffer;
+            receiveBuffer.len = static_cast<ULONG>(sizeof(buffer));
+#endif
+        }
+    };
+
+    struct Listener : Handle
+    {
+        std::shared_ptr<const Service> service;
+        SOCKET accepted;  // Connection taken by the last accept
+#ifdef _WIN32
+        char addresses[2 * (sizeof(sockaddr_in) + 16)];  // Filled by AcceptEx
+#endif
+
+        Listener(uint64_t handleId, SOCKET handleSocket, std::shared_ptr<const Service> handleService)
+            : Handle(handleId, Kind::Listener, handleSocket), service(std::move(handleService)), accepted(INVALID_SOCKET) {}
+
+        ~Listener()
+        {
+            if (accepted != INVALID_SOCKET)
+            {
+                closesocket(accepted);
+            }
+        }
+    };
+
+    struct PendingTimer
+    {
+        Clock::time_point deadline;
+        LightSyncReactor::TimerId id;
+
+        bool operator>(const PendingTimer& other) const
+        {
+            return deadline > other.deadline;
+        }
+    };
+
+    // Lifecycle (any thread)
+    std::mutex g_lifecycleMutex;
+    std::thread g_thread;
+    std::atomic<bool> g_running(false);
+    std::atomic<bool> g_stopping(false);
+    std::atomic<std::thread::id> g_networkThread{ std::thread::id() };
+    LightSyncReactor::PhaseObserver g_phaseObserver;  // Set before the thread starts, then read by it only
+
+    // Posted tasks and timers (any thread, under g_queueMutex)
+    std::mutex g_queueMutex;
+    bool g_accepting = false;
+    std::vector<LightSyncReactor::Task> g_tasks;
+    std::priority_queue<PendingTimer, std::vector<PendingTimer>, std::greater<PendingTimer>> g_timerQueue;
+    std::unordered_map<LightSyncReactor::TimerId, LightSyncReactor::Task> g_timerTasks;
+    LightSyncReactor::TimerId g_nextTimer = 1;
+
+    // Sockets (network thread only)
+    std::unordered_map<uint64_t, std::unique_ptr<Handle>> g_handles;
+    std::map<int, uint64_t> g_listeners;  // Port to listener handle
+    std::vector<std::pair<uint64_t, Operation>> g_deferredFailures;
+    uint64_t g_nextHandle = 1;
+    SOCKET g_datagramSocket = INVALID_SOCKET;  // Opened by the first datagram, closed when the thread ends
+
+    Handle* FindHandle(uint64_t id)
+    {
+        auto found = g_handles.find(id);
+        return found != g_handles.end() ? found->second.get() : nullptr;
+    }
+
+    // Completes an operation that failed before it was in flight on the next loop iteration
+    void DeferFailure(Handle& handle)
+    {
+        g_deferredFailures.emplace_back(handle.id, handle.operation);
+    }
+
+    sockaddr_in LoopbackAddress(int port)
+    {
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(static_cast<uint16_t>(port));
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        return address;
+    }
+
+#ifdef _WIN32
+    // I/O completion port backend: operations are issued at once and finish as completion packets
+    HANDLE g_completionPort = nullptr;
+    LPFN_CONNECTEX g_connectEx = nullptr;
+    LPFN_ACCEPTEX g_acceptEx = nullptr;
+
+    void Complete(Handle& handle, Operation operation, bool succeeded, size_t bytes);
+
+    bool OpenBackend()
+    {
+        WSADATA wsaData;
+        if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0)
+        {
+            return false;
+        }
+
+        // ConnectEx and AcceptEx are extensions looked up through any TCP socket
+        SOCKET probe = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        GUID connectExId = WSAID_CONNECTEX;
+        GUID acceptExId = WSAID_ACCEPTEX;
+        DWORD bytes = 0;
+        const bool loaded = probe != INVALID_SOCKET &&
+            WSAIoctl(probe, SIO_GET_EXTENSION_FUNCTION_POINTER, &connectExId, sizeof(connectExId),
+                &g_connectEx, sizeof(g_connectEx), &bytes, nullptr, nullptr) == 0 &&
+            WSAIoctl(probe, SIO_GET_EXTENSION_FUNCTION_POINTER, &acceptExId, sizeof(acceptExId),
+                &g_acceptEx, sizeof(g_acceptEx), &bytes, nullptr, nullptr) == 0;
+        if (probe != INVALID_SOCKET)
+        {
+            closesocket(probe);
+        }
+
+        g_completionPort = loaded ? CreateIoCompletionPort(INVALID_HANDLE_VALUE, nullptr, 0, 1) : nullptr;
+        if (g_completionPort == nullptr)
+        {
+            WSACleanup();
+            return false;
+        }
+        return true;
+    }
+
+    void CloseBackend()
+    {
+        CloseHandle(g_completionPort);
+        g_completionPort = nullptr;
+        WSACleanup();
+    }
+
+    void WakeBackend()
+    {
+        PostQueuedCompletionStatus(g_completionPort, 0, WAKE_KEY, nullptr);
+    }
+
+    SOCKET NewSocket()
+    {
+        return WSASocket(AF_INET, SOCK_STREAM, IPPROTO_TCP, nullptr, 0, WSA_FLAG_OVERLAPPED);
+    }
+
+    SOCKET NewDatagramSocket()
+    {
+        SOCKET datagramSocket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+        u_long nonBlocking = 1;
+        if (datagramSocket != INVALID_SOCKET && ioctlsocket(datagramSocket, FIONBIO, &nonBlocking) != 0)
+        {
+            closesocket(datagramSocket);
+            datagramSocket = INVALID_SOCKET;
+        }
+        return datagramSocket;
+    }
+
+    bool Associate(Handle& handle)
+    {
+        return CreateIoCompletionPort(reinterpret_cast<HANDLE>(handle.socket), g_completionPort,
+            static_cast<ULONG_PTR>(handle.id), 0) != nullptr;
+    }
+
+    void Issue(Handle& handle, Operation operation)
+    {
+        handle.operation = operation;
+        ZeroMemory(&handle.overlapped, sizeof(handle.overlapped));
+    }
+
+    void StartConnect(Connection& connection, const sockaddr_in& address)
+    {
+        Issue(connection, Operation::Connect);
+
+        // ConnectEx needs a bound socket
+        sockaddr_in local = {};
+        local.sin_family = AF_INET;
+        local.sin_addr.s_addr = htonl(INADDR_ANY);
+        if (bind(connection.socket, reinterpret_cast<const SOCKADDR*>(&local), sizeof(local)) == SOCKET_ERROR ||
+            (!g_connectEx(connection.socket, reinterpret_cast<const SOCKADDR*>(&address), sizeof(address),
+                nullptr, 0, nullptr, &connection.overlapped) && WSAGetLastError() != ERROR_IO_PENDING))
+        {
+            DeferFailure(connection);
+        }
+    }
+
+    void StartSend(Connection& connection)
+    {
+        Issue(connection, Operation::Send);
+
+        const Outgoing& out = connection.out;
+        const size_t end = std::min(out.segments.size(), out.segment + MAX_BUFFERS_PER_SEND);
+        connection.buffers.clear();
+        for (size_t i = out.segment; i < end; ++i)
+        {
+            const size_t skip = i == out.segment ? out.offset : 0;
+            if (out.segments[i].size == skip)
+                continue;
+            WSABUF buffer;
+            buffer.buf = const_cast<CHAR*>(out.segments[i].data + skip);
+            buffer.len = static_cast<ULONG>(out.segments[i].size - skip);
+            connection.buffers.push_back(buffer);
+        }
+
+        if (WSASend(connection.socket, connection.buffers.data(), static_cast<DWORD>(connection.buffers.size()),
+            nullptr, 0, &connection.overlapped, nullptr) == SOCKET_ERROR && WSAGetLastError() != WSA_IO_PENDING)
+        {
+            DeferFailure(connection);
+        }
+    }
+
+    void StartReceive(Inbound& inbound)
+    {
+        Issue(inbound, Operation::Receive);
+        DWORD flags = 0;
+        if (WSARecv(inbound.socket, &inbound.receiveBuffer, 1, nullptr, &flags, &inbound.overlapped, nullptr) == SOCKET_ERROR &&
+            WSAGetLastError() != WSA_IO_PENDING)
+        {
+            DeferFailure(inbound);
+        }
+    }
+
+    void StartAccept(Listener& listener)
+    {
+        Issue(listener, Operation::Accept);
+        listener.accepted = NewSocket();
+        DWORD bytes = 0;
+        if (listener.accepted == INVALID_SOCKET ||
+            (!g_acceptEx(listener.socket, listener.accepted, listener.addresses, 0,
+                sizeof(sockaddr_in) + 16, sizeof(sockaddr_in) + 16, &bytes, &listener.overlapped) &&
+                WSAGetLastError() != ERROR_IO_PENDING))
+        {
+            DeferFailure(listener);
+        }
+    }
+
+    // The operation's completion packet still arrives, with ERROR_OPERATION_ABORTED
+    void CancelOperation(Handle& handle)
+    {
+        CancelIoEx(reinterpret_cast<HANDLE>(handle.socket), &handle.overlapped);
+    }
+
+    void WaitBackend(int timeoutMs)
+    {
+        DWORD bytes = 0;
+        ULONG_PTR key = 0;
+        OVERLAPPED* overlapped = nullptr;
+        const BOOL succeeded = GetQueuedCompletionStatus(g_completionPort, &bytes, &key, &overlapped,
+            timeoutMs < 0 ? INFINITE : static_cast<DWORD>(timeoutMs));
+        if (overlapped == nullptr)
+            return; // Timeout or wake-up
+
+        Handle* handle = FindHandle(static_cast<uint64_t>(key));
+        if (handle == nullptr || handle->operation == Operation::None)
+            return;
+
+        const Operation operation = handle->operation;
+        handle->operation = Operation::None;
+        if (succeeded && operation == Operation::Connect)
+        {
+            setsockopt(handle->socket, SOL_SOCKET, SO_UPDATE_CONNECT_CONTEXT, nullptr, 0);
+        }
+        else if (succeeded && operation == Operation::Accept)
+        {
+            Listener& listener = static_cast<Listener&>(*handle);
+            setsockopt(listener.accepted, SOL_SOCKET, SO_UPDATE_ACCEPT_CONTEXT,
+                reinterpret_cast<const char*>(&listener.socket), sizeof(listener.socket));
+        }
+        Complete(*handle, operation, succeeded != FALSE, bytes);
+    }
+#else
+    // epoll backend: operations wait for readiness and are performed once the socket is ready
+    int g_epoll = -1;
+    int g_wakeEvent = -1;
+
+    void Complete(Handle& handle, Operation operation, bool succeeded, size_t bytes);
+
+    bool OpenBackend()
+    {
+        g_epoll = epoll_create1(EPOLL_CLOEXEC);
+        g_wakeEvent = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.u64 = WAKE_KEY;
+        if (g_epoll < 0 || g_wakeEvent < 0 || epoll_ctl(g_epoll, EPOLL_CTL_ADD, g_wakeEvent, &event) != 0)
+        {
+            if (g_epoll >= 0)
+                close(g_epoll);
+            if (g_wakeEvent >= 0)
+                close(g_wakeEvent);
+            g_epoll = g_wakeEvent = -1;
+            return false;
+        }
+        return true;
+    }
+
+    void CloseBackend()
+    {
+        close(g_epoll);
+        close(g_wakeEvent);
+        g_epoll = g_wakeEvent = -1;
+    }
+
+    void WakeBackend()
+    {
+        const uint64_t one = 1;
+        ssize_t written = write(g_wakeEvent, &one, sizeof(one));
+        (void)written; // A full counter already wakes the loop
+    }
+
+    SOCKET NewSocket()
+    {
+        return socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_TCP);
+    }
+
+    SOCKET NewDatagramSocket()
+    {
+        return socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_UDP);
+    }
+
+    bool Associate(Handle&)
+    {
+        return true; // Sockets join the epoll set when their first operation waits
+    }
+
+    // One-shot interest: the socket reports once, then stays quiet until the next operation
+    void Arm(Handle& handle, Operation operation, uint32_t events)
+    {
+        handle.operation = operation;
+        epoll_event event = {};
+        event.events = events | EPOLLONESHOT;
+        event.data.u64 = handle.id;
+        if (epoll_ctl(g_epoll, handle.registered ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, handle.socket, &event) != 0)
+        {
+            DeferFailure(handle);
+            return;
+        }
+        handle.registered = true;
+    }
+
+    void StartConnect(Connection& connection, const sockaddr_in& address)
+    {
+        if (connect(connection.socket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 &&
+            errno != EINPROGRESS)
+        {
+            connection.operation = Operation::Connect;
+            DeferFailure(connection);
+            return;
+        }
+        Arm(connection, Operation::Connect, EPOLLOUT);
+    }
+
+    void StartSend(Connection& connection)
+    {
+        Arm(connection, Operation::Send, EPOLLOUT);
+    }
+
+    void StartReceive(Inbound& inbound)
+    {
+        Arm(inbound, Operation::Receive, EPOLLIN);
+    }
+
+    void StartAccept(Listener& listener)
+    {
+        Arm(listener, Operation::Accept, EPOLLIN);
+    }
+
+    // Nothing is in flight in the kernel, so the operation fails right away
+    void CancelOperation(Handle& handle)
+    {
+        const Operation operation = handle.operation;
+        handle.operation = Operation::None;
+        Complete(handle, operation, false, 0);
+    }
+
+    bool WouldBlock()
+    {
+        return errno == EAGAIN || errno == EWOULDBLOCK;
+    }
+
+    void OnReady(Handle& handle)
+    {
+        const Operation operation = handle.operation;
+        handle.operation = Operation::None;
+
+        switch (operation)
+        {
+        case Operation::Connect:
+        {
+            int error = 0;
+            socklen_t length = sizeof(error);
+            const bool connected = getsockopt(handle.socket, SOL_SOCKET, SO_ERROR, &error, &length) == 0 && error == 0;
+            Complete(handle, operation, connected, 0);
+            break;
+        }
+        case Operation::Send:
+        {
+            const Outgoing& out = static_cast<Connection&>(handle).out;
+            iovec buffers[MAX_BUFFERS_PER_SEND];
+            size_t count = 0;
+            for (size_t i = out.segment; i < out.segments.size() && count < MAX_BUFFERS_PER_SEND; ++i)
+            {
+                const size_t skip = i == out.segment ? out.offset : 0;
+                buffers[count].iov_base = const_cast<char*>(out.segments[i].data + skip);
+                buffers[count].iov_len = out.segments[i].size - skip;
+                ++count;
+            }
+            msghdr message = {};
+            message.msg_iov = buffers;
+            message.msg_iovlen = count;
+            const ssize_t sent = sendmsg(handle.socket, &message, MSG_NOSIGNAL);
+            if (sent < 0 && WouldBlock())
+            {
+                StartSend(static_cast<Connection&>(handle));
+                break;
+            }
+            Complete(handle, operation, sent >= 0, sent > 0 ? static_cast<size_t>(sent) : 0);
+            break;
+        }
+        case Operation::Receive:
+        {
+            Inbound& inbound = static_cast<Inbound&>(handle);
+            const ssize_t received = recv(inbound.socket, inbound.buffer, sizeof(inbound.buffer), 0);
+            if (received < 0 && WouldBlock())
+            {
+                StartReceive(inbound);
+                break;
+            }
+            Complete(handle, operation, received >= 0, received > 0 ? static_cast<size_t>(received) : 0);
+            break;
+        }
+        case Operation::Accept:
+        {
+            Listener& listener = static_cast<Listener&>(handle);
+            listener.accepted = accept4(listener.socket, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (listener.accepted == INVALID_SOCKET && WouldBlock())
+            {
+                StartAccept(listener);
+                break;
+            }
+            Complete(handle, operation, listener.accepted != INVALID_SOCKET, 0);
+            break;
+        }
+        case Operation::None:
+            break;
+        }
+    }
+
+    void WaitBackend(int timeoutMs)
+    {
+        epoll_event events[64];
+        const int count = epoll_wait(g_epoll, events, 64, timeoutMs);
+        for (int i = 0; i < count; ++i)
+        {
+            if (events[i].data.u64 == WAKE_KEY)
+            {
+                uint64_t value = 0;
+                ssize_t drained = read(g_wakeEvent, &value, sizeof(value));
+                (void)drained;
+                continue;
+            }
+
+            // A handle closed by an earlier event of this batch is gone from the table
+            Handle* handle = FindHandle(events[i].data.u64);
+            if (handle != nullptr && handle->operation != Operation::None)
+            {
+                OnReady(*handle);
+            }
+        }
+    }
+#endif
+
+    void InvokeSendHandler(const LightSyncReactor::SendHandler& handler, bool sent)
+    {
+        if (!handler)
+            return;
+        try
+        {
+            handler(sent);
+        }
+        catch (...)
+        {
+            // A failing callback must never take down the network thread
+        }
+    }
+
+    void ReportPhase(int port, const char* phase, Clock::time_point start, Clock::time_point end)
+    {
+        if (!g_phaseObserver)
+            return;
+        try
+        {
+            g_phaseObserver(port, phase, start, end);
+        }
+        catch (...)
+        {
+            // A failing observer must never take down the network thread
+        }
+    }
+
+    // Reports the phase that just ended and starts timing the next one
+    void EndPhase(Outbound& outbound, const char* phase)
+    {
+        const Clock::time_point now = Clock::now();
+        ReportPhase(outbound.port, phase, outbound.phaseStart, now);
+        outbound.phaseStart = now;
+    }
+
+    // Runs the timeout on the network thread, where it cancels whatever the handle is doing
+    void ArmTimeout(Handle& handle, std::chrono::milliseconds timeout)
+    {
+        LightSyncReactor::CancelTimer(handle.timer);
+        const uint64_t id = handle.id;
+        handle.timer = LightSyncReactor::AddTimer(timeout, [id]()
+        {
+            Handle* timedOut = FindHandle(id);
+            if (timedOut != nullptr)
+            {
+                timedOut->timer = 0;
+                timedOut->cancelled = true;
+                if (timedOut->operation != Operation::None)
+                {
+                    CancelOperation(*timedOut);
+                }
+            }
+        });
+    }
+
+    // Closes a handle that has no operation in flight; outbound messages report their result
+    void Close(Handle& handle, bool sent)
+    {
+        LightSyncReactor::CancelTimer(handle.timer);
+
+        LightSyncReactor::SendHandler handler;
+        if (handle.kind == Kind::Outbound)
+        {
+            handler = std::move(static_cast<Outbound&>(handle).handler);
+        }
+        g_handles.erase(handle.id);
+
+        // The handle is gone before the callback runs, which may queue the next message
+        InvokeSendHandler(handler, sent);
+    }
+
+    // Stops a handle: it closes once its operation (if any) completed
+    void Abort(Handle& handle)
+    {
+        handle.cancelled = true;
+        if (handle.operation == Operation::None)
+        {
+            Close(handle, false);
+        }
+        else
+        {
+            CancelOperation(handle);
+        }
+    }
+
+    Handle& AddHandle(std::unique_ptr<Handle> handle)
+    {
+        Handle& added = *handle;
+        g_handles.emplace(added.id, std::move(handle));
+        return added;
+    }
+
+    void StartOutbound(int port, std::vector<Segment>& segments, LightSyncReactor::SendHandler& handler)
+    {
+        const SOCKET connectSocket = g_stopping.load() ? INVALID_SOCKET : NewSocket();
+        if (connectSocket == INVALID_SOCKET)
+        {
+            InvokeSendHandler(handler, false);
+            return;
+        }
+
+        std::unique_ptr<Outbound> created(new Outbound(g_nextHandle++, connectSocket, port));
+        created->out.segments = std::move(segments);
+        created->out.Advance(0);
+        created->handler = std::move(handler);
+        Outbound& outbound = static_cast<Outbound&>(AddHandle(std::move(created)));
+        if (!Associate(outbound))
+        {
+            Close(outbound, false);
+            return;
+        }
+
+        // One deadline covers connecting and writing, like the blocking socket's send timeout did
+        ArmTimeout(outbound, std::chrono::milliseconds(LightSyncReactor::SEND_TIMEOUT_MS));
+        outbound.phaseStart = Clock::now();
+        StartConnect(outbound, LoopbackAddress(port));
+    }
+
+    void OnOutboundConnected(Outbound& outbound, bool connected)
+    {
+        EndPhase(outbound, "connect");
+        if (!connected)
+        {
+            Close(outbound, false);
+        }
+        else if (outbound.out.Done())
+        {
+            Close(outbound, true);
+        }
+        else
+        {
+            StartSend(outbound);
+        }
+    }
+
+    void OnOutboundSent(Outbound& outbound, bool sent, size_t bytes)
+    {
+        outbound.out.Advance(bytes);
+        if (!sent)
+        {
+            EndPhase(outbound, "send");
+            Close(outbound, false);
+        }
+        else if (outbound.out.Done())
+        {
+            EndPhase(outbound, "send");
+            Close(outbound, true);
+        }
+        else
+        {
+            StartSend(outbound);
+        }
+    }
+
+    void StartAcceptAfterPause(Listener& listener)
+    {
+        const uint64_t id = listener.id;
+        listener.timer = LightSyncReactor::AddTimer(std::chrono::milliseconds(ACCEPT_RETRY_MS), [id]()
+        {
+            Handle* paused = FindHandle(id);
+            if (paused != nullptr)
+            {
+                paused->timer = 0;
+                StartAccept(static_cast<Listener&>(*paused));
+            }
+        });
+        if (listener.timer == 0)
+        {
+            Close(listener, false);
+        }
+    }
+
+    void OnAccepted(Listener& listener, bool accepted)
+    {
+        SOCKET clientSocket = listener.accepted;
+        listener.accepted = INVALID_SOCKET;
+        if (!accepted)
+        {
+            if (clientSocket != INVALID_SOCKET)
+            {
+                closesocket(clientSocket);
+            }
+            if (listener.cancelled)
+            {
+                Close(listener, false);
+            }
+            else
+            {
+                StartAcceptAfterPause(listener); // Usually a client that reset before it was accepted
+            }
+            return;
+        }
+
+        std::unique_ptr<Inbound> created(new Inbound(g_nextHandle++, clientSocket, listener.service));
+        Inbound& inbound = static_cast<Inbound&>(AddHandle(std::move(created)));
+        StartAccept(listener);
+
+        if (!Associate(inbound))
+        {
+            Close(inbound, false);
+            return;
+        }
+        ArmTimeout(inbound, inbound.service->receiveTimeout);
+        StartReceive(inbound);
+    }
+
+    bool RequestComplete(const Inbound& inbound, size_t previousSize)
+    {
+        if (inbound.service->framing != LightSyncReactor::Framing::HeaderEnd)
+            return false;
+        const size_t from = previousSize > 3 ? previousSize - 3 : 0;
+        return inbound.request.find("\r\n\r\n", from) != std::string::npos;
+    }
+
+    // Hands the request to the service and starts writing its reply
+    void Answer(Inbound& inbound)
+    {
+        if (inbound.request.empty())
+        {
+            Close(inbound, false);
+            return;
+        }
+
+        try
+        {
+            inbound.reply = inbound.service->handler(inbound.request);
+        }
+        catch (...)
+        {
+            inbound.reply.clear(); // A faulty request must never take down the listener
+        }
+
+        if (inbound.reply.empty())
+        {
+            Close(inbound, true);
+            return;
+        }
+
+        inbound.out.segments.assign(1, Segment{ inbound.reply.data(), inbound.reply.size() });
+        ArmTimeout(inbound, std::chrono::milliseconds(LightSyncReactor::SEND_TIMEOUT_MS));
+        StartSend(inbound);
+    }
+
+    void OnReceived(Inbound& inbound, bool received, size_t bytes)
+    {
+        if (!received)
+        {
+            Close(inbound, false); // Timed out or reset: dropped without a reply
+            return;
+        }
+        if (bytes == 0)
+        {
+            Answer(inbound); // The client shut down its sending side
+            return;
+        }
+
+        const size_t previousSize = inbound.request.size();
+        inbound.request.append(inbound.buffer, bytes);
+        if (inbound.request.size() > inbound.service->maxRequestBytes)
+        {
+            Close(inbound, false);
+        }
+        else if (RequestComplete(inbound, previousSize))
+        {
+            Answer(inbound);
+        }
+        else
+        {
+            StartReceive(inbound);
+        }
+    }
+
+    void OnReplySent(Inbound& inbound, bool sent, size_t bytes)
+    {
+        inbound.out.Advance(bytes);
+        if (sent && !inbound.out.Done())
+        {
+            StartSend(inbound);
+            return;
+        }
+        Close(inbound, sent);
+    }
+
+    void Complete(Handle& handle, Operation operation, bool succeeded, size_t bytes)
+    {
+        succeeded = succeeded && !handle.cancelled;
+        switch (handle.kind)
+        {
+        case Kind::Outbound:
+            if (operation == Operation::Connect)
+                OnOutboundConnected(static_cast<Outbound&>(handle), succeeded);
+            else
+                OnOutboundSent(static_cast<Outbound&>(handle), succeeded, bytes);
+            break;
+        case Kind::Inbound:
+            if (operation == Operation::Receive)
+                OnReceived(static_cast<Inbound&>(handle), succeeded, bytes);
+            else
+                OnReplySent(static_cast<Inbound&>(handle), succeeded, bytes);
+            break;
+        case Kind::Listener:
+            OnAccepted(static_cast<Listener&>(handle), succeeded);
+            break;
+        }
+    }
+
+    void CompleteDeferredFailures()
+    {
+        std::vector<std::pair<uint64_t, Operation>> failures;
+        failures.swap(g_deferredFailures);
+        for (const auto& failure : failures)
+        {
+            Handle* handle = FindHandle(failure.first);
+            if (handle != nullptr && handle->operation == failure.second)
+            {
+                handle->operation = Operation::None;
+                Complete(*handle, failure.second, false, 0);
+            }
+        }
+    }
+
+    void CloseListenerNow(int port)
+    {
+        auto found = g_listeners.find(port);
+        if (found == g_listeners.end())
+            return;
+        const uint64_t id = found->second;
+        g_listeners.erase(found);
+        Handle* listener = FindHandle(id);
+        if (listener == nullptr)
+            return;
+
+        // Release the port now; a cancelled accept still completes before the handle goes
+        Abort(*listener);
+        listener = FindHandle(id);
+        if (listener != nullptr)
+        {
+            closesocket(listener->socket);
+            listener->socket = INVALID_SOCKET;
+        }
+    }
+
+    // First step of Stop: every socket fails its current operation and closes
+    void AbortAll()
+    {
+        g_listeners.clear();
+        std::vector<uint64_t> ids;
+        ids.reserve(g_handles.size());
+        for (const auto& entry : g_handles)
+        {
+            ids.push_back(entry.first);
+        }
+        for (uint64_t id : ids)
+        {
+            Handle* handle = FindHandle(id);
+            if (handle != nullptr)
+            {
+                Abort(*handle);
+            }
+        }
+    }
+
+    // Swapped with g_tasks to run them, so both vectors keep their capacity (network thread only)
+    std::vector<LightSyncReactor::Task> g_runningTasks;
+
+    void RunTasks()
+    {
+        std::vector<LightSyncReactor::Task>& tasks = g_runningTasks;
+        {
+            std::lock_guard<std::mutex> lock(g_queueMutex);
+            tasks.swap(g_tasks);
+        }
+        for (auto& task : tasks)
+        {
+            try
+            {
+                task();
+            }
+            catch (...)
+            {
+                // A failing task must never take down the network thread
+            }
+        }
+        tasks.clear();
+    }
+
+    // Runs the timers that are due; returns the wait until the next one (-1 for none)
+    int RunTimers()
+    {
+        for (;;)
+        {
+            LightSyncReactor::Task task;
+            {
+                std::lock_guard<std::mutex> lock(g_queueMutex);
+                while (!g_timerQueue.empty() && g_timerTasks.count(g_timerQueue.top().id) == 0)
+                {
+                    g_timerQueue.pop(); // Cancelled
+                }
+                if (g_timerQueue.empty())
+                    return g_tasks.empty() ? -1 : 0;
+
+                const PendingTimer next = g_timerQueue.top();
+                const auto now = Clock::now();
+                if (next.deadline > now)
+                {
+                    const auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(next.deadline - now) +
+                        std::chrono::milliseconds(1);
+                    return g_tasks.empty() ? static_cast<int>(wait.count()) : 0;
+                }
+
+                g_timerQueue.pop();
+                auto found = g_timerTasks.find(next.id);
+                task = std::move(found->second);
+                g_timerTasks.erase(found);
+            }
+
+            try
+            {
+                task();
+            }
+            catch (...)
+            {
+                // A failing timer must never take down the network thread
+            }
+        }
+    }
+
+    void Run(const LightSyncReactor::Task& threadStarted)
+    {
+        g_networkThread.store(std::this_thread::get_id());
+        if (threadStarted)
+        {
+            threadStarted();
+        }
+
+        for (;;)
+        {
+            RunTasks();
+            CompleteDeferredFailures();
+            if (g_stopping.load() && g_handles.empty())
+                break;
+
+            const int timeoutMs = RunTimers();
+            WaitBackend(g_deferredFailures.empty() ? timeoutMs : 0);
+        }
+
+        if (g_datagramSocket != INVALID_SOCKET)
+        {
+            closesocket(g_datagramSocket);
+            g_datagramSocket = INVALID_SOCKET;
+        }
+        g_networkThread.store(std::thread::id());
+    }
+}
+
+/**
+ * @brief Starts the network thread
+ *
+ * @param threadStarted Runs on the network thread before anything else (naming it for traces)
+ * @param phaseObserver Called on the network thread when an outbound connect or write completes
+ * @return True if the thread is running
+ */
+bool LightSyncReactor::Start(Task threadStarted, PhaseObserver phaseObserver)
+{
+    std::lock_guard<std::mutex> lock(g_lifecycleMutex);
+    if (g_running.load())
+    {
+        return true;
+    }
+    if (!OpenBackend())
+    {
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> queueLock(g_queueMutex);
+        g_accepting = true;
+    }
+    g_stopping.store(false);
+    g_running.store(true);
+    g_phaseObserver = std::move(phaseObserver);
+    g_thread = std::thread(Run, std::move(threadStarted));
+    return true;
+}
+
+/**
+ * @brief Stops the network thread once every socket is closed
+ *
+ * Sends in flight report failure to their handlers, listeners stop and timers
+ * that are still pending are dropped. Tasks posted before the call still run.
+ */
+void LightSyncReactor::Stop()
+{
+    std::lock_guard<std::mutex> lock(g_lifecycleMutex);
+    if (!g_running.load())
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> queueLock(g_queueMutex);
+        g_accepting = false;
+        g_tasks.push_back(AbortAll);
+        g_stopping.store(true);
+        WakeBackend();
+    }
+
+    if (g_thread.joinable())
+    {
+        g_thread.join();
+    }
+
+    {
+        std::lock_guard<std::mutex> queueLock(g_queueMutex);
+        g_tasks.clear();
+        g_timerTasks.clear();
+        g_timerQueue = decltype(g_timerQueue)();
+    }
+    g_deferredFailures.clear();
+    CloseBackend();
+    g_running.store(false);
+}
+
+bool LightSyncReactor::IsRunning()
+{
+    return g_running.load();
+}
+
+bool LightSyncReactor::IsNetworkThread()
+{
+    return g_networkThread.load() == std::this_thread::get_id();
+}
+
+/**
+ * @brief Queues a task for the network thread
+ *
+ * @param task Work to run; it must not block
+ * @return False if the network thread is not running (the task is dropped)
+ */
+bool LightSyncReactor::Post(Task task)
+{
+    std::lock_guard<std::mutex> lock(g_queueMutex);
+    if (!g_accepting)
+    {
+        return false;
+    }
+    g_tasks.push_back(std::move(task));
+    if (g_tasks.size() == 1 && !IsNetworkThread())
+    {
+        WakeBackend();
+    }
+    return true;
+}
+
+/**
+ * @brief Schedules a task on the network thread
+ *
+ * @param delay Time from now after which the task runs
+ * @param task Work to run; it must not block
+ * @return Id for CancelTimer, or 0 if the network thread is not running
+ */
+LightSyncReactor::TimerId LightSyncReactor::AddTimer(std::chrono::milliseconds delay, Task task)
+{
+    std::lock_guard<std::mutex> lock(g_queueMutex);
+    if (!g_accepting)
+    {
+        return 0;
+    }
+
+    const TimerId id = g_nextTimer++;
+    const Clock::time_point deadline = Clock::now() + delay;
+    const bool earliest = g_timerQueue.empty() || deadline < g_timerQueue.top().deadline;
+    g_timerQueue.push(PendingTimer{ deadline, id });
+    g_timerTasks.emplace(id, std::move(task));
+
+    // The network thread recomputes its wait before it blocks again
+    if (earliest && !IsNetworkThread())
+    {
+        WakeBackend();
+    }
+    return id;
+}
+
+void LightSyncReactor::CancelTimer(TimerId timer)
+{
+    if (timer == 0)
+        return;
+    std::lock_guard<std::mutex> lock(g_queueMutex);
+    g_timerTasks.erase(timer);
+}
+
+/**
+ * @brief Queues one message to a loopback port
+ *
+ * The connection is opened, written and closed without blocking any thread;
+ * the receiver treats the close as the end of the message. Connecting and
+ * writing must finish within SEND_TIMEOUT_MS.
+ *
+ * @param port TCP port of the receiver
+ * @param segments Buffers in message order; they must stay valid until the handler ran
+ * @param handler Called on the network thread with the result (may be empty)
+ * @return False if the network thread is not running; the handler is then not called
+ */
+bool LightSyncReactor::Send(int port, std::vector<Segment> segments, SendHandler handler)
+{
+    return Post([port, segments = std::move(segments), handler = std::move(handler)]() mutable
+    {
+        StartOutbound(port, segments, handler);
+    });
+}
+
+/**
+ * @brief Sends each datagram to a loopback UDP port
+ *
+ * Every datagram goes through one non-blocking UDP socket that the network
+ * thread opens on first use and keeps until it stops, so a sample costs one
+ * sendto per datagram. Nothing waits for the socket to become writable: a
+ * datagram the socket buffer cannot take is dropped like one lost on the way,
+ * and the next sample replaces it. The batch is reported to the phase
+ * observer as "datagrams".
+ *
+ * @param port UDP port the receiver listens on
+ * @param datagrams Payloads, one datagram each
+ * @param sentBytes Receives the bytes of the datagrams that were handed to the socket
+ * @return Number of datagrams handed to the socket; 0 off the network thread
+ */
+size_t LightSyncReactor::SendDatagrams(int port, const std::vector<std::string>& datagrams, size_t& sentBytes)
+{
+    sentBytes = 0;
+    if (!IsNetworkThread() || datagrams.empty())
+    {
+        return 0;
+    }
+    if (g_datagramSocket == INVALID_SOCKET)
+    {
+        g_datagramSocket = NewDatagramSocket();
+        if (g_datagramSocket == INVALID_SOCKET)
+        {
+            return 0;
+        }
+    }
+
+    const Clock::time_point start = Clock::now();
+    const sockaddr_in address = LoopbackAddress(port);
+    size_t sent = 0;
+    for (const std::string& datagram : datagrams)
+    {
+        const auto result = sendto(g_datagramSocket, datagram.data(), static_cast<int>(datagram.size()), 0,
+            reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+        if (result >= 0 && static_cast<size_t>(result) == datagram.size())
+        {
+            ++sent;
+            sentBytes += datagram.size();
+        }
+    }
+    ReportPhase(port, "datagrams", start, Clock::now());
+    return sent;
+}
+
+/**
+ * @brief Starts serving requests on a loopback port
+ *
+ * The port is bound before the call returns, so a port in use is reported
+ * here. Each accepted connection is read until the framing says the request
+ * is complete, or until the client shuts down its sending side. Requests
+ * over maxRequestBytes, or not complete within the receive timeout, are
+ * dropped without a reply.
+ *
+ * @param port TCP port to listen on (loopback only)
+ * @param framing How the end of a request is recognized
+ * @param maxRequestBytes Largest request that is answered
+ * @param receiveTimeout Time a client has to send its whole request
+ * @param handler Called on the network thread with each request
+ * @return True if the port is listening
+ */
+bool LightSyncReactor::Listen(int port, Framing framing, size_t maxRequestBytes,
+    std::chrono::milliseconds receiveTimeout, RequestHandler handler)
+{
+    if (!IsRunning())
+    {
+        return false;
+    }
+
+    SOCKET listenSocket = NewSocket();
+    if (listenSocket == INVALID_SOCKET)
+    {
+        return false;
+    }
+
+#ifndef _WIN32
+    // Lets tests rebind a port whose last connections are still in TIME_WAIT
+    int reuse = 1;
+    setsockopt(listenSocket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+#endif
+
+    const sockaddr_in address = LoopbackAddress(port);
+    if (bind(listenSocket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(listenSocket, SOMAXCONN) != 0)
+    {
+        closesocket(listenSocket);
+        return false;
+    }
+
+    std::shared_ptr<Service> service = std::make_shared<Service>();
+    service->port = port;
+    service->framing = framing;
+    service->maxRequestBytes = maxRequestBytes;
+    service->receiveTimeout = receiveTimeout;
+    service->handler = std::move(handler);
+
+    const bool posted = Post([listenSocket, service]()
+    {
+        CloseListenerNow(service->port);
+        std::unique_ptr<Listener> created(new Listener(g_nextHandle++, listenSocket, service));
+        Listener& listener = static_cast<Listener&>(AddHandle(std::move(created)));
+        if (g_stopping.load() || !Associate(listener))
+        {
+            Close(listener, false);
+            return;
+        }
+        g_listeners[service->port] = listener.id;
+        StartAccept(listener);
+    });
+    if (!posted)
+    {
+        closesocket(listenSocket);
+    }
+    return posted;
+}
+
+/**
+ * @brief Stops accepting connections on a port
+ *
+ * Returns once the listener is closed, so the port can be bound again.
+ *
+ * @param port Port passed to Listen
+ */
+void LightSyncReactor::CloseListener(int port)
+{
+    if (IsNetworkThread())
+    {
+        CloseListenerNow(port);
+        return;
+    }
+
+    std::promise<void> closed;
+    std::future<void> done = closed.get_future();
+    if (Post([port, &closed]()
+    {
+        CloseListenerNow(port);
+        closed.set_value();
+    }))
+    {
+        done.wait();
+    }
+}
@@ -0,0 +1,105 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Network thread that runs every socket of the plug-in
+ *
+ * Messages to receivers, live drag datagrams, the control channel and the
+ * metrics endpoint share one thread instead of a blocking thread per
+ * connection or listener. Sockets are non-blocking and driven by an I/O
+ * completion port on Windows, or by epoll on Linux. The reactor does not use
+ * the Rhino SDK, so Tests/LightSyncReactorTest.cpp builds it on its own;
+ * tracing is hooked in by the caller through Start's hooks. The same thread
+ * runs timers (send timeouts, backoff, trickled batches, subscription leases)
+ * and tasks posted from other threads, so state that only callbacks touch
+ * needs no lock.
+ *
+ * Every callback runs on the network thread and must not block on the network.
+ * Encoding a message there is fine; it only delays the other sockets.
+ */
+class LightSyncReactor
+{
+public:
+    typedef std::function<void()> Task;
+    typedef uint64_t TimerId;
+
+    // Piece of a message that is sent in place, without being copied into one buffer
+    struct Segment
+    {
+        const char* data;
+        size_t size;
+    };
+
+    // Called once a message was written and its connection closed (true), or it failed or timed out
+    typedef std::function<void(bool sent)> SendHandler;
+
+    // Told how long each phase of an outbound message took ("connect", "send", "datagrams"), on the network thread
+    typedef std::function<void(int port, const char* phase, std::chrono::steady_clock::time_point start,
+        std::chrono::steady_clock::time_point end)> PhaseObserver;
+
+    // Receives a complete request and returns the reply to write back (empty for none)
+    typedef std::function<std::string(const std::string& request)> RequestHandler;
+
+    // How the end of an inbound request is recognized
+    enum class Framing
+    {
+        HalfClose,  // The client shuts down its sending side (control channel)
+        HeaderEnd   // A blank line ends the HTTP request head (metrics endpoint)
+    };
+
+    // Starts the network thread (no-op if it is running); threadStarted runs first on the new thread
+    // and phaseObserver, if set, sees every outbound connect and write
+    static bool Start(Task threadStarted = Task(), PhaseObserver phaseObserver = PhaseObserver());
+
+    // Closes every socket, fails the sends in flight and joins the thread
+    static void Stop();
+
+    static bool IsRunning();
+    static bool IsNetworkThread();
+
+    // Runs the task on the network thread; false (and the task is dropped) once stopped
+    static bool Post(Task task);
+
+    // Runs the task on the network thread after the delay; 0 once stopped
+    static TimerId AddTimer(std::chrono::milliseconds delay, Task task);
+
+    // Drops a timer that has not run yet (any thread)
+    static void CancelTimer(TimerId timer);
+
+    // Connects to the loopback port, writes the segments and closes the connection. The
+    // segments' data must stay valid until the handler ran; false if nothing was queued.
+    static bool Send(int port, std::vector<Segment> segments, SendHandler handler);
+
+    // Network thread only: sends each datagram to the loopback UDP port over the reactor's one UDP
+    // socket; returns how many were handed to the socket (the rest were dropped) and their bytes
+    static size_t SendDatagrams(int port, const std::vector<std::string>& datagrams, size_t& sentBytes);
+
+    // Serves loopback connections on the port: each request is handed to the handler
+    // and its reply written before the connection is closed
+    static bool Listen(int port, Framing framing, size_t maxRequestBytes,
+        std::chrono::milliseconds receiveTimeout, RequestHandler handler);
+
+    // Stops accepting on the port; connections already accepted are still answered
+    static void CloseListener(int port);
+
+    // Constants
+    static constexpr int SEND_TIMEOUT_MS = 5000;  // Connect and write of one message or reply
+};
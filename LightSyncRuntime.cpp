@@ -0,0 +1,166 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+
+#include "stdafx.h"
+#include "LightSyncRuntime.h"
+#include "LightAgentLink.h"
+#include "LightSnapshotExporter.h"
+#include "LightSyncControlServer.h"
+#include "LightSyncReactor.h"
+#include "LightSyncSubscriptions.h"
+#include "LightSyncTrace.h"
+#include "LightUtils.h"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+namespace {
+    std::mutex g_runtimeMutex;
+    std::atomic<bool> g_started(false);
+    std::chrono::steady_clock::time_point g_loaded;
+    double g_loadMs = 0.0;
+    double g_startMs = 0.0;
+    double g_secondsBeforeStart = 0.0;
+    const wchar_t* g_trigger = L"";
+
+    double MillisecondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+/**
+ * @brief Starts the network thread, the control port and the backup file writer once
+ *
+ * Called on the UI thread before anything is sent. A part that fails to start
+ * is reported once and not retried; light events keep being tracked without it.
+ *
+ * @param trigger What needed the runtime, kept for the statistics (string literal)
+ */
+void LightSyncRuntime::EnsureStarted(const wchar_t* trigger)
+{
+    if (g_started.load(std::memory_order_acquire))
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(g_runtimeMutex);
+    if (g_started.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    // Every socket (receivers, control port, metrics) runs on the network thread, a track of its own in
+    // traces; each receiver port gets a "Sender :<port>" track with the connect and send time of its messages
+    // and the time of its datagram batches
+    const bool networkStarted = LightSyncReactor::Start([] { LightSyncTrace::NameThread("Network"); },
+        [](int port, const char* phase, std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end)
+        {
+            if (LightSyncTrace::IsRunning())
+            {
+                LightSyncTrace::AddSpan("Sender :" + std::to_string(port), phase, begin, end);
+            }
+        });
+    if (!networkStarted)
+    {
+        RhinoApp().Print(L"LightSync: network thread could not be started, nothing will be sent.\n");
+    }
+    // Receivers register (region) subscriptions on the control port
+    if (!LightSyncControlServer::Start(LightSyncControlServer::DEFAULT_CONTROL_PORT,
+        LightSyncSubscriptions::HandleControlMessage))
+    {
+        RhinoApp().Print(L"LightSync: control port %d unavailable, subscriptions disabled.\n",
+            LightSyncControlServer::DEFAULT_CONTROL_PORT);
+    }
+    // The backup file follows published snapshots on its own thread; the agent writes it instead
+    if (!LightAgentLink::IsActive())
+    {
+        LightSnapshotExporter::Start(LightUtils::DEFAULT_EXPORT_PATH);
+    }
+
+    g_startMs = MillisecondsSince(start);
+    g_secondsBeforeStart = std::chrono::duration<double>(start - g_loaded).count();
+    g_trigger = trigger;
+    g_started.store(true, std::memory_order_release);
+}
+
+bool LightSyncRuntime::IsStarted()
+{
+    return g_started.load(std::memory_order_acquire);
+}
+
+/**
+ * @brief Checks whether a document has a light worth syncing without reading any
+ *
+ * @param doc Document to check
+ * @return True if the light table holds a light that is not deleted
+ */
+bool LightSyncRuntime::HasLights(CRhinoDoc& doc)
+{
+    const CRhinoLightTable& table = doc.m_light_table;
+    const int lightCount = table.LightCount();
+    for (int i = 0; i < lightCount; ++i)
+    {
+        if (!table[i].IsDeleted())
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Records how long OnLoadPlugIn took, i.e. the plug-in's cost to Rhino's startup
+ *
+ * @param milliseconds Measured load time
+ */
+void LightSyncRuntime::RecordLoad(double milliseconds)
+{
+    std::lock_guard<std::mutex> lock(g_runtimeMutex);
+    g_loaded = std::chrono::steady_clock::now();
+    g_loadMs = milliseconds;
+}
+
+double LightSyncRuntime::LoadMilliseconds()
+{
+    std::lock_guard<std::mutex> lock(g_runtimeMutex);
+    return g_loadMs;
+}
+
+/**
+ * @return Time EnsureStarted spent starting the runtime (0 until it is started)
+ */
+double LightSyncRuntime::StartMilliseconds()
+{
+    std::lock_guard<std::mutex> lock(g_runtimeMutex);
+    return g_startMs;
+}
+
+/**
+ * @return Seconds between loading the plug-in and starting the runtime (0 until it is started)
+ */
+double LightSyncRuntime::SecondsBeforeStart()
+{
+    std::lock_guard<std::mutex> lock(g_runtimeMutex);
+    return g_secondsBeforeStart;
+}
+
+/**
+ * @return What started the runtime (empty until it is started)
+ */
+const wchar_t* LightSyncRuntime::Trigger()
+{
+    std::lock_guard<std::mutex> lock(g_runtimeMutex);
+    return g_trigger;
+}
@@ -0,0 +1,39 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+
+#pragma once
+
+#include "stdafx.h"
+
+/**
+ * @brief Deferred start-up of everything the plug-in needs to sync lights
+ *
+ * Rhino loads the plug-in at startup so the light watcher sees every event,
+ * but most sessions never sync a light. Loading therefore only registers the
+ * watcher; the network thread, the control port and the backup file writer are
+ * started by the first light event, the first lit document or a sync command.
+ * Both costs are measured and reported by the LightSyncStats command.
+ */
+class LightSyncRuntime
+{
+public:
+    static void EnsureStarted(const wchar_t* trigger);
+    static bool IsStarted();
+    static bool HasLights(CRhinoDoc& doc);
+
+    static void RecordLoad(double milliseconds);
+    static double LoadMilliseconds();
+    static double StartMilliseconds();
+    static double SecondsBeforeStart();
+    static const wchar_t* Trigger();
+};
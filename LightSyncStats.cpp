@@ -0,0 +1,98 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+#include "stdafx.h"
+#include "LightSyncStats.h"
+#include "LightAgentLink.h"
+#include "LightDocumentPipeline.h"
+#include "LightSnapshotStore.h"
+#include "LightSyncRuntime.h"
+#include "LightTombstoneStore.h"
+
+LightSyncStats::Counters& LightSyncStats::Get()
+{
+    static Counters counters;
+    return counters;
+}
+
+void LightSyncStats::Increment(std::atomic<uint64_t>& counter, uint64_t amount)
+{
+    counter.fetch_add(amount, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Prints all counters to the Rhino command line (UI thread only)
+ */
+void LightSyncStats::Print()
+{
+    const Counters& counters = Get();
+
+    RhinoApp().Print(L"=== LightSync Statistics ===\n");
+    RhinoApp().Print(L"  Plug-in load:        %.3f ms\n", LightSyncRuntime::LoadMilliseconds());
+    if (LightSyncRuntime::IsStarted())
+    {
+        RhinoApp().Print(L"  Runtime start:       %.3f ms, %.1f s after load (%s)\n", LightSyncRuntime::StartMilliseconds(),
+            LightSyncRuntime::SecondsBeforeStart(), LightSyncRuntime::Trigger());
+    }
+    else
+    {
+        RhinoApp().Print(L"  Runtime start:       not started (no light event or sync command yet)\n");
+    }
+    RhinoApp().Print(L"  Light events:        %llu\n", counters.lightEvents.load(std::memory_order_relaxed));
+    RhinoApp().Print(L"  Suppressed (no-op):  %llu\n", counters.suppressedEvents.load(std::memory_order_relaxed));
+    RhinoApp().Print(L"  Scene updates:       %llu\n", counters.sceneUpdates.load(std::memory_order_relaxed));
+    RhinoApp().Print(L"  Field updates:       %llu\n", counters.fieldUpdates.load(std::memory_order_relaxed));
+    RhinoApp().Print(L"  Messages sent:       %llu\n", counters.messagesSent.load(std::memory_order_relaxed));
+    RhinoApp().Print(L"  Bytes sent:          %llu\n", counters.bytesSent.load(std::memory_order_relaxed));
+    RhinoApp().Print(L"  Send failures:       %llu\n", counters.sendFailures.load(std::memory_order_relaxed));
+    RhinoApp().Print(L"  Send backoffs:       %llu (%llu backlog drop(s))\n", counters.sendBackoffs.load(std::memory_order_relaxed),
+        counters.backlogDrops.load(std::memory_order_relaxed));
+    RhinoApp().Print(L"  Datagrams sent:      %llu (%llu failed)\n", counters.datagramsSent.load(std::memory_order_relaxed),
+        counters.datagramFailures.load(std::memory_order_relaxed));
+    RhinoApp().Print(L"  Buffer pool misses:  %llu\n", counters.bufferPoolMisses.load(std::memory_order_relaxed));
+    RhinoApp().Print(L"  File exports:        %llu\n", counters.fileExports.load(std::memory_order_relaxed));
+    RhinoApp().Print(L"  Export failures:     %llu\n", counters.exportFailures.load(std::memory_order_relaxed));
+    RhinoApp().Print(L"  Journal records:     %llu\n", counters.journalRecords.load(std::memory_order_relaxed));
+    RhinoApp().Print(L"  Coalesced sends:     %llu\n", counters.coalescedDeliveries.load(std::memory_order_relaxed));
+    RhinoApp().Print(L"  Document pipelines:  %d\n", static_cast<int>(LightDocumentPipeline::Count()));
+    RhinoApp().Print(L"  Resumes:             %llu keyframe(s), %llu delta replay(s), %llu already current\n",
+        counters.resumeKeyframes.load(std::memory_order_relaxed), counters.resumeDeltas.load(std::memory_order_relaxed),
+        counters.resumeCurrent.load(std::memory_order_relaxed));
+    RhinoApp().Print(L"  Queries answered:    %llu\n", counters.queries.load(std::memory_order_relaxed));
+    RhinoApp().Print(L"  Leases expired:      %llu\n", counters.leasesExpired.load(std::memory_order_relaxed));
+
+    // The snapshot is shared with the senders, so reading it here costs no copy
+    LightSnapshot::Ptr snapshot = LightSnapshotStore::Latest();
+    if (snapshot)
+    {
+        RhinoApp().Print(L"  Snapshot version:    %llu (%d light(s))\n",
+            static_cast<unsigned long long>(snapshot->Version()), static_cast<int>(snapshot->Count()));
+    }
+    RhinoApp().Print(L"  Tombstones:          %d in %d document(s), ~%d bytes (%llu compacted)\n",
+        static_cast<int>(LightTombstoneStore::Count()), static_cast<int>(LightTombstoneStore::DocumentCount()),
+        static_cast<int>(LightTombstoneStore::MemoryBytes()),
+        counters.tombstonesCompacted.load(std::memory_order_relaxed));
+
+    // The agent keeps its own counters in the shared ring header
+    LightAgentLink::AgentStats agent;
+    if (LightAgentLink::GetAgentStats(agent))
+    {
+        RhinoApp().Print(L"  Agent records:       %llu pushed, %llu read, %llu dropped\n",
+            counters.agentRecords.load(std::memory_order_relaxed), agent.recordsRead,
+            counters.agentRecordsDropped.load(std::memory_order_relaxed));
+        RhinoApp().Print(L"  Agent ring:          %d / %d KB in use\n",
+            static_cast<int>(agent.usedBytes / 1024), static_cast<int>(agent.capacityBytes / 1024));
+        RhinoApp().Print(L"  Agent sends:         %llu message(s), %llu byte(s), %llu failure(s), %llu export(s)\n",
+            agent.messagesSent, agent.bytesSent, agent.sendFailures, agent.fileExports);
+    }
+    RhinoApp().Print(L"=== End of Statistics ===\n");
+}
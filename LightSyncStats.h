@@ -0,0 +1,66 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+#pragma once
+
+#include "stdafx.h"
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief Process-wide counters for the sync pipeline
+ *
+ * Counters are plain relaxed atomics so they can be bumped from the UI thread
+ * and the network thread without locking. The LightSyncStats command prints them.
+ */
+class LightSyncStats
+{
+public:
+    struct Counters
+    {
+        std::atomic<uint64_t> lightEvents;        // Light table events received
+        std::atomic<uint64_t> suppressedEvents;   // Events that changed nothing transmitted
+        std::atomic<uint64_t> sceneUpdates;       // Events that resolved and sent a scene
+        std::atomic<uint64_t> fieldUpdates;       // Events sent as the changed fields of one light
+        std::atomic<uint64_t> messagesSent;       // Payloads fully written to a receiver
+        std::atomic<uint64_t> bytesSent;
+        std::atomic<uint64_t> sendFailures;       // Connect or send failures
+        std::atomic<uint64_t> sendBackoffs;       // Pauses of a receiver's channel after a failed send
+        std::atomic<uint64_t> backlogDrops;       // Deliveries dropped for a failing receiver's backlog cap
+        std::atomic<uint64_t> bufferPoolMisses;   // Buffers allocated because their pool was empty
+        std::atomic<uint64_t> fileExports;        // Snapshot versions written to the backup file
+        std::atomic<uint64_t> exportFailures;
+        std::atomic<uint64_t> journalRecords;     // Events appended to the replay journal
+        std::atomic<uint64_t> tombstonesCompacted; // Deleted-light tombstones dropped (undo purge, close, limit)
+        std::atomic<uint64_t> coalescedDeliveries; // Queued deliveries superseded by a newer scene
+        std::atomic<uint64_t> agentRecords;       // Change records handed to the sync agent
+        std::atomic<uint64_t> agentRecordsDropped; // Records the agent ring had no room for
+        std::atomic<uint64_t> datagramsSent;      // Live drag samples sent over UDP
+        std::atomic<uint64_t> datagramFailures;
+        std::atomic<uint64_t> resumeKeyframes;    // Resuming receivers sent the cached keyframe
+        std::atomic<uint64_t> resumeDeltas;       // Resuming receivers sent only the deltas they missed
+        std::atomic<uint64_t> resumeCurrent;      // Resuming receivers that were already up to date
+        std::atomic<uint64_t> queries;            // Light queries answered on the control channel
+        std::atomic<uint64_t> leasesExpired;      // Receivers unsubscribed because their lease ran out
+
+        Counters() : lightEvents(0), suppressedEvents(0), sceneUpdates(0), fieldUpdates(0),
+            messagesSent(0), bytesSent(0), sendFailures(0), sendBackoffs(0), backlogDrops(0), bufferPoolMisses(0),
+            fileExports(0), exportFailures(0), journalRecords(0), tombstonesCompacted(0),
+            coalescedDeliveries(0), agentRecords(0), agentRecordsDropped(0), datagramsSent(0),
+            datagramFailures(0), resumeKeyframes(0), resumeDeltas(0), resumeCurrent(0),
+            queries(0), leasesExpired(0) {}
+    };
+
+    static Counters& Get();
+    static void Increment(std::atomic<uint64_t>& counter, uint64_t amount = 1);
+    static void Print();
+};
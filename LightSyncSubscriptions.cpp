@@ -0,0 +1,822 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+#include "stdafx.h"
+#include "LightSyncSubscriptions.h"
+#include "LightDocumentPipeline.h"
+#include "LightQuantizedEncoder.h"
+#include "LightSyncJson.h"
+#include "LightSyncBuffers.h"
+#include "LightSyncNetwork.h"
+#include "LightSyncReactor.h"
+#include "LightSyncStats.h"
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+
+namespace {
+    // Reads {"x":..,"y":..,"z":..} in the same layout the plugin sends locations
+    bool ReadPoint(const LightSyncJson::Value* value, ON_3dPoint& point)
+    {
+        if (!value || value->type != LightSyncJson::Type::Object)
+            return false;
+        point.x = value->GetNumber("x", 0.0);
+        point.y = value->GetNumber("y", 0.0);
+        point.z = value->GetNumber("z", 0.0);
+        return true;
+    }
+
+    bool ReadVector(const LightSyncJson::Value* value, ON_3dVector& vector)
+    {
+        ON_3dPoint point;
+        if (!ReadPoint(value, point))
+            return false;
+        vector = ON_3dVector(point.x, point.y, point.z);
+        return vector.Unitize();
+    }
+
+    // Ports, serials, versions and counts in control messages must be whole and not negative
+    bool IsWholeNumber(double value)
+    {
+        return value >= 0.0 && value == std::floor(value);
+    }
+
+    // Converts a whole number, saturating at what the target integer holds
+    uint64_t ClampWholeNumber(double value, uint64_t max)
+    {
+        return value >= static_cast<double>(max) ? max : static_cast<uint64_t>(value);
+    }
+
+    std::string ReplyOk()
+    {
+        return "{\"status\": \"ok\"}";
+    }
+
+    std::string ReplyError(const char* message)
+    {
+        return std::string("{\"status\": \"error\", \"message\": \"") + message + "\"}";
+    }
+
+    // Appends text as a quoted JSON string (document names are user supplied)
+    void AppendQuoted(std::string& out, const std::wstring& text)
+    {
+        std::string utf8;
+        LightSyncNetwork::AppendUTF8(utf8, text.c_str(), text.size());
+
+        out += '"';
+        for (char c : utf8)
+        {
+            if (c == '"' || c == '\\')
+            {
+                out += '\\';
+                out += c;
+            }
+            else if (static_cast<unsigned char>(c) < 0x20)
+            {
+                out += ' ';
+            }
+            else
+            {
+                out += c;
+            }
+        }
+        out += '"';
+    }
+}
+
+// Static member initialization - the default Unreal listener streams the whole scene
+std::mutex LightSyncSubscriptions::m_mutex;
+std::map<int, LightSyncSubscriptions::Subscriber> LightSyncSubscriptions::m_subscribers = {
+    { LightSyncNetwork::DEFAULT_TCP_PORT, LightSyncSubscriptions::Subscriber() }
+};
+std::map<unsigned int, LightSyncSubscriptions::Document> LightSyncSubscriptions::m_documents;
+bool LightSyncSubscriptions::m_leaseSweepScheduled = false;
+
+/**
+ * @brief Handles one request received on the control channel
+ *
+ * Supported requests:
+ *   {"type": "subscribe", "port": 5173, "document": 2, "regions": [{"min": {"x":..,"y":..,"z":..}, "max": {...}}],
+ *    "encoding": "quantized", "precision": 0.001, "lease": 10}
+ *   {"type": "heartbeat", "port": 5173}
+ *   {"type": "unsubscribe", "port": 5173}
+ *   {"type": "camera", "port": 5173, "position": {...}, "forward": {...}, "fov": 90}
+ *   {"type": "documents"}
+ *   {"type": "resume", "port": 5173, "document": 2, "version": 1234}
+ *   {"type": "query", "document": 2, "ids": ["..."], "types": ["Spot"], "region": {"min": {...}, "max": {...}},
+ *    "changedSince": 1200, "version": 1234, "offset": 0, "limit": 256}
+ * A subscribe without regions streams the whole scene to that port. Without a
+ * document it keeps its current one, or binds to the next document that sends
+ * a scene. "encoding" is "json" (the default) or "quantized", whose positions
+ * are rounded to "precision" meters (see LightQuantizedFormat). With a "lease"
+ * in seconds the subscription ends unless a heartbeat (or another subscribe)
+ * renews it within that time; a heartbeat replies with the receiver's document
+ * and current sequence. A camera
+ * report makes later messages to that port prioritized by view contribution. The documents request lists the open documents' ids. A
+ * resume sends the receiver what it missed since the version it last applied
+ * from the document (the whole scene without one). A query needs no port; it
+ * returns a page of the document's lights that pass every filter given (see
+ * LightSyncQuery::Run), and "limit": 0 returns only the counts. Ports,
+ * documents, versions, offsets and limits must be whole numbers; larger
+ * versions and offsets saturate and the limit is capped at
+ * LightSyncQuery::MAX_PAGE_SIZE.
+ *
+ * @param request UTF-8 JSON request
+ * @return UTF-8 JSON reply with a status field
+ */
+std::string LightSyncSubscriptions::HandleControlMessage(const std::string& request)
+{
+    LightSyncJson::Value message;
+    if (!LightSyncJson::Parse(request, message) || message.type != LightSyncJson::Type::Object)
+    {
+        return ReplyError("malformed request");
+    }
+
+    const std::string type = message.GetString("type", "");
+    if (type == "documents")
+    {
+        return ListDocuments();
+    }
+
+    if (type == "query")
+    {
+        LightSyncQuery::Filter filter;
+        const LightSyncJson::Value* ids = message.Find("ids");
+        if (ids && ids->type == LightSyncJson::Type::Array)
+        {
+            for (const auto& id : ids->items)
+            {
+                const ON_UUID lightId = id.type == LightSyncJson::Type::String ? ON_UuidFromString(id.string.c_str()) : ON_nil_uuid;
+                if (ON_UuidIsNil(lightId))
+                {
+                    return ReplyError("ids must be light uuids");
+                }
+                filter.ids.push_back(lightId);
+            }
+        }
+
+        const LightSyncJson::Value* types = message.Find("types");
+        if (types && types->type == LightSyncJson::Type::Array)
+        {
+            for (const auto& name : types->items)
+            {
+                LightUtils::LightType lightType;
+                if (name.type != LightSyncJson::Type::String || !LightSyncQuery::ParseLightType(name.string, lightType))
+                {
+                    return ReplyError("unknown light type");
+                }
+                filter.typeMask |= 1u << static_cast<unsigned int>(lightType);
+            }
+        }
+
+        const LightSyncJson::Value* region = message.Find("region");
+        if (region)
+        {
+            if (!ReadPoint(region->Find("min"), filter.region.min) || !ReadPoint(region->Find("max"), filter.region.max))
+            {
+                return ReplyError("region needs min and max points");
+            }
+            filter.hasRegion = true;
+        }
+
+        const double document = message.GetNumber("document", 0.0);
+        const double changedSince = message.GetNumber("changedSince", 0.0);
+        const double version = message.GetNumber("version", 0.0);
+        const double offset = message.GetNumber("offset", 0.0);
+        const double limit = message.GetNumber("limit", static_cast<double>(LightSyncQuery::DEFAULT_PAGE_SIZE));
+        if (!IsWholeNumber(document) || document > 4294967295.0 || !IsWholeNumber(changedSince) || !IsWholeNumber(version) ||
+            !IsWholeNumber(offset) || !IsWholeNumber(limit))
+        {
+            return ReplyError("invalid document, changedSince, version, offset or limit");
+        }
+        filter.changedSince = ClampWholeNumber(changedSince, std::numeric_limits<uint64_t>::max());
+        filter.version = ClampWholeNumber(version, std::numeric_limits<uint64_t>::max());
+        filter.offset = static_cast<size_t>(ClampWholeNumber(offset, std::numeric_limits<size_t>::max()));
+        filter.limit = static_cast<size_t>(ClampWholeNumber(limit, LightSyncQuery::MAX_PAGE_SIZE));
+        return Query(static_cast<unsigned int>(document), filter);
+    }
+
+    const double port = message.GetNumber("port", 0.0);
+    if (!IsWholeNumber(port) || port < 1.0 || port > 65535.0)
+    {
+        return ReplyError("missing or invalid port");
+    }
+
+    if (type == "subscribe")
+    {
+        std::vector<LightSpatialIndex::Box> regions;
+        const LightSyncJson::Value* regionList = message.Find("regions");
+        if (regionList && regionList->type == LightSyncJson::Type::Array)
+        {
+            for (const auto& region : regionList->items)
+            {
+                LightSpatialIndex::Box box;
+                if (!ReadPoint(region.Find("min"), box.min) || !ReadPoint(region.Find("max"), box.max))
+                {
+                    return ReplyError("region needs min and max points");
+                }
+                regions.push_back(box);
+            }
+        }
+
+        const double document = message.GetNumber("document", 0.0);
+        if (!IsWholeNumber(document) || document > 4294967295.0)
+        {
+            return ReplyError("invalid document");
+        }
+
+        const std::string encoding = message.GetString("encoding", "json");
+        if (encoding != "json" && encoding != "quantized")
+        {
+            return ReplyError("unknown encoding");
+        }
+        const double precision = message.GetNumber("precision", LightQuantizedFormat::DEFAULT_POSITION_STEP);
+        if (!(precision >= LightQuantizedFormat::MIN_POSITION_STEP && precision <= LightQuantizedFormat::MAX_POSITION_STEP))
+        {
+            return ReplyError("precision must be between 0.000001 and 1 meter");
+        }
+        const double lease = message.GetNumber("lease", 0.0);
+        if (!(lease >= 0.0 && lease <= MAX_LEASE_SECONDS))
+        {
+            return ReplyError("lease must be between 0 and 3600 seconds");
+        }
+        return Subscribe(static_cast<int>(port), static_cast<unsigned int>(document), std::move(regions),
+            encoding == "quantized", precision, lease);
+    }
+
+    if (type == "heartbeat")
+    {
+        return Heartbeat(static_cast<int>(port));
+    }
+
+    if (type == "unsubscribe")
+    {
+        return Unsubscribe(static_cast<int>(port));
+    }
+
+    if (type == "resume")
+    {
+        const double document = message.GetNumber("document", 0.0);
+        const double version = message.GetNumber("version", -1.0);
+        if (!IsWholeNumber(document) || document > 4294967295.0)
+        {
+            return ReplyError("invalid document");
+        }
+        if (version != std::floor(version))
+        {
+            return ReplyError("invalid version");
+        }
+        return Resume(static_cast<int>(port), static_cast<unsigned int>(document), version < 0.0 ? -1 :
+            static_cast<int64_t>(ClampWholeNumber(version, static_cast<uint64_t>(std::numeric_limits<int64_t>::max()))));
+    }
+
+    if (type == "camera")
+    {
+        LightPrioritizer::Camera camera;
+        if (!ReadPoint(message.Find("position"), camera.position) || !ReadVector(message.Find("forward"), camera.forward))
+        {
+            return ReplyError("camera needs position and a non-zero forward vector");
+        }
+        camera.fovDegrees = message.GetNumber("fov", camera.fovDegrees);
+        camera.valid = true;
+        return UpdateCamera(static_cast<int>(port), camera);
+    }
+
+    return ReplyError("unknown request type");
+}
+
+void LightSyncSubscriptions::AddDocument(unsigned int docSerial, const std::wstring& name)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_documents[docSerial].name = name;
+}
+
+/**
+ * @brief Forgets a closing document
+ *
+ * Its spatial index is dropped and its receivers are released; they bind to the
+ * next document that sends a scene, starting their region membership over.
+ *
+ * @param docSerial Runtime serial number of the closing document
+ */
+void LightSyncSubscriptions::RemoveDocument(unsigned int docSerial)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_documents.erase(docSerial);
+    for (auto& entry : m_subscribers)
+    {
+        Subscriber& subscriber = entry.second;
+        if (subscriber.document == docSerial)
+        {
+            subscriber.document = 0;
+            subscriber.lightsInRegions.clear();
+        }
+    }
+}
+
+/**
+ * @brief Keeps a document's spatial index in step with its active lights
+ *
+ * Only the light named by the event is re-bucketed. The index is rebuilt on
+ * first use, when the unit scale changes, or when the event names no light.
+ *
+ * @param docSerial Document the lights belong to
+ * @param activeLights Active lights with positions in meters
+ * @param changedLightId Light affected by the event (nil if unknown)
+ * @param unitScale Model unit scale the positions were converted with
+ */
+void LightSyncSubscriptions::UpdateSpatialIndex(unsigned int docSerial,
+    const std::vector<LightUtils::LightInfo>& activeLights, const ON_UUID& changedLightId, double unitScale)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Document& document = m_documents[docSerial];
+
+    if (!document.indexBuilt || unitScale != document.indexUnitScale || ON_UuidIsNil(changedLightId))
+    {
+        document.spatialIndex.Rebuild(activeLights);
+        document.indexBuilt = true;
+        document.indexUnitScale = unitScale;
+        return;
+    }
+
+    for (const auto& light : activeLights)
+    {
+        if (light.id == changedLightId)
+        {
+            document.spatialIndex.Update(light.id, light.location);
+            return;
+        }
+    }
+
+    // Deleted, switched off or tombstoned lights drop out of the index
+    document.spatialIndex.Remove(changedLightId);
+}
+
+void LightSyncSubscriptions::UpdateSpatialIndexEntry(unsigned int docSerial, const LightUtils::LightInfo& light,
+    double unitScale)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // A single light cannot seed the index; the next full event rebuilds it
+    auto document = m_documents.find(docSerial);
+    if (document != m_documents.end() && document->second.indexBuilt &&
+        unitScale == document->second.indexUnitScale)
+    {
+        document->second.spatialIndex.Update(light.id, light.location);
+    }
+}
+
+void LightSyncSubscriptions::RemoveSpatialIndexEntry(unsigned int docSerial, const ON_UUID& lightId)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto document = m_documents.find(docSerial);
+    if (document != m_documents.end() && document->second.indexBuilt)
+    {
+        document->second.spatialIndex.Remove(lightId);
+    }
+}
+
+bool LightSyncSubscriptions::HasRegionScopedSubscribers(unsigned int docSerial)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    for (const auto& entry : m_subscribers)
+    {
+        if (entry.second.document == docSerial && !entry.second.regions.empty())
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Works out what each receiver of a document should be sent
+ *
+ * Receivers not bound to a document yet are bound to this one first.
+ * Whole-scene receivers get every active light. Region-scoped receivers get the
+ * lights the spatial index finds inside their regions, and the enter/leave
+ * lists are computed against what that receiver was sent last time. Region
+ * light lists come from LightSyncBuffers; the sender returns them when done.
+ *
+ * @param docSerial Document the lights belong to
+ * @param activeLights Active lights with positions in meters
+ * @param snapshot Snapshot of the same lights, shared by whole-scene deliveries
+ * @param deliveries Receives one delivery per receiver bound to the document (a pooled list)
+ */
+void LightSyncSubscriptions::ResolveDeliveries(unsigned int docSerial, const std::vector<LightUtils::LightInfo>& activeLights,
+    const LightSnapshot::Ptr& snapshot, std::vector<Delivery>& deliveries)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const LightSpatialIndex& spatialIndex = m_documents[docSerial].spatialIndex;
+
+    deliveries.reserve(deliveries.size() + m_subscribers.size());
+
+    // Built only when a region-scoped receiver needs to look lights up by id
+    std::unordered_map<ON_UUID, const LightUtils::LightInfo*, LightUtils::UuidHash> lightsById;
+
+    for (auto& entry : m_subscribers)
+    {
+        Subscriber& subscriber = entry.second;
+        if (subscriber.document == 0)
+        {
+            subscriber.document = docSerial;
+        }
+        if (subscriber.document != docSerial)
+        {
+            continue;
+        }
+
+        Delivery delivery;
+        delivery.port = entry.first;
+        delivery.document = docSerial;
+        delivery.sequence = ++subscriber.sequence;
+        delivery.version = snapshot ? snapshot->Version() : 0;
+        delivery.camera = subscriber.camera;
+        delivery.quantized = subscriber.quantized;
+        delivery.positionStep = subscriber.positionStep;
+
+        if (subscriber.regions.empty())
+        {
+            delivery.snapshot = snapshot;
+            deliveries.push_back(std::move(delivery));
+            continue;
+        }
+
+        delivery.lights = LightSyncBuffers::Lights().Acquire();
+
+        if (lightsById.empty() && !activeLights.empty())
+        {
+            lightsById.reserve(activeLights.size());
+            for (const auto& light : activeLights)
+            {
+                lightsById[light.id] = &light;
+            }
+        }
+
+        delivery.regionScoped = true;
+
+        std::vector<ON_UUID> candidates;
+        for (const auto& region : subscriber.regions)
+        {
+            spatialIndex.Query(region, candidates);
+        }
+
+        std::unordered_set<ON_UUID, LightUtils::UuidHash> inRegions;
+        inRegions.reserve(candidates.size());
+        for (const ON_UUID& lightId : candidates)
+        {
+            auto light = lightsById.find(lightId);
+            if (light == lightsById.end() || !inRegions.insert(lightId).second)
+                continue; // Stale index entry or overlapping regions
+
+            delivery.lights.push_back(*light->second);
+            if (subscriber.lightsInRegions.find(lightId) == subscriber.lightsInRegions.end())
+            {
+                delivery.entered.push_back(lightId);
+            }
+        }
+
+        for (const ON_UUID& lightId : subscriber.lightsInRegions)
+        {
+            if (inRegions.find(lightId) == inRegions.end())
+            {
+                delivery.left.push_back(lightId);
+            }
+        }
+
+        subscriber.lightsInRegions.swap(inRegions);
+        deliveries.push_back(std::move(delivery));
+    }
+}
+
+/**
+ * @brief Works out which receivers should get a partial update for a few lights
+ *
+ * Used for commits of individually streamed lights and for field updates.
+ * Region membership is left untouched; it is refreshed by the next full event
+ * for that receiver.
+ *
+ * @param docSerial Document the lights belong to
+ * @param lights Updated lights with positions in meters
+ * @param version Snapshot version the update produced
+ * @param deliveries Receives one partial delivery per receiver of the document that streams at least
+ *        one of the lights (a pooled list)
+ */
+void LightSyncSubscriptions::ResolvePartialDeliveries(unsigned int docSerial,
+    const std::vector<LightUtils::LightInfo>& lights, uint64_t version, std::vector<Delivery>& deliveries)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    for (const auto& entry : m_subscribers)
+    {
+        const Subscriber& subscriber = entry.second;
+        if (subscriber.document != docSerial)
+        {
+            continue;
+        }
+
+        Delivery delivery;
+        delivery.port = entry.first;
+        delivery.document = docSerial;
+        delivery.sequence = subscriber.sequence; // Must not supersede a trickle in progress
+        delivery.version = version;
+        delivery.regionScoped = !subscriber.regions.empty();
+        delivery.partial = true;
+        delivery.quantized = subscriber.quantized;
+        delivery.positionStep = subscriber.positionStep;
+        delivery.lights = LightSyncBuffers::Lights().Acquire();
+
+        for (const auto& light : lights)
+        {
+            if (!delivery.regionScoped ||
+                subscriber.lightsInRegions.find(light.id) != subscriber.lightsInRegions.end())
+            {
+                delivery.lights.push_back(light);
+            }
+        }
+
+        if (!delivery.lights.empty())
+        {
+            deliveries.push_back(std::move(delivery));
+        }
+        else
+        {
+            LightSyncBuffers::Lights().Release(std::move(delivery.lights));
+        }
+    }
+}
+
+std::vector<int> LightSyncSubscriptions::PortsStreamingLight(unsigned int docSerial, const ON_UUID& lightId)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::vector<int> ports;
+    for (const auto& entry : m_subscribers)
+    {
+        const Subscriber& subscriber = entry.second;
+        if (subscriber.document != docSerial)
+            continue;
+        if (subscriber.regions.empty() ||
+            subscriber.lightsInRegions.find(lightId) != subscriber.lightsInRegions.end())
+        {
+            ports.push_back(entry.first);
+        }
+    }
+    return ports;
+}
+
+bool LightSyncSubscriptions::IsCurrentSequence(int port, unsigned int sequence)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto subscriber = m_subscribers.find(port);
+    return subscriber != m_subscribers.end() && subscriber->second.sequence == sequence;
+}
+
+bool LightSyncSubscriptions::ClaimSequence(int port, unsigned int docSerial, bool newScene, Delivery& delivery)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto subscriber = m_subscribers.find(port);
+    if (subscriber == m_subscribers.end() || subscriber->second.document != docSerial)
+    {
+        return false;
+    }
+    delivery.sequence = newScene ? ++subscriber->second.sequence : subscriber->second.sequence;
+    delivery.quantized = subscriber->second.quantized;
+    delivery.positionStep = subscriber->second.positionStep;
+    return true;
+}
+
+std::string LightSyncSubscriptions::Subscribe(int port, unsigned int document,
+    std::vector<LightSpatialIndex::Box> regions, bool quantized, double positionStep, double leaseSeconds)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (document != 0 && m_documents.find(document) == m_documents.end())
+    {
+        return ReplyError("unknown document");
+    }
+
+    // Re-subscribing starts over, so the next message reports every light as entered
+    Subscriber& subscriber = m_subscribers[port];
+    if (document != 0)
+    {
+        subscriber.document = document;
+    }
+    subscriber.regions = std::move(regions);
+    subscriber.lightsInRegions.clear();
+    subscriber.quantized = quantized;
+    subscriber.positionStep = positionStep;
+    subscriber.leaseSeconds = leaseSeconds;
+    if (leaseSeconds > 0.0)
+    {
+        subscriber.leaseExpiry = std::chrono::steady_clock::now() +
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(leaseSeconds));
+        ScheduleLeaseSweep();
+    }
+    return ReplyOk();
+}
+
+/**
+ * @brief Renews a receiver's lease
+ *
+ * Receivers without a lease may send heartbeats too, to learn which document
+ * they are bound to and which sequence they should be at.
+ *
+ * @param port Receiver port
+ * @return Reply with the receiver's document and current sequence
+ */
+std::string LightSyncSubscriptions::Heartbeat(int port)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto subscriber = m_subscribers.find(port);
+    if (subscriber == m_subscribers.end())
+    {
+        return ReplyError("port is not subscribed");
+    }
+    if (subscriber->second.leaseSeconds > 0.0)
+    {
+        subscriber->second.leaseExpiry = std::chrono::steady_clock::now() +
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(subscriber->second.leaseSeconds));
+    }
+    return "{\"status\": \"ok\", \"document\": " + std::to_string(subscriber->second.document) +
+        ", \"sequence\": " + std::to_string(subscriber->second.sequence) + "}";
+}
+
+/**
+ * @brief Starts the expired-lease check unless it is already scheduled
+ *
+ * Called with m_mutex held. The check only runs while leased receivers exist.
+ */
+void LightSyncSubscriptions::ScheduleLeaseSweep()
+{
+    if (!m_leaseSweepScheduled)
+    {
+        m_leaseSweepScheduled = LightSyncReactor::AddTimer(std::chrono::milliseconds(LEASE_SWEEP_MS), SweepLeases) != 0;
+    }
+}
+
+/**
+ * @brief Unsubscribes the receivers whose lease ran out (network thread timer)
+ */
+void LightSyncSubscriptions::SweepLeases()
+{
+    std::vector<int> expired;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_leaseSweepScheduled = false;
+
+        const auto now = std::chrono::steady_clock::now();
+        bool leased = false;
+        for (auto it = m_subscribers.begin(); it != m_subscribers.end();)
+        {
+            if (it->second.leaseSeconds > 0.0 && it->second.leaseExpiry <= now)
+            {
+                expired.push_back(it->first);
+                it = m_subscribers.erase(it);
+                continue;
+            }
+            leased = leased || it->second.leaseSeconds > 0.0;
+            ++it;
+        }
+
+        if (leased)
+        {
+            ScheduleLeaseSweep();
+        }
+    }
+
+    for (int port : expired)
+    {
+        LightQuantizedEncoder::ForgetReceiver(port);
+    }
+    LightSyncStats::Increment(LightSyncStats::Get().leasesExpired, expired.size());
+}
+
+std::string LightSyncSubscriptions::Unsubscribe(int port)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_subscribers.erase(port);
+    }
+    LightQuantizedEncoder::ForgetReceiver(port);
+    return ReplyOk();
+}
+
+std::string LightSyncSubscriptions::UpdateCamera(int port, const LightPrioritizer::Camera& camera)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto subscriber = m_subscribers.find(port);
+    if (subscriber == m_subscribers.end())
+    {
+        return ReplyError("port is not subscribed");
+    }
+    subscriber->second.camera = camera;
+    return ReplyOk();
+}
+
+/**
+ * @brief Binds a (re)connecting receiver and has its document catch it up
+ *
+ * An unbound receiver is bound to the document it names, or else to the oldest
+ * open one. The reported version only counts for the document it came from.
+ * Region-scoped receivers are not resumed; their next event resends their regions.
+ *
+ * @param port Receiver port
+ * @param document Document the version belongs to, 0 if unknown
+ * @param version Last version the receiver applied, -1 if none
+ * @return Reply of the document's pipeline, or an error
+ */
+std::string LightSyncSubscriptions::Resume(int port, unsigned int document, int64_t version)
+{
+    unsigned int docSerial = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto subscriber = m_subscribers.find(port);
+        if (subscriber == m_subscribers.end())
+        {
+            return ReplyError("port is not subscribed");
+        }
+        if (!subscriber->second.regions.empty())
+        {
+            return ReplyError("region-scoped receivers are resent their regions by the next event");
+        }
+        if (subscriber->second.document == 0)
+        {
+            if (document != 0 && m_documents.find(document) != m_documents.end())
+                subscriber->second.document = document;
+            else if (!m_documents.empty())
+                subscriber->second.document = m_documents.begin()->first;
+            else
+                return ReplyError("no open document");
+        }
+        docSerial = subscriber->second.document;
+    }
+
+    // Pipelines take the subscription lock themselves while claiming sequences
+    return LightDocumentPipeline::Resume(docSerial, port, document == docSerial ? version : -1);
+}
+
+/**
+ * @brief Runs a light query against an open document
+ *
+ * @param document Document to query, 0 for the oldest open one
+ * @param filter Parsed filters and page
+ * @return Reply of LightSyncQuery::Run, or an error
+ */
+std::string LightSyncSubscriptions::Query(unsigned int document, const LightSyncQuery::Filter& filter)
+{
+    unsigned int docSerial = document;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_documents.empty())
+        {
+            return ReplyError("no open document");
+        }
+        if (document == 0)
+        {
+            docSerial = m_documents.begin()->first;
+        }
+        else if (m_documents.find(document) == m_documents.end())
+        {
+            return ReplyError("unknown document");
+        }
+    }
+
+    // Answered from the document's snapshot without holding the subscription lock
+    return LightSyncQuery::Run(docSerial, filter);
+}
+
+std::string LightSyncSubscriptions::ListDocuments()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::string reply = "{\"status\": \"ok\", \"documents\": [";
+    bool first = true;
+    for (const auto& entry : m_documents)
+    {
+        reply += first ? "{\"id\": " : ", {\"id\": ";
+        reply += std::to_string(entry.first);
+        reply += ", \"name\": ";
+        AppendQuoted(reply, entry.second.name);
+        reply += "}";
+        first = false;
+    }
+    reply += "]}";
+    return reply;
+}
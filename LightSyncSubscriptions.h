@@ -0,0 +1,183 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+#pragma once
+
+#include "stdafx.h"
+#include "LightPrioritizer.h"
+#include "LightSnapshot.h"
+#include "LightSpatialIndex.h"
+#include "LightSyncQuery.h"
+#include "LightUtils.h"
+#include "Receiver/LightQuantizedFormat.h"
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * @brief Registry of receivers and the part of the scene each one streams
+ *
+ * Receivers register through the control server with the port they listen on
+ * and, optionally, a list of axis-aligned regions in meters. Region-scoped
+ * receivers only get the lights inside their regions plus the ids of lights
+ * that entered or left them since the previous message. The default Unreal
+ * listener is registered for the whole scene so existing setups keep working.
+ *
+ * Every receiver streams one document. A receiver can name the document it
+ * wants when subscribing; one that did not is bound to the first document that
+ * sends a scene. Either way it is released again when that document closes and
+ * then binds to the next document that sends a scene. Spatial indexes are kept
+ * per document, so an event in one document never touches another's receivers.
+ *
+ * A whole-scene receiver that (re)connects sends a resume request with the
+ * last version it applied and is caught up from its document's resume log.
+ * Tools that only need some lights query them without subscribing.
+ *
+ * Receivers on slow links can subscribe to the quantized encoding, which
+ * sends compact binary messages at a position precision of their choice.
+ *
+ * A receiver may subscribe with a lease and renew it with heartbeats; one
+ * whose lease runs out (it crashed or lost the control channel) is
+ * unsubscribed by a network thread timer, so its messages stop being queued.
+ */
+class LightSyncSubscriptions
+{
+public:
+    // What one receiver should get for the current event
+    struct Delivery
+    {
+        int port;
+        unsigned int document;         // Runtime serial number of the document the lights belong to
+        unsigned int sequence;         // Per-receiver message counter, newer sequences supersede older ones
+        uint64_t transformSequence;    // Newest live drag sample when resolved, 0 if none was ever taken
+        uint64_t version;              // Snapshot version the receiver is at once it applied the message
+        bool regionScoped;
+        bool partial;                  // Lights update the receiver's scene instead of replacing it
+        bool quantized;                // Encoded with LightQuantizedEncoder instead of as JSON
+        bool namedById;                // Quantized partial records carry ids, not scene handles (resumed deltas)
+        double positionStep;           // Quantized position precision in meters
+        LightSnapshot::Ptr snapshot;   // Whole-scene receivers read the shared snapshot...
+        std::vector<LightUtils::LightInfo> lights;  // ...everyone else gets their own list
+        std::vector<ON_UUID> entered;  // Region-scoped only
+        std::vector<ON_UUID> left;     // Region-scoped only
+        LightPrioritizer::Camera camera;  // Valid when the receiver reported its view
+        std::shared_ptr<const std::string> encodedLights;  // Resumed keyframes: the snapshot's lights, already encoded
+
+        // Prioritized scenes are split into batches that share one sequence
+        size_t batchIndex;
+        size_t batchCount;
+        size_t firstLightIndex;
+        size_t totalLightCount;
+
+        Delivery() : port(0), document(0), sequence(0), transformSequence(0), version(0), regionScoped(false), partial(false),
+            quantized(false), namedById(false), positionStep(LightQuantizedFormat::DEFAULT_POSITION_STEP), batchIndex(0), batchCount(1), firstLightIndex(0), totalLightCount(0) {}
+
+        size_t LightCount() const { return snapshot ? snapshot->Count() : lights.size(); }
+        const LightUtils::LightInfo& LightAt(size_t index) const
+        {
+            return snapshot ? snapshot->At(index) : lights[index];
+        }
+    };
+
+    // Control channel entry point (called on the network thread)
+    static std::string HandleControlMessage(const std::string& request);
+
+    // Makes a document known to receivers (listed by the "documents" request) or updates its name
+    static void AddDocument(unsigned int docSerial, const std::wstring& name);
+
+    // Forgets a closing document and releases the receivers bound to it
+    static void RemoveDocument(unsigned int docSerial);
+
+    // Keeps the document's spatial index current; changedLightId is nil when the event does not identify a light
+    static void UpdateSpatialIndex(unsigned int docSerial, const std::vector<LightUtils::LightInfo>& activeLights,
+        const ON_UUID& changedLightId, double unitScale);
+
+    // Moves a single light in an already built index (no-op until the first full event)
+    static void UpdateSpatialIndexEntry(unsigned int docSerial, const LightUtils::LightInfo& light, double unitScale);
+
+    // Drops a light from an already built index
+    static void RemoveSpatialIndexEntry(unsigned int docSerial, const ON_UUID& lightId);
+
+    // True if any receiver of the document streams only part of it (its membership needs a full event)
+    static bool HasRegionScopedSubscribers(unsigned int docSerial);
+
+    // Splits the document's active lights into one delivery per receiver bound to it (binding unbound
+    // receivers first), appended to deliveries; whole-scene receivers share the snapshot of those lights
+    // instead of getting a copy
+    static void ResolveDeliveries(unsigned int docSerial, const std::vector<LightUtils::LightInfo>& activeLights,
+        const LightSnapshot::Ptr& snapshot, std::vector<Delivery>& deliveries);
+
+    // Partial updates for a few lights: each receiver of the document gets those of the lights it
+    // streams, appended to deliveries
+    static void ResolvePartialDeliveries(unsigned int docSerial, const std::vector<LightUtils::LightInfo>& lights,
+        uint64_t version, std::vector<Delivery>& deliveries);
+
+    // Ports of the document's receivers that currently stream the given light
+    static std::vector<int> PortsStreamingLight(unsigned int docSerial, const ON_UUID& lightId);
+
+    // True while no newer message has been resolved for the receiver (stops stale trickles)
+    static bool IsCurrentSequence(int port, unsigned int sequence);
+
+    // Sequence (a new one for a scene) and encoding of a message resumed to a receiver bound to the document
+    static bool ClaimSequence(int port, unsigned int docSerial, bool newScene, Delivery& delivery);
+
+    // Constants
+    static constexpr int LEASE_SWEEP_MS = 1000;           // Interval of the expired-lease check
+    static constexpr double MAX_LEASE_SECONDS = 3600.0;
+
+private:
+    struct Subscriber
+    {
+        std::vector<LightSpatialIndex::Box> regions;  // Empty means the whole scene
+        std::unordered_set<ON_UUID, LightUtils::UuidHash> lightsInRegions;
+        LightPrioritizer::Camera camera;
+        unsigned int sequence;
+        unsigned int document;  // 0 until bound to a document
+        bool quantized;
+        double positionStep;
+        double leaseSeconds;    // 0 for a subscription that never expires
+        std::chrono::steady_clock::time_point leaseExpiry;
+
+        Subscriber() : sequence(0), document(0), quantized(false), positionStep(LightQuantizedFormat::DEFAULT_POSITION_STEP),
+            leaseSeconds(0.0) {}
+    };
+
+    struct Document
+    {
+        std::wstring name;
+        LightSpatialIndex spatialIndex;
+        bool indexBuilt;
+        double indexUnitScale;
+
+        Document() : indexBuilt(false), indexUnitScale(1.0) {}
+    };
+
+    static std::string Subscribe(int port, unsigned int document, std::vector<LightSpatialIndex::Box> regions,
+        bool quantized, double positionStep, double leaseSeconds);
+    static std::string Heartbeat(int port);
+    static void ScheduleLeaseSweep();
+    static void SweepLeases();
+    static std::string Unsubscribe(int port);
+    static std::string UpdateCamera(int port, const LightPrioritizer::Camera& camera);
+    static std::string ListDocuments();
+    static std::string Resume(int port, unsigned int document, int64_t version);
+    static std::string Query(unsigned int document, const LightSyncQuery::Filter& filter);
+
+    static std::mutex m_mutex;
+    static std::map<int, Subscriber> m_subscribers;
+    static std::map<unsigned int, Document> m_documents;
+    static bool m_leaseSweepScheduled;
+};
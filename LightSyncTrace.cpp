@@ -0,0 +1,294 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+#include "stdafx.h"
+#include "LightSyncTrace.h"
+#include "LightUtils.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+const std::wstring LightSyncTrace::DEFAULT_TRACE_PATH = L"C:/ProgramData/RhinoLightSync/Trace.json";
+
+namespace {
+    typedef std::chrono::steady_clock Clock;
+
+    struct Event
+    {
+        const char* name;
+        int64_t startMicroseconds;
+        int64_t durationMicroseconds;
+    };
+
+    // Written by its thread only; count is published after the event it covers
+    struct ThreadBuffer
+    {
+        std::string track;
+        std::atomic<size_t> count;
+        std::atomic<size_t> dropped;
+        Event events[LightSyncTrace::MAX_SPANS_PER_THREAD];
+
+        explicit ThreadBuffer(const std::string& trackName) : track(trackName), count(0), dropped(0) {}
+    };
+
+    std::atomic<bool> g_running(false);
+    std::atomic<unsigned int> g_session(0);
+    Clock::time_point g_origin;
+
+    std::mutex g_registryMutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> g_buffers;
+    std::atomic<size_t> g_unregisteredDrops(0);
+
+    thread_local std::string t_track;
+    thread_local std::shared_ptr<ThreadBuffer> t_buffer;
+    thread_local unsigned int t_session = 0;
+
+    // Buffers of the AddSpan tracks this thread writes, for the running trace
+    thread_local std::map<std::string, std::shared_ptr<ThreadBuffer>> t_trackBuffers;
+    thread_local unsigned int t_trackSession = 0;
+
+    int64_t ToMicroseconds(Clock::time_point time)
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(time - g_origin).count();
+    }
+
+    int64_t NowMicroseconds()
+    {
+        return ToMicroseconds(Clock::now());
+    }
+
+    // New buffer in the registry of the running trace; caller holds g_registryMutex
+    std::shared_ptr<ThreadBuffer> RegisterBuffer(const std::string& track)
+    {
+        if (g_buffers.size() >= LightSyncTrace::MAX_THREADS)
+        {
+            return nullptr;
+        }
+        g_buffers.push_back(std::make_shared<ThreadBuffer>(track));
+        return g_buffers.back();
+    }
+
+    // Buffer of the calling thread for the running trace, registered on first use
+    ThreadBuffer* CurrentBuffer()
+    {
+        const unsigned int session = g_session.load(std::memory_order_acquire);
+        if (t_session == session && t_buffer)
+        {
+            return t_buffer.get();
+        }
+
+        std::lock_guard<std::mutex> lock(g_registryMutex);
+        t_session = session;
+        t_buffer = RegisterBuffer(t_track.empty() ? "Thread" : t_track);
+        return t_buffer.get();
+    }
+
+    // Buffer of the calling thread for one AddSpan track, registered on first use
+    ThreadBuffer* TrackBuffer(const std::string& track)
+    {
+        const unsigned int session = g_session.load(std::memory_order_acquire);
+        if (t_trackSession != session)
+        {
+            t_trackBuffers.clear();
+            t_trackSession = session;
+        }
+        auto found = t_trackBuffers.find(track);
+        if (found != t_trackBuffers.end())
+        {
+            return found->second.get();
+        }
+
+        std::lock_guard<std::mutex> lock(g_registryMutex);
+        std::shared_ptr<ThreadBuffer> buffer = RegisterBuffer(track);
+        t_trackBuffers.emplace(track, buffer);
+        return buffer.get();
+    }
+
+    // Appends one span; only the buffer's own thread calls this
+    void Append(ThreadBuffer* buffer, const char* name, int64_t startMicroseconds, int64_t endMicroseconds)
+    {
+        if (!buffer)
+        {
+            g_unregisteredDrops.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        const size_t index = buffer->count.load(std::memory_order_relaxed);
+        if (index >= LightSyncTrace::MAX_SPANS_PER_THREAD)
+        {
+            buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        buffer->events[index] = Event{ name, startMicroseconds, endMicroseconds - startMicroseconds };
+        buffer->count.store(index + 1, std::memory_order_release);
+    }
+
+    void AppendEscaped(std::string& out, const std::string& text)
+    {
+        for (char c : text)
+        {
+            if (c == '"' || c == '\\')
+                out += '\\';
+            if (static_cast<unsigned char>(c) >= 0x20)
+                out += c;
+        }
+    }
+}
+
+LightSyncTrace::Span::Span(const char* name)
+    : m_name(name), m_startMicroseconds(g_running.load(std::memory_order_acquire) ? NowMicroseconds() : -1)
+{
+}
+
+LightSyncTrace::Span::~Span()
+{
+    if (m_startMicroseconds < 0 || !g_running.load(std::memory_order_acquire))
+    {
+        return;
+    }
+
+    const int64_t end = NowMicroseconds();
+    Append(CurrentBuffer(), m_name, m_startMicroseconds, end);
+}
+
+/**
+ * @brief Starts a new trace, discarding the buffers of the previous one
+ */
+void LightSyncTrace::Start()
+{
+    NameThread("Rhino UI");
+
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+    g_running.store(false);
+    g_buffers.clear();
+    g_unregisteredDrops.store(0);
+    g_origin = Clock::now();
+    g_session.fetch_add(1, std::memory_order_release);
+    g_running.store(true, std::memory_order_release);
+}
+
+/**
+ * @brief Stops the trace and writes its spans as Chrome trace-event JSON
+ *
+ * Spans that end after the trace was stopped are not recorded. Each track is
+ * a thread id of its own, named by a thread_name metadata event.
+ *
+ * @param path File to write (replaced)
+ * @param spanCount Receives the number of spans written
+ * @param droppedCount Receives the number of spans lost to full buffers
+ * @return False if no trace was running or the file could not be written
+ */
+bool LightSyncTrace::Stop(const std::wstring& path, size_t& spanCount, size_t& droppedCount)
+{
+    spanCount = 0;
+    droppedCount = 0;
+    if (!g_running.exchange(false))
+    {
+        return false;
+    }
+
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+        std::lock_guard<std::mutex> lock(g_registryMutex);
+        buffers.swap(g_buffers);
+    }
+    droppedCount = g_unregisteredDrops.load();
+
+    // Threads with the same name share a track; the UI thread comes first
+    std::map<std::string, int> tracks;
+    tracks["Rhino UI"] = 1;
+    for (const auto& buffer : buffers)
+    {
+        tracks.emplace(buffer->track, static_cast<int>(tracks.size()) + 1);
+    }
+
+    std::string json = "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+    json += "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, \"args\": {\"name\": \"Rhino LightSync\"}}";
+    for (const auto& track : tracks)
+    {
+        json += ",\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " + std::to_string(track.second) +
+            ", \"args\": {\"name\": \"";
+        AppendEscaped(json, track.first);
+        json += "\"}},\n{\"name\": \"thread_sort_index\", \"ph\": \"M\", \"pid\": 1, \"tid\": " +
+            std::to_string(track.second) + ", \"args\": {\"sort_index\": " + std::to_string(track.second) + "}}";
+    }
+    for (const auto& buffer : buffers)
+    {
+        const std::string tid = std::to_string(tracks[buffer->track]);
+        const size_t count = buffer->count.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count; ++i)
+        {
+            const Event& event = buffer->events[i];
+            json += ",\n{\"name\": \"";
+            AppendEscaped(json, event.name);
+            json += "\", \"cat\": \"lightsync\", \"ph\": \"X\", \"pid\": 1, \"tid\": " + tid +
+                ", \"ts\": " + std::to_string(event.startMicroseconds) +
+                ", \"dur\": " + std::to_string(event.durationMicroseconds) + "}";
+        }
+        spanCount += count;
+        droppedCount += buffer->dropped.load();
+    }
+    json += "\n]}\n";
+
+    if (!LightUtils::EnsureDirectoryExists(path))
+    {
+        return false;
+    }
+    FILE* file = _wfopen(path.c_str(), L"wb");
+    if (!file)
+    {
+        return false;
+    }
+    const bool written = fwrite(json.data(), 1, json.size(), file) == json.size();
+    return fclose(file) == 0 && written;
+}
+
+bool LightSyncTrace::IsRunning()
+{
+    return g_running.load();
+}
+
+void LightSyncTrace::NameThread(const std::string& name)
+{
+    t_track = name;
+}
+
+/**
+ * @brief Records a span measured by the caller on a track of its own
+ *
+ * The span is kept in a buffer of the calling thread for that track, so it
+ * needs no lock after the track's first span. Spans that began before the
+ * trace started are dropped.
+ *
+ * @param track Name of the track the span appears on
+ * @param name Span name; must outlive the trace (a string literal)
+ * @param start When the measured phase began
+ * @param end When it ended
+ */
+void LightSyncTrace::AddSpan(const std::string& track, const char* name, std::chrono::steady_clock::time_point start,
+    std::chrono::steady_clock::time_point end)
+{
+    if (!g_running.load(std::memory_order_acquire))
+    {
+        return;
+    }
+    const int64_t startMicroseconds = ToMicroseconds(start);
+    if (startMicroseconds < 0)
+    {
+        return;
+    }
+    Append(TrackBuffer(track), name, startMicroseconds, ToMicroseconds(end));
+}
@@ -0,0 +1,71 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+#pragma once
+
+#include "stdafx.h"
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Scoped spans of the sync pipeline, written as a Chrome trace
+ *
+ * While a trace is running, every Span records its name, start and duration in
+ * a fixed-size buffer owned by the calling thread. Only that thread writes the
+ * buffer and it publishes each span with one release store, so recording never
+ * locks; a thread takes the registry lock once per trace, on its first span.
+ * When the trace is stopped the buffers are written as a Chrome trace-event
+ * JSON file (chrome://tracing, ui.perfetto.dev). Threads appear as tracks
+ * named with NameThread (the UI thread, the network thread, the workers);
+ * threads with the same name share a track. AddSpan records a span that was
+ * timed elsewhere onto a named track, such as the network thread's connect
+ * and send phases on one "Sender :<port>" track per receiver port. With no
+ * trace running a span costs one relaxed atomic load.
+ */
+class LightSyncTrace
+{
+public:
+    /**
+     * @brief Records the lifetime of the scope as one span of the current trace
+     */
+    class Span
+    {
+    public:
+        // name must outlive the trace (a string literal)
+        explicit Span(const char* name);
+        ~Span();
+
+    private:
+        const char* m_name;
+        int64_t m_startMicroseconds;  // -1 when no trace is running
+    };
+
+    static const std::wstring DEFAULT_TRACE_PATH;
+    static const size_t MAX_SPANS_PER_THREAD = 16384;  // Later spans of a thread are dropped
+    static const size_t MAX_THREADS = 128;  // Buffers per trace: one per thread and per AddSpan track
+
+    // Starts a trace; the calling thread becomes the "Rhino UI" track
+    static void Start();
+
+    // Stops the trace and writes it; spanCount and droppedCount report what was kept and lost
+    static bool Stop(const std::wstring& path, size_t& spanCount, size_t& droppedCount);
+
+    static bool IsRunning();
+
+    // Track the calling thread's spans appear on (kept across traces)
+    static void NameThread(const std::string& name);
+
+    // Records an already measured span on the named track (name must outlive the trace)
+    static void AddSpan(const std::string& track, const char* name, std::chrono::steady_clock::time_point start,
+        std::chrono::steady_clock::time_point end);
+};
@@ -0,0 +1,207 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+#include "stdafx.h"
+#include "LightTombstoneStore.h"
+#include "LightSyncStats.h"
+#include <atomic>
+#include <limits>
+#include <map>
+#include <unordered_map>
+#include <utility>
+
+namespace {
+    // Undo serials are numbered per document, so undo records are named by both serials
+    typedef std::pair<unsigned int, unsigned int> UndoRecord;  // Document serial, undo serial
+
+    struct Document
+    {
+        std::unordered_map<ON_UUID, unsigned int, LightUtils::UuidHash> undoSerials;
+    };
+
+    // Keyed by document runtime serial number
+    std::unordered_map<unsigned int, Document> g_documents;
+    // Every document's deletions by undo record, oldest first within a document
+    std::multimap<UndoRecord, ON_UUID> g_byUndoRecord;
+    // Atomic so the metrics endpoint can read it off the UI thread
+    std::atomic<size_t> g_count(0);
+
+    void Erase(unsigned int docSerial, Document& document, const ON_UUID& lightId, unsigned int undoRecordSerial)
+    {
+        document.undoSerials.erase(lightId);
+
+        auto range = g_byUndoRecord.equal_range(UndoRecord(docSerial, undoRecordSerial));
+        for (auto tombstone = range.first; tombstone != range.second; ++tombstone)
+        {
+            if (tombstone->second == lightId)
+            {
+                g_byUndoRecord.erase(tombstone);
+                return;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Records a light deletion
+ *
+ * @param docSerial Runtime serial number of the light's document
+ * @param lightId Deleted light
+ * @param undoRecordSerial Undo record the deletion belongs to (0 if none)
+ */
+void LightTombstoneStore::Add(unsigned int docSerial, const ON_UUID& lightId, unsigned int undoRecordSerial)
+{
+    Document& document = g_documents[docSerial];
+
+    auto existing = document.undoSerials.find(lightId);
+    if (existing != document.undoSerials.end())
+    {
+        Erase(docSerial, document, lightId, existing->second);
+        --g_count;
+    }
+
+    // Beyond the limit the oldest deletion goes; its light is still flagged deleted in the table
+    if (document.undoSerials.size() >= MAX_TOMBSTONES_PER_DOCUMENT)
+    {
+        auto oldest = g_byUndoRecord.lower_bound(UndoRecord(docSerial, 0));
+        document.undoSerials.erase(oldest->second);
+        g_byUndoRecord.erase(oldest);
+        --g_count;
+        LightSyncStats::Increment(LightSyncStats::Get().tombstonesCompacted);
+    }
+
+    document.undoSerials.emplace(lightId, undoRecordSerial);
+    g_byUndoRecord.emplace(UndoRecord(docSerial, undoRecordSerial), lightId);
+    ++g_count;
+}
+
+void LightTombstoneStore::Remove(unsigned int docSerial, const ON_UUID& lightId)
+{
+    auto document = g_documents.find(docSerial);
+    if (document == g_documents.end())
+    {
+        return;
+    }
+
+    auto existing = document->second.undoSerials.find(lightId);
+    if (existing != document->second.undoSerials.end())
+    {
+        Erase(docSerial, document->second, lightId, existing->second);
+        --g_count;
+    }
+    if (document->second.undoSerials.empty())
+    {
+        g_documents.erase(document);
+    }
+}
+
+bool LightTombstoneStore::Contains(unsigned int docSerial, const ON_UUID& lightId)
+{
+    auto document = g_documents.find(docSerial);
+    return document != g_documents.end() &&
+        document->second.undoSerials.find(lightId) != document->second.undoSerials.end();
+}
+
+bool LightTombstoneStore::Empty(unsigned int docSerial)
+{
+    return g_documents.find(docSerial) == g_documents.end();
+}
+
+/**
+ * @brief Compacts the tombstones of deletions recorded in a purged undo record
+ *
+ * Only that record's deletions become final. Serials are not purged in
+ * order: the redo stack is purged as soon as a new action is recorded, and
+ * its records are newer than deletions that can still be undone, so a
+ * deletion in any other record keeps its tombstone. Undo serials are per
+ * document, so the same serial in another document is left alone.
+ *
+ * @param docSerial Runtime serial number of the document that owned the record
+ * @param undoRecordSerial Serial number of the purged record
+ * @return Number of tombstones dropped
+ */
+size_t LightTombstoneStore::PurgeUndoRecord(unsigned int docSerial, unsigned int undoRecordSerial)
+{
+    auto document = g_documents.find(docSerial);
+    if (document == g_documents.end())
+    {
+        return 0;
+    }
+
+    size_t purged = 0;
+    const auto range = g_byUndoRecord.equal_range(UndoRecord(docSerial, undoRecordSerial));
+    for (auto tombstone = range.first; tombstone != range.second; ++tombstone)
+    {
+        document->second.undoSerials.erase(tombstone->second);
+        ++purged;
+    }
+    g_byUndoRecord.erase(range.first, range.second);
+    if (document->second.undoSerials.empty())
+    {
+        g_documents.erase(document);
+    }
+
+    g_count -= purged;
+    LightSyncStats::Increment(LightSyncStats::Get().tombstonesCompacted, purged);
+    return purged;
+}
+
+size_t LightTombstoneStore::RemoveDocument(unsigned int docSerial)
+{
+    auto document = g_documents.find(docSerial);
+    if (document == g_documents.end())
+    {
+        return 0;
+    }
+
+    const size_t removed = document->second.undoSerials.size();
+    g_count -= removed;
+    g_documents.erase(document);
+    g_byUndoRecord.erase(g_byUndoRecord.lower_bound(UndoRecord(docSerial, 0)),
+        g_byUndoRecord.upper_bound(UndoRecord(docSerial, std::numeric_limits<unsigned int>::max())));
+    LightSyncStats::Increment(LightSyncStats::Get().tombstonesCompacted, removed);
+    return removed;
+}
+
+size_t LightTombstoneStore::Count()
+{
+    return g_count;
+}
+
+size_t LightTombstoneStore::DocumentCount()
+{
+    return g_documents.size();
+}
+
+/**
+ * @brief Estimates the heap memory held by the tombstones
+ *
+ * Counts one hash node plus its bucket slot and one tree node per tombstone
+ * (two pointers of overhead for hash nodes, three pointers and a color for
+ * tree nodes), and one hash node per document.
+ *
+ * @return Approximate bytes
+ */
+size_t LightTombstoneStore::MemoryBytes()
+{
+    const size_t hashNode = sizeof(std::pair<const ON_UUID, unsigned int>) + 2 * sizeof(void*);
+    const size_t treeNode = sizeof(std::pair<const UndoRecord, ON_UUID>) + 4 * sizeof(void*);
+
+    size_t bytes = g_documents.bucket_count() * sizeof(void*);
+    for (const auto& document : g_documents)
+    {
+        bytes += sizeof(document) + 2 * sizeof(void*);
+        bytes += document.second.undoSerials.bucket_count() * sizeof(void*);
+        bytes += document.second.undoSerials.size() * (hashNode + treeNode);
+    }
+    return bytes;
+}
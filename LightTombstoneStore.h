@@ -0,0 +1,54 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+
+#pragma once
+
+#include "stdafx.h"
+#include "LightUtils.h"
+#include <cstddef>
+
+/**
+ * @brief Deleted-light tombstones, kept per document and bounded
+ *
+ * A tombstone keeps a deleted light out of the scenes sent to receivers until
+ * it is undeleted. It is only a lookup: an undeleted light is the same table
+ * entry with the same id, and it goes out as added at the snapshot's new
+ * version. Each one remembers the undo record it was deleted in: once
+ * Rhino purges that record the deletion can no longer be undone, the light's
+ * own deleted flag is enough, and the tombstone is compacted away. A document's
+ * tombstones are dropped when it closes, and each document keeps at most
+ * MAX_TOMBSTONES_PER_DOCUMENT (oldest dropped first). UI thread only, except
+ * Count(), which any thread may read.
+ */
+class LightTombstoneStore
+{
+public:
+    static const size_t MAX_TOMBSTONES_PER_DOCUMENT = 16384;
+
+    static void Add(unsigned int docSerial, const ON_UUID& lightId, unsigned int undoRecordSerial);
+    static void Remove(unsigned int docSerial, const ON_UUID& lightId);
+    static bool Contains(unsigned int docSerial, const ON_UUID& lightId);
+    static bool Empty(unsigned int docSerial);
+
+    // Drops the tombstones of deletions recorded in exactly that undo record of the document
+    static size_t PurgeUndoRecord(unsigned int docSerial, unsigned int undoRecordSerial);
+
+    // Drops everything kept for a closing document
+    static size_t RemoveDocument(unsigned int docSerial);
+
+    static size_t Count();
+    static size_t DocumentCount();
+
+    // Approximate heap use of all tombstones and their indexes
+    static size_t MemoryBytes();
+};
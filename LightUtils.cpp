@@ -11,60 +11,170 @@
 // Contact: rudraojhaif@gmail.com for licensing inquiries.
 #include "stdafx.h"
 #include "LightUtils.h"
+#include "LightSchema.h"
+#include <cstdio>
 #include <fstream>
 #include <sstream>
+#include <type_traits>
 #include <vector>
 
 const std::wstring LightUtils::DEFAULT_EXPORT_PATH = L"C:/ProgramData/RhinoLightSync/Lights.txt";
 
+namespace {
+    // Export file form of each schema value type, see ExportLightsToFile
+    void WriteExportValue(std::wostream& out, LightUtils::LightType type)
+    {
+        out << LightUtils::GetLightTypeName(type);
+    }
+
+    void WriteExportValue(std::wostream& out, bool enabled)
+    {
+        out << (enabled ? L"On" : L"Off");
+    }
+
+    void WriteExportValue(std::wostream& out, const ON_3dPoint& location)
+    {
+        out << L"(" << location.x << L"," << location.y << L"," << location.z << L")";
+    }
+
+    void WriteExportValue(std::wostream& out, const ON_3dVector& direction)
+    {
+        LightUtils::WriteRotation(out, direction);
+    }
+
+    void WriteExportValue(std::wostream& out, double value)
+    {
+        out << value;
+    }
+
+    void WriteExportValue(std::wostream& out, const ON_Color& color)
+    {
+        LightUtils::WriteColor(out, color);
+    }
+
+    void WriteExportValue(std::wostream& out, const LightSchema::SpotAngles& angles)
+    {
+        out << angles.inner << L"\u00B0 " << angles.outer << L"\u00B0";
+    }
+
+    // Inventory report form of each schema value type, see PrintLightInventory
+    std::wstring InventoryText(LightUtils::LightType type)
+    {
+        return LightUtils::GetLightTypeName(type);
+    }
+
+    std::wstring InventoryText(bool enabled)
+    {
+        return enabled ? L"Yes" : L"No";
+    }
+
+    std::wstring InventoryText(const ON_3dPoint& location)
+    {
+        wchar_t text[96];
+        swprintf(text, sizeof(text) / sizeof(text[0]), L"(%.3f, %.3f, %.3f)", location.x, location.y, location.z);
+        return text;
+    }
+
+    std::wstring InventoryText(const ON_3dVector& direction)
+    {
+        wchar_t text[96];
+        swprintf(text, sizeof(text) / sizeof(text[0]), L"(%.3f, %.3f, %.3f)", direction.x, direction.y, direction.z);
+        return text;
+    }
+
+    std::wstring InventoryText(double value)
+    {
+        wchar_t text[48];
+        swprintf(text, sizeof(text) / sizeof(text[0]), L"%.3f", value);
+        return text;
+    }
+
+    std::wstring InventoryText(const ON_Color& color)
+    {
+        return LightUtils::ColorToString(color);
+    }
+
+    std::wstring InventoryText(const LightSchema::SpotAngles& angles)
+    {
+        wchar_t text[96];
+        swprintf(text, sizeof(text) / sizeof(text[0]), L"%.2f\u00B0 inner, %.2f\u00B0 outer", angles.inner, angles.outer);
+        return text;
+    }
+}
+
 std::vector<LightUtils::LightInfo> LightUtils::GetAllLights(CRhinoDoc* doc)
 {
     std::vector<LightInfo> lightInfos;
+    GetAllLights(doc, lightInfos);
+    return lightInfos;
+}
+
+void LightUtils::GetAllLights(CRhinoDoc* doc, std::vector<LightInfo>& lightInfos)
+{
+    lightInfos.clear();
 
     if (nullptr == doc)
     {
-        return lightInfos; // Return empty vector
+        return; // Leave the vector empty
     }
 
     try
     {
-        // Retrieve all lights from the document's light table
-        ON_SimpleArray<const CRhinoLight*> lights;
+        // Retrieve all lights from the document's light table. The list is kept
+        // between calls (UI thread only) so its storage is reused.
+        static ON_SimpleArray<const CRhinoLight*> lights;
+        lights.Empty();
         doc->m_light_table.GetSortedList(lights);
         const int lightCount = lights.Count();
+        lightInfos.reserve(lightCount);
 
         // Convert each light to LightInfo structure
         for (int i = 0; i < lightCount; ++i)
         {
-            const auto& light = lights[i]->Light();
-            if (!light.m_bOn)
+            // Deleted lights stay in the table until their undo record is purged
+            if (lights[i]->IsDeleted() || !lights[i]->Light().m_bOn)
                 continue;
-            LightInfo info;
-            info.type = GetLightTypeString(light.Style());
-            info.location = light.Location();
-            info.direction = light.Direction();
-            info.intensity = light.Intensity();
-            info.color = light.Diffuse();
-            info.isSpotLight = light.IsSpotLight();
-
-            if (info.isSpotLight)
-            {
-                info.outerAngle = light.HotSpot() * (180.0 / 3.14159265358979323846);
-                info.innerAngle = light.SpotAngleDegrees();
-            }
-
-            lightInfos.push_back(info);
+            lightInfos.push_back(MakeLightInfo(*lights[i]));
         }
     }
     catch (...)
     {
-        // Return whatever we managed to collect
+        // Keep whatever we managed to collect
     }
+}
 
-    return lightInfos;
+LightUtils::LightInfo LightUtils::MakeLightInfo(const CRhinoLight& rhinoLight)
+{
+    const auto& light = rhinoLight.Light();
+
+    LightInfo info;
+    info.id = rhinoLight.Attributes().m_uuid;
+    info.type = GetLightType(light.Style());
+    info.location = light.Location();
+    info.direction = light.Direction();
+    info.intensity = light.Intensity();
+    info.color = light.Diffuse();
+    info.isSpotLight = light.IsSpotLight();
+    info.enabled = light.m_bOn;
+
+    if (info.isSpotLight)
+    {
+        // HotSpot is the fraction of the cone at full intensity, not an angle
+        info.outerAngle = light.SpotAngleDegrees();
+        info.innerAngle = info.outerAngle * light.HotSpot();
+    }
+
+    return info;
 }
 
 bool LightUtils::ExportLightsToFile(const std::vector<LightInfo>& lights, const std::wstring& filePath)
+{
+    return ExportLightsToFile(lights.size(),
+        [&lights](size_t index) -> const LightInfo& { return lights[index]; }, filePath);
+}
+
+bool LightUtils::ExportLightsToFile(size_t lightCount, const std::function<const LightInfo&(size_t)>& lightAt,
+    const std::wstring& filePath)
 {
     try
     {
@@ -83,27 +193,37 @@ bool LightUtils::ExportLightsToFile(const std::vector<LightInfo>& lights, const
 
         // Write header comment
         outFile << L"# RhinoLightSync Export File" << std::endl;
-        outFile << L"# Format: <Type> <Location> <Rotation> <Intensity> <Color> [InnerAngle OuterAngle]" << std::endl;
-        outFile << L"# Total Lights: " << lights.size() << std::endl << std::endl;
+        outFile << L"# Format:";
+        LightSchema::ForEachField([&outFile](const auto& field) {
+            if (field.complete)
+            {
+                // Only spot angles are optional
+                const bool optional = std::is_same<typename std::decay_t<decltype(field)>::ValueType, LightSchema::SpotAngles>::value;
+                outFile << (optional ? L" [<" : L" <") << field.label << (optional ? L">]" : L">");
+            }
+        });
+        outFile << std::endl;
+        outFile << L"# Total Lights: " << lightCount << std::endl << std::endl;
 
         // Export each light
-        for (const auto& lightInfo : lights)
+        for (size_t i = 0; i < lightCount; ++i)
         {
-            std::wstring rotationString = DirectionToRotation(lightInfo.direction);
-            std::wstring colorString = ColorToString(lightInfo.color);
-
-            // Write formatted line: Type Location Rotation Intensity Color
-            outFile << lightInfo.type << L" "
-                << L"(" << lightInfo.location.x << L"," << lightInfo.location.y << L"," << lightInfo.location.z << L") "
-                << rotationString << L" "
-                << lightInfo.intensity << L" "
-                << colorString;
-
-            // Add spot light angles if applicable
-            if (lightInfo.isSpotLight)
-            {
-                outFile << L" " << lightInfo.innerAngle << L" " << lightInfo.outerAngle << L"";
-            }
+            const LightInfo& lightInfo = lightAt(i);
+
+            // One space-separated line of the record's fields, in schema order
+            bool first = true;
+            LightSchema::ForEachField([&](const auto& field) {
+                const auto value = field.get(lightInfo);
+                if (field.complete && LightSchema::IsPresent(value))
+                {
+                    if (!first)
+                    {
+                        outFile << L" ";
+                    }
+                    first = false;
+                    WriteExportValue(outFile, value);
+                }
+            });
 
             outFile << std::endl;
         }
@@ -126,50 +246,63 @@ void LightUtils::PrintLightInventory(const std::vector<LightInfo>& lights)
     // Process each light and display its properties
     for (size_t i = 0; i < lights.size(); ++i)
     {
-        const auto& lightInfo = lights[i];
+        PrintLightInfo(lights[i], i + 1);
+    }
 
-        // Display light information in console
-        RhinoApp().Print(L"Light %d:\n", (int)(i + 1));
-        RhinoApp().Print(L"  Type: %s\n", lightInfo.type.c_str());
-        RhinoApp().Print(L"  Position: (%.3f, %.3f, %.3f)\n",
-            lightInfo.location.x, lightInfo.location.y, lightInfo.location.z);
-        RhinoApp().Print(L"  Direction: (%.3f, %.3f, %.3f)\n",
-            lightInfo.direction.x, lightInfo.direction.y, lightInfo.direction.z);
-        RhinoApp().Print(L"  Intensity: %.3f\n", lightInfo.intensity);
-        RhinoApp().Print(L"  Color: %s\n", ColorToString(lightInfo.color).c_str());
+    RhinoApp().Print(L"=== End of Light Report ===\n");
+}
 
-        // Display spot light specific properties
-        if (lightInfo.isSpotLight)
+void LightUtils::PrintLightInfo(const LightInfo& lightInfo, size_t number)
+{
+    // Display light information in console
+    RhinoApp().Print(L"Light %d:\n", (int)number);
+    LightSchema::ForEachField([&lightInfo](const auto& field) {
+        const auto value = field.get(lightInfo);
+        if (LightSchema::IsPresent(value))
         {
-            RhinoApp().Print(L"  Inner Angle: %.2f\n", lightInfo.innerAngle);
-            RhinoApp().Print(L"  Outer Angle: %.2f\n", lightInfo.outerAngle);
+            RhinoApp().Print(L"  %s: %s\n", field.label, InventoryText(value).c_str());
         }
+    });
 
-        RhinoApp().Print(L"\n");
-    }
-
-    RhinoApp().Print(L"=== End of Light Report ===\n");
+    RhinoApp().Print(L"\n");
 }
 
-std::wstring LightUtils::GetLightTypeString(ON::light_style style)
+LightUtils::LightType LightUtils::GetLightType(ON::light_style style)
 {
     switch (style)
     {
     case ON::camera_directional_light:
     case ON::world_directional_light:
-        return L"Directional";
+        return LightType::Directional;
 
     case ON::camera_point_light:
     case ON::world_point_light:
-        return L"Point";
+        return LightType::Point;
 
     case ON::camera_spot_light:
     case ON::world_spot_light:
-        return L"Spot";
+        return LightType::Spot;
 
     case ON::ambient_light:
-        return L"Ambient";
+        return LightType::Ambient;
 
+    default:
+        return LightType::Unknown;
+    }
+}
+
+const wchar_t* LightUtils::GetLightTypeName(LightType type)
+{
+    switch (type)
+    {
+    case LightType::Directional:
+        return L"Directional";
+    case LightType::Point:
+        return L"Point";
+    case LightType::Spot:
+        return L"Spot";
+    case LightType::Ambient:
+        return L"Ambient";
     default:
         return L"Unknown";
     }
@@ -211,6 +344,20 @@ bool LightUtils::EnsureDirectoryExists(const std::wstring& filePath)
 }
 
 std::wstring LightUtils::DirectionToRotation(const ON_3dVector& direction)
+{
+    std::wstringstream ss;
+    WriteRotation(ss, direction);
+    return ss.str();
+}
+
+std::wstring LightUtils::ColorToString(const ON_Color& color)
+{
+    std::wstringstream ss;
+    WriteColor(ss, color);
+    return ss.str();
+}
+
+void LightUtils::WriteRotation(std::wostream& stream, const ON_3dVector& direction)
 {
     // Calculate rotation angles from direction vector
     ON_3dVector normalized = direction;
@@ -220,15 +367,34 @@ std::wstring LightUtils::DirectionToRotation(const ON_3dVector& direction)
     double elevation = asin(normalized.z) * 180.0 / ON_PI;
     double azimuth = atan2(normalized.y, normalized.x) * 180.0 / ON_PI;
 
-    // Format as string
-    std::wstringstream ss;
-    ss << L"(" << azimuth << L", " << elevation << L", 0.00)";
-    return ss.str();
+    stream << L"(" << azimuth << L", " << elevation << L", 0.00)";
 }
 
-std::wstring LightUtils::ColorToString(const ON_Color& color)
+void LightUtils::WriteColor(std::wostream& stream, const ON_Color& color)
 {
-    std::wstringstream ss;
-    ss << L"RGB(" << (int)color.Red() << L"," << (int)color.Green() << L"," << (int)color.Blue() << L")";
-    return ss.str();
+    stream << L"RGB(" << (int)color.Red() << L"," << (int)color.Green() << L"," << (int)color.Blue() << L")";
+}
+
+std::wstring LightUtils::UuidToString(const ON_UUID& uuid)
+{
+    // ON_UuidToString writes the canonical 36 character form plus terminator
+    wchar_t buffer[37] = {};
+    ON_UuidToString(uuid, buffer);
+    return std::wstring(buffer);
+}
+
+void LightUtils::AppendUuid(std::string& out, const ON_UUID& uuid)
+{
+    // Same text as UuidToString, written through a stack buffer
+    char buffer[37] = {};
+    ON_UuidToString(uuid, buffer);
+    out.append(buffer, 36);
+}
+
+size_t LightUtils::UuidHash::operator()(const ON_UUID& uuid) const
+{
+    // UUIDs are already well distributed; fold the 128 bits into a size_t
+    uint64_t words[2];
+    memcpy(words, &uuid, sizeof(words));
+    return static_cast<size_t>(words[0] ^ (words[1] * 0x9E3779B97F4A7C15ULL));
 }
\ No newline at end of file
@@ -12,14 +12,43 @@
 #pragma once
 
 #include "stdafx.h"
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
 
 class LightUtils
 {
 public:
+    // Transmitted fields of a light, used as bits of a dirty mask
+    enum Field : unsigned int
+    {
+        FIELD_LOCATION    = 1u << 0,
+        FIELD_DIRECTION   = 1u << 1,
+        FIELD_INTENSITY   = 1u << 2,
+        FIELD_COLOR       = 1u << 3,
+        FIELD_SPOT_ANGLES = 1u << 4,
+        FIELD_ENABLED     = 1u << 5,
+        FIELD_TYPE        = 1u << 6,
+        FIELD_ALL         = (1u << 7) - 1
+    };
+
+    // Light kinds as sent to receivers (camera and world styles map to the same kind)
+    enum class LightType : unsigned char
+    {
+        Unknown,
+        Directional,
+        Point,
+        Spot,
+        Ambient
+    };
+
     // Structure to hold light information for easier handling
     struct LightInfo
     {
-        std::wstring type;
+        ON_UUID id;         // Rhino object id, stable across events
+        LightType type;
         ON_3dPoint location;
         ON_3dVector direction;
         double intensity;
@@ -27,19 +56,39 @@ public:
         bool isSpotLight;
         double innerAngle;  // For spot lights
         double outerAngle;  // For spot lights
+        bool enabled;
+        unsigned int dirtyFields;  // Fields a partial message carries, FIELD_ALL for a full record
+        uint64_t version;          // Snapshot version that last changed the light (0 outside snapshots)
+
+        LightInfo() : id(ON_nil_uuid), type(LightType::Unknown), intensity(0.0), isSpotLight(false), innerAngle(0.0), outerAngle(0.0),
+            enabled(true), dirtyFields(FIELD_ALL), version(0) {}
+    };
 
-        LightInfo() : intensity(0.0), isSpotLight(false), innerAngle(0.0), outerAngle(0.0) {}
+    // Hash functor so light ids can key unordered containers
+    struct UuidHash
+    {
+        size_t operator()(const ON_UUID& uuid) const;
     };
 
     // Main functions
     static std::vector<LightInfo> GetAllLights(CRhinoDoc* doc);
+    static void GetAllLights(CRhinoDoc* doc, std::vector<LightInfo>& lightInfos);  // Reuses the vector's capacity
+    static LightInfo MakeLightInfo(const CRhinoLight& rhinoLight);
     static bool ExportLightsToFile(const std::vector<LightInfo>& lights, const std::wstring& filePath);
+    static bool ExportLightsToFile(size_t lightCount, const std::function<const LightInfo&(size_t)>& lightAt,
+        const std::wstring& filePath);  // For light sets that are not one vector (snapshots)
     static void PrintLightInventory(const std::vector<LightInfo>& lights);
+    static void PrintLightInfo(const LightInfo& lightInfo, size_t number);  // One inventory entry, numbered from 1
 
     // Helper functions
-    static std::wstring GetLightTypeString(ON::light_style style);
+    static LightType GetLightType(ON::light_style style);
+    static const wchar_t* GetLightTypeName(LightType type);
     static std::wstring DirectionToRotation(const ON_3dVector& direction);
     static std::wstring ColorToString(const ON_Color& color);
+    static void WriteRotation(std::wostream& stream, const ON_3dVector& direction);
+    static void WriteColor(std::wostream& stream, const ON_Color& color);
+    static std::wstring UuidToString(const ON_UUID& uuid);
+    static void AppendUuid(std::string& out, const ON_UUID& uuid);  // UTF-8 form of UuidToString
     static bool EnsureDirectoryExists(const std::wstring& filePath);
 
     // Constants
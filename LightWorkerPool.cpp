@@ -0,0 +1,218 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+
+#include "stdafx.h"
+#include "LightWorkerPool.h"
+#include "LightSyncTrace.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    struct Job
+    {
+        const std::function<void(size_t, size_t)>* body;
+        size_t count;
+        size_t chunkSize;
+        size_t chunkCount;
+        std::atomic<size_t> nextChunk;
+        std::atomic<size_t> doneChunks;
+        std::mutex doneMutex;
+        std::condition_variable doneCondition;
+        std::exception_ptr error;
+    };
+
+    std::mutex g_poolMutex;
+    std::condition_variable g_poolCondition;
+    std::deque<std::shared_ptr<Job>> g_queue;
+    std::vector<std::thread> g_workers;
+    // Bumped by Shutdown; workers of an older generation exit
+    unsigned int g_generation = 0;
+
+    // Claims chunks until none are left
+    void RunChunks(Job& job)
+    {
+        for (;;)
+        {
+            const size_t chunk = job.nextChunk.fetch_add(1);
+            if (chunk >= job.chunkCount)
+            {
+                return;
+            }
+
+            const size_t begin = chunk * job.chunkSize;
+            const size_t end = (job.count - begin < job.chunkSize) ? job.count : begin + job.chunkSize;
+            try
+            {
+                (*job.body)(begin, end);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(job.doneMutex);
+                if (!job.error)
+                {
+                    job.error = std::current_exception();
+                }
+            }
+
+            if (job.doneChunks.fetch_add(1) + 1 == job.chunkCount)
+            {
+                std::lock_guard<std::mutex> lock(job.doneMutex);
+                job.doneCondition.notify_all();
+            }
+        }
+    }
+
+    void WorkerLoop(unsigned int generation, size_t index)
+    {
+        LightSyncTrace::NameThread("Worker " + std::to_string(index + 1));
+        for (;;)
+        {
+            std::shared_ptr<Job> job;
+            {
+                std::unique_lock<std::mutex> lock(g_poolMutex);
+                g_poolCondition.wait(lock, [generation] { return generation != g_generation || !g_queue.empty(); });
+                if (generation != g_generation)
+                {
+                    return;
+                }
+                job = std::move(g_queue.front());
+                g_queue.pop_front();
+            }
+            LightSyncTrace::Span span("chunks");
+            RunChunks(*job);
+        }
+    }
+
+    size_t WorkerTarget()
+    {
+        const unsigned int hardwareThreads = std::thread::hardware_concurrency();
+        const size_t workers = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+        return workers < LightWorkerPool::MAX_WORKERS ? workers : static_cast<size_t>(LightWorkerPool::MAX_WORKERS);
+    }
+
+    // Starts the workers if needed; caller holds g_poolMutex
+    void EnsureWorkers()
+    {
+        if (!g_workers.empty())
+        {
+            return;
+        }
+        const size_t workers = WorkerTarget();
+        g_workers.reserve(workers);
+        for (size_t i = 0; i < workers; ++i)
+        {
+            g_workers.emplace_back(WorkerLoop, g_generation, i);
+        }
+    }
+}
+
+/**
+ * @brief Runs a chunked loop on the calling thread and the pool's workers
+ *
+ * Small ranges (a single chunk) or maxThreads == 1 run inline without touching
+ * the pool.
+ *
+ * @param count Number of items
+ * @param chunkSize Items per chunk
+ * @param body Called with [begin, end) of each chunk, possibly concurrently
+ * @param maxThreads Threads to use including the caller, 0 for all
+ */
+void LightWorkerPool::ParallelFor(size_t count, size_t chunkSize,
+    const std::function<void(size_t begin, size_t end)>& body, size_t maxThreads)
+{
+    if (count == 0)
+    {
+        return;
+    }
+    if (chunkSize == 0)
+    {
+        chunkSize = count;
+    }
+
+    auto job = std::make_shared<Job>();
+    job->body = &body;
+    job->count = count;
+    job->chunkSize = chunkSize;
+    job->chunkCount = (count + chunkSize - 1) / chunkSize;
+    job->nextChunk = 0;
+    job->doneChunks = 0;
+
+    // One queue entry per helping worker; a worker that arrives late finds no chunks left
+    size_t helpers = job->chunkCount - 1;
+    if (maxThreads > 0 && helpers > maxThreads - 1)
+    {
+        helpers = maxThreads - 1;
+    }
+    if (helpers > 0)
+    {
+        std::lock_guard<std::mutex> lock(g_poolMutex);
+        EnsureWorkers();
+        if (helpers > g_workers.size())
+        {
+            helpers = g_workers.size();
+        }
+        for (size_t i = 0; i < helpers; ++i)
+        {
+            g_queue.push_back(job);
+        }
+    }
+    if (helpers > 1)
+    {
+        g_poolCondition.notify_all();
+    }
+    else if (helpers == 1)
+    {
+        g_poolCondition.notify_one();
+    }
+
+    RunChunks(*job);
+
+    {
+        std::unique_lock<std::mutex> lock(job->doneMutex);
+        job->doneCondition.wait(lock, [&job] { return job->doneChunks.load() == job->chunkCount; });
+    }
+
+    if (job->error)
+    {
+        std::rethrow_exception(job->error);
+    }
+}
+
+size_t LightWorkerPool::ThreadCount()
+{
+    return WorkerTarget() + 1;
+}
+
+void LightWorkerPool::Shutdown()
+{
+    std::vector<std::thread> workers;
+    {
+        std::lock_guard<std::mutex> lock(g_poolMutex);
+        ++g_generation;
+        g_queue.clear();
+        workers.swap(g_workers);
+    }
+    g_poolCondition.notify_all();
+
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+}
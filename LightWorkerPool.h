@@ -0,0 +1,44 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+
+#pragma once
+
+#include "stdafx.h"
+#include <cstddef>
+#include <functional>
+
+/**
+ * @brief Small shared pool of worker threads for splitting encoding work
+ *
+ * ParallelFor cuts a range into fixed-size chunks that the calling thread and
+ * the workers claim one at a time, so the result does not depend on how many
+ * threads took part. Workers are started on first use and stopped by Shutdown.
+ */
+class LightWorkerPool
+{
+public:
+    // Upper bound on worker threads, in addition to the calling thread
+    static const size_t MAX_WORKERS = 15;
+
+    // Runs body(begin, end) for every chunk of [0, count) and returns once all are done.
+    // maxThreads limits the threads used including the caller (0 = whole pool).
+    // An exception thrown by a chunk is rethrown on the calling thread.
+    static void ParallelFor(size_t count, size_t chunkSize,
+        const std::function<void(size_t begin, size_t end)>& body, size_t maxThreads = 0);
+
+    // Threads ParallelFor can use, including the caller
+    static size_t ThreadCount();
+
+    // Stops and joins the workers; the next ParallelFor starts them again
+    static void Shutdown();
+};
@@ -0,0 +1,310 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+#include "stdafx.h"
+#include "LiveDragStreamer.h"
+#include "LightEventWatcher.h"
+#include "LightSyncNetwork.h"
+#include "LightSyncReactor.h"
+#include "LightSyncSubscriptions.h"
+#include "LightSyncTrace.h"
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <unordered_set>
+
+namespace {
+    // Document whose views are sampled while live drag is enabled
+    std::atomic<unsigned int> g_docSerialNumber(0);
+
+    // Samples the dynamic transforms once per redraw, after objects are drawn
+    class CLiveDragConduit : public CRhinoDisplayConduit
+    {
+    public:
+        CLiveDragConduit() : CRhinoDisplayConduit(CSupportChannels::SC_POSTDRAWOBJECTS) {}
+
+        bool ExecConduit(CRhinoDisplayPipeline& dp, UINT nActiveChannel, bool& bTerminateChannel) override
+        {
+            if (nActiveChannel == CSupportChannels::SC_POSTDRAWOBJECTS)
+            {
+                CRhinoDoc* doc = CRhinoDoc::FromRuntimeSerialNumber(g_docSerialNumber.load());
+                if (doc)
+                {
+                    LiveDragStreamer::SampleDocument(*doc);
+                }
+            }
+            return true;
+        }
+    };
+
+    CLiveDragConduit g_conduit;
+    std::atomic<bool> g_enabled(false);
+    std::atomic<double> g_maxRateHz(LiveDragStreamer::DEFAULT_MAX_RATE_HZ);
+    std::atomic<bool> g_udp(false);
+    std::atomic<uint64_t> g_transformSequence(0);
+    std::chrono::steady_clock::time_point g_lastSample;
+
+    // Lights streamed since their last commit (UI thread only)
+    std::unordered_set<ON_UUID, LightUtils::UuidHash> g_streamedLights;
+
+    // Latest sample per receiver port (one TCP payload or its datagrams); older samples are overwritten, never queued
+    std::mutex g_sendMutex;
+    std::map<int, std::vector<std::string>> g_pendingPayloads;
+    bool g_flushPosted = false;
+
+    // TCP messages still being written per port (network thread only)
+    std::map<int, size_t> g_inFlight;
+
+    // Hands the pending samples to the network (network thread). A TCP port whose
+    // previous sample is still being written keeps its newest sample pending until
+    // that write completes, so a slow receiver gets the latest state, not a backlog.
+    void Flush()
+    {
+        LightSyncTrace::Span span("live drag");
+        std::map<int, std::vector<std::string>> payloads;
+        const bool udp = g_udp.load();
+        {
+            std::lock_guard<std::mutex> lock(g_sendMutex);
+            g_flushPosted = false;
+            for (auto it = g_pendingPayloads.begin(); it != g_pendingPayloads.end();)
+            {
+                if (!udp && g_inFlight.count(it->first) != 0)
+                {
+                    ++it;
+                    continue;
+                }
+                payloads[it->first] = std::move(it->second);
+                it = g_pendingPayloads.erase(it);
+            }
+        }
+
+        for (auto& payload : payloads)
+        {
+            const int port = payload.first;
+            if (udp)
+            {
+                LightSyncNetwork::SendDatagrams(payload.second, port);
+                continue;
+            }
+            for (std::string& message : payload.second)
+            {
+                ++g_inFlight[port];
+                const bool queued = LightSyncNetwork::SendPayload(std::move(message), port, [port](bool)
+                {
+                    if (--g_inFlight[port] == 0)
+                    {
+                        g_inFlight.erase(port);
+                        Flush();
+                    }
+                });
+                if (!queued && --g_inFlight[port] == 0)
+                {
+                    g_inFlight.erase(port);
+                }
+            }
+        }
+    }
+
+    std::string TransformRecordJSON(const ON_UUID& lightId, const ON_3dPoint& location, const ON_3dVector& direction)
+    {
+        CLightEventWatcher::FRhinoRotation rotation = CLightEventWatcher::DirectionToRhinoRotation(direction);
+        std::wostringstream json;
+        json << L"{\"uuid\": \"" << LightUtils::UuidToString(lightId) << L"\", "
+            << std::fixed << std::setprecision(6)
+            << L"\"location\": {\"x\": " << location.x << L", \"y\": " << location.y << L", \"z\": " << location.z << L"}, "
+            << std::setprecision(3)
+            << L"\"rotation\": {\"pitch\": " << rotation.pitch << L", \"yaw\": " << rotation.yaw
+            << L", \"roll\": " << rotation.roll << L"}}";
+        return LightSyncNetwork::WStringToUTF8(json.str());
+    }
+
+    // Wraps records [begin, end) in one transform message under the next transform sequence
+    std::string TransformMessage(unsigned int docSerial, const std::vector<std::string>& records, size_t begin, size_t end)
+    {
+        std::string message = "{\"event\": \"Light Transform\", \"document\": " + std::to_string(docSerial) +
+            ", \"partial\": true, \"transformSequence\": " + std::to_string(++g_transformSequence) + ", \"lights\": [";
+        for (size_t i = begin; i < end; ++i)
+        {
+            if (i > begin)
+                message += ", ";
+            message += records[i];
+        }
+        message += "]}";
+        return message;
+    }
+
+    // Room a transform message needs besides its records (header, brackets, separators)
+    constexpr size_t TRANSFORM_MESSAGE_OVERHEAD = 128;
+}
+
+/**
+ * @brief Turns live drag streaming on
+ *
+ * @param docSerialNumber Runtime serial number of the document whose views are sampled
+ * @param maxRateHz Maximum number of transform updates per second
+ * @param channel Whether samples go out over TCP connections or as UDP datagrams
+ */
+void LiveDragStreamer::Enable(unsigned int docSerialNumber, double maxRateHz, Channel channel)
+{
+    g_maxRateHz.store(maxRateHz > 0.0 ? maxRateHz : DEFAULT_MAX_RATE_HZ);
+    g_udp.store(channel == Channel::Udp);
+    g_docSerialNumber.store(docSerialNumber);
+    g_enabled.store(true);
+
+    // Re-enabling moves the conduit to the given document
+    g_conduit.Enable(docSerialNumber);
+}
+
+/**
+ * @brief Turns live drag streaming off and drops samples not yet sent
+ */
+void LiveDragStreamer::Disable()
+{
+    if (!g_enabled.exchange(false))
+    {
+        return;
+    }
+
+    g_conduit.Disable();
+    {
+        std::lock_guard<std::mutex> lock(g_sendMutex);
+        g_pendingPayloads.clear();
+    }
+    g_streamedLights.clear();
+}
+
+bool LiveDragStreamer::IsEnabled()
+{
+    return g_enabled.load();
+}
+
+double LiveDragStreamer::MaxRateHz()
+{
+    return g_maxRateHz.load();
+}
+
+LiveDragStreamer::Channel LiveDragStreamer::TransformChannel()
+{
+    return g_udp.load() ? Channel::Udp : Channel::Tcp;
+}
+
+uint64_t LiveDragStreamer::TransformSequence()
+{
+    return g_transformSequence.load();
+}
+
+/**
+ * @brief Samples the selected lights that are being dynamically transformed
+ *
+ * Builds one compact transform-only message per receiver containing the lights
+ * that receiver streams and hands it to the network thread. On the UDP channel
+ * the lights are split over as many datagrams as needed to keep each one below
+ * MAX_DATAGRAM_BYTES, each under its own transform sequence. Samples arriving
+ * faster than the configured rate are dropped.
+ *
+ * @param doc Document whose lights are sampled
+ */
+void LiveDragStreamer::SampleDocument(CRhinoDoc& doc)
+{
+    if (!g_enabled.load())
+    {
+        return;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    const auto minInterval = std::chrono::duration<double>(1.0 / g_maxRateHz.load());
+    if (now - g_lastSample < minInterval)
+    {
+        return;
+    }
+
+    const double unitScale = CLightEventWatcher::GetModelUnitScaleToMeters(&doc);
+    std::map<int, std::vector<std::string>> records;
+
+    const int lightCount = doc.m_light_table.LightCount();
+    for (int i = 0; i < lightCount; ++i)
+    {
+        const CRhinoLight& rhinoLight = doc.m_light_table[i];
+        if (rhinoLight.IsDeleted() || !rhinoLight.IsSelected())
+            continue;
+
+        ON_Xform xform;
+        if (!rhinoLight.GetDynamicTransform(xform))
+            continue; // Not being dragged
+
+        const ON_Light& light = rhinoLight.Light();
+        ON_3dPoint location = xform * light.Location();
+        location.x *= unitScale;
+        location.y *= unitScale;
+        location.z *= unitScale;
+        const ON_3dVector direction = xform * light.Direction();
+
+        const ON_UUID& lightId = rhinoLight.Attributes().m_uuid;
+        g_streamedLights.insert(lightId);
+
+        const std::vector<int> ports = LightSyncSubscriptions::PortsStreamingLight(doc.RuntimeSerialNumber(), lightId);
+        if (ports.empty())
+            continue;
+
+        const std::string record = TransformRecordJSON(lightId, location, direction);
+        for (int port : ports)
+        {
+            records[port].push_back(record);
+        }
+    }
+
+    if (records.empty())
+    {
+        return;
+    }
+    g_lastSample = now;
+
+    const bool udp = g_udp.load();
+    std::map<int, std::vector<std::string>> payloads;
+    for (const auto& portRecords : records)
+    {
+        const std::vector<std::string>& lights = portRecords.second;
+        std::vector<std::string>& messages = payloads[portRecords.first];
+
+        size_t begin = 0;
+        size_t size = TRANSFORM_MESSAGE_OVERHEAD;
+        for (size_t i = 0; i < lights.size(); ++i)
+        {
+            if (udp && i > begin && size + lights[i].size() > LightSyncNetwork::MAX_DATAGRAM_BYTES)
+            {
+                messages.push_back(TransformMessage(doc.RuntimeSerialNumber(), lights, begin, i));
+                begin = i;
+                size = TRANSFORM_MESSAGE_OVERHEAD;
+            }
+            size += lights[i].size();
+        }
+        messages.push_back(TransformMessage(doc.RuntimeSerialNumber(), lights, begin, lights.size()));
+    }
+
+    std::lock_guard<std::mutex> lock(g_sendMutex);
+    for (auto& payload : payloads)
+    {
+        g_pendingPayloads[payload.first] = std::move(payload.second);
+    }
+    if (!g_flushPosted)
+    {
+        g_flushPosted = LightSyncReactor::Post(Flush);
+    }
+}
+
+bool LiveDragStreamer::ConsumeStreamedLight(const ON_UUID& lightId)
+{
+    return g_streamedLights.erase(lightId) > 0;
+}
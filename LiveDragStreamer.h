@@ -0,0 +1,56 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+#pragma once
+
+#include "stdafx.h"
+#include "LightUtils.h"
+#include <cstdint>
+
+/**
+ * @brief Streams transforms of selected lights while they are being dragged
+ *
+ * Light table events only fire once a transform is committed. When live drag is
+ * enabled, a display conduit samples the dynamic transform of the selected
+ * lights on every redraw, capped at a maximum rate, and sends transform-only
+ * updates for just those lights. The commit on release is then sent as a
+ * partial full-property update for the dragged lights only.
+ *
+ * Every transform message is numbered from one process-wide transform
+ * sequence, and messages with state carry the number current when they were
+ * resolved, so receivers can tell samples that are older than what they show.
+ * On the UDP channel each sample goes out as small datagrams instead of a TCP
+ * connection; the commit stays on TCP.
+ */
+class LiveDragStreamer
+{
+public:
+    enum class Channel { Tcp, Udp };
+
+    static void Enable(unsigned int docSerialNumber, double maxRateHz, Channel channel);
+    static void Disable();
+    static bool IsEnabled();
+    static double MaxRateHz();
+    static Channel TransformChannel();
+
+    // Transform sequence of the newest sample, 0 before the first one
+    static uint64_t TransformSequence();
+
+    // Called by the conduit with the current dynamic transforms (UI thread)
+    static void SampleDocument(CRhinoDoc& doc);
+
+    // Returns true (once) if the light was streamed during a drag and now needs its commit
+    static bool ConsumeStreamedLight(const ON_UUID& lightId);
+
+    // Constants
+    static constexpr double DEFAULT_MAX_RATE_HZ = 60.0;
+};
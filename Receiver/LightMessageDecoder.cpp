@@ -0,0 +1,743 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+
+#include "LightMessageDecoder.h"
+#include "LightQuantizedFormat.h"
+#include <charconv>
+#include <cmath>
+#include <cstring>
+
+namespace {
+    // Nesting allowed for skipped unknown members
+    constexpr int MAX_DEPTH = 32;
+    constexpr double DEGREES_PER_RADIAN = 57.29577951308232;
+
+    int HexValue(char c)
+    {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+    struct StringView
+    {
+        const char* data;
+        size_t size;
+
+        bool Equals(const char* text) const
+        {
+            return strlen(text) == size && memcmp(data, text, size) == 0;
+        }
+    };
+
+    class Cursor
+    {
+    public:
+        Cursor(const char* data, size_t size) : m_begin(data), m_pos(data), m_end(data + size), m_error(nullptr) {}
+
+        const char* Error() const { return m_error; }
+        size_t Offset() const { return static_cast<size_t>(m_pos - m_begin); }
+
+        bool Fail(const char* error)
+        {
+            if (!m_error)
+                m_error = error;
+            return false;
+        }
+
+        void SkipWhitespace()
+        {
+            while (m_pos < m_end && (*m_pos == ' ' || *m_pos == '\t' || *m_pos == '\n' || *m_pos == '\r'))
+                ++m_pos;
+        }
+
+        bool AtEnd()
+        {
+            SkipWhitespace();
+            return m_pos == m_end;
+        }
+
+        bool Peek(char expected)
+        {
+            SkipWhitespace();
+            return m_pos < m_end && *m_pos == expected;
+        }
+
+        bool Consume(char expected)
+        {
+            if (!Peek(expected))
+                return false;
+            ++m_pos;
+            return true;
+        }
+
+        bool Expect(char expected)
+        {
+            return Consume(expected) || Fail("unexpected character");
+        }
+
+        // Raw string contents between the quotes; escapes are left as they are
+        bool String(StringView& view)
+        {
+            if (!Consume('"'))
+                return Fail("expected string");
+            const char* start = m_pos;
+            while (m_pos < m_end && *m_pos != '"')
+            {
+                if (*m_pos == '\\' && m_pos + 1 < m_end)
+                    ++m_pos;
+                ++m_pos;
+            }
+            if (m_pos >= m_end)
+                return Fail("unterminated string");
+            view.data = start;
+            view.size = static_cast<size_t>(m_pos - start);
+            ++m_pos;
+            return true;
+        }
+
+        bool Number(double& value)
+        {
+            SkipWhitespace();
+            const std::from_chars_result result = std::from_chars(m_pos, m_end, value);
+            if (result.ec != std::errc())
+                return Fail("expected number");
+            m_pos = result.ptr;
+            return true;
+        }
+
+        bool Integer(int64_t& value)
+        {
+            SkipWhitespace();
+            const std::from_chars_result result = std::from_chars(m_pos, m_end, value);
+            if (result.ec != std::errc())
+                return Fail("expected integer");
+            m_pos = result.ptr;
+            return true;
+        }
+
+        bool Bool(bool& value)
+        {
+            SkipWhitespace();
+            if (Literal("true"))
+            {
+                value = true;
+                return true;
+            }
+            if (Literal("false"))
+            {
+                value = false;
+                return true;
+            }
+            return Fail("expected boolean");
+        }
+
+        bool Uuid(LightUuid& uuid)
+        {
+            StringView text;
+            return String(text) && (LightUuid::Parse(text.data, text.size, uuid) || Fail("malformed uuid"));
+        }
+
+        // Steps over any value, for members this decoder does not know
+        bool SkipValue(int depth)
+        {
+            if (depth > MAX_DEPTH)
+                return Fail("nesting too deep");
+
+            SkipWhitespace();
+            if (m_pos >= m_end)
+                return Fail("unexpected end of message");
+
+            StringView ignored;
+            switch (*m_pos)
+            {
+            case '"':
+                return String(ignored);
+            case '{':
+                ++m_pos;
+                if (Consume('}'))
+                    return true;
+                do
+                {
+                    if (!String(ignored) || !Expect(':') || !SkipValue(depth + 1))
+                        return false;
+                } while (Consume(','));
+                return Expect('}');
+            case '[':
+                ++m_pos;
+                if (Consume(']'))
+                    return true;
+                do
+                {
+                    if (!SkipValue(depth + 1))
+                        return false;
+                } while (Consume(','));
+                return Expect(']');
+            case 't':
+            case 'f':
+            {
+                bool value = false;
+                return Bool(value);
+            }
+            case 'n':
+                return Literal("null") || Fail("expected null");
+            default:
+            {
+                double value = 0.0;
+                return Number(value);
+            }
+            }
+        }
+
+        // Calls member(key) for each member of an object; member must consume the value
+        template <class MemberFn>
+        bool Object(const MemberFn& member)
+        {
+            if (!Expect('{'))
+                return false;
+            if (Consume('}'))
+                return true;
+            do
+            {
+                StringView key;
+                if (!String(key) || !Expect(':') || !member(key))
+                    return false;
+            } while (Consume(','));
+            return Expect('}');
+        }
+
+        // Calls element() for each element of an array; element must consume it
+        template <class ElementFn>
+        bool Array(const ElementFn& element)
+        {
+            if (!Expect('['))
+                return false;
+            if (Consume(']'))
+                return true;
+            do
+            {
+                if (!element())
+                    return false;
+            } while (Consume(','));
+            return Expect(']');
+        }
+
+    private:
+        bool Literal(const char* literal)
+        {
+            const size_t length = strlen(literal);
+            if (static_cast<size_t>(m_end - m_pos) < length || memcmp(m_pos, literal, length) != 0)
+                return false;
+            m_pos += length;
+            return true;
+        }
+
+        const char* m_begin;
+        const char* m_pos;
+        const char* m_end;
+        const char* m_error;
+    };
+
+    ReceivedLight::Type ParseType(const StringView& name)
+    {
+        if (name.Equals("Directional")) return ReceivedLight::Type::Directional;
+        if (name.Equals("Point")) return ReceivedLight::Type::Point;
+        if (name.Equals("Spot")) return ReceivedLight::Type::Spot;
+        if (name.Equals("Ambient")) return ReceivedLight::Type::Ambient;
+        return ReceivedLight::Type::Unknown;
+    }
+
+    unsigned char ColorComponent(double value)
+    {
+        return static_cast<unsigned char>(value < 0.0 ? 0.0 : (value > 255.0 ? 255.0 : value));
+    }
+
+    bool ParseLight(Cursor& cursor, ReceivedLight& light)
+    {
+        return cursor.Object([&](const StringView& key) {
+            if (key.Equals("uuid"))
+                return cursor.Uuid(light.uuid);
+            if (key.Equals("id"))
+                return cursor.Integer(light.index);
+            if (key.Equals("type"))
+            {
+                StringView name;
+                if (!cursor.String(name))
+                    return false;
+                light.type = ParseType(name);
+                light.members |= ReceivedLight::TYPE;
+                return true;
+            }
+            if (key.Equals("enabled"))
+            {
+                light.members |= ReceivedLight::ENABLED;
+                return cursor.Bool(light.enabled);
+            }
+            if (key.Equals("location"))
+            {
+                light.members |= ReceivedLight::LOCATION;
+                return cursor.Object([&](const StringView& axis) {
+                    if (axis.Equals("x")) return cursor.Number(light.location[0]);
+                    if (axis.Equals("y")) return cursor.Number(light.location[1]);
+                    if (axis.Equals("z")) return cursor.Number(light.location[2]);
+                    return cursor.SkipValue(0);
+                    });
+            }
+            if (key.Equals("rotation"))
+            {
+                light.members |= ReceivedLight::ROTATION;
+                return cursor.Object([&](const StringView& angle) {
+                    if (angle.Equals("pitch")) return cursor.Number(light.pitch);
+                    if (angle.Equals("yaw")) return cursor.Number(light.yaw);
+                    if (angle.Equals("roll")) return cursor.Number(light.roll);
+                    return cursor.SkipValue(0);
+                    });
+            }
+            if (key.Equals("intensity"))
+            {
+                light.members |= ReceivedLight::INTENSITY;
+                return cursor.Number(light.intensity);
+            }
+            if (key.Equals("color"))
+            {
+                light.members |= ReceivedLight::COLOR;
+                return cursor.Object([&](const StringView& channel) {
+                    const int component = channel.Equals("r") ? 0 : (channel.Equals("g") ? 1 : (channel.Equals("b") ? 2 : -1));
+                    if (component < 0)
+                        return cursor.SkipValue(0);
+                    double value = 0.0;
+                    if (!cursor.Number(value))
+                        return false;
+                    light.color[component] = ColorComponent(value);
+                    return true;
+                    });
+            }
+            if (key.Equals("spotLight"))
+            {
+                light.members |= ReceivedLight::SPOT_ANGLES;
+                return cursor.Object([&](const StringView& angle) {
+                    if (angle.Equals("innerAngle")) return cursor.Number(light.innerAngle);
+                    if (angle.Equals("outerAngle")) return cursor.Number(light.outerAngle);
+                    return cursor.SkipValue(0);
+                    });
+            }
+            return cursor.SkipValue(0);
+            });
+    }
+
+    bool ParseUuidArray(Cursor& cursor, std::vector<LightUuid>& ids)
+    {
+        return cursor.Array([&]() {
+            ids.emplace_back();
+            return cursor.Uuid(ids.back());
+            });
+    }
+}
+
+bool LightUuid::operator==(const LightUuid& other) const
+{
+    return memcmp(bytes, other.bytes, sizeof(bytes)) == 0;
+}
+
+std::string LightUuid::ToString() const
+{
+    static const char HEX[] = "0123456789abcdef";
+    std::string text;
+    text.reserve(36);
+    for (size_t i = 0; i < sizeof(bytes); ++i)
+    {
+        if (i == 4 || i == 6 || i == 8 || i == 10)
+            text += '-';
+        text += HEX[bytes[i] >> 4];
+        text += HEX[bytes[i] & 0x0F];
+    }
+    return text;
+}
+
+/**
+ * @brief Parses the canonical 8-4-4-4-12 hex form of an id
+ *
+ * @param text Characters of the id, not necessarily terminated
+ * @param length Number of characters, must be 36
+ * @param uuid Receives the id
+ * @return False if the text is not a canonical id
+ */
+bool LightUuid::Parse(const char* text, size_t length, LightUuid& uuid)
+{
+    if (length != 36)
+        return false;
+
+    size_t byte = 0;
+    for (size_t i = 0; i < length;)
+    {
+        if (i == 8 || i == 13 || i == 18 || i == 23)
+        {
+            if (text[i] != '-')
+                return false;
+            ++i;
+            continue;
+        }
+        const int high = HexValue(text[i]);
+        const int low = HexValue(text[i + 1]);
+        if (high < 0 || low < 0)
+            return false;
+        uuid.bytes[byte++] = static_cast<unsigned char>((high << 4) | low);
+        i += 2;
+    }
+    return byte == sizeof(uuid.bytes);
+}
+
+size_t LightUuid::Hash::operator()(const LightUuid& uuid) const
+{
+    // Ids are random; fold the 128 bits into a size_t
+    uint64_t words[2];
+    memcpy(words, uuid.bytes, sizeof(words));
+    return static_cast<size_t>(words[0] ^ (words[1] * 0x9E3779B97F4A7C15ULL));
+}
+
+ReceivedLight::ReceivedLight()
+    : uuid(), index(-1), members(0), type(Type::Unknown), enabled(true), location{ 0.0, 0.0, 0.0 },
+    pitch(0.0), yaw(0.0), roll(0.0), intensity(0.0), color{ 0, 0, 0 }, innerAngle(0.0), outerAngle(0.0)
+{
+}
+
+LightMessage::LightMessage()
+{
+    Clear();
+}
+
+void LightMessage::Clear()
+{
+    kind = Kind::Other;
+    event = "";
+    eventLength = 0;
+    document = -1;
+    sequence = -1;
+    transformSequence = -1;
+    version = -1;
+    lightCount = 0;
+    partial = false;
+    regionScoped = false;
+    batchIndex = 0;
+    batchCount = 1;
+    totalLightCount = 0;
+    lights.clear();
+    entered.clear();
+    left.clear();
+}
+
+bool LightMessage::IsEvent(const char* name) const
+{
+    return strlen(name) == eventLength && memcmp(event, name, eventLength) == 0;
+}
+
+/**
+ * @brief Decodes one light data, transform or sun study message
+ *
+ * @param data UTF-8 message as received (one connection's worth of bytes)
+ * @param size Number of bytes
+ * @param message Cleared and filled with the header and records
+ * @return False if the bytes are not a well-formed message; see Error()
+ */
+bool LightMessageDecoder::Decode(const char* data, size_t size, LightMessage& message)
+{
+    message.Clear();
+    if (size >= 2 && static_cast<unsigned char>(data[0]) == LightQuantizedFormat::MAGIC[0] &&
+        static_cast<unsigned char>(data[1]) == LightQuantizedFormat::MAGIC[1])
+    {
+        return DecodeQuantized(data, size, message);
+    }
+    Cursor cursor(data, size);
+
+    const bool parsed = cursor.Object([&](const StringView& key) {
+        if (key.Equals("event"))
+        {
+            StringView event;
+            if (!cursor.String(event))
+                return false;
+            message.event = event.data;
+            message.eventLength = event.size;
+            message.kind = event.Equals("Sun Study") ? LightMessage::Kind::SunStudy : LightMessage::Kind::LightData;
+            return true;
+        }
+        if (key.Equals("document"))
+            return cursor.Integer(message.document);
+        if (key.Equals("sequence"))
+            return cursor.Integer(message.sequence);
+        if (key.Equals("transformSequence"))
+            return cursor.Integer(message.transformSequence);
+        if (key.Equals("version"))
+            return cursor.Integer(message.version);
+        if (key.Equals("lightCount"))
+        {
+            int64_t count = 0;
+            if (!cursor.Integer(count))
+                return false;
+            message.lightCount = count > 0 ? static_cast<size_t>(count) : 0;
+            return true;
+        }
+        if (key.Equals("partial"))
+            return cursor.Bool(message.partial);
+        if (key.Equals("regionScoped"))
+            return cursor.Bool(message.regionScoped);
+        if (key.Equals("batch"))
+        {
+            return cursor.Object([&](const StringView& member) {
+                int64_t value = 0;
+                if (!member.Equals("index") && !member.Equals("count") && !member.Equals("totalLightCount"))
+                    return cursor.SkipValue(0);
+                if (!cursor.Integer(value))
+                    return false;
+                const size_t count = value > 0 ? static_cast<size_t>(value) : 0;
+                if (member.Equals("index")) message.batchIndex = count;
+                else if (member.Equals("count")) message.batchCount = count;
+                else message.totalLightCount = count;
+                return true;
+                });
+        }
+        if (key.Equals("entered"))
+            return ParseUuidArray(cursor, message.entered);
+        if (key.Equals("left"))
+            return ParseUuidArray(cursor, message.left);
+        if (key.Equals("lights") && message.kind != LightMessage::Kind::SunStudy)
+        {
+            // lightCount precedes the array, so the records fit without regrowing
+            message.lights.reserve(message.lightCount);
+            return cursor.Array([&]() {
+                message.lights.emplace_back();
+                return ParseLight(cursor, message.lights.back());
+                });
+        }
+        return cursor.SkipValue(0);
+        });
+
+    if (!parsed || !cursor.AtEnd())
+    {
+        m_error = cursor.Error() ? cursor.Error() : "trailing characters after message";
+        m_errorOffset = cursor.Offset();
+        return false;
+    }
+
+    m_error = "";
+    m_errorOffset = 0;
+    return true;
+}
+
+/**
+ * @brief Decodes a quantized light data message
+ *
+ * Complete scenes (re)fill the handle table when they are not older than it;
+ * partial records may only use handles of the scene with their own sequence.
+ *
+ * @param data Message starting with the quantized magic bytes
+ * @param size Number of bytes
+ * @param message Cleared message to fill
+ * @return False if the bytes are not a well-formed quantized message
+ */
+bool LightMessageDecoder::DecodeQuantized(const char* data, size_t size, LightMessage& message)
+{
+    using namespace LightQuantizedFormat;
+
+    const unsigned char* const begin = reinterpret_cast<const unsigned char*>(data);
+    const unsigned char* const end = begin + size;
+    const unsigned char* pos = begin + sizeof(MAGIC);
+    const auto fail = [&](const char* error) {
+        m_error = error;
+        m_errorOffset = static_cast<size_t>(pos - begin);
+        return false;
+    };
+    const auto have = [&](size_t bytes) { return static_cast<size_t>(end - pos) >= bytes; };
+    const auto readUuid = [&](LightUuid& uuid) {
+        if (!have(UUID_BYTES))
+            return false;
+        memcpy(uuid.bytes, pos, UUID_BYTES);
+        pos += UUID_BYTES;
+        return true;
+    };
+
+    if (!have(2))
+        return fail("truncated header");
+    if (*pos++ != FORMAT_VERSION)
+        return fail("unsupported quantized format version");
+    const unsigned char flags = *pos++;
+
+    uint64_t document = 0, sequence = 0, version = 0, transformSequence = 0, eventLength = 0;
+    if (!ReadVarint(pos, end, document) || !ReadVarint(pos, end, sequence) || !ReadVarint(pos, end, version) ||
+        !ReadVarint(pos, end, transformSequence) || !ReadVarint(pos, end, eventLength) || !have(eventLength))
+        return fail("truncated header");
+    message.kind = LightMessage::Kind::LightData;
+    message.document = static_cast<int64_t>(document);
+    message.sequence = static_cast<int64_t>(sequence);
+    message.version = version > 0 ? static_cast<int64_t>(version) : -1;
+    message.transformSequence = transformSequence > 0 ? static_cast<int64_t>(transformSequence) : -1;
+    message.event = reinterpret_cast<const char*>(pos);
+    message.eventLength = static_cast<size_t>(eventLength);
+    pos += eventLength;
+    message.partial = (flags & FLAG_PARTIAL) != 0;
+    message.regionScoped = (flags & FLAG_REGION_SCOPED) != 0;
+
+    uint64_t batchIndex = 0, batchCount = 1, totalLightCount = 0, firstIndex = 0;
+    if ((flags & FLAG_BATCHED) != 0 &&
+        (!ReadVarint(pos, end, batchIndex) || !ReadVarint(pos, end, batchCount) || !ReadVarint(pos, end, totalLightCount)))
+        return fail("truncated batch");
+    if (!message.partial && !ReadVarint(pos, end, firstIndex))
+        return fail("truncated header");
+    message.batchIndex = static_cast<size_t>(batchIndex);
+    message.batchCount = static_cast<size_t>(batchCount);
+    message.totalLightCount = static_cast<size_t>(totalLightCount);
+
+    uint64_t stepMicrometers = 0;
+    uint64_t origin[3] = { 0, 0, 0 };
+    if (!ReadVarint(pos, end, stepMicrometers) || !ReadVarint(pos, end, origin[0]) ||
+        !ReadVarint(pos, end, origin[1]) || !ReadVarint(pos, end, origin[2]))
+        return fail("truncated origin");
+    const double step = static_cast<double>(stepMicrometers) * 1e-6;
+    const int64_t originSteps[3] = { UnZigZag(origin[0]), UnZigZag(origin[1]), UnZigZag(origin[2]) };
+
+    if (message.regionScoped)
+    {
+        for (std::vector<LightUuid>* ids : { &message.entered, &message.left })
+        {
+            uint64_t count = 0;
+            if (!ReadVarint(pos, end, count) || count > static_cast<uint64_t>(end - pos) / UUID_BYTES)
+                return fail("truncated id list");
+            ids->resize(static_cast<size_t>(count));
+            for (LightUuid& id : *ids)
+                readUuid(id);
+        }
+    }
+
+    // Every record takes at least two bytes, which bounds what a bad count can reserve
+    uint64_t lightCount = 0;
+    if (!ReadVarint(pos, end, lightCount) || lightCount > static_cast<uint64_t>(end - pos) / 2)
+        return fail("invalid light count");
+    message.lightCount = static_cast<size_t>(lightCount);
+    if (!message.partial && firstIndex + lightCount > ((flags & FLAG_BATCHED) != 0 ? totalLightCount : lightCount))
+        return fail("records exceed the scene");
+
+    // A complete scene no older than the table replaces it (batches of one scene extend it)
+    bool recordHandles = false;
+    if (!message.partial && message.sequence >= m_handleSequence)
+    {
+        if (message.sequence != m_handleSequence || batchIndex == 0)
+            m_handles.clear();
+        m_handleSequence = message.sequence;
+        recordHandles = true;
+    }
+
+    message.lights.reserve(message.lightCount);
+    for (uint64_t i = 0; i < lightCount; ++i)
+    {
+        if (!have(1))
+            return fail("truncated record");
+        const unsigned char fields = *pos++;
+        message.lights.emplace_back();
+        ReceivedLight& light = message.lights.back();
+
+        if ((fields & RECORD_COMPLETE) != 0)
+        {
+            if (!readUuid(light.uuid) || !have(1))
+                return fail("truncated record");
+            const unsigned char type = *pos++;
+            light.type = type <= static_cast<unsigned char>(ReceivedLight::Type::Ambient) ?
+                static_cast<ReceivedLight::Type>(type) : ReceivedLight::Type::Unknown;
+            light.index = static_cast<int64_t>(firstIndex + i);
+            light.members = ReceivedLight::TYPE | (fields & (FIELD_LOCATION | FIELD_DIRECTION | FIELD_INTENSITY |
+                FIELD_COLOR | FIELD_SPOT_ANGLES));
+            if (recordHandles)
+            {
+                const size_t index = static_cast<size_t>(firstIndex + i);
+                if (index >= m_handles.size())
+                    m_handles.resize(index + 1);
+                m_handles[index] = light.uuid;
+            }
+        }
+        else
+        {
+            light.members = fields & (FIELD_LOCATION | FIELD_DIRECTION | FIELD_INTENSITY | FIELD_COLOR |
+                FIELD_SPOT_ANGLES | FIELD_ENABLED);
+            if ((fields & RECORD_HANDLE) != 0)
+            {
+                uint64_t handle = 0;
+                if (!ReadVarint(pos, end, handle))
+                    return fail("truncated record");
+                if (m_handleSequence != message.sequence || handle >= m_handles.size())
+                    return fail("light handle of a scene this decoder has not seen");
+                light.uuid = m_handles[static_cast<size_t>(handle)];
+            }
+            else if (!readUuid(light.uuid))
+            {
+                return fail("truncated record");
+            }
+        }
+
+        // Members follow in the plug-in's schema order
+        if ((fields & RECORD_COMPLETE) == 0 && (fields & FIELD_ENABLED) != 0)
+        {
+            if (!have(1))
+                return fail("truncated enabled flag");
+            light.enabled = *pos++ != 0;
+        }
+        if ((fields & FIELD_LOCATION) != 0)
+        {
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                uint64_t offset = 0;
+                if (!ReadVarint(pos, end, offset))
+                    return fail("truncated location");
+                light.location[axis] = static_cast<double>(originSteps[axis] + static_cast<int64_t>(offset)) * step;
+            }
+        }
+        if ((fields & FIELD_DIRECTION) != 0)
+        {
+            if (!have(4))
+                return fail("truncated direction");
+            double x = 0.0, y = 0.0, z = 0.0;
+            DecodeOctahedral(ReadU16(pos), ReadU16(pos + 2), x, y, z);
+            pos += 4;
+            light.pitch = std::asin(-z) * DEGREES_PER_RADIAN;
+            light.yaw = std::atan2(y, x) * DEGREES_PER_RADIAN;
+            light.roll = 0.0;
+        }
+        if ((fields & FIELD_INTENSITY) != 0)
+        {
+            if (!have(4))
+                return fail("truncated intensity");
+            light.intensity = ReadFloat(pos);
+            pos += 4;
+        }
+        if ((fields & FIELD_COLOR) != 0)
+        {
+            if (!have(3))
+                return fail("truncated color");
+            memcpy(light.color, pos, 3);
+            pos += 3;
+        }
+        if ((fields & FIELD_SPOT_ANGLES) != 0)
+        {
+            if (!have(4))
+                return fail("truncated spot angles");
+            light.innerAngle = DequantizeAngle(ReadU16(pos));
+            light.outerAngle = DequantizeAngle(ReadU16(pos + 2));
+            pos += 4;
+        }
+    }
+
+    if (pos != end)
+        return fail("trailing bytes after message");
+
+    m_error = "";
+    m_errorOffset = 0;
+    return true;
+}
@@ -0,0 +1,148 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+#pragma once
+
+// Standalone: no stdafx.h, Rhino or Windows headers, so receivers can compile it as is
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 128-bit light id as parsed from its canonical text form
+ *
+ * Bytes are kept in text order, which is all a receiver needs to compare ids.
+ */
+struct LightUuid
+{
+    unsigned char bytes[16];
+
+    bool operator==(const LightUuid& other) const;
+    bool operator!=(const LightUuid& other) const { return !(*this == other); }
+
+    // Canonical lower-case "xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx" form
+    std::string ToString() const;
+
+    // Parses 36 characters of canonical text, returns false if malformed
+    static bool Parse(const char* text, size_t length, LightUuid& uuid);
+
+    struct Hash
+    {
+        size_t operator()(const LightUuid& uuid) const;
+    };
+};
+
+/**
+ * @brief One light record of a received message, flat and fixed-size
+ *
+ * members tells which values the record carried; the bits match the sender's
+ * "fields" mask, plus TYPE for complete records (which carry every member
+ * except SPOT_ANGLES on non-spot lights).
+ */
+struct ReceivedLight
+{
+    enum Member : unsigned int
+    {
+        LOCATION = 1 << 0,
+        ROTATION = 1 << 1,
+        INTENSITY = 1 << 2,
+        COLOR = 1 << 3,
+        SPOT_ANGLES = 1 << 4,
+        ENABLED = 1 << 5,
+        TYPE = 1 << 6
+    };
+
+    enum class Type : unsigned char { Unknown, Directional, Point, Spot, Ambient };
+
+    LightUuid uuid;
+    int64_t index;          // Scene position ("id") of complete records, -1 otherwise
+    unsigned int members;
+    Type type;
+    bool enabled;
+    double location[3];     // Meters
+    double pitch, yaw, roll;
+    double intensity;
+    unsigned char color[3]; // RGB
+    double innerAngle, outerAngle;
+
+    ReceivedLight();
+};
+
+/**
+ * @brief Header and records of one decoded message
+ *
+ * Reused across messages: Clear keeps the capacity of the arrays, so decoding
+ * a message no larger than an earlier one does not allocate. event points into
+ * the decoded buffer and is only valid while that buffer is.
+ */
+struct LightMessage
+{
+    enum class Kind { LightData, SunStudy, Other };
+
+    Kind kind;
+    const char* event;          // Raw event name, not terminated
+    size_t eventLength;
+    int64_t document;           // Sending document's runtime serial number, -1 if absent
+    int64_t sequence;           // -1 if the message has none (live drag transforms)
+    int64_t transformSequence;  // Orders transform samples against other messages, -1 if absent
+    int64_t version;            // Sender's scene version once this message is applied, -1 if absent
+    size_t lightCount;
+    bool partial;
+    bool regionScoped;
+    size_t batchIndex;
+    size_t batchCount;          // 1 unless the scene is split into batches
+    size_t totalLightCount;
+    std::vector<ReceivedLight> lights;
+    std::vector<LightUuid> entered;
+    std::vector<LightUuid> left;
+
+    LightMessage();
+    void Clear();
+    bool IsEvent(const char* name) const;
+};
+
+/**
+ * @brief Decodes the light sync plug-in's messages in place
+ *
+ * Walks the UTF-8 message text once with a cursor, reading numbers and ids
+ * straight from the buffer without building a tree or copying strings.
+ * Members it does not know are skipped, so newer senders stay readable.
+ *
+ * Quantized messages (see LightQuantizedFormat.h) are recognized by their
+ * first bytes. Their partial records name lights by scene index, so the
+ * decoder keeps the ids of the newest complete quantized scene: one decoder
+ * should see every message of its receiver. A partial record naming a scene
+ * this decoder did not see fails to decode, and the receiver should resume.
+ */
+class LightMessageDecoder
+{
+public:
+    // Decodes one complete message; on failure message is left partially filled
+    bool Decode(const char* data, size_t size, LightMessage& message);
+
+    // Why and where the last Decode failed
+    const char* Error() const { return m_error; }
+    size_t ErrorOffset() const { return m_errorOffset; }
+
+    LightMessageDecoder() : m_error(""), m_errorOffset(0), m_handleSequence(-1) {}
+
+private:
+    bool DecodeQuantized(const char* data, size_t size, LightMessage& message);
+
+    const char* m_error;
+    size_t m_errorOffset;
+
+    // Ids by scene index of the newest complete quantized scene
+    std::vector<LightUuid> m_handles;
+    int64_t m_handleSequence;
+};
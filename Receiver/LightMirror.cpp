@@ -0,0 +1,208 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+
+#include "LightMirror.h"
+
+/**
+ * @brief Applies a decoded message to the mirror
+ *
+ * A complete scene with a newer sequence replaces the mirror; further batches
+ * of that sequence are merged into it. Partial messages update or remove the
+ * listed lights. Messages without a sequence (live drag transforms) apply unless
+ * they carry a transform sequence that is not newer than what the lights show.
+ *
+ * @param message Successfully decoded message
+ * @return Applied, Stale if a newer scene already superseded it, or Ignored for
+ *         messages that carry no lights (sun studies)
+ */
+LightMirror::Result LightMirror::Apply(const LightMessage& message)
+{
+    if (message.kind != LightMessage::Kind::LightData)
+    {
+        return Result::Ignored;
+    }
+
+    if (message.sequence < 0 && message.transformSequence >= 0)
+    {
+        return ApplyTransformSample(message);
+    }
+
+    if (message.sequence >= 0)
+    {
+        if (message.sequence < m_sequence)
+        {
+            return Result::Stale;
+        }
+        if (!message.partial && message.sequence > m_sequence)
+        {
+            Clear();
+            m_sequence = message.sequence;
+        }
+    }
+
+    // Samples taken before this message was resolved are older than its lights
+    if (message.transformSequence > m_transformFloor)
+    {
+        m_transformFloor = message.transformSequence;
+    }
+
+    // A scene from another document starts the version over; a batched scene counts once complete
+    const bool complete = message.batchIndex + 1 >= message.batchCount;
+    if (message.version >= 0 && complete && (message.document != m_document || message.version > m_version))
+    {
+        m_document = message.document;
+        m_version = message.version;
+    }
+
+    if (message.partial)
+    {
+        for (const LightUuid& uuid : message.left)
+        {
+            Remove(uuid);
+        }
+    }
+
+    for (const ReceivedLight& light : message.lights)
+    {
+        if ((light.members & ReceivedLight::ENABLED) && !light.enabled)
+        {
+            Remove(light.uuid);
+        }
+        else
+        {
+            Upsert(light);
+        }
+    }
+    return Result::Applied;
+}
+
+/**
+ * @brief Applies a sequence-numbered transform sample
+ *
+ * Samples are idempotent (they carry absolute values), so a lost one is simply
+ * replaced by the next. A light keeps its state when it already shows a newer
+ * sample, or when a message with state resolved after the sample was applied.
+ *
+ * @param message Transform message carrying a transform sequence
+ * @return Applied if at least one light took the sample, Stale otherwise
+ */
+LightMirror::Result LightMirror::ApplyTransformSample(const LightMessage& message)
+{
+    if (message.transformSequence <= m_transformFloor)
+    {
+        return Result::Stale;
+    }
+
+    bool applied = false;
+    for (const ReceivedLight& light : message.lights)
+    {
+        if (m_slots.find(light.uuid) == m_slots.end())
+        {
+            continue;
+        }
+
+        int64_t& lastSample = m_transformSequences[light.uuid];
+        if (lastSample >= message.transformSequence)
+        {
+            continue;
+        }
+        lastSample = message.transformSequence;
+        Upsert(light);
+        applied = true;
+    }
+    return applied ? Result::Applied : Result::Stale;
+}
+
+const ReceivedLight* LightMirror::Find(const LightUuid& uuid) const
+{
+    auto slot = m_slots.find(uuid);
+    return slot == m_slots.end() ? nullptr : &m_lights[slot->second];
+}
+
+void LightMirror::Clear()
+{
+    m_lights.clear();
+    m_slots.clear();
+    m_transformSequences.clear();
+}
+
+void LightMirror::Upsert(const ReceivedLight& light)
+{
+    auto slot = m_slots.find(light.uuid);
+    if (slot == m_slots.end())
+    {
+        // Only complete records can introduce a light
+        if (!(light.members & ReceivedLight::TYPE))
+        {
+            return;
+        }
+        m_slots.emplace(light.uuid, m_lights.size());
+        m_lights.push_back(light);
+        return;
+    }
+
+    ReceivedLight& mirrored = m_lights[slot->second];
+    if (light.members & ReceivedLight::TYPE)
+    {
+        mirrored = light;
+        return;
+    }
+
+    if (light.members & ReceivedLight::LOCATION)
+    {
+        mirrored.location[0] = light.location[0];
+        mirrored.location[1] = light.location[1];
+        mirrored.location[2] = light.location[2];
+    }
+    if (light.members & ReceivedLight::ROTATION)
+    {
+        mirrored.pitch = light.pitch;
+        mirrored.yaw = light.yaw;
+        mirrored.roll = light.roll;
+    }
+    if (light.members & ReceivedLight::INTENSITY)
+    {
+        mirrored.intensity = light.intensity;
+    }
+    if (light.members & ReceivedLight::COLOR)
+    {
+        mirrored.color[0] = light.color[0];
+        mirrored.color[1] = light.color[1];
+        mirrored.color[2] = light.color[2];
+    }
+    if (light.members & ReceivedLight::SPOT_ANGLES)
+    {
+        mirrored.innerAngle = light.innerAngle;
+        mirrored.outerAngle = light.outerAngle;
+    }
+}
+
+void LightMirror::Remove(const LightUuid& uuid)
+{
+    auto slot = m_slots.find(uuid);
+    if (slot == m_slots.end())
+    {
+        return;
+    }
+
+    // Swap with the last light to keep the array dense
+    const size_t index = slot->second;
+    m_slots.erase(slot);
+    m_transformSequences.erase(uuid);
+    if (index + 1 < m_lights.size())
+    {
+        m_lights[index] = m_lights.back();
+        m_slots[m_lights[index].uuid] = index;
+    }
+    m_lights.pop_back();
+}
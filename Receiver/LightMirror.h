@@ -0,0 +1,64 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+#pragma once
+
+#include "LightMessageDecoder.h"
+#include <unordered_map>
+
+/**
+ * @brief Local copy of the sender's light set, kept current from decoded messages
+ *
+ * Complete scene messages replace the mirror (batches of one sequence are
+ * merged), partial messages update only the members they carry, and messages
+ * older than the current sequence are dropped because a newer scene already
+ * superseded them. Transform samples (which may arrive as UDP datagrams, out of
+ * order or not at all) are dropped per light when a newer sample or a newer
+ * message with state was already applied.
+ */
+class LightMirror
+{
+public:
+    enum class Result { Applied, Stale, Ignored };
+
+    LightMirror() : m_sequence(-1), m_document(-1), m_version(-1), m_transformFloor(-1) {}
+
+    Result Apply(const LightMessage& message);
+
+    size_t Count() const { return m_lights.size(); }
+    const ReceivedLight& At(size_t index) const { return m_lights[index]; }
+    const ReceivedLight* Find(const LightUuid& uuid) const;
+
+    // Sequence of the newest scene applied, -1 before the first one
+    int64_t Sequence() const { return m_sequence; }
+
+    // Document and scene version of the newest message applied, to send in a resume request (-1 if none)
+    int64_t Document() const { return m_document; }
+    int64_t Version() const { return m_version; }
+
+    void Clear();
+
+private:
+    Result ApplyTransformSample(const LightMessage& message);
+    void Upsert(const ReceivedLight& light);
+    void Remove(const LightUuid& uuid);
+
+    std::vector<ReceivedLight> m_lights;
+    std::unordered_map<LightUuid, size_t, LightUuid::Hash> m_slots;
+    int64_t m_sequence;
+    int64_t m_document;
+    int64_t m_version;
+
+    // Transform sequence of the newest sample applied per light, and of the newest stateful message
+    std::unordered_map<LightUuid, int64_t, LightUuid::Hash> m_transformSequences;
+    int64_t m_transformFloor;
+};
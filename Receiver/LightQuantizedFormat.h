@@ -0,0 +1,221 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+#pragma once
+
+// Standalone: shared by the plug-in's encoder and the receiver library's decoder
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+/**
+ * @brief Layout and quantization of compact light data messages
+ *
+ * Receivers that subscribe with "encoding": "quantized" get their light data
+ * messages in this binary form instead of JSON. All integers are unsigned
+ * LEB128 varints unless stated; signed ones are zigzag encoded first.
+ *
+ * Header:
+ *   'L' 'Q' FORMAT_VERSION flags(u8)
+ *   document sequence version transformSequence (varints, 0 = absent)
+ *   event length, event UTF-8 bytes
+ *   if BATCHED: batch index, batch count, total light count
+ *   first scene index of the records (complete messages only)
+ *   position step in micrometers, origin x y z (signed, in steps)
+ *   if REGION_SCOPED: entered count + 16-byte ids, left count + 16-byte ids
+ *   light count
+ *
+ * Record:
+ *   fields(u8): the LightUtils field bits of the members present, with
+ *   RECORD_COMPLETE (the TYPE bit) for a complete record and RECORD_HANDLE
+ *   when the light is named by a handle instead of its 16-byte id.
+ *   Members follow the id in the plug-in's schema order (LightSchema.h):
+ *   type, enabled, location, direction, intensity, color, spot angles.
+ *   Complete records carry the 16-byte id, type (u8, ReceivedLight::Type) and
+ *   the members of their field bits, so spot angles only for spot lights;
+ *   their scene index is the first scene index plus their position in the
+ *   message. Partial records carry the handle or id, then the members of their
+ *   field bits (enabled as u8).
+ *
+ * A handle is the scene index a light had in the receiver's complete message
+ * with the same sequence; the encoder only uses one after that message was
+ * sent successfully, and names lights by id again after a failed send or a
+ * resume, so a decoder that missed the scene can still apply partials.
+ *
+ * Members and their error bounds:
+ *   location    unsigned offsets from the origin, in steps: |error| <= step / 2 per axis
+ *   direction   octahedral, 2 x u16: under 0.01 degrees
+ *   intensity   float32: relative error under 6e-8
+ *   color       RGB8: exact (Rhino colors are 8-bit)
+ *   spot angles 2 x u16 over 0..180 degrees: under 0.0014 degrees
+ *
+ * Ids are written in the byte order of their text form, as LightUuid keeps them.
+ */
+namespace LightQuantizedFormat
+{
+    constexpr unsigned char MAGIC[2] = { 'L', 'Q' };
+    constexpr unsigned char FORMAT_VERSION = 2;
+
+    // Header flags
+    constexpr unsigned char FLAG_PARTIAL = 1 << 0;
+    constexpr unsigned char FLAG_REGION_SCOPED = 1 << 1;
+    constexpr unsigned char FLAG_BATCHED = 1 << 2;
+
+    // Record field bits (bits 0-5 are the LightUtils / ReceivedLight members)
+    constexpr unsigned char FIELD_LOCATION = 1 << 0;
+    constexpr unsigned char FIELD_DIRECTION = 1 << 1;
+    constexpr unsigned char FIELD_INTENSITY = 1 << 2;
+    constexpr unsigned char FIELD_COLOR = 1 << 3;
+    constexpr unsigned char FIELD_SPOT_ANGLES = 1 << 4;
+    constexpr unsigned char FIELD_ENABLED = 1 << 5;
+    constexpr unsigned char RECORD_COMPLETE = 1 << 6;
+    constexpr unsigned char RECORD_HANDLE = 1 << 7;
+
+    constexpr size_t UUID_BYTES = 16;
+    constexpr double DEFAULT_POSITION_STEP = 0.001;  // Meters
+    constexpr double MIN_POSITION_STEP = 0.000001;
+    constexpr double MAX_POSITION_STEP = 1.0;
+    constexpr double MAX_SPOT_ANGLE = 180.0;
+
+    inline void AppendVarint(std::string& out, uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            out += static_cast<char>((value & 0x7F) | 0x80);
+            value >>= 7;
+        }
+        out += static_cast<char>(value);
+    }
+
+    // Advances pos past the varint; false if it runs past end or is longer than 64 bits
+    inline bool ReadVarint(const unsigned char*& pos, const unsigned char* end, uint64_t& value)
+    {
+        value = 0;
+        for (unsigned int shift = 0; shift < 64 && pos < end; shift += 7)
+        {
+            const unsigned char byte = *pos++;
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+                return true;
+        }
+        return false;
+    }
+
+    inline uint64_t ZigZag(int64_t value)
+    {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    inline int64_t UnZigZag(uint64_t value)
+    {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    inline void AppendU16(std::string& out, uint16_t value)
+    {
+        out += static_cast<char>(value & 0xFF);
+        out += static_cast<char>(value >> 8);
+    }
+
+    inline uint16_t ReadU16(const unsigned char* pos)
+    {
+        return static_cast<uint16_t>(pos[0] | (pos[1] << 8));
+    }
+
+    inline void AppendFloat(std::string& out, float value)
+    {
+        uint32_t bits = 0;
+        memcpy(&bits, &value, sizeof(bits));
+        for (int i = 0; i < 4; ++i)
+        {
+            out += static_cast<char>((bits >> (8 * i)) & 0xFF);
+        }
+    }
+
+    inline float ReadFloat(const unsigned char* pos)
+    {
+        const uint32_t bits = static_cast<uint32_t>(pos[0]) | (static_cast<uint32_t>(pos[1]) << 8) |
+            (static_cast<uint32_t>(pos[2]) << 16) | (static_cast<uint32_t>(pos[3]) << 24);
+        float value = 0.0f;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    inline uint16_t QuantizeUnit(double value)
+    {
+        const double clamped = value < -1.0 ? -1.0 : (value > 1.0 ? 1.0 : value);
+        return static_cast<uint16_t>(std::lround((clamped * 0.5 + 0.5) * 65535.0));
+    }
+
+    inline double DequantizeUnit(uint16_t value)
+    {
+        return value / 65535.0 * 2.0 - 1.0;
+    }
+
+    /**
+     * @brief Maps a direction onto the octahedron unfolded into the unit square
+     *
+     * A zero vector encodes as +Z.
+     */
+    inline void EncodeOctahedral(double x, double y, double z, uint16_t& u, uint16_t& v)
+    {
+        const double norm = std::fabs(x) + std::fabs(y) + std::fabs(z);
+        if (norm <= 0.0)
+        {
+            u = v = QuantizeUnit(0.0);
+            return;
+        }
+        double px = x / norm;
+        double py = y / norm;
+        if (z < 0.0)
+        {
+            const double fx = (1.0 - std::fabs(py)) * (px >= 0.0 ? 1.0 : -1.0);
+            const double fy = (1.0 - std::fabs(px)) * (py >= 0.0 ? 1.0 : -1.0);
+            px = fx;
+            py = fy;
+        }
+        u = QuantizeUnit(px);
+        v = QuantizeUnit(py);
+    }
+
+    // Unit direction of an encoded pair
+    inline void DecodeOctahedral(uint16_t u, uint16_t v, double& x, double& y, double& z)
+    {
+        x = DequantizeUnit(u);
+        y = DequantizeUnit(v);
+        z = 1.0 - std::fabs(x) - std::fabs(y);
+        if (z < 0.0)
+        {
+            const double fx = (1.0 - std::fabs(y)) * (x >= 0.0 ? 1.0 : -1.0);
+            const double fy = (1.0 - std::fabs(x)) * (y >= 0.0 ? 1.0 : -1.0);
+            x = fx;
+            y = fy;
+        }
+        const double length = std::sqrt(x * x + y * y + z * z);
+        x /= length;
+        y /= length;
+        z /= length;
+    }
+
+    inline uint16_t QuantizeAngle(double degrees)
+    {
+        const double clamped = degrees < 0.0 ? 0.0 : (degrees > MAX_SPOT_ANGLE ? MAX_SPOT_ANGLE : degrees);
+        return static_cast<uint16_t>(std::lround(clamped / MAX_SPOT_ANGLE * 65535.0));
+    }
+
+    inline double DequantizeAngle(uint16_t value)
+    {
+        return value / 65535.0 * MAX_SPOT_ANGLE;
+    }
+}
@@ -0,0 +1,347 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+#include "stdafx.h"
+#include "SunStudy.h"
+#include "LightEventWatcher.h"
+#include "LightUtils.h"
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+    constexpr double DEG_TO_RAD = ON_PI / 180.0;
+    constexpr double RAD_TO_DEG = 180.0 / ON_PI;
+
+    // Altitude (degrees) above which the sun has its full noon color
+    constexpr double FULL_COLOR_ALTITUDE = 30.0;
+
+    // Color channels may differ by this much before a keyframe is required
+    constexpr int COLOR_TOLERANCE = 2;
+
+    bool IsLeapYear(int year)
+    {
+        return (year % 4 == 0 && year % 100 != 0) || (year % 400 == 0);
+    }
+
+    int DayOfYear(int year, int month, int day)
+    {
+        static const int cumulativeDays[12] = { 0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334 };
+        const bool leapYear = IsLeapYear(year);
+        const int clampedMonth = month < 1 ? 1 : (month > 12 ? 12 : month);
+        int dayOfYear = cumulativeDays[clampedMonth - 1] + day;
+        if (leapYear && clampedMonth > 2)
+            ++dayOfYear;
+        return dayOfYear;
+    }
+
+    double Lerp(double a, double b, double t)
+    {
+        return a + (b - a) * t;
+    }
+
+    // Checks whether every sample between first and last is reproduced by linear
+    // interpolation of the two end samples within the study tolerances
+    bool IsInterpolated(const std::vector<SunStudy::Keyframe>& samples, size_t first, size_t last,
+        const SunStudy::Settings& settings)
+    {
+        const SunStudy::Keyframe& a = samples[first];
+        const SunStudy::Keyframe& b = samples[last];
+        const double span = b.hour - a.hour;
+        if (span <= 0.0)
+            return true;
+
+        const double intensityTolerance = settings.intensityTolerance * settings.peakIntensity;
+
+        for (size_t i = first + 1; i < last; ++i)
+        {
+            const SunStudy::Keyframe& sample = samples[i];
+            const double t = (sample.hour - a.hour) / span;
+
+            if (fabs(Lerp(a.pitch, b.pitch, t) - sample.pitch) > settings.angleTolerance)
+                return false;
+            if (fabs(Lerp(a.yaw, b.yaw, t) - sample.yaw) > settings.angleTolerance)
+                return false;
+            if (fabs(Lerp(a.intensity, b.intensity, t) - sample.intensity) > intensityTolerance)
+                return false;
+
+            const int red = static_cast<int>(Lerp(a.color.Red(), b.color.Red(), t) + 0.5);
+            const int green = static_cast<int>(Lerp(a.color.Green(), b.color.Green(), t) + 0.5);
+            const int blue = static_cast<int>(Lerp(a.color.Blue(), b.color.Blue(), t) + 0.5);
+            if (abs(red - sample.color.Red()) > COLOR_TOLERANCE ||
+                abs(green - sample.color.Green()) > COLOR_TOLERANCE ||
+                abs(blue - sample.color.Blue()) > COLOR_TOLERANCE)
+                return false;
+        }
+
+        return true;
+    }
+}
+
+/**
+ * @brief Samples the sun over the study time range
+ *
+ * Produces one keyframe per sampling step with the light rotation, intensity and
+ * color the directional sun would have at that time. Yaw is unwrapped so that
+ * interpolating consecutive keyframes never spins the light the long way round.
+ *
+ * @param settings Study site, date and time range
+ * @return Densely sampled keyframes (see SimplifyKeyframes), none for an invalid date or range
+ */
+std::vector<SunStudy::Keyframe> SunStudy::BuildKeyframes(const Settings& settings)
+{
+    std::vector<Keyframe> samples;
+
+    const double stepHours = (settings.stepMinutes > 0.0 ? settings.stepMinutes : 5.0) / 60.0;
+    if (!IsValidDate(settings) || settings.endHour <= settings.startHour)
+    {
+        return samples;
+    }
+
+    const int stepCount = static_cast<int>(ceil((settings.endHour - settings.startHour) / stepHours));
+    samples.reserve(static_cast<size_t>(stepCount) + 1);
+
+    for (int step = 0; step <= stepCount; ++step)
+    {
+        const double hour = step == stepCount ? settings.endHour : settings.startHour + step * stepHours;
+
+        double altitude = 0.0;
+        double azimuth = 0.0;
+        SolarPosition(settings, hour, altitude, azimuth);
+
+        Keyframe keyframe;
+        keyframe.hour = hour;
+
+        CLightEventWatcher::FRhinoRotation rotation =
+            CLightEventWatcher::DirectionToRhinoRotation(SunLightDirection(altitude, azimuth));
+        keyframe.pitch = rotation.pitch;
+        keyframe.yaw = rotation.yaw;
+
+        // Keep yaw continuous across the +/-180 degree seam
+        if (!samples.empty())
+        {
+            const double previousYaw = samples.back().yaw;
+            while (keyframe.yaw - previousYaw > 180.0)
+                keyframe.yaw -= 360.0;
+            while (keyframe.yaw - previousYaw < -180.0)
+                keyframe.yaw += 360.0;
+        }
+
+        // Intensity follows the projected irradiance and drops to zero below the horizon
+        keyframe.intensity = altitude > 0.0 ? settings.peakIntensity * sin(altitude * DEG_TO_RAD) : 0.0;
+        keyframe.color = SunColor(settings.noonColor, altitude);
+
+        samples.push_back(keyframe);
+    }
+
+    return samples;
+}
+
+/**
+ * @brief Reduces dense samples to the keyframes Unreal needs for linear interpolation
+ *
+ * Greedily extends each segment for as long as linear interpolation between its
+ * end points reproduces every skipped sample within the study tolerances.
+ *
+ * @param samples Densely sampled keyframes ordered by time
+ * @param settings Study settings providing the tolerances
+ * @return Compact keyframe curve including both end samples
+ */
+std::vector<SunStudy::Keyframe> SunStudy::SimplifyKeyframes(const std::vector<Keyframe>& samples,
+    const Settings& settings)
+{
+    if (samples.size() <= 2)
+    {
+        return samples;
+    }
+
+    std::vector<Keyframe> keyframes;
+    keyframes.push_back(samples.front());
+
+    size_t anchor = 0;
+    for (size_t last = 2; last < samples.size(); ++last)
+    {
+        if (!IsInterpolated(samples, anchor, last, settings))
+        {
+            // The previous sample is the furthest one the segment could reach
+            anchor = last - 1;
+            keyframes.push_back(samples[anchor]);
+        }
+    }
+
+    keyframes.push_back(samples.back());
+    return keyframes;
+}
+
+/**
+ * @brief Creates the JSON message carrying the whole sun curve
+ *
+ * @param keyframes Keyframe curve (usually the output of SimplifyKeyframes)
+ * @param settings Study settings, echoed so Unreal can label the study
+ * @param lightId UUID of the directional light the curve drives
+ * @return JSON string sent once to Unreal
+ */
+std::wstring SunStudy::CreateSunStudyJSON(const std::vector<Keyframe>& keyframes,
+    const Settings& settings, const ON_UUID& lightId)
+{
+    std::wstringstream json;
+
+    json << L"{\n";
+    json << L"  \"event\": \"Sun Study\",\n";
+    json << L"  \"lightId\": \"" << LightUtils::UuidToString(lightId) << L"\",\n";
+    json << L"  \"date\": \"" << settings.year << L"-"
+        << std::setw(2) << std::setfill(L'0') << settings.month << L"-"
+        << std::setw(2) << std::setfill(L'0') << settings.day << L"\",\n";
+    json << std::setfill(L' ');
+    json << L"  \"latitude\": " << std::fixed << std::setprecision(6) << settings.latitude << L",\n";
+    json << L"  \"longitude\": " << std::fixed << std::setprecision(6) << settings.longitude << L",\n";
+    json << L"  \"interpolation\": \"linear\",\n";
+    json << L"  \"keyframeCount\": " << keyframes.size() << L",\n";
+    json << L"  \"keyframes\": [\n";
+
+    for (size_t i = 0; i < keyframes.size(); ++i)
+    {
+        const Keyframe& keyframe = keyframes[i];
+
+        json << L"    {\n";
+        json << L"      \"time\": " << std::fixed << std::setprecision(4) << keyframe.hour << L",\n";
+        json << L"      \"rotation\": {\n";
+        json << L"        \"pitch\": " << std::fixed << std::setprecision(3) << keyframe.pitch << L",\n";
+        json << L"        \"yaw\": " << std::fixed << std::setprecision(3) << keyframe.yaw << L",\n";
+        json << L"        \"roll\": " << std::fixed << std::setprecision(3) << 0.0 << L"\n";
+        json << L"      },\n";
+        json << L"      \"intensity\": " << std::fixed << std::setprecision(4) << keyframe.intensity << L",\n";
+        json << L"      \"color\": {\n";
+        json << L"        \"r\": " << static_cast<int>(keyframe.color.Red()) << L",\n";
+        json << L"        \"g\": " << static_cast<int>(keyframe.color.Green()) << L",\n";
+        json << L"        \"b\": " << static_cast<int>(keyframe.color.Blue()) << L"\n";
+        json << L"      }\n";
+        json << L"    }";
+
+        // Add comma if not the last element
+        if (i + 1 < keyframes.size())
+        {
+            json << L",";
+        }
+        json << L"\n";
+    }
+
+    json << L"  ]\n";
+    json << L"}";
+
+    return json.str();
+}
+
+/**
+ * @brief Number of days in a month of the Gregorian calendar
+ *
+ * @param year Year, for February in leap years
+ * @param month Month 1-12
+ * @return Days in the month, 0 for a month outside 1-12
+ */
+int SunStudy::DaysInMonth(int year, int month)
+{
+    static const int days[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    if (month < 1 || month > 12)
+        return 0;
+    return month == 2 && IsLeapYear(year) ? 29 : days[month - 1];
+}
+
+/**
+ * @brief Checks that the study's day exists in its month (no February 30th)
+ *
+ * @param settings Study date
+ * @return False if the month or day is out of range
+ */
+bool SunStudy::IsValidDate(const Settings& settings)
+{
+    return settings.day >= 1 && settings.day <= DaysInMonth(settings.year, settings.month);
+}
+
+/**
+ * @brief Computes the solar altitude and azimuth for a local clock time
+ *
+ * Uses the NOAA fractional-year approximation, accurate to a fraction of a
+ * degree which is well below what is visible in a daylight study.
+ *
+ * @param settings Study site and date
+ * @param hour Local clock time in hours
+ * @param altitudeDegrees Receives the elevation above the horizon
+ * @param azimuthDegrees Receives the azimuth clockwise from north
+ */
+void SunStudy::SolarPosition(const Settings& settings, double hour, double& altitudeDegrees, double& azimuthDegrees)
+{
+    const int dayOfYear = DayOfYear(settings.year, settings.month, settings.day);
+    const double utcHour = hour - settings.timeZoneHours;
+
+    // Fractional year in radians
+    const double gamma = 2.0 * ON_PI / 365.0 * (dayOfYear - 1 + (utcHour - 12.0) / 24.0);
+
+    // Equation of time (minutes) and solar declination (radians)
+    const double equationOfTime = 229.18 * (0.000075 + 0.001868 * cos(gamma) - 0.032077 * sin(gamma)
+        - 0.014615 * cos(2.0 * gamma) - 0.040849 * sin(2.0 * gamma));
+    const double declination = 0.006918 - 0.399912 * cos(gamma) + 0.070257 * sin(gamma)
+        - 0.006758 * cos(2.0 * gamma) + 0.000907 * sin(2.0 * gamma)
+        - 0.002697 * cos(3.0 * gamma) + 0.00148 * sin(3.0 * gamma);
+
+    // True solar time (minutes) and hour angle (radians)
+    const double timeOffset = equationOfTime + 4.0 * settings.longitude - 60.0 * settings.timeZoneHours;
+    const double trueSolarTime = hour * 60.0 + timeOffset;
+    const double hourAngle = (trueSolarTime / 4.0 - 180.0) * DEG_TO_RAD;
+
+    const double latitude = settings.latitude * DEG_TO_RAD;
+    double cosZenith = sin(latitude) * sin(declination) + cos(latitude) * cos(declination) * cos(hourAngle);
+    cosZenith = cosZenith > 1.0 ? 1.0 : (cosZenith < -1.0 ? -1.0 : cosZenith);
+
+    altitudeDegrees = 90.0 - acos(cosZenith) * RAD_TO_DEG;
+    azimuthDegrees = atan2(sin(hourAngle), cos(hourAngle) * sin(latitude) - tan(declination) * cos(latitude))
+        * RAD_TO_DEG + 180.0;
+}
+
+/**
+ * @brief Converts a solar position to the direction the sun light travels
+ *
+ * Rhino's world Y axis is treated as north and X as east.
+ *
+ * @param altitudeDegrees Elevation above the horizon
+ * @param azimuthDegrees Azimuth clockwise from north
+ * @return Unit vector pointing from the sun towards the ground
+ */
+ON_3dVector SunStudy::SunLightDirection(double altitudeDegrees, double azimuthDegrees)
+{
+    const double altitude = altitudeDegrees * DEG_TO_RAD;
+    const double azimuth = azimuthDegrees * DEG_TO_RAD;
+
+    ON_3dVector towardsSun(sin(azimuth) * cos(altitude), cos(azimuth) * cos(altitude), sin(altitude));
+    return -towardsSun;
+}
+
+/**
+ * @brief Warms the sun color near the horizon
+ *
+ * @param noonColor Color of the sun high in the sky
+ * @param altitudeDegrees Elevation above the horizon
+ * @return Blend between a sunrise orange and the noon color
+ */
+ON_Color SunStudy::SunColor(const ON_Color& noonColor, double altitudeDegrees)
+{
+    static const ON_Color horizonColor(255, 120, 50);
+
+    double t = altitudeDegrees / FULL_COLOR_ALTITUDE;
+    t = t < 0.0 ? 0.0 : (t > 1.0 ? 1.0 : t);
+    t = t * t * (3.0 - 2.0 * t); // Smoothstep so the keyframe curve stays gentle
+
+    return ON_Color(
+        static_cast<int>(Lerp(horizonColor.Red(), noonColor.Red(), t) + 0.5),
+        static_cast<int>(Lerp(horizonColor.Green(), noonColor.Green(), t) + 0.5),
+        static_cast<int>(Lerp(horizonColor.Blue(), noonColor.Blue(), t) + 0.5));
+}
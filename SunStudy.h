@@ -0,0 +1,76 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+#pragma once
+
+#include "stdafx.h"
+#include <string>
+#include <vector>
+
+/**
+ * @brief Precomputes a daylight study for the directional sun as a keyframe curve
+ *
+ * Instead of moving the sun in Rhino and streaming every step through the light
+ * table events, the whole day is sampled once, reduced to the keyframes needed
+ * for linear interpolation within tolerance, and sent to Unreal in one message.
+ * Unreal interpolates between keyframes locally while scrubbing.
+ */
+class SunStudy
+{
+public:
+    // Parameters describing the study (site, date and sampled time range)
+    struct Settings
+    {
+        double latitude;         // Degrees, north positive
+        double longitude;        // Degrees, east positive
+        double timeZoneHours;    // Offset from UTC in hours
+        int year;
+        int month;
+        int day;
+        double startHour;        // Local clock time in hours, at timeZoneHours from UTC
+        double endHour;
+        double stepMinutes;      // Sampling interval before keyframe reduction
+        double peakIntensity;    // Intensity of the sun at the zenith
+        ON_Color noonColor;      // Color of the sun high in the sky
+        double angleTolerance;   // Max interpolation error in degrees
+        double intensityTolerance; // Max interpolation error relative to peak intensity
+
+        Settings() : latitude(0.0), longitude(0.0), timeZoneHours(0.0), year(2025), month(6), day(21),
+            startHour(6.0), endHour(20.0), stepMinutes(5.0), peakIntensity(1.0),
+            noonColor(255, 255, 255), angleTolerance(0.25), intensityTolerance(0.01) {}
+    };
+
+    // One sample of the sun curve
+    struct Keyframe
+    {
+        double hour;        // Local clock time in hours
+        double pitch;       // Degrees, same convention as light events
+        double yaw;         // Degrees, unwrapped so consecutive keys never jump by 360
+        double intensity;
+        ON_Color color;
+
+        Keyframe() : hour(0.0), pitch(0.0), yaw(0.0), intensity(0.0) {}
+    };
+
+    // Main functions
+    static std::vector<Keyframe> BuildKeyframes(const Settings& settings);
+    static std::vector<Keyframe> SimplifyKeyframes(const std::vector<Keyframe>& samples, const Settings& settings);
+    static std::wstring CreateSunStudyJSON(const std::vector<Keyframe>& keyframes,
+        const Settings& settings, const ON_UUID& lightId);
+
+    // Helper functions
+    static int DaysInMonth(int year, int month);
+    static bool IsValidDate(const Settings& settings);
+    static void SolarPosition(const Settings& settings, double hour, double& altitudeDegrees, double& azimuthDegrees);
+    static ON_3dVector SunLightDirection(double altitudeDegrees, double azimuthDegrees);
+    static ON_Color SunColor(const ON_Color& noonColor, double altitudeDegrees);
+};
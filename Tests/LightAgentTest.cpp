@@ -0,0 +1,326 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+/**
+ * @brief Tests of the shared ring and the sync agent (POSIX)
+ *
+ * Checks the shm_open ring on its own (wrap-around, full ring drops, producer
+ * close) and then the whole agent path: records written into the ring the way
+ * LightAgentLink writes them are read by LightAgent::Run, which sends the
+ * scene to a loopback listener and writes the backup file. Exits non-zero on
+ * the first failed check.
+ */
+
+#include "../Agent/LightAgent.h"
+#include "../Agent/LightAgentProtocol.h"
+#include "../Agent/LightAgentRing.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #condition); \
+            exit(1); \
+        } \
+    } while (0)
+
+namespace {
+    using namespace LightAgentProtocol;
+
+    constexpr int RECEIVER_PORT = 47181;
+    constexpr uint32_t DOCUMENT = 7;
+
+    std::string RingName(const char* suffix)
+    {
+        return "/LightSyncAgentTest" + std::to_string(getpid()) + suffix;
+    }
+
+    // Record of size bytes whose contents identify it
+    void Fill(unsigned char* record, size_t size, uint32_t index)
+    {
+        for (size_t i = 0; i < size; ++i)
+        {
+            record[i] = static_cast<unsigned char>(index * 31 + i);
+        }
+    }
+
+    bool Matches(const std::vector<unsigned char>& record, size_t size, uint32_t index)
+    {
+        if (record.size() != size)
+            return false;
+        for (size_t i = 0; i < size; ++i)
+        {
+            if (record[i] != static_cast<unsigned char>(index * 31 + i))
+                return false;
+        }
+        return true;
+    }
+
+    void TestRing()
+    {
+        const std::string name = RingName("Ring");
+        LightAgentRing producer;
+        LightAgentRing consumer;
+        CHECK(!consumer.Open(name));
+        CHECK(producer.Create(name, 1));
+        CHECK(producer.Capacity() == 64 * 1024);
+        CHECK(consumer.Open(name));
+        CHECK(consumer.Capacity() == producer.Capacity());
+
+        // Records of changing sizes wrap around the ring many times, read back in order
+        std::vector<unsigned char> record;
+        uint32_t written = 0;
+        uint32_t read = 0;
+        for (int round = 0; round < 2000; ++round)
+        {
+            for (int i = 0; i < 3; ++i, ++written)
+            {
+                const size_t size = 1 + (written * 977) % 5000;
+                unsigned char* space = producer.BeginWrite(size);
+                CHECK(space != nullptr);
+                Fill(space, size, written);
+                producer.EndWrite();
+            }
+            while (consumer.Read(record))
+            {
+                CHECK(Matches(record, 1 + (read * 977) % 5000, read));
+                ++read;
+            }
+        }
+        CHECK(read == written);
+        CHECK(producer.Dropped() == 0);
+        CHECK(consumer.Used() == 0);
+        CHECK(consumer.Counters()->recordsRead.load() == written);
+
+        // A full ring drops and counts instead of overwriting unread records
+        size_t accepted = 0;
+        while (unsigned char* space = producer.BeginWrite(1000))
+        {
+            Fill(space, 1000, static_cast<uint32_t>(accepted++));
+            producer.EndWrite();
+        }
+        CHECK(accepted > 0);
+        CHECK(producer.Dropped() == 1);
+        CHECK(producer.BeginWrite(producer.Capacity()) == nullptr);
+        CHECK(producer.Dropped() == 2);
+        for (size_t i = 0; i < accepted; ++i)
+        {
+            CHECK(consumer.Read(record));
+            CHECK(Matches(record, 1000, static_cast<uint32_t>(i)));
+        }
+        CHECK(!consumer.Read(record));
+
+        // Lengths in the shared frames are not trusted: one past the ring's end or past the
+        // written bytes skips what is unread and counts as a drop, then reading carries on (the
+        // frame's length sits 8 bytes before the payload)
+        for (uint32_t badLength : { 1u << 30, 4000u })
+        {
+            const uint64_t dropped = producer.Dropped();
+            unsigned char* space = producer.BeginWrite(16);
+            CHECK(space != nullptr);
+            memcpy(space - 8, &badLength, sizeof(badLength));
+            producer.EndWrite();
+            CHECK(!consumer.Read(record));
+            CHECK(consumer.Dropped() == dropped + 1);
+            CHECK(consumer.Used() == 0);
+
+            space = producer.BeginWrite(100);
+            CHECK(space != nullptr);
+            Fill(space, 100, 7);
+            producer.EndWrite();
+            CHECK(consumer.Read(record));
+            CHECK(Matches(record, 100, 7));
+        }
+
+        // Closing the producer is seen by the consumer and removes the name
+        CHECK(!consumer.IsProducerClosed());
+        producer.Close();
+        CHECK(consumer.IsProducerClosed());
+        consumer.Close();
+        CHECK(!consumer.Open(name));
+    }
+
+    // Light as LightAgentLink::WriteLight fills it
+    Light MakeLight(uint8_t idByte, LightType type, double x)
+    {
+        Light light = {};
+        memset(light.id, idByte, sizeof(light.id));
+        light.type = static_cast<uint8_t>(type);
+        light.enabled = 1;
+        light.isSpotLight = type == LightType::Spot ? 1 : 0;
+        light.color[0] = 255;
+        light.color[1] = 128;
+        light.color[2] = 0;
+        light.dirtyFields = FIELD_ALL;
+        light.location[0] = x;
+        light.direction[2] = -1.0;
+        light.intensity = 1.5;
+        light.innerAngle = 20.0;
+        light.outerAngle = 30.0;
+        return light;
+    }
+
+    void Push(LightAgentRing& ring, RecordKind kind, uint32_t sceneLightCount, const std::vector<Light>& lights)
+    {
+        const size_t size = RecordSize(static_cast<uint32_t>(lights.size()));
+        unsigned char* record = ring.BeginWrite(size);
+        CHECK(record != nullptr);
+
+        RecordHeader header = {};
+        header.kind = static_cast<uint16_t>(kind);
+        header.document = DOCUMENT;
+        header.lightCount = static_cast<uint32_t>(lights.size());
+        header.sceneLightCount = sceneLightCount;
+        strcpy(header.eventName, "Light Added");
+        memcpy(record, &header, sizeof(header));
+        if (!lights.empty())
+        {
+            memcpy(record + sizeof(header), lights.data(), lights.size() * sizeof(Light));
+        }
+        ring.EndWrite();
+    }
+
+    int Listen(int port)
+    {
+        const int sock = socket(AF_INET, SOCK_STREAM, 0);
+        CHECK(sock >= 0);
+        const int reuse = 1;
+        setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(static_cast<unsigned short>(port));
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        CHECK(bind(sock, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0);
+        CHECK(listen(sock, 4) == 0);
+        return sock;
+    }
+
+    // Accepts one connection and reads it until the sender closes it
+    std::string Receive(int listener)
+    {
+        const int sock = accept(listener, nullptr, nullptr);
+        CHECK(sock >= 0);
+        std::string message;
+        char buffer[4096];
+        ssize_t received;
+        while ((received = recv(sock, buffer, sizeof(buffer), 0)) > 0)
+        {
+            message.append(buffer, static_cast<size_t>(received));
+        }
+        close(sock);
+        return message;
+    }
+
+    std::string ReadFile(const std::string& path)
+    {
+        std::string text;
+        FILE* file = fopen(path.c_str(), "rb");
+        CHECK(file != nullptr);
+        char buffer[4096];
+        size_t read;
+        while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+        {
+            text.append(buffer, read);
+        }
+        fclose(file);
+        return text;
+    }
+
+    bool Contains(const std::string& text, const std::string& part)
+    {
+        return text.find(part) != std::string::npos;
+    }
+
+    void TestAgentRoundTrip()
+    {
+        const int listener = Listen(RECEIVER_PORT);
+
+        LightAgent::Options options;
+        options.ringName = RingName("Agent");
+        options.ports.assign(1, RECEIVER_PORT);
+        options.exportPath = "/tmp/LightSyncAgentTest" + std::to_string(getpid()) + ".txt";
+        options.statsIntervalSeconds = 0;
+
+        LightAgentRing ring;
+        CHECK(ring.Create(options.ringName));
+
+        std::atomic<bool> stop(false);
+        LightAgent agent(options);
+        std::thread agentThread([&agent, &stop] { agent.Run(stop); });
+
+        // One light of every type, written as a scene the way PushScene splits it
+        const std::vector<Light> lights = {
+            MakeLight(0x11, LightType::Directional, 1.0),
+            MakeLight(0x22, LightType::Point, 2.0),
+            MakeLight(0x33, LightType::Spot, 3.0),
+            MakeLight(0x44, LightType::Ambient, 4.0),
+            MakeLight(0x55, LightType::Unknown, 5.0) };
+        Push(ring, RecordKind::SceneBegin, static_cast<uint32_t>(lights.size()), {});
+        Push(ring, RecordKind::Lights, 0, std::vector<Light>(lights.begin(), lights.begin() + 2));
+        Push(ring, RecordKind::Lights, 0, std::vector<Light>(lights.begin() + 2, lights.end()));
+        Push(ring, RecordKind::SceneEnd, 0, {});
+
+        const std::string message = Receive(listener);
+        CHECK(Contains(message, "\"event\": \"Light Added\""));
+        CHECK(Contains(message, "\"document\": 7"));
+        CHECK(Contains(message, "\"lightCount\": 5"));
+
+        // Each light keeps its type through the ring and the agent
+        const char* const expected[] = { "Directional", "Point", "Spot", "Ambient", "Unknown" };
+        size_t position = 0;
+        for (const char* type : expected)
+        {
+            position = message.find(std::string("\"type\": \"") + type + "\"", position);
+            CHECK(position != std::string::npos);
+        }
+        CHECK(Contains(message, "\"uuid\": \"11111111-1111-1111-1111-111111111111\""));
+        CHECK(Contains(message, "\"spotLight\""));
+
+        // The backup file is written when the agent stops
+        stop.store(true);
+        agentThread.join();
+        const std::string exported = ReadFile(options.exportPath);
+        CHECK(Contains(exported, "# Total Lights: 5"));
+        CHECK(Contains(exported, "\nDirectional (1,0,0)"));
+        CHECK(Contains(exported, "\nPoint (2,0,0)"));
+        CHECK(Contains(exported, "\nSpot (3,0,0)"));
+        CHECK(Contains(exported, "\nAmbient (4,0,0)"));
+        CHECK(Contains(exported, "\nUnknown (5,0,0)"));
+
+        CHECK(ring.Counters()->recordsRead.load() == 4);
+        CHECK(ring.Counters()->messagesSent.load() == 1);
+        CHECK(ring.Dropped() == 0);
+
+        ring.Close();
+        close(listener);
+        remove(options.exportPath.c_str());
+    }
+}
+
+int main()
+{
+    TestRing();
+    TestAgentRoundTrip();
+    printf("LightAgentTest: all checks passed\n");
+    return 0;
+}
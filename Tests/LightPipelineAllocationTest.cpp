@@ -0,0 +1,334 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+/**
+ * @brief Counts the heap allocations of the event pipeline's encode and send steps (Linux)
+ *
+ * Replaces the global operator new with a counter and runs messages through
+ * the Rhino-free parts of the pipeline the way SendLightDataToTCP does: encode
+ * buffers and delivery lists drawn from LightBufferPool, a header written
+ * through stack buffers, segments over cached records, and LightSyncReactor
+ * sending the segments to a loopback listener. Once the pools are warm an
+ * encode must not allocate at all, and a send must cost the same fixed number
+ * of allocations whatever the message's size. Exits non-zero on the first
+ * failed check.
+ */
+
+#include "../LightBufferPool.h"
+#include "../LightSyncReactor.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #condition); \
+            exit(1); \
+        } \
+    } while (0)
+
+namespace {
+    std::atomic<uint64_t> g_allocations(0);
+}
+
+void* operator new(size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = malloc(size == 0 ? 1 : size))
+        return memory;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+    free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+    free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+    free(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept
+{
+    free(memory);
+}
+
+namespace {
+    using std::chrono::milliseconds;
+
+    constexpr int RECEIVER_PORT = 47201;
+    constexpr size_t SMALL_SCENE = 1;
+    constexpr size_t LARGE_SCENE = 1000;
+
+    // Allocations one steady-state send may cost: the sender's copy of the segment list, the
+    // posted task and the send handler (closures too large for std::function's inline storage),
+    // the outbound connection, its handle table entry and its timeout's timer entry
+    constexpr uint64_t MAX_SEND_ALLOCATIONS = 6;
+
+    // Same pieces as LightSyncBuffers::EncodeBuffers
+    struct EncodeBuffers
+    {
+        std::string header;
+        std::string indexPrefixes;
+        std::vector<size_t> prefixEnds;
+        std::vector<LightSyncReactor::Segment> segments;
+
+        void clear()
+        {
+            header.clear();
+            indexPrefixes.clear();
+            prefixEnds.clear();
+            segments.clear();
+        }
+    };
+
+    // Stands in for LightSyncSubscriptions::Delivery
+    struct Delivery
+    {
+        int port;
+        unsigned int sequence;
+        size_t lightCount;
+    };
+
+    std::atomic<uint64_t> g_poolMisses(0);
+    LightBufferPool<std::shared_ptr<EncodeBuffers>> g_encoders(8, &g_poolMisses);
+    LightBufferPool<std::vector<Delivery>> g_deliveries(4, &g_poolMisses);
+
+    // Cached records, as LightFragmentCache holds them between events
+    std::vector<std::string> g_records;
+
+    void AppendUnsigned(std::string& json, uint64_t value)
+    {
+        char buffer[24];
+        const int length = snprintf(buffer, sizeof(buffer), "%llu", static_cast<unsigned long long>(value));
+        if (length > 0)
+            json.append(buffer, static_cast<size_t>(length));
+    }
+
+    // What EncodeLightData does for a JSON receiver
+    void Encode(const Delivery& delivery, EncodeBuffers& buffers)
+    {
+        static const char RECORD_SEPARATOR[] = ",\n";
+        static const char MESSAGE_FOOTER[] = "  ]\n}";
+
+        buffers.header += "{\n  \"event\": \"Light Modified\",\n  \"sequence\": ";
+        AppendUnsigned(buffers.header, delivery.sequence);
+        buffers.header += ",\n  \"lightCount\": ";
+        AppendUnsigned(buffers.header, delivery.lightCount);
+        buffers.header += ",\n  \"lights\": [\n";
+
+        buffers.prefixEnds.resize(delivery.lightCount);
+        for (size_t i = 0; i < delivery.lightCount; ++i)
+        {
+            buffers.indexPrefixes += "    {\n      \"id\": ";
+            AppendUnsigned(buffers.indexPrefixes, i);
+            buffers.indexPrefixes += ",\n";
+            buffers.prefixEnds[i] = buffers.indexPrefixes.size();
+        }
+
+        buffers.segments.reserve(3 * delivery.lightCount + 2);
+        buffers.segments.push_back({ buffers.header.data(), buffers.header.size() });
+        size_t prefixBegin = 0;
+        for (size_t i = 0; i < delivery.lightCount; ++i)
+        {
+            buffers.segments.push_back({ buffers.indexPrefixes.data() + prefixBegin, buffers.prefixEnds[i] - prefixBegin });
+            buffers.segments.push_back({ g_records[i].data(), g_records[i].size() });
+            buffers.segments.push_back({ RECORD_SEPARATOR, i + 1 < delivery.lightCount ? sizeof(RECORD_SEPARATOR) - 1 : 1 });
+            prefixBegin = buffers.prefixEnds[i];
+        }
+        buffers.segments.push_back({ MESSAGE_FOOTER, sizeof(MESSAGE_FOOTER) - 1 });
+    }
+
+    // Resolves one delivery into a pooled list, encodes it into pooled buffers and hands both back
+    uint64_t EncodeOnce(unsigned int sequence, size_t lightCount)
+    {
+        const uint64_t before = g_allocations.load();
+
+        std::vector<Delivery> deliveries = g_deliveries.Acquire();
+        deliveries.push_back(Delivery{ RECEIVER_PORT, sequence, lightCount });
+        std::shared_ptr<EncodeBuffers> buffers = g_encoders.Acquire();
+        Encode(deliveries.front(), *buffers);
+        CHECK(buffers->segments.size() == 3 * lightCount + 2);
+        g_deliveries.Release(std::move(deliveries));
+        g_encoders.Release(std::move(buffers));
+
+        return g_allocations.load() - before;
+    }
+
+    // Accepts connections and drains them through a stack buffer, so receiving allocates nothing
+    int g_listener = -1;
+    std::atomic<int> g_received(0);
+    std::atomic<size_t> g_receivedBytes(0);
+
+    void Receive()
+    {
+        char buffer[65536];
+        for (;;)
+        {
+            const int sock = accept(g_listener, nullptr, nullptr);
+            if (sock < 0)
+                return;
+            size_t bytes = 0;
+            ssize_t received;
+            while ((received = recv(sock, buffer, sizeof(buffer), 0)) > 0)
+            {
+                bytes += static_cast<size_t>(received);
+            }
+            close(sock);
+            g_receivedBytes = bytes;
+            ++g_received;
+        }
+    }
+
+    void WaitFor(const std::atomic<int>& counter, int value)
+    {
+        for (int i = 0; i < 2000 && counter.load() < value; ++i)
+        {
+            std::this_thread::sleep_for(milliseconds(1));
+        }
+        CHECK(counter.load() >= value);
+    }
+
+    // Encodes and sends one message like SendLightDataToTCP; returns the send's allocations
+    uint64_t SendOnce(unsigned int sequence, size_t lightCount)
+    {
+        std::shared_ptr<EncodeBuffers> buffers = g_encoders.Acquire();
+        Encode(Delivery{ RECEIVER_PORT, sequence, lightCount }, *buffers);
+        size_t messageBytes = 0;
+        for (const LightSyncReactor::Segment& segment : buffers->segments)
+        {
+            messageBytes += segment.size;
+        }
+
+        const int received = g_received.load();
+        std::atomic<int> handled(0);
+        std::atomic<bool> sent(false);
+        const uint64_t before = g_allocations.load();
+        std::vector<LightSyncReactor::Segment> segments(buffers->segments);
+        CHECK(LightSyncReactor::Send(RECEIVER_PORT, std::move(segments), [buffers = std::move(buffers), &handled, &sent](bool ok) mutable
+        {
+            g_encoders.Release(std::move(buffers));
+            sent = ok;
+            ++handled;
+        }));
+        WaitFor(handled, 1);
+
+        // Whatever the network thread does after the handler finishes before this task runs
+        std::atomic<int> settled(0);
+        CHECK(LightSyncReactor::Post([&settled] { ++settled; }));
+        WaitFor(settled, 1);
+        const uint64_t allocations = g_allocations.load() - before;
+
+        WaitFor(g_received, received + 1);
+        CHECK(sent);
+        CHECK(g_receivedBytes == messageBytes);
+        return allocations;
+    }
+
+    void TestEncode()
+    {
+        // The first encode of each size grows the pooled buffers
+        CHECK(EncodeOnce(1, LARGE_SCENE) > 0);
+        CHECK(g_poolMisses == 2);
+
+        // After that neither the delivery list nor the encode buffers allocate
+        for (unsigned int sequence = 2; sequence < 100; ++sequence)
+        {
+            CHECK(EncodeOnce(sequence, sequence % 2 ? LARGE_SCENE : SMALL_SCENE) == 0);
+        }
+        CHECK(g_poolMisses == 2);
+
+        // A buffer still referenced elsewhere is not pooled
+        std::shared_ptr<EncodeBuffers> held = g_encoders.Acquire();
+        std::shared_ptr<EncodeBuffers> other = held;
+        g_encoders.Release(std::move(held));
+        std::shared_ptr<EncodeBuffers> next = g_encoders.Acquire();
+        CHECK(next.get() != other.get());
+        CHECK(g_poolMisses == 3);
+    }
+
+    void TestSend()
+    {
+        g_listener = socket(AF_INET, SOCK_STREAM, 0);
+        const int reuse = 1;
+        setsockopt(g_listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(static_cast<unsigned short>(RECEIVER_PORT));
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        CHECK(bind(g_listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0);
+        CHECK(listen(g_listener, 16) == 0);
+        std::thread receiver(Receive);
+
+        // Warm up the reactor's queues, maps and the pooled buffers of both sizes
+        for (unsigned int sequence = 1; sequence <= 20; ++sequence)
+        {
+            SendOnce(sequence, sequence % 2 ? LARGE_SCENE : SMALL_SCENE);
+        }
+
+        // Every later send costs the same few allocations, however many lights the message holds
+        const uint64_t small = SendOnce(21, SMALL_SCENE);
+        const uint64_t large = SendOnce(22, LARGE_SCENE);
+        printf("Allocations per steady-state send: %llu\n", static_cast<unsigned long long>(small));
+        CHECK(small <= MAX_SEND_ALLOCATIONS);
+        CHECK(large == small);
+        for (unsigned int sequence = 23; sequence < 60; ++sequence)
+        {
+            CHECK(SendOnce(sequence, sequence % 2 ? LARGE_SCENE : SMALL_SCENE) == small);
+        }
+
+        // The encode buffers came back from every handler
+        CHECK(EncodeOnce(60, LARGE_SCENE) == 0);
+
+        shutdown(g_listener, SHUT_RDWR);
+        close(g_listener);
+        receiver.join();
+    }
+}
+
+int main()
+{
+    for (size_t i = 0; i < LARGE_SCENE; ++i)
+    {
+        g_records.push_back("      \"uuid\": \"00000000-0000-4000-8000-" + std::to_string(100000000000ull + i) +
+            "\",\n      \"type\": \"Point\",\n      \"intensity\": 1\n    }");
+    }
+
+    CHECK(LightSyncReactor::Start());
+    TestEncode();
+    TestSend();
+    LightSyncReactor::Stop();
+    printf("LightPipelineAllocationTest: all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,269 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+
+/**
+ * @brief Tests that quantized partials decode after a lost or resumed scene
+ *
+ * Writes quantized messages the way LightQuantizedEncoder does, naming partial
+ * lights through LightQuantizedHandles, and decodes them with a receiver's
+ * LightMessageDecoder that only gets the messages that were delivered. A scene
+ * that was dropped, a lost batch, a superseded scene or a resumed receiver must
+ * never leave partials holding handles the decoder cannot resolve. Exits
+ * non-zero on the first failed check.
+ */
+
+#include "../LightQuantizedHandles.h"
+#include "../Receiver/LightMessageDecoder.h"
+#include "../Receiver/LightQuantizedFormat.h"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #condition); \
+            exit(1); \
+        } \
+    } while (0)
+
+namespace {
+    using namespace LightQuantizedFormat;
+
+    typedef LightQuantizedHandles<LightUuid, LightUuid::Hash> Handles;
+
+    constexpr size_t SCENE_SIZE = 6;
+    constexpr unsigned char POINT_LIGHT = 2;
+
+    std::vector<LightUuid> g_ids;
+
+    struct Message
+    {
+        unsigned int sequence;
+        bool partial;
+        size_t batchIndex;
+        size_t batchCount;
+        size_t firstIndex;
+        std::vector<size_t> lights;  // Indices into g_ids
+    };
+
+    void AppendUuid(std::string& out, const LightUuid& id)
+    {
+        out.append(reinterpret_cast<const char*>(id.bytes), sizeof(id.bytes));
+    }
+
+    // What LightQuantizedEncoder::Encode writes for lights that only carry an intensity
+    std::string Encode(Handles& handles, const Message& message, size_t& handlesUsed)
+    {
+        handlesUsed = 0;
+        std::string out(reinterpret_cast<const char*>(MAGIC), sizeof(MAGIC));
+        out += static_cast<char>(FORMAT_VERSION);
+        out += static_cast<char>((message.partial ? FLAG_PARTIAL : 0) | (message.batchCount > 1 ? FLAG_BATCHED : 0));
+        AppendVarint(out, 1);
+        AppendVarint(out, message.sequence);
+        AppendVarint(out, 0);
+        AppendVarint(out, 0);
+        AppendVarint(out, 0);
+        if (message.batchCount > 1)
+        {
+            AppendVarint(out, message.batchIndex);
+            AppendVarint(out, message.batchCount);
+            AppendVarint(out, SCENE_SIZE);
+        }
+        if (!message.partial)
+            AppendVarint(out, message.firstIndex);
+        AppendVarint(out, 1000);
+        for (int axis = 0; axis < 3; ++axis)
+            AppendVarint(out, ZigZag(0));
+        AppendVarint(out, message.lights.size());
+
+        if (!message.partial)
+            handles.Stage(message.sequence, message.batchIndex);
+        for (size_t i = 0; i < message.lights.size(); ++i)
+        {
+            const LightUuid& id = g_ids[message.lights[i]];
+            if (!message.partial)
+            {
+                out += static_cast<char>(RECORD_COMPLETE | FIELD_INTENSITY);
+                AppendUuid(out, id);
+                out += static_cast<char>(POINT_LIGHT);
+                handles.StageLight(id, message.firstIndex + i);
+            }
+            else
+            {
+                size_t handle = 0;
+                const bool useHandle = handles.Find(message.sequence, id, handle);
+                out += static_cast<char>(FIELD_INTENSITY | (useHandle ? RECORD_HANDLE : 0));
+                if (useHandle)
+                {
+                    AppendVarint(out, handle);
+                    ++handlesUsed;
+                }
+                else
+                    AppendUuid(out, id);
+            }
+            AppendFloat(out, static_cast<float>(message.lights[i] + 1));
+        }
+        return out;
+    }
+
+    Message Scene(unsigned int sequence)
+    {
+        Message message = { sequence, false, 0, 1, 0, {} };
+        for (size_t i = 0; i < SCENE_SIZE; ++i)
+            message.lights.push_back(i);
+        return message;
+    }
+
+    Message Batch(unsigned int sequence, size_t batchIndex)
+    {
+        const size_t batchSize = SCENE_SIZE / 2;
+        Message message = { sequence, false, batchIndex, 2, batchIndex * batchSize, {} };
+        for (size_t i = 0; i < batchSize; ++i)
+            message.lights.push_back(message.firstIndex + i);
+        return message;
+    }
+
+    Message Partial(unsigned int sequence)
+    {
+        return Message{ sequence, true, 0, 1, 0, { 1, 4 } };
+    }
+
+    // Encodes and, when sent, decodes the message; returns how many partial lights used handles
+    size_t Deliver(Handles& handles, LightMessageDecoder& decoder, const Message& message, bool sent)
+    {
+        size_t handlesUsed = 0;
+        const std::string bytes = Encode(handles, message, handlesUsed);
+        handles.Delivered(sent);
+        if (!sent)
+            return 0;
+
+        LightMessage decoded;
+        if (!decoder.Decode(bytes.data(), bytes.size(), decoded))
+        {
+            fprintf(stderr, "decode failed: %s at %zu\n", decoder.Error(), decoder.ErrorOffset());
+            CHECK(false);
+        }
+        CHECK(decoded.partial == message.partial);
+        CHECK(decoded.lights.size() == message.lights.size());
+        for (size_t i = 0; i < message.lights.size(); ++i)
+        {
+            CHECK(decoded.lights[i].uuid == g_ids[message.lights[i]]);
+            CHECK(decoded.lights[i].intensity == static_cast<float>(message.lights[i] + 1));
+        }
+        return handlesUsed;
+    }
+
+    void TestDeliveredScene()
+    {
+        Handles handles;
+        LightMessageDecoder decoder;
+        CHECK(Deliver(handles, decoder, Scene(1), true) == 0);
+        CHECK(Deliver(handles, decoder, Partial(1), true) == 2);
+
+        // A partial that failed to send leaves the receiver's scene unknown
+        CHECK(Deliver(handles, decoder, Partial(1), false) == 0);
+        CHECK(Deliver(handles, decoder, Partial(1), true) == 0);
+    }
+
+    void TestDroppedScene()
+    {
+        Handles handles;
+        LightMessageDecoder decoder;
+        CHECK(Deliver(handles, decoder, Scene(1), true) == 0);
+        CHECK(Deliver(handles, decoder, Partial(1), true) == 2);
+
+        // The decoder never sees scene 2, so its partial names lights by id and still decodes
+        CHECK(Deliver(handles, decoder, Scene(2), false) == 0);
+        CHECK(Deliver(handles, decoder, Partial(2), true) == 0);
+
+        // Handles of the lost scene are exactly what the decoder rejects
+        Handles encoderView;
+        size_t handlesUsed = 0;
+        Encode(encoderView, Scene(2), handlesUsed);
+        encoderView.Delivered(true);
+        const std::string stale = Encode(encoderView, Partial(2), handlesUsed);
+        CHECK(handlesUsed == 2);
+        LightMessage decoded;
+        CHECK(!decoder.Decode(stale.data(), stale.size(), decoded));
+
+        // The next scene that arrives brings handles back
+        CHECK(Deliver(handles, decoder, Scene(3), true) == 0);
+        CHECK(Deliver(handles, decoder, Partial(3), true) == 2);
+    }
+
+    void TestSupersededScene()
+    {
+        Handles handles;
+        LightMessageDecoder decoder;
+        CHECK(Deliver(handles, decoder, Scene(1), true) == 0);
+        CHECK(Deliver(handles, decoder, Scene(2), true) == 0);
+
+        // A late partial of the replaced scene names its lights by id
+        CHECK(Deliver(handles, decoder, Partial(1), true) == 0);
+        CHECK(Deliver(handles, decoder, Partial(2), true) == 2);
+    }
+
+    void TestBatches()
+    {
+        Handles handles;
+        LightMessageDecoder decoder;
+
+        // Both batches arrived: lights of either batch have handles
+        CHECK(Deliver(handles, decoder, Batch(1, 0), true) == 0);
+        CHECK(Deliver(handles, decoder, Batch(1, 1), true) == 0);
+        CHECK(Deliver(handles, decoder, Partial(1), true) == 2);
+
+        // The second batch of the next scene was lost
+        CHECK(Deliver(handles, decoder, Batch(2, 0), true) == 0);
+        CHECK(Deliver(handles, decoder, Batch(2, 1), false) == 0);
+        CHECK(Deliver(handles, decoder, Partial(2), true) == 0);
+
+        // Only the first batch of a scene arrived so far: its light gets a handle, the other its id
+        CHECK(Deliver(handles, decoder, Batch(3, 0), true) == 0);
+        CHECK(Deliver(handles, decoder, Partial(3), true) == 1);
+    }
+
+    void TestResumedReceiver()
+    {
+        Handles handles;
+        LightMessageDecoder decoder;
+        CHECK(Deliver(handles, decoder, Scene(1), true) == 0);
+        CHECK(Deliver(handles, decoder, Partial(1), true) == 2);
+
+        // A reconnected receiver starts with a new decoder and resumes with deltas only
+        handles.Forget();
+        LightMessageDecoder resumed;
+        CHECK(Deliver(handles, resumed, Partial(1), true) == 0);
+    }
+}
+
+int main()
+{
+    for (size_t i = 0; i < SCENE_SIZE; ++i)
+    {
+        LightUuid id = {};
+        id.bytes[0] = 0x40;
+        id.bytes[15] = static_cast<unsigned char>(i + 1);
+        g_ids.push_back(id);
+    }
+
+    TestDeliveredScene();
+    TestDroppedScene();
+    TestSupersededScene();
+    TestBatches();
+    TestResumedReceiver();
+    printf("LightQuantizedHandlesTest: all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,354 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+/**
+ * @brief Loopback tests of live drag datagrams, from the network thread to LightMirror (Linux)
+ *
+ * Packs transform samples into datagrams the way LiveDragStreamer does, sends
+ * them through LightSyncReactor's UDP socket and receives them on a loopback
+ * port: every datagram must decode on its own as one complete message below
+ * the size limit, all samples of a drag must leave from the same socket, and
+ * LightMirror must drop late samples and samples older than a commit. Exits
+ * non-zero on the first failed check.
+ */
+
+#include "../LightSyncReactor.h"
+#include "../Receiver/LightMessageDecoder.h"
+#include "../Receiver/LightMirror.h"
+#include <arpa/inet.h>
+#include <dirent.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <future>
+#include <string>
+#include <vector>
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #condition); \
+            exit(1); \
+        } \
+    } while (0)
+
+namespace {
+    typedef std::chrono::steady_clock Clock;
+
+    constexpr int RECEIVER_PORT = 47193;
+    constexpr unsigned int DOCUMENT = 3;
+    constexpr size_t LIGHTS = 40;
+
+    // As in LightSyncNetwork and LiveDragStreamer
+    constexpr size_t MAX_DATAGRAM_BYTES = 1200;
+    constexpr size_t TRANSFORM_MESSAGE_OVERHEAD = 128;
+
+    std::atomic<int> g_datagramPhases(0);
+    int64_t g_transformSequence = 0;
+
+    void ObservePhase(int port, const char* phase, Clock::time_point, Clock::time_point)
+    {
+        if (port == RECEIVER_PORT && std::string(phase) == "datagrams")
+            ++g_datagramPhases;
+    }
+
+    int OpenDescriptors()
+    {
+        int count = 0;
+        DIR* directory = opendir("/proc/self/fd");
+        CHECK(directory != nullptr);
+        while (readdir(directory) != nullptr)
+        {
+            ++count;
+        }
+        closedir(directory);
+        return count;
+    }
+
+    std::string LightUuidText(size_t light)
+    {
+        char text[40];
+        snprintf(text, sizeof(text), "%08zx-0000-4000-8000-%012zx", light + 1, light * 7);
+        return text;
+    }
+
+    LightUuid LightId(size_t light)
+    {
+        const std::string text = LightUuidText(light);
+        LightUuid uuid;
+        CHECK(LightUuid::Parse(text.data(), text.size(), uuid));
+        return uuid;
+    }
+
+    std::string TransformRecord(size_t light, double x)
+    {
+        char record[256];
+        snprintf(record, sizeof(record),
+            "{\"uuid\": \"%s\", \"location\": {\"x\": %.6f, \"y\": %.6f, \"z\": %.6f}, "
+            "\"rotation\": {\"pitch\": %.3f, \"yaw\": %.3f, \"roll\": %.3f}}",
+            LightUuidText(light).c_str(), x, static_cast<double>(light), 2.5, -45.0, 90.0, 0.0);
+        return record;
+    }
+
+    std::string TransformMessage(const std::vector<std::string>& records, size_t begin, size_t end)
+    {
+        std::string message = "{\"event\": \"Light Transform\", \"document\": " + std::to_string(DOCUMENT) +
+            ", \"partial\": true, \"transformSequence\": " + std::to_string(++g_transformSequence) + ", \"lights\": [";
+        for (size_t i = begin; i < end; ++i)
+        {
+            if (i > begin)
+                message += ", ";
+            message += records[i];
+        }
+        message += "]}";
+        return message;
+    }
+
+    // One sample of every light at x, split like LiveDragStreamer::Sample splits it for UDP
+    std::vector<std::string> Sample(double x)
+    {
+        std::vector<std::string> records;
+        for (size_t light = 0; light < LIGHTS; ++light)
+        {
+            records.push_back(TransformRecord(light, x));
+        }
+
+        std::vector<std::string> datagrams;
+        size_t begin = 0;
+        size_t size = TRANSFORM_MESSAGE_OVERHEAD;
+        for (size_t i = 0; i < records.size(); ++i)
+        {
+            if (i > begin && size + records[i].size() > MAX_DATAGRAM_BYTES)
+            {
+                datagrams.push_back(TransformMessage(records, begin, i));
+                begin = i;
+                size = TRANSFORM_MESSAGE_OVERHEAD;
+            }
+            size += records[i].size();
+        }
+        datagrams.push_back(TransformMessage(records, begin, records.size()));
+        return datagrams;
+    }
+
+    // Complete scene of every light at x = 0, resolved after transform sequence resolvedAt
+    std::string Scene(int64_t sequence, int64_t resolvedAt)
+    {
+        std::string message = "{\"event\": \"Light Added\", \"document\": " + std::to_string(DOCUMENT) +
+            ", \"sequence\": " + std::to_string(sequence) + ", \"transformSequence\": " + std::to_string(resolvedAt) +
+            ", \"lightCount\": " + std::to_string(LIGHTS) + ", \"lights\": [";
+        for (size_t light = 0; light < LIGHTS; ++light)
+        {
+            if (light > 0)
+                message += ", ";
+            message += "{\"id\": " + std::to_string(light) + ", \"uuid\": \"" + LightUuidText(light) + "\", "
+                "\"type\": \"Point\", \"location\": {\"x\": 0.0, \"y\": 0.0, \"z\": 0.0}, "
+                "\"rotation\": {\"pitch\": 0.0, \"yaw\": 0.0, \"roll\": 0.0}, \"intensity\": 1, "
+                "\"color\": {\"r\": 255, \"g\": 255, \"b\": 255}}";
+        }
+        message += "]}";
+        return message;
+    }
+
+    // Released light 0 at x, resolved after transform sequence resolvedAt
+    std::string Commit(int64_t sequence, int64_t resolvedAt, double x)
+    {
+        char message[512];
+        snprintf(message, sizeof(message),
+            "{\"event\": \"Light Commit\", \"document\": %u, \"sequence\": %lld, \"transformSequence\": %lld, "
+            "\"partial\": true, \"lightCount\": 1, \"lights\": [{\"id\": 0, \"uuid\": \"%s\", \"type\": \"Point\", "
+            "\"location\": {\"x\": %.6f, \"y\": 0.0, \"z\": 0.0}, \"rotation\": {\"pitch\": 0.0, \"yaw\": 0.0, "
+            "\"roll\": 0.0}, \"intensity\": 1, \"color\": {\"r\": 255, \"g\": 255, \"b\": 255}}]}",
+            DOCUMENT, static_cast<long long>(sequence), static_cast<long long>(resolvedAt),
+            LightUuidText(0).c_str(), x);
+        return message;
+    }
+
+    int BindReceiver()
+    {
+        const int sock = socket(AF_INET, SOCK_DGRAM, 0);
+        CHECK(sock >= 0);
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(static_cast<unsigned short>(RECEIVER_PORT));
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        CHECK(bind(sock, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0);
+
+        // Loopback datagrams arrive at once; a missing one fails the test instead of hanging it
+        timeval timeout = {};
+        timeout.tv_sec = 2;
+        setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        int bufferBytes = 1 << 20;
+        setsockopt(sock, SOL_SOCKET, SO_RCVBUF, &bufferBytes, sizeof(bufferBytes));
+        return sock;
+    }
+
+    // Sends the datagrams on the network thread; returns how many went out
+    size_t Send(const std::vector<std::string>& datagrams)
+    {
+        std::promise<size_t> sent;
+        CHECK(LightSyncReactor::Post([&]
+        {
+            size_t sentBytes = 0;
+            const size_t count = LightSyncReactor::SendDatagrams(RECEIVER_PORT, datagrams, sentBytes);
+            size_t expectedBytes = 0;
+            for (const std::string& datagram : datagrams)
+            {
+                expectedBytes += datagram.size();
+            }
+            CHECK(count < datagrams.size() || sentBytes == expectedBytes);
+            sent.set_value(count);
+        }));
+        return sent.get_future().get();
+    }
+
+    // Receives count datagrams; sourcePort is where they came from, which must be the same for all
+    std::vector<std::string> Receive(int sock, size_t count, unsigned short& sourcePort)
+    {
+        std::vector<std::string> datagrams;
+        char buffer[65536];
+        for (size_t i = 0; i < count; ++i)
+        {
+            sockaddr_in from = {};
+            socklen_t fromSize = sizeof(from);
+            const ssize_t received = recvfrom(sock, buffer, sizeof(buffer), 0, reinterpret_cast<sockaddr*>(&from), &fromSize);
+            CHECK(received > 0);
+            CHECK(i == 0 || ntohs(from.sin_port) == sourcePort);
+            sourcePort = ntohs(from.sin_port);
+            datagrams.emplace_back(buffer, static_cast<size_t>(received));
+        }
+        return datagrams;
+    }
+
+    double LocationX(const LightMirror& mirror, size_t light)
+    {
+        const ReceivedLight* found = mirror.Find(LightId(light));
+        CHECK(found != nullptr);
+        return found->location[0];
+    }
+
+    void TestFramingAndDrops()
+    {
+        const int receiver = BindReceiver();
+        LightMessageDecoder decoder;
+        LightMessage message;
+        LightMirror mirror;
+
+        const std::string scene = Scene(1, g_transformSequence);
+        CHECK(decoder.Decode(scene.data(), scene.size(), message));
+        CHECK(mirror.Apply(message) == LightMirror::Result::Applied);
+        CHECK(mirror.Count() == LIGHTS);
+
+        // A drag of many lights is split, and every datagram is a complete message on its own
+        const std::vector<std::string> first = Sample(1.0);
+        CHECK(first.size() > 1);
+        CHECK(Send(first) == first.size());
+        unsigned short firstSource = 0;
+        const std::vector<std::string> firstReceived = Receive(receiver, first.size(), firstSource);
+        CHECK(firstReceived == first);
+
+        size_t lights = 0;
+        for (const std::string& datagram : firstReceived)
+        {
+            CHECK(datagram.size() < MAX_DATAGRAM_BYTES);
+            CHECK(decoder.Decode(datagram.data(), datagram.size(), message));
+            CHECK(message.IsEvent("Light Transform"));
+            CHECK(message.partial && message.sequence < 0 && message.transformSequence > 0);
+            lights += message.lights.size();
+            CHECK(mirror.Apply(message) == LightMirror::Result::Applied);
+        }
+        CHECK(lights == LIGHTS);
+        CHECK(LocationX(mirror, 0) == 1.0 && LocationX(mirror, LIGHTS - 1) == 1.0);
+
+        // The next sample leaves from the same socket
+        const std::vector<std::string> second = Sample(2.0);
+        CHECK(Send(second) == second.size());
+        unsigned short secondSource = 0;
+        const std::vector<std::string> secondReceived = Receive(receiver, second.size(), secondSource);
+        CHECK(secondSource == firstSource);
+        for (const std::string& datagram : secondReceived)
+        {
+            CHECK(decoder.Decode(datagram.data(), datagram.size(), message));
+            CHECK(mirror.Apply(message) == LightMirror::Result::Applied);
+        }
+
+        // First-sample datagrams arriving late do not move the lights back
+        for (const std::string& datagram : firstReceived)
+        {
+            CHECK(decoder.Decode(datagram.data(), datagram.size(), message));
+            CHECK(mirror.Apply(message) == LightMirror::Result::Stale);
+        }
+        CHECK(LocationX(mirror, 0) == 2.0 && LocationX(mirror, LIGHTS - 1) == 2.0);
+
+        // A sample taken before the commit was resolved arrives after it and is dropped
+        const std::vector<std::string> beforeCommit = Sample(3.0);
+        const std::string commit = Commit(2, g_transformSequence, 5.0);
+        CHECK(decoder.Decode(commit.data(), commit.size(), message));
+        CHECK(mirror.Apply(message) == LightMirror::Result::Applied);
+        CHECK(Send(beforeCommit) == beforeCommit.size());
+        unsigned short beforeCommitSource = 0;
+        for (const std::string& datagram : Receive(receiver, beforeCommit.size(), beforeCommitSource))
+        {
+            CHECK(decoder.Decode(datagram.data(), datagram.size(), message));
+            CHECK(mirror.Apply(message) == LightMirror::Result::Stale);
+        }
+        CHECK(beforeCommitSource == firstSource);
+        CHECK(LocationX(mirror, 0) == 5.0 && LocationX(mirror, LIGHTS - 1) == 2.0);
+
+        // Samples taken after the commit apply again
+        const std::vector<std::string> afterCommit = Sample(4.0);
+        CHECK(Send(afterCommit) == afterCommit.size());
+        unsigned short afterCommitSource = 0;
+        for (const std::string& datagram : Receive(receiver, afterCommit.size(), afterCommitSource))
+        {
+            CHECK(decoder.Decode(datagram.data(), datagram.size(), message));
+            CHECK(mirror.Apply(message) == LightMirror::Result::Applied);
+        }
+        CHECK(LocationX(mirror, 0) == 4.0 && LocationX(mirror, LIGHTS - 1) == 4.0);
+
+        // Every call reported its phase; off the network thread nothing is sent
+        CHECK(g_datagramPhases == 4);
+        size_t sentBytes = 1;
+        CHECK(LightSyncReactor::SendDatagrams(RECEIVER_PORT, first, sentBytes) == 0);
+        CHECK(sentBytes == 0);
+
+        close(receiver);
+    }
+}
+
+int main()
+{
+    // The UDP socket lives as long as the network thread: none is left open once it stopped
+    const int descriptorsBefore = OpenDescriptors();
+    CHECK(LightSyncReactor::Start(LightSyncReactor::Task(), ObservePhase));
+    TestFramingAndDrops();
+    LightSyncReactor::Stop();
+    CHECK(OpenDescriptors() == descriptorsBefore);
+
+    // A restarted network thread opens a new one
+    CHECK(LightSyncReactor::Start());
+    const int receiver = BindReceiver();
+    const std::vector<std::string> sample = Sample(6.0);
+    CHECK(Send(sample) == sample.size());
+    unsigned short source = 0;
+    CHECK(Receive(receiver, sample.size(), source) == sample);
+    close(receiver);
+    LightSyncReactor::Stop();
+    CHECK(OpenDescriptors() == descriptorsBefore);
+
+    printf("LightSyncDatagramTest: all checks passed\n");
+    return 0;
+}
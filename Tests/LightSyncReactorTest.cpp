@@ -0,0 +1,304 @@
+// Copyright (c) 2025 Rudra Ojha
+// All rights reserved.
+//
+// This source code is provided for educational and reference purposes only.
+// Redistribution, modification, or use of this code in any commercial or private
+// product is strictly prohibited without explicit written permission from the author.
+//
+// Unauthorized use in any software or plugin distributed to end-users,
+// whether open-source or commercial, is not allowed.
+//
+// Contact: rudraojhaif@gmail.com for licensing inquiries.
+
+/**
+ * @brief Loopback tests of the network thread on its epoll backend (Linux)
+ *
+ * Drives LightSyncReactor the way the plug-in does: tasks and timers, the two
+ * request framings of the control channel and the metrics endpoint, outbound
+ * messages split into many segments, the connect and send phases reported
+ * for traces, refused and stalled receivers, and stopping with a send in
+ * flight. Exits non-zero on the first failed check.
+ */
+
+#include "../LightSyncReactor.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #condition); \
+            exit(1); \
+        } \
+    } while (0)
+
+namespace {
+    using std::chrono::milliseconds;
+    typedef std::chrono::steady_clock Clock;
+
+    constexpr int CONTROL_PORT = 47174;
+    constexpr int METRICS_PORT = 47175;
+    constexpr int RECEIVER_PORT = 47173;
+    constexpr int CLOSED_PORT = 47999;
+    constexpr int STALLED_PORT = 47998;
+
+    // Phases reported by the reactor for RECEIVER_PORT (network thread)
+    std::atomic<int> g_connectPhases(0);
+    std::atomic<int> g_sendPhases(0);
+    std::atomic<bool> g_phaseOrderValid(true);
+
+    void ObservePhase(int port, const char* phase, Clock::time_point start, Clock::time_point end)
+    {
+        if (port != RECEIVER_PORT)
+            return;
+        if (end < start)
+            g_phaseOrderValid = false;
+        if (std::string(phase) == "connect")
+            ++g_connectPhases;
+        else if (std::string(phase) == "send")
+            ++g_sendPhases;
+    }
+
+    // Gives a new listener time to be registered by the network thread
+    void WaitForListener()
+    {
+        std::this_thread::sleep_for(milliseconds(20));
+    }
+
+    long ElapsedMilliseconds(Clock::time_point start)
+    {
+        return static_cast<long>(std::chrono::duration_cast<milliseconds>(Clock::now() - start).count());
+    }
+
+    sockaddr_in Loopback(int port)
+    {
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(static_cast<unsigned short>(port));
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        return address;
+    }
+
+    int Connect(int port)
+    {
+        const int sock = socket(AF_INET, SOCK_STREAM, 0);
+        const sockaddr_in address = Loopback(port);
+        if (connect(sock, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+        {
+            close(sock);
+            return -1;
+        }
+        return sock;
+    }
+
+    // Listener that never accepts, so a large message stalls once the socket buffers are full
+    int ListenWithoutAccepting(int port)
+    {
+        const int sock = socket(AF_INET, SOCK_STREAM, 0);
+        const int reuse = 1;
+        setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        const sockaddr_in address = Loopback(port);
+        CHECK(bind(sock, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0);
+        CHECK(listen(sock, 4) == 0);
+        return sock;
+    }
+
+    std::string ReadAll(int sock)
+    {
+        std::string text;
+        char buffer[4096];
+        ssize_t received;
+        while ((received = recv(sock, buffer, sizeof(buffer), 0)) > 0)
+        {
+            text.append(buffer, static_cast<size_t>(received));
+        }
+        return text;
+    }
+
+    // Sends the request, half-closes like a control client and returns the reply
+    std::string Request(int port, const std::string& request, bool halfClose)
+    {
+        const int sock = Connect(port);
+        CHECK(sock >= 0);
+        send(sock, request.data(), request.size(), MSG_NOSIGNAL);
+        if (halfClose)
+            shutdown(sock, SHUT_WR);
+        const std::string reply = ReadAll(sock);
+        close(sock);
+        return reply;
+    }
+
+    void TestTasksAndTimers()
+    {
+        // Timers run in due order; a cancelled one never runs
+        std::string order;
+        std::promise<std::string> done;
+        LightSyncReactor::AddTimer(milliseconds(30), [&] { order += "b"; done.set_value(order); });
+        LightSyncReactor::AddTimer(milliseconds(10), [&] { order += "a"; });
+        const LightSyncReactor::TimerId cancelled = LightSyncReactor::AddTimer(milliseconds(20), [&] { order += "X"; });
+        LightSyncReactor::CancelTimer(cancelled);
+        CHECK(done.get_future().get() == "ab");
+
+        std::promise<bool> onNetworkThread;
+        CHECK(LightSyncReactor::Post([&] { onNetworkThread.set_value(LightSyncReactor::IsNetworkThread()); }));
+        CHECK(onNetworkThread.get_future().get());
+        CHECK(!LightSyncReactor::IsNetworkThread());
+    }
+
+    void TestListeners()
+    {
+        // Control channel framing: the request ends when the client half-closes
+        CHECK(LightSyncReactor::Listen(CONTROL_PORT, LightSyncReactor::Framing::HalfClose, 1 << 20, milliseconds(500),
+            [](const std::string& request) { return "echo:" + request; }));
+        WaitForListener();
+        for (int i = 0; i < 20; ++i)
+        {
+            const std::string request = "hello" + std::to_string(i);
+            CHECK(Request(CONTROL_PORT, request, true) == "echo:" + request);
+        }
+
+        // A request over the limit is dropped without a reply
+        CHECK(Request(CONTROL_PORT, std::string(2 << 20, 'x'), true).empty());
+
+        // A client that never half-closes is dropped after the receive timeout
+        const Clock::time_point start = Clock::now();
+        CHECK(Request(CONTROL_PORT, "abc", false).empty());
+        const long elapsed = ElapsedMilliseconds(start);
+        CHECK(elapsed >= 400 && elapsed < 1500);
+
+        // Metrics framing: a blank line ends the request head
+        CHECK(LightSyncReactor::Listen(METRICS_PORT, LightSyncReactor::Framing::HeaderEnd, 8192, milliseconds(500),
+            [](const std::string& request) { return std::string(request.compare(0, 13, "GET /metrics ") == 0 ? "200" : "404"); }));
+        WaitForListener();
+        CHECK(Request(METRICS_PORT, "GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n", false) == "200");
+
+        // A port can be listened on once; after CloseListener it is free again
+        CHECK(!LightSyncReactor::Listen(METRICS_PORT, LightSyncReactor::Framing::HeaderEnd, 8192, milliseconds(500),
+            [](const std::string&) { return std::string(); }));
+        LightSyncReactor::CloseListener(METRICS_PORT);
+        CHECK(Connect(METRICS_PORT) < 0);
+        CHECK(LightSyncReactor::Listen(METRICS_PORT, LightSyncReactor::Framing::HeaderEnd, 8192, milliseconds(500),
+            [](const std::string&) { return std::string("again"); }));
+        WaitForListener();
+        CHECK(Request(METRICS_PORT, "x\r\n\r\n", false) == "again");
+    }
+
+    void TestSends()
+    {
+        // The reactor's own listener stands in for a receiver
+        std::atomic<int> received(0);
+        std::atomic<size_t> receivedBytes(0);
+        CHECK(LightSyncReactor::Listen(RECEIVER_PORT, LightSyncReactor::Framing::HalfClose, 64 << 20, milliseconds(2000),
+            [&](const std::string& message) { ++received; receivedBytes += message.size(); return std::string(); }));
+        WaitForListener();
+
+        // More segments than one vectored write takes, some of them empty
+        const std::string chunk(1000, 'y');
+        std::vector<LightSyncReactor::Segment> segments;
+        size_t messageBytes = 0;
+        for (int i = 0; i < 3000; ++i)
+        {
+            const size_t size = i % 7 == 0 ? 0 : chunk.size();
+            segments.push_back(LightSyncReactor::Segment{ chunk.data(), size });
+            messageBytes += size;
+        }
+
+        constexpr int MESSAGES = 50;
+        std::atomic<int> sent(0);
+        std::atomic<int> failed(0);
+        std::atomic<int> pending(MESSAGES);
+        std::promise<void> allDone;
+        for (int i = 0; i < MESSAGES; ++i)
+        {
+            CHECK(LightSyncReactor::Send(RECEIVER_PORT, segments, [&](bool ok)
+            {
+                ++(ok ? sent : failed);
+                if (--pending == 0)
+                    allDone.set_value();
+            }));
+        }
+        allDone.get_future().wait();
+        for (int i = 0; i < 500 && received < MESSAGES; ++i)
+        {
+            std::this_thread::sleep_for(milliseconds(10));
+        }
+        CHECK(sent == MESSAGES && failed == 0);
+        CHECK(received == MESSAGES);
+        CHECK(receivedBytes == messageBytes * MESSAGES);
+
+        // Every message reported its connect and its write
+        CHECK(g_connectPhases == MESSAGES);
+        CHECK(g_sendPhases == MESSAGES);
+        CHECK(g_phaseOrderValid);
+
+        // Nobody listening: the handler reports failure
+        std::promise<bool> refused;
+        CHECK(LightSyncReactor::Send(CLOSED_PORT, segments, [&](bool ok) { refused.set_value(ok); }));
+        CHECK(!refused.get_future().get());
+
+        // A receiver that stops reading fails the send after SEND_TIMEOUT_MS
+        const int stalled = ListenWithoutAccepting(STALLED_PORT);
+        const std::string huge(64 << 20, 'z');
+        std::promise<bool> timedOut;
+        const Clock::time_point start = Clock::now();
+        CHECK(LightSyncReactor::Send(STALLED_PORT, { { huge.data(), huge.size() } }, [&](bool ok) { timedOut.set_value(ok); }));
+        CHECK(!timedOut.get_future().get());
+        CHECK(ElapsedMilliseconds(start) >= LightSyncReactor::SEND_TIMEOUT_MS - 100);
+        close(stalled);
+    }
+
+    void TestStopAndRestart()
+    {
+        // Stopping fails the send in flight at once, and nothing is queued from its handler
+        const int stalled = ListenWithoutAccepting(STALLED_PORT - 1);
+        const std::string huge(64 << 20, 'z');
+        std::atomic<int> result(-1);
+        std::atomic<bool> queuedAfterStop(true);
+        CHECK(LightSyncReactor::Send(STALLED_PORT - 1, { { huge.data(), huge.size() } }, [&](bool ok)
+        {
+            result = ok ? 1 : 0;
+            queuedAfterStop = LightSyncReactor::Send(1, {}, {});
+        }));
+        std::this_thread::sleep_for(milliseconds(100));
+        const Clock::time_point start = Clock::now();
+        LightSyncReactor::Stop();
+        CHECK(ElapsedMilliseconds(start) < 500);
+        CHECK(result == 0);
+        CHECK(!queuedAfterStop);
+        CHECK(!LightSyncReactor::IsRunning());
+        CHECK(!LightSyncReactor::Post([] {}));
+        CHECK(LightSyncReactor::AddTimer(milliseconds(1), [] {}) == 0);
+        close(stalled);
+
+        // A restarted reactor serves again and runs its start-up task on the new thread
+        std::promise<bool> started;
+        CHECK(LightSyncReactor::Start([&] { started.set_value(LightSyncReactor::IsNetworkThread()); }));
+        CHECK(started.get_future().get());
+        CHECK(LightSyncReactor::Listen(CONTROL_PORT, LightSyncReactor::Framing::HalfClose, 1 << 20, milliseconds(500),
+            [](const std::string& request) { return "again:" + request; }));
+        WaitForListener();
+        CHECK(Request(CONTROL_PORT, "q", true) == "again:q");
+        LightSyncReactor::Stop();
+    }
+}
+
+int main()
+{
+    CHECK(LightSyncReactor::Start(LightSyncReactor::Task(), ObservePhase));
+    TestTasksAndTimers();
+    TestListeners();
+    TestSends();
+    TestStopAndRestart();
+    printf("LightSyncReactorTest: all checks passed\n");
+    return 0;
+}